@@ -35,6 +35,8 @@
 
 #include "btkAnalogOffsetRemover.h"
 
+#include <algorithm>
+
 namespace btk
 {
   /**
@@ -45,6 +47,19 @@ namespace btk
    * removed from the raw input (see the method SetRawInput()). The analog signals set in the raw input which
    * are not given to the offset input are not processed but will be available in the output.
    *
+   * The offsets can also be estimated from the raw input itself (see the method SetEstimation() with the value 
+   * AnalogOffsetRemover::QuietestWindow). In this case, no offset input is required. Each processed channel is cut
+   * into consecutive windows (see SetWindowLength()) and the offset is computed with a robust statistic (median or
+   * trimmed mean, see SetStatistic()) over the window with the lowest variance. For example, with force platform 
+   * channels, this window corresponds to an unloaded period of the trial. By default, all the analog channels are
+   * processed. You can restrict them with the method SetChannelLabels().
+   *
+   * Only the current window of each channel is stored during the estimation. In incremental mode 
+   * (see SetIncrementalMode()), the samples appended to the raw input since the last update are the only ones 
+   * scanned and the results are the same than the batch estimation on the full signals. The estimation restarts 
+   * from the first sample when the analog channels are not the same objects than at the last update (for example,
+   * when another trial is set as raw input). The offsets removed at the last update are given by the method GetOffsets().
+   *
    * @ingroup BTKBasicFilters
    */
    
@@ -81,6 +96,7 @@ namespace btk
     /**
      * @fn void AnalogOffsetRemover::SetOffsetInput(Acquisition::Pointer input)
      * Sets the input required with this process which corresponds to the offsets to remove.
+     * This input is only used with the estimation AnalogOffsetRemover::OffsetInput.
      */
 
    /**
@@ -88,15 +104,170 @@ namespace btk
     * Gets the output created with this process.
     */
   
+  /**
+   * @enum AnalogOffsetRemover::Estimation
+   * Enums used to specify how the offsets are estimated.
+   */
+  /**
+   * @var AnalogOffsetRemover::Estimation AnalogOffsetRemover::OffsetInput
+   * The offsets are the mean of the channels given in the offset input.
+   */
+  /**
+   * @var AnalogOffsetRemover::Estimation AnalogOffsetRemover::QuietestWindow
+   * The offsets are estimated from the quietest window of each channel of the raw input.
+   */
+  
+  /**
+   * @enum AnalogOffsetRemover::Statistic
+   * Enums used to specify the statistic computed over the quietest window.
+   */
+  /**
+   * @var AnalogOffsetRemover::Statistic AnalogOffsetRemover::Median
+   * Median of the window.
+   */
+  /**
+   * @var AnalogOffsetRemover::Statistic AnalogOffsetRemover::TrimmedMean
+   * Mean of the window without its extreme values (see SetTrimmingProportion()).
+   */
+  
+  /**
+   * @fn Estimation AnalogOffsetRemover::GetEstimation() const
+   * Returns the method used to estimate the offsets.
+   */
+  
+  /**
+   * Sets the method used to estimate the offsets (AnalogOffsetRemover::OffsetInput by default).
+   */
+  void AnalogOffsetRemover::SetEstimation(Estimation estimation)
+  {
+    if (this->m_Estimation == estimation)
+      return;
+    this->m_Estimation = estimation;
+    this->m_States.clear();
+    this->Modified();
+  };
+  
+  /**
+   * @fn Statistic AnalogOffsetRemover::GetStatistic() const
+   * Returns the statistic computed over the quietest window.
+   */
+  
+  /**
+   * Sets the statistic computed over the quietest window (AnalogOffsetRemover::Median by default).
+   */
+  void AnalogOffsetRemover::SetStatistic(Statistic statistic)
+  {
+    if (this->m_Statistic == statistic)
+      return;
+    this->m_Statistic = statistic;
+    this->m_States.clear();
+    this->Modified();
+  };
+  
+  /**
+   * @fn int AnalogOffsetRemover::GetWindowLength() const
+   * Returns the number of samples in each window.
+   */
+  
+  /**
+   * Sets the number of samples in each window (100 by default). The length must be greater than 0.
+   */
+  void AnalogOffsetRemover::SetWindowLength(int length)
+  {
+    if (this->m_WindowLength == length)
+      return;
+    if (length < 1)
+    {
+      btkErrorMacro("The window length must be greater than 0.");
+      return;
+    }
+    this->m_WindowLength = length;
+    this->m_States.clear();
+    this->Modified();
+  };
+  
+  /**
+   * @fn double AnalogOffsetRemover::GetTrimmingProportion() const
+   * Returns the proportion of samples removed at each end of the window for the trimmed mean.
+   */
+  
+  /**
+   * Sets the proportion of samples removed at each end of the window for the trimmed mean (0.25 by default,
+   * corresponding to the interquartile mean). The proportion must be in the range [0, 0.5[.
+   */
+  void AnalogOffsetRemover::SetTrimmingProportion(double proportion)
+  {
+    if (this->m_TrimmingProportion == proportion)
+      return;
+    if ((proportion < 0.0) || (proportion >= 0.5))
+    {
+      btkErrorMacro("The trimming proportion must be in the range [0, 0.5[.");
+      return;
+    }
+    this->m_TrimmingProportion = proportion;
+    this->m_States.clear();
+    this->Modified();
+  };
+  
+  /**
+   * @fn const std::vector<std::string>& AnalogOffsetRemover::GetChannelLabels() const
+   * Returns the labels of the channels processed with the estimation AnalogOffsetRemover::QuietestWindow.
+   */
+  
+  /**
+   * Sets the labels of the channels processed with the estimation AnalogOffsetRemover::QuietestWindow.
+   * An empty list (default) means that every analog channel is processed.
+   */
+  void AnalogOffsetRemover::SetChannelLabels(const std::vector<std::string>& labels)
+  {
+    if (this->m_ChannelLabels == labels)
+      return;
+    this->m_ChannelLabels = labels;
+    this->m_States.clear();
+    this->Modified();
+  };
+  
+  /**
+   * @fn bool AnalogOffsetRemover::GetIncrementalMode() const
+   * Returns the state of the incremental mode.
+   */
+  
+  /**
+   * Sets the incremental mode.
+   *
+   * In this mode, with the estimation AnalogOffsetRemover::QuietestWindow, the state of the estimation is kept
+   * between two updates and only the samples appended to the channels of the raw input are scanned. The state 
+   * is reset if the processed channels are not the same or if they were shortened.
+   */
+  void AnalogOffsetRemover::SetIncrementalMode(bool enabled)
+  {
+    if (this->m_IncrementalMode == enabled)
+      return;
+    this->m_IncrementalMode = enabled;
+    this->m_States.clear();
+    this->Modified();
+  };
+  
+  /**
+   * @fn const std::vector<double>& AnalogOffsetRemover::GetOffsets() const
+   * Returns the offsets removed at the last update. They are ordered as the analog channels of the raw input.
+   * The value of a channel not processed is set to 0.
+   */
+  
   /**
    * Constructor. 
    * Sets the number of inputs to 2 (raw and offset acquisition) and outputs to 1.
    */
   AnalogOffsetRemover::AnalogOffsetRemover()
-  : ProcessObject()
+  : ProcessObject(), m_ChannelLabels(), m_States(), m_Offsets()
   {
     this->SetInputNumber(2);
     this->SetOutputNumber(1);
+    this->m_Estimation = OffsetInput;
+    this->m_Statistic = Median;
+    this->m_WindowLength = 100;
+    this->m_TrimmingProportion = 0.25;
+    this->m_IncrementalMode = false;
   };
 
   /**
@@ -124,38 +295,32 @@ namespace btk
   {
     Acquisition::Pointer rawInput = this->GetRawInput();
     Acquisition::Pointer offsetInput = this->GetOffsetInput();
-    if (!rawInput || !offsetInput)
+    if (!rawInput || (!offsetInput && (this->m_Estimation == OffsetInput)))
     {
       btkErrorMacro("Missing at least one input.");
       return;
     }
     
-    AnalogCollection::Pointer raws = rawInput->GetAnalogs();
-    AnalogCollection::Pointer offsets = offsetInput->GetAnalogs();
+    std::vector<bool> processed(rawInput->GetAnalogNumber(), false);
+    this->m_Offsets.assign(rawInput->GetAnalogNumber(), 0.0);
+    if (this->m_Estimation == OffsetInput)
+      this->ComputeReferenceOffsets(rawInput, offsetInput, processed);
+    else
+      this->ComputeQuietestWindowOffsets(rawInput, processed);
+    
     AnalogCollection::Pointer analogs = AnalogCollection::New();
-    std::list< std::pair<Analog::Pointer, Analog::Pointer> > signals; // Raw, offset
-    for (AnalogCollection::ConstIterator itR = raws->Begin() ; itR != raws->End() ; ++itR)
+    int inc = 0;
+    for (AnalogCollection::ConstIterator it = rawInput->BeginAnalog() ; it != rawInput->EndAnalog() ; ++it)
     {
-      bool found = false;
-      for (AnalogCollection::ConstIterator itO = offsets->Begin() ; itO != offsets->End() ; ++itO)
+      if (processed[inc])
       {
-        if ((*itO)->GetLabel().compare((*itR)->GetLabel()) == 0)
-        {
-          Analog::Pointer clone = (*itR)->Clone();
-          signals.push_back(std::make_pair(clone, *itO));
-          analogs->InsertItem(clone);
-          found = true;
-          break;
-        }
+        Analog::Pointer clone = (*it)->Clone();
+        clone->GetValues().array() -= this->m_Offsets[inc];
+        analogs->InsertItem(clone);
       }
-      if (!found)
-        analogs->InsertItem(*itR);
-    }
-    
-    for (std::list< std::pair<Analog::Pointer, Analog::Pointer> >::iterator it = signals.begin() ; it != signals.end() ; ++it)
-    {
-      double dc = it->second->GetValues().sum() / it->second->GetValues().rows();
-      it->first->GetValues().array() -= dc;
+      else
+        analogs->InsertItem(*it);
+      ++inc;
     }
     
     Acquisition::Pointer output = this->GetOutput();
@@ -171,4 +336,148 @@ namespace btk
     // To set internal variables
     output->Resize(rawInput->GetPointNumber(), rawInput->GetPointFrameNumber(), rawInput->GetAnalogNumber(), rawInput->GetNumberAnalogSamplePerFrame());
   };
+  
+  /**
+   * Sets the offsets of the raw channels with the mean of the channels with the same label in the offset input.
+   */
+  void AnalogOffsetRemover::ComputeReferenceOffsets(Acquisition::Pointer rawInput, Acquisition::Pointer offsetInput, std::vector<bool>& processed)
+  {
+    AnalogCollection::Pointer offsets = offsetInput->GetAnalogs();
+    int inc = 0;
+    for (AnalogCollection::ConstIterator itR = rawInput->BeginAnalog() ; itR != rawInput->EndAnalog() ; ++itR)
+    {
+      for (AnalogCollection::ConstIterator itO = offsets->Begin() ; itO != offsets->End() ; ++itO)
+      {
+        if ((*itO)->GetLabel().compare((*itR)->GetLabel()) == 0)
+        {
+          this->m_Offsets[inc] = (*itO)->GetValues().sum() / (*itO)->GetValues().rows();
+          processed[inc] = true;
+          break;
+        }
+      }
+      ++inc;
+    }
+  };
+  
+  /**
+   * Sets the offsets of the selected raw channels with the statistic computed over their quietest window.
+   * In incremental mode, the states of the previous update are reused when it is possible.
+   */
+  void AnalogOffsetRemover::ComputeQuietestWindowOffsets(Acquisition::Pointer rawInput, std::vector<bool>& processed)
+  {
+    // Selected channels
+    std::vector<Analog::Pointer> channels;
+    int inc = 0;
+    for (AnalogCollection::ConstIterator it = rawInput->BeginAnalog() ; it != rawInput->EndAnalog() ; ++it)
+    {
+      if (this->m_ChannelLabels.empty() 
+          || (std::find(this->m_ChannelLabels.begin(), this->m_ChannelLabels.end(), (*it)->GetLabel()) != this->m_ChannelLabels.end()))
+      {
+        channels.push_back(*it);
+        processed[inc] = true;
+      }
+      ++inc;
+    }
+    for (std::vector<std::string>::const_iterator it = this->m_ChannelLabels.begin() ; it != this->m_ChannelLabels.end() ; ++it)
+    {
+      if (rawInput->FindAnalog(*it) == rawInput->EndAnalog())
+        btkWarningMacro("No analog channel with the label '" + *it + "'. Channel skipped.");
+    }
+    
+    // Previous states are kept only if they were computed on the same channels (a new trial gives new channels).
+    // The states keep a reference on their channel, so its address cannot be reused by another channel.
+    const int numSamples = rawInput->GetAnalogFrameNumber();
+    bool resetStates = !this->m_IncrementalMode || (this->m_States.size() != channels.size());
+    for (size_t i = 0 ; !resetStates && (i < channels.size()) ; ++i)
+      resetStates = (this->m_States[i].Channel != channels[i]) || (this->m_States[i].ProcessedSamples > numSamples);
+    if (resetStates)
+    {
+      this->m_States.resize(channels.size());
+      for (size_t i = 0 ; i < channels.size() ; ++i)
+      {
+        this->m_States[i].Channel = channels[i];
+        this->m_States[i].ProcessedSamples = 0;
+        this->m_States[i].Window.clear();
+        this->m_States[i].Window.reserve(this->m_WindowLength);
+        this->m_States[i].BestActivity = 0.0;
+        this->m_States[i].Offset = 0.0;
+        this->m_States[i].Found = false;
+      }
+    }
+    
+    // Scan of the samples not yet processed.
+    std::vector<double> buffer;
+    buffer.reserve(this->m_WindowLength);
+    const double scale = 1.0 / static_cast<double>(this->m_WindowLength);
+    size_t idx = 0;
+    inc = 0;
+    for (std::vector<bool>::const_iterator it = processed.begin() ; it != processed.end() ; ++it)
+    {
+      if (*it)
+      {
+        WindowState& state = this->m_States[idx];
+        const double* values = channels[idx]->GetValues().data();
+        for (int i = state.ProcessedSamples ; i < numSamples ; ++i)
+        {
+          state.Window.push_back(values[i]);
+          if (static_cast<int>(state.Window.size()) == this->m_WindowLength)
+          {
+            double mean = 0.0;
+            for (int j = 0 ; j < this->m_WindowLength ; ++j)
+              mean += state.Window[j];
+            mean *= scale;
+            double activity = 0.0;
+            for (int j = 0 ; j < this->m_WindowLength ; ++j)
+              activity += (state.Window[j] - mean) * (state.Window[j] - mean);
+            activity *= scale;
+            // The first quietest window is kept.
+            if (!state.Found || (activity < state.BestActivity))
+            {
+              buffer.assign(state.Window.begin(), state.Window.end());
+              state.Offset = this->ComputeStatistic(buffer);
+              state.BestActivity = activity;
+              state.Found = true;
+            }
+            state.Window.clear();
+          }
+        }
+        state.ProcessedSamples = numSamples;
+        // Signal shorter than one window: the available samples are used.
+        if (state.Found)
+          this->m_Offsets[inc] = state.Offset;
+        else if (!state.Window.empty())
+        {
+          buffer.assign(state.Window.begin(), state.Window.end());
+          this->m_Offsets[inc] = this->ComputeStatistic(buffer);
+        }
+        ++idx;
+      }
+      ++inc;
+    }
+  };
+  
+  /**
+   * Computes the selected statistic of the given values. The order of the values is modified.
+   */
+  double AnalogOffsetRemover::ComputeStatistic(std::vector<double>& values) const
+  {
+    const size_t num = values.size();
+    if (this->m_Statistic == Median)
+    {
+      std::vector<double>::iterator mid = values.begin() + num / 2;
+      std::nth_element(values.begin(), mid, values.end());
+      double median = *mid;
+      if ((num % 2) == 0)
+        median = (median + *std::max_element(values.begin(), mid)) / 2.0;
+      return median;
+    }
+    size_t trim = static_cast<size_t>(this->m_TrimmingProportion * static_cast<double>(num));
+    if (2 * trim >= num)
+      trim = (num - 1) / 2;
+    std::sort(values.begin(), values.end());
+    double sum = 0.0;
+    for (size_t i = trim ; i < num - trim ; ++i)
+      sum += values[i];
+    return sum / static_cast<double>(num - 2 * trim);
+  };
 };
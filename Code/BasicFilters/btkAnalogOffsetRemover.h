@@ -39,6 +39,9 @@
 #include "btkProcessObject.h"
 #include "btkAcquisition.h"
 
+#include <vector>
+#include <string>
+
 namespace btk
 {
   class AnalogOffsetRemover : public ProcessObject
@@ -47,6 +50,9 @@ namespace btk
     typedef btkSharedPtr<AnalogOffsetRemover> Pointer;
     typedef btkSharedPtr<const AnalogOffsetRemover> ConstPointer;
     
+    typedef enum {OffsetInput = 0, QuietestWindow} Estimation;
+    typedef enum {Median = 0, TrimmedMean} Statistic;
+    
     static Pointer New() {return Pointer(new AnalogOffsetRemover());};
     
     // ~AnalogOffsetRemover(); // Implicit
@@ -57,6 +63,20 @@ namespace btk
     Acquisition::Pointer GetOffsetInput() {return this->GetInput(1);};
         
     Acquisition::Pointer GetOutput() {return this->GetOutput(0);};
+    
+    Estimation GetEstimation() const {return this->m_Estimation;};
+    BTK_BASICFILTERS_EXPORT void SetEstimation(Estimation estimation);
+    Statistic GetStatistic() const {return this->m_Statistic;};
+    BTK_BASICFILTERS_EXPORT void SetStatistic(Statistic statistic);
+    int GetWindowLength() const {return this->m_WindowLength;};
+    BTK_BASICFILTERS_EXPORT void SetWindowLength(int length);
+    double GetTrimmingProportion() const {return this->m_TrimmingProportion;};
+    BTK_BASICFILTERS_EXPORT void SetTrimmingProportion(double proportion);
+    const std::vector<std::string>& GetChannelLabels() const {return this->m_ChannelLabels;};
+    BTK_BASICFILTERS_EXPORT void SetChannelLabels(const std::vector<std::string>& labels);
+    bool GetIncrementalMode() const {return this->m_IncrementalMode;};
+    BTK_BASICFILTERS_EXPORT void SetIncrementalMode(bool enabled);
+    const std::vector<double>& GetOffsets() const {return this->m_Offsets;};
 
   protected:
     BTK_BASICFILTERS_EXPORT AnalogOffsetRemover();
@@ -69,6 +89,29 @@ namespace btk
   private:
     AnalogOffsetRemover(const AnalogOffsetRemover& ); // Not implemented.
     AnalogOffsetRemover& operator=(const AnalogOffsetRemover& ); // Not implemented.
+    
+    struct WindowState
+    {
+      Analog::Pointer Channel;
+      int ProcessedSamples;
+      std::vector<double> Window;
+      double BestActivity;
+      double Offset;
+      bool Found;
+    };
+    
+    void ComputeReferenceOffsets(Acquisition::Pointer rawInput, Acquisition::Pointer offsetInput, std::vector<bool>& processed);
+    void ComputeQuietestWindowOffsets(Acquisition::Pointer rawInput, std::vector<bool>& processed);
+    double ComputeStatistic(std::vector<double>& values) const;
+    
+    Estimation m_Estimation;
+    Statistic m_Statistic;
+    int m_WindowLength;
+    double m_TrimmingProportion;
+    std::vector<std::string> m_ChannelLabels;
+    bool m_IncrementalMode;
+    std::vector<WindowState> m_States;
+    std::vector<double> m_Offsets;
   };
 };
 
@@ -0,0 +1,283 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "btkCombinedGroundReactionWrenchFilter.h"
+
+#include <algorithm>
+#include <limits>
+#include <cmath>
+
+namespace btk
+{
+  /**
+   * @class CombinedGroundReactionWrenchFilter btkCombinedGroundReactionWrenchFilter.h
+   * @brief Combine the ground reaction wrenches of several force platforms into a single resultant wrench.
+   *
+   * The input is the collection of wrenches computed by the filter GroundReactionWrenchFilter and must be
+   * expressed in the global frame (default behaviour of this filter). For each frame, the output contains:
+   *  - the resultant force (sum of the forces of all the force platforms) ;
+   *  - the point of wrench application (PWA) of the resultant wrench, computed as in the class GroundReactionWrenchFilter ;
+   *  - the moment at the PWA (i.e. the free moment of the resultant wrench).
+   *
+   * Each input moment is expressed at the position of its wrench. These moments are then transported to
+   * the same point before to be summed. As in the rest of the toolkit, the vertical axis of the global frame is 
+   * assumed to be the Z axis and the combined PWA is computed in the horizontal plane passing by the average
+   * height of the input positions (i.e. the surface of the force platforms). The positions of false PWA (negative residual) 
+   * are not used for this average, except when no position is valid for the frame. If the input cannot be combined, the
+   * output is cleared (no frame).
+   *
+   * The methods SetThresholdValue() and SetThresholdState() have the same role than in the class
+   * GroundReactionWrenchFilter, but are applied on the resultant vertical force. When the PWA cannot be 
+   * computed, its residual is set to -1 and the moment is expressed at the point of the plane located at the 
+   * vertical of the global origin.
+   *
+   * @code
+   * btk::GroundReactionWrenchFilter::Pointer grwf = btk::GroundReactionWrenchFilter::New();
+   * grwf->SetInput(pfe->GetOutput());
+   * btk::CombinedGroundReactionWrenchFilter::Pointer cgrwf = btk::CombinedGroundReactionWrenchFilter::New();
+   * cgrwf->SetInput(grwf->GetOutput());
+   * cgrwf->SetThresholdValue(10.0); // 10 newtons
+   * cgrwf->SetThresholdState(true);
+   * cgrwf->Update();
+   * btk::Wrench::Pointer resultant = cgrwf->GetOutput();
+   * @endcode
+   *
+   * @ingroup BTKBasicFilters
+   */
+  
+  /**
+   * @typedef CombinedGroundReactionWrenchFilter::Pointer
+   * Smart pointer associated with a CombinedGroundReactionWrenchFilter object.
+   */
+  
+  /**
+   * @typedef CombinedGroundReactionWrenchFilter::ConstPointer
+   * Smart pointer associated with a const CombinedGroundReactionWrenchFilter object.
+   */
+    
+  /**
+   * @fn static Pointer CombinedGroundReactionWrenchFilter::New();
+   * Creates a smart pointer associated with a CombinedGroundReactionWrenchFilter object.
+   */
+  
+  /**
+   * @fn bool CombinedGroundReactionWrenchFilter::GetThresholdState() const
+   * Returns the state of the threshold used to suppress false PWA.
+   */
+
+  /**
+   * Sets the threshold state.
+   */
+  void CombinedGroundReactionWrenchFilter::SetThresholdState(bool activated)
+  {
+    if (this->m_ThresholdActivated == activated)
+      return;
+    this->m_ThresholdActivated = activated;
+    this->Modified();
+  };
+  
+  /**
+   * @fn double CombinedGroundReactionWrenchFilter::GetThresholdValue() const
+   * Returns the value used to suppress PWA computed with a resultant Fz value lower or equal than it.
+   * 
+   * The threshold must be activated (see CombinedGroundReactionWrenchFilter::SetThresholdState) to be used during the computation of the PWA.
+   */
+  
+  /**
+   * Sets the threshold value.
+   *
+   * The threshold must be activated (see CombinedGroundReactionWrenchFilter::SetThresholdState) to be used during the computation of the PWA.
+   */
+  void CombinedGroundReactionWrenchFilter::SetThresholdValue(double v)
+  {
+    if (fabs(this->m_ThresholdValue - v) <= std::numeric_limits<double>::epsilon())
+      return;
+    if (v < 0.0)
+      btkWarningMacro("Negative threshold has no effect on the algorithm because it compares the threshold value with the absolute value of Fz.");
+    this->m_ThresholdValue = v;
+    this->Modified();
+  };
+
+  /**
+   * @fn WrenchCollection::Pointer CombinedGroundReactionWrenchFilter::GetInput()
+   * Gets the input registered with this process.
+   */
+  
+  /**
+   * @fn void CombinedGroundReactionWrenchFilter::SetInput(WrenchCollection::Pointer input)
+   * Sets the input required with this process.
+   */
+  
+  /**
+   * @fn Wrench::Pointer CombinedGroundReactionWrenchFilter::GetOutput()
+   * Gets the output created with this process.
+   */
+  
+  /**
+   * Constructor. Sets the number of inputs and outputs to 1.
+   */
+  CombinedGroundReactionWrenchFilter::CombinedGroundReactionWrenchFilter()
+  : ProcessObject()
+  {
+    this->SetInputNumber(1);
+    this->SetOutputNumber(1);
+    this->m_ThresholdActivated = false;
+    this->m_ThresholdValue = 0.0;
+  };
+
+  /**
+   * @fn WrenchCollection::Pointer CombinedGroundReactionWrenchFilter::GetInput(int idx)
+   * Returns the input at the index @a idx.
+   */
+  
+  /**
+   * @fn Wrench::Pointer CombinedGroundReactionWrenchFilter::GetOutput(int idx)
+   * Returns the output at the index @a idx.
+   */
+  
+  /**
+   * Creates a Wrench:Pointer object and return it as a DataObject::Pointer.
+   */
+  DataObject::Pointer CombinedGroundReactionWrenchFilter::MakeOutput(int /* idx */)
+  {
+    return Wrench::New("GRW");
+  };
+  
+  // Wrench::SetFrameNumber() refuses 0 frames, so each component is cleared.
+  static void _btk_clear_wrench(Wrench::Pointer wrench)
+  {
+    wrench->GetPosition()->SetFrameNumber(0);
+    wrench->GetForce()->SetFrameNumber(0);
+    wrench->GetMoment()->SetFrameNumber(0);
+  };
+  
+  /**
+   * Generates the outputs' data.
+   */
+  void CombinedGroundReactionWrenchFilter::GenerateData()
+  {
+    Wrench::Pointer output = this->GetOutput();
+    WrenchCollection::Pointer input = this->GetInput();
+    // The result of a previous update must not be kept if the input cannot be combined.
+    if (!input || input->IsEmpty())
+    {
+      btkWarningMacro("No wrench to combine.");
+      _btk_clear_wrench(output);
+      return;
+    }
+    const int frameNumber = input->GetItem(0)->GetForce()->GetFrameNumber();
+    for (WrenchCollection::ConstIterator it = input->Begin() ; it != input->End() ; ++it)
+    {
+      if ((*it)->GetForce()->GetFrameNumber() != frameNumber)
+      {
+        btkErrorMacro("The wrenches to combine must have the same number of frames.");
+        _btk_clear_wrench(output);
+        return;
+      }
+    }
+    if (frameNumber == 0)
+    {
+      _btk_clear_wrench(output);
+      return;
+    }
+    output->SetFrameNumber(frameNumber);
+    double* F = output->GetForce()->GetValues().data();
+    double* M = output->GetMoment()->GetValues().data();
+    double* P = output->GetPosition()->GetValues().data();
+    double* res = output->GetPosition()->GetResiduals().data();
+    double* fx = F; double* fy = F + frameNumber; double* fz = F + 2 * frameNumber;
+    double* mx = M; double* my = M + frameNumber; double* mz = M + 2 * frameNumber;
+    double* px = P; double* py = P + frameNumber; double* pz = P + 2 * frameNumber;
+    std::fill(F, F + 3 * frameNumber, 0.0);
+    std::fill(M, M + 3 * frameNumber, 0.0);
+    std::fill(P, P + 3 * frameNumber, 0.0);
+    std::fill(res, res + frameNumber, 0.0);
+    // Sum of the forces and of the moments expressed at the global origin: M_o = sum(M_i + P_i x F_i).
+    // The height of the plane is the mean height of the valid positions (a false PWA has a negative residual).
+    // Until the PWA is computed, pz and res keep the sum of the valid heights and their number, while py keeps the
+    // sum of all the heights (used when no position is valid).
+    // The loops are done along the frames as the values are stored column by column.
+    for (WrenchCollection::ConstIterator it = input->Begin() ; it != input->End() ; ++it)
+    {
+      const double* f = (*it)->GetForce()->GetValues().data();
+      const double* m = (*it)->GetMoment()->GetValues().data();
+      const double* p = (*it)->GetPosition()->GetValues().data();
+      const double* r = (*it)->GetPosition()->GetResiduals().data();
+      const double* fxi = f; const double* fyi = f + frameNumber; const double* fzi = f + 2 * frameNumber;
+      const double* mxi = m; const double* myi = m + frameNumber; const double* mzi = m + 2 * frameNumber;
+      const double* pxi = p; const double* pyi = p + frameNumber; const double* pzi = p + 2 * frameNumber;
+      for (int i = 0 ; i < frameNumber ; ++i)
+      {
+        fx[i] += fxi[i];
+        fy[i] += fyi[i];
+        fz[i] += fzi[i];
+        mx[i] += mxi[i] + (pyi[i] * fzi[i] - pzi[i] * fyi[i]);
+        my[i] += myi[i] + (pzi[i] * fxi[i] - pxi[i] * fzi[i]);
+        mz[i] += mzi[i] + (pxi[i] * fyi[i] - pyi[i] * fxi[i]);
+        const double w = (r[i] >= 0.0) ? 1.0 : 0.0;
+        pz[i] += w * pzi[i];
+        res[i] += w;
+        py[i] += pzi[i];
+      }
+    }
+    // PWA (see GroundReactionWrenchFilter)
+    const double threshold = this->m_ThresholdActivated ? this->m_ThresholdValue : -1.0;
+    const double scale = 1.0 / static_cast<double>(input->GetItemNumber());
+    for (int i = 0 ; i < frameNumber ; ++i)
+    {
+      const double Fx = fx[i], Fy = fy[i], Fz = fz[i];
+      // Height of the plane
+      const double h = (res[i] > 0.0) ? pz[i] / res[i] : py[i] * scale;
+      // Square norm of the forces.
+      const double sNF = Fx * Fx + Fy * Fy + Fz * Fz;
+      // M_s = M_o + F x OS with S = (0, 0, h)
+      const double Mx = mx[i] + Fy * h;
+      const double My = my[i] - Fx * h;
+      const double Mz = mz[i];
+      const double x = (Fy * Mz - Fz * My) / sNF - (Fx * Fx * My - Fx * (Fy * Mx)) / (sNF * Fz);
+      const double y = (Fz * Mx - Fx * Mz) / sNF - (Fx * (Fy * My) - Fy * Fy * Mx) / (sNF * Fz);
+      // Suppress false PWA
+      const bool valid = (sNF != 0.0) & !(std::fabs(Fz) <= threshold);
+      const double Px = valid ? x : 0.0;
+      const double Py = valid ? y : 0.0;
+      res[i] = valid ? 0.0 : -1.0;
+      // M_pwa = M_s + F_s x PWA
+      mx[i] = Mx + (0.0 - Py * Fz);
+      my[i] = My + (Fz * Px - 0.0);
+      mz[i] = Mz + (Fx * Py - Px * Fy);
+      px[i] = Px; py[i] = Py; pz[i] = h;
+    }
+  };
+};
@@ -0,0 +1,542 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "btkEMGEnvelopeFilter.h"
+#include "btkConvert.h"
+
+#include <btkEigen/SignalProcessing/FiltFilt.h>
+#include <btkEigen/SignalProcessing/IIRFilterDesign.h>
+#include <btkEigen/SignalProcessing/MovingStatistics.h>
+
+#include <vector>
+
+namespace btk
+{
+  /**
+   * @class EMGEnvelopeFilter btkEMGEnvelopeFilter.h
+   * @brief Compute the linear envelope of EMG signals.
+   *
+   * The envelope of each selected analog channel is computed with the following steps:
+   *  - Band-pass filtering of the raw signal (see SetBandPassFrequencies() and SetBandPassFilterOrder()). 
+   *    This step can be disabled with the method SetBandPassFilterEnabled() ;
+   *  - Full-wave rectification ;
+   *  - Smoothing of the rectified signal (see SetEnvelopeMethod()) with a low-pass filter (see SetLowPassFrequency()
+   *    and SetLowPassFilterOrder()) or with a moving root mean square (see SetMovingRMSWindow()) ;
+   *  - Amplitude normalisation (see SetNormalization()) by the peak of each envelope or by a reference 
+   *    value (e.g. maximum voluntary contraction) given for each channel (see SetReferenceValue()).
+   *
+   * All the filters are Butterworth filters applied forward and backward (zero lag). Then the order of the
+   * filtering is twice the order set. The cutoff frequency of the low-pass filter is adjusted to compensate
+   * the double pass (see the function btkEigen::adjustZeroLagButterworth()).
+   *
+   * The processed channels are selected by their label (see SetLabels()). If no label is given, the channels 
+   * are selected by their gain (see SetGain()), which corresponds to the parameter ANALOG:GAIN in a C3D file.
+   * If no label and no gain are given, all the analog channels are processed.
+   *
+   * The selected channels are processed together. Their samples are gathered in a single matrix to apply each 
+   * step on all the channels at once (see btkEigen::filtfilt_multichannel()), which is faster than processing 
+   * each channel separately.
+   *
+   * The output is a new collection containing only the envelope of the selected channels. The label, description, unit and
+   * gain of each channel are kept.
+   *
+   * @ingroup BTKBasicFilters
+   */
+  
+  /**
+   * @typedef EMGEnvelopeFilter::Pointer
+   * Smart pointer associated with a EMGEnvelopeFilter object.
+   */
+  
+  /**
+   * @typedef EMGEnvelopeFilter::ConstPointer
+   * Smart pointer associated with a const EMGEnvelopeFilter object.
+   */
+  
+  /**
+   * @enum EMGEnvelopeFilter::EnvelopeMethod
+   * Method used to smooth the rectified signals.
+   */
+  /**
+   * @var EMGEnvelopeFilter::EnvelopeMethod EMGEnvelopeFilter::LowPass
+   * Zero lag low-pass Butterworth filter.
+   */
+  /**
+   * @var EMGEnvelopeFilter::EnvelopeMethod EMGEnvelopeFilter::MovingRMS
+   * Moving root mean square with a centered window.
+   */
+  
+  /**
+   * @enum EMGEnvelopeFilter::Normalization
+   * Amplitude normalisation applied on the envelopes.
+   */
+  /**
+   * @var EMGEnvelopeFilter::Normalization EMGEnvelopeFilter::NoNormalization
+   * The amplitude of the envelopes is not modified.
+   */
+  /**
+   * @var EMGEnvelopeFilter::Normalization EMGEnvelopeFilter::PeakNormalization
+   * Each envelope is divided by its maximum value.
+   */
+  /**
+   * @var EMGEnvelopeFilter::Normalization EMGEnvelopeFilter::ReferenceNormalization
+   * Each envelope is divided by the reference value associated with its label (see SetReferenceValue()).
+   */
+  
+  /**
+   * @fn static Pointer EMGEnvelopeFilter::New();
+   * Creates a smart pointer associated with a EMGEnvelopeFilter object.
+   */
+  
+  /**
+   * @fn Acquisition::Pointer EMGEnvelopeFilter::GetInput()
+   * Gets the input registered with this process.
+   */
+  
+  /**
+   * @fn void EMGEnvelopeFilter::SetInput(Acquisition::Pointer input)
+   * Sets the input required with this process.
+   */
+  
+  /**
+   * @fn AnalogCollection::Pointer EMGEnvelopeFilter::GetOutput()
+   * Gets the output created with this process.
+   */
+  
+  /**
+   * @fn const std::list<std::string>& EMGEnvelopeFilter::GetLabels() const
+   * Returns the labels of the channels to process.
+   */
+  
+  /**
+   * Sets the labels of the channels to process. 
+   */
+  void EMGEnvelopeFilter::SetLabels(const std::list<std::string>& labels)
+  {
+    if (this->m_Labels == labels)
+      return;
+    this->m_Labels = labels;
+    this->Modified();
+  };
+  
+  /**
+   * @fn Analog::Gain EMGEnvelopeFilter::GetGain() const
+   * Returns the gain used to select the channels to process.
+   */
+  
+  /**
+   * Sets the gain used to select the channels to process. This gain is used only if no label is given.
+   * Set it to Analog::Unknown to not select the channels by their gain (default).
+   */
+  void EMGEnvelopeFilter::SetGain(Analog::Gain g)
+  {
+    if (this->m_Gain == g)
+      return;
+    this->m_Gain = g;
+    this->Modified();
+  };
+  
+  /**
+   * @fn bool EMGEnvelopeFilter::GetBandPassFilterEnabled() const
+   * Returns true if the raw signals are band-pass filtered before the rectification.
+   */
+  
+  /**
+   * Enables or disables the band-pass filtering of the raw signals (enabled by default).
+   */
+  void EMGEnvelopeFilter::SetBandPassFilterEnabled(bool enabled)
+  {
+    if (this->m_BandPassFilterEnabled == enabled)
+      return;
+    this->m_BandPassFilterEnabled = enabled;
+    this->Modified();
+  };
+  
+  /**
+   * @fn double EMGEnvelopeFilter::GetBandPassLowFrequency() const
+   * Returns the low cutoff frequency (Hz) of the band-pass filter.
+   */
+  
+  /**
+   * @fn double EMGEnvelopeFilter::GetBandPassHighFrequency() const
+   * Returns the high cutoff frequency (Hz) of the band-pass filter.
+   */
+  
+  /**
+   * Sets the cutoff frequencies (Hz) of the band-pass filter (20 Hz and 450 Hz by default).
+   */
+  void EMGEnvelopeFilter::SetBandPassFrequencies(double low, double high)
+  {
+    if ((this->m_BandPassFrequencies[0] == low) && (this->m_BandPassFrequencies[1] == high))
+      return;
+    if ((low <= 0.0) || (high <= low))
+    {
+      btkErrorMacro("The cutoff frequencies of the band-pass filter must be positive and sorted in ascending order.");
+      return;
+    }
+    this->m_BandPassFrequencies[0] = low;
+    this->m_BandPassFrequencies[1] = high;
+    this->Modified();
+  };
+  
+  /**
+   * @fn int EMGEnvelopeFilter::GetBandPassFilterOrder() const
+   * Returns the order of the band-pass filter.
+   */
+  
+  /**
+   * Sets the order of the band-pass filter (2 by default).
+   */
+  void EMGEnvelopeFilter::SetBandPassFilterOrder(int order)
+  {
+    if (this->m_BandPassFilterOrder == order)
+      return;
+    if (order < 1)
+    {
+      btkErrorMacro("The order of the filter must be greater than 0.");
+      return;
+    }
+    this->m_BandPassFilterOrder = order;
+    this->Modified();
+  };
+  
+  /**
+   * @fn EnvelopeMethod EMGEnvelopeFilter::GetEnvelopeMethod() const
+   * Returns the method used to smooth the rectified signals.
+   */
+  
+  /**
+   * Sets the method used to smooth the rectified signals (low-pass filter by default).
+   */
+  void EMGEnvelopeFilter::SetEnvelopeMethod(EnvelopeMethod method)
+  {
+    if (this->m_EnvelopeMethod == method)
+      return;
+    this->m_EnvelopeMethod = method;
+    this->Modified();
+  };
+  
+  /**
+   * @fn double EMGEnvelopeFilter::GetLowPassFrequency() const
+   * Returns the cutoff frequency (Hz) of the low-pass filter.
+   */
+  
+  /**
+   * Sets the cutoff frequency (Hz) of the low-pass filter (6 Hz by default).
+   */
+  void EMGEnvelopeFilter::SetLowPassFrequency(double freq)
+  {
+    if (this->m_LowPassFrequency == freq)
+      return;
+    if (freq <= 0.0)
+    {
+      btkErrorMacro("The cutoff frequency of the low-pass filter must be positive.");
+      return;
+    }
+    this->m_LowPassFrequency = freq;
+    this->Modified();
+  };
+  
+  /**
+   * @fn int EMGEnvelopeFilter::GetLowPassFilterOrder() const
+   * Returns the order of the low-pass filter.
+   */
+  
+  /**
+   * Sets the order of the low-pass filter (2 by default).
+   */
+  void EMGEnvelopeFilter::SetLowPassFilterOrder(int order)
+  {
+    if (this->m_LowPassFilterOrder == order)
+      return;
+    if (order < 1)
+    {
+      btkErrorMacro("The order of the filter must be greater than 0.");
+      return;
+    }
+    this->m_LowPassFilterOrder = order;
+    this->Modified();
+  };
+  
+  /**
+   * @fn double EMGEnvelopeFilter::GetMovingRMSWindow() const
+   * Returns the duration (s) of the window used by the moving root mean square.
+   */
+  
+  /**
+   * Sets the duration (s) of the window used by the moving root mean square (0.1 s by default).
+   */
+  void EMGEnvelopeFilter::SetMovingRMSWindow(double duration)
+  {
+    if (this->m_MovingRMSWindow == duration)
+      return;
+    if (duration <= 0.0)
+    {
+      btkErrorMacro("The duration of the window must be positive.");
+      return;
+    }
+    this->m_MovingRMSWindow = duration;
+    this->Modified();
+  };
+  
+  /**
+   * @fn Normalization EMGEnvelopeFilter::GetNormalization() const
+   * Returns the normalisation applied on the envelopes.
+   */
+  
+  /**
+   * Sets the normalisation applied on the envelopes (no normalisation by default).
+   */
+  void EMGEnvelopeFilter::SetNormalization(Normalization n)
+  {
+    if (this->m_Normalization == n)
+      return;
+    this->m_Normalization = n;
+    this->Modified();
+  };
+  
+  /**
+   * Returns the reference value associated with the channel @a label or 0 if there is no reference value for this channel.
+   */
+  double EMGEnvelopeFilter::GetReferenceValue(const std::string& label) const
+  {
+    std::map<std::string, double>::const_iterator it = this->m_ReferenceValues.find(label);
+    if (it == this->m_ReferenceValues.end())
+      return 0.0;
+    return it->second;
+  };
+  
+  /**
+   * Sets the reference value used to normalise the envelope of the channel @a label.
+   * This value is used only with the normalisation ReferenceNormalization.
+   */
+  void EMGEnvelopeFilter::SetReferenceValue(const std::string& label, double value)
+  {
+    std::map<std::string, double>::iterator it = this->m_ReferenceValues.find(label);
+    if ((it != this->m_ReferenceValues.end()) && (it->second == value))
+      return;
+    if (value <= 0.0)
+    {
+      btkErrorMacro("The reference value must be positive.");
+      return;
+    }
+    this->m_ReferenceValues[label] = value;
+    this->Modified();
+  };
+  
+  /**
+   * Removes all the reference values.
+   */
+  void EMGEnvelopeFilter::ClearReferenceValues()
+  {
+    if (this->m_ReferenceValues.empty())
+      return;
+    this->m_ReferenceValues.clear();
+    this->Modified();
+  };
+  
+  /**
+   * Constructor. 
+   * Sets the number of inputs and outputs to 1.
+   */
+  EMGEnvelopeFilter::EMGEnvelopeFilter()
+  : ProcessObject(), m_Labels(), m_ReferenceValues()
+  {
+    this->m_Gain = Analog::Unknown;
+    this->m_BandPassFilterEnabled = true;
+    this->m_BandPassFrequencies[0] = 20.0;
+    this->m_BandPassFrequencies[1] = 450.0;
+    this->m_BandPassFilterOrder = 2;
+    this->m_EnvelopeMethod = LowPass;
+    this->m_LowPassFrequency = 6.0;
+    this->m_LowPassFilterOrder = 2;
+    this->m_MovingRMSWindow = 0.1;
+    this->m_Normalization = NoNormalization;
+    this->SetInputNumber(1);
+    this->SetOutputNumber(1);
+  };
+  
+  /**
+   * @fn Acquisition::Pointer EMGEnvelopeFilter::GetInput(int idx)
+   * Returns the input at the index @a idx.
+   */
+  
+  /**
+   * @fn AnalogCollection::Pointer EMGEnvelopeFilter::GetOutput(int idx)
+   * Returns the output at the index @a idx.
+   */
+  
+  /**
+   * Creates an AnalogCollection::Pointer object and return it as a DataObject::Pointer.
+   */
+  DataObject::Pointer EMGEnvelopeFilter::MakeOutput(int /* idx */)
+  {
+    return AnalogCollection::New();
+  };
+  
+  /**
+   * Generates the outputs' data.
+   */
+  void EMGEnvelopeFilter::GenerateData()
+  {
+    AnalogCollection::Pointer output = this->GetOutput();
+    output->Clear();
+    Acquisition::Pointer input = this->GetInput();
+    if (!input)
+      return;
+    
+    // Selection of the channels
+    std::vector<Analog::Pointer> channels;
+    if (!this->m_Labels.empty())
+    {
+      for (std::list<std::string>::const_iterator it = this->m_Labels.begin() ; it != this->m_Labels.end() ; ++it)
+      {
+        Acquisition::AnalogIterator itA = input->FindAnalog(*it);
+        if (itA == input->EndAnalog())
+        {
+          btkWarningMacro("No analog channel with the label '" + *it + "'. It is not processed.");
+        }
+        else
+          channels.push_back(*itA);
+      }
+    }
+    else
+    {
+      for (Acquisition::AnalogIterator it = input->BeginAnalog() ; it != input->EndAnalog() ; ++it)
+      {
+        if ((this->m_Gain == Analog::Unknown) || ((*it)->GetGain() == this->m_Gain))
+          channels.push_back(*it);
+      }
+    }
+    if (channels.empty())
+      return;
+    
+    const double fs = input->GetAnalogFrequency();
+    if (fs <= 0.0)
+    {
+      btkErrorMacro("The analog sample frequency must be set to compute the envelope of the EMG signals.");
+      return;
+    }
+    const int frameNumber = input->GetAnalogFrameNumber();
+    const int channelNumber = static_cast<int>(channels.size());
+    
+    // The channels are stored in the rows and the samples in the columns. Then, the samples of all
+    // the channels for one frame are contiguous and each step is vectorized over the channels.
+    Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic> X(channelNumber, frameNumber);
+    for (int i = 0 ; i < channelNumber ; ++i)
+      X.row(i) = channels[i]->GetValues().transpose();
+    
+    Eigen::Matrix<double, Eigen::Dynamic, 1> b, a;
+    // Band-pass filter
+    if (this->m_BandPassFilterEnabled)
+    {
+      const double nyquist = fs / 2.0;
+      if (this->m_BandPassFrequencies[1] >= nyquist)
+      {
+        btkErrorMacro("The high cutoff frequency of the band-pass filter must be lower than the Nyquist frequency (" + ToString(nyquist) + " Hz).");
+        return;
+      }
+      double wn[2] = {this->m_BandPassFrequencies[0] / nyquist, this->m_BandPassFrequencies[1] / nyquist};
+      btkEigen::butter(&b, &a, this->m_BandPassFilterOrder, wn, btkEigen::BandPass);
+      if (frameNumber <= 3 * (std::max(b.rows(), a.rows()) - 1))
+      {
+        btkErrorMacro("Not enough frames to filter the EMG signals.");
+        return;
+      }
+      btkEigen::filtfilt_multichannel(b, a, &X);
+    }
+    // Full-wave rectification & envelope
+    if (this->m_EnvelopeMethod == LowPass)
+    {
+      X = X.cwiseAbs();
+      int n = 2 * this->m_LowPassFilterOrder;
+      double wn = this->m_LowPassFrequency / (fs / 2.0);
+      btkEigen::adjustZeroLagButterworth(n, wn);
+      if (wn >= 1.0)
+      {
+        btkErrorMacro("The cutoff frequency of the low-pass filter is too high compared to the analog sample frequency.");
+        return;
+      }
+      btkEigen::butter(&b, &a, n, wn, btkEigen::LowPass);
+      if (frameNumber <= 3 * (std::max(b.rows(), a.rows()) - 1))
+      {
+        btkErrorMacro("Not enough frames to filter the EMG signals.");
+        return;
+      }
+      btkEigen::filtfilt_multichannel(b, a, &X);
+    }
+    else // MovingRMS
+    {
+      // The squares of the signals make the rectification useless.
+      const int window = std::max(1, static_cast<int>(this->m_MovingRMSWindow * fs + 0.5));
+      Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic> rms;
+      btkEigen::movrms(&rms, X.transpose(), window);
+      X = rms.transpose();
+    }
+    // Amplitude normalisation
+    if (this->m_Normalization == PeakNormalization)
+    {
+      Eigen::Matrix<double, Eigen::Dynamic, 1> peaks = X.rowwise().maxCoeff();
+      for (int i = 0 ; i < channelNumber ; ++i)
+      {
+        if (peaks.coeff(i) > 0.0)
+          X.row(i) /= peaks.coeff(i);
+      }
+    }
+    else if (this->m_Normalization == ReferenceNormalization)
+    {
+      for (int i = 0 ; i < channelNumber ; ++i)
+      {
+        std::map<std::string, double>::const_iterator it = this->m_ReferenceValues.find(channels[i]->GetLabel());
+        if (it == this->m_ReferenceValues.end())
+        {
+          btkWarningMacro("No reference value for the channel '" + channels[i]->GetLabel() + "'. Its envelope is not normalised.");
+        }
+        else
+          X.row(i) /= it->second;
+      }
+    }
+    
+    for (int i = 0 ; i < channelNumber ; ++i)
+    {
+      Analog::Pointer envelope = Analog::New(channels[i]->GetLabel(), frameNumber);
+      envelope->SetDescription(channels[i]->GetDescription());
+      envelope->SetUnit(channels[i]->GetUnit());
+      envelope->SetGain(channels[i]->GetGain());
+      envelope->GetValues() = X.row(i).transpose();
+      output->InsertItem(envelope);
+    }
+  };
+};
@@ -0,0 +1,119 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __btkEMGEnvelopeFilter_h
+#define __btkEMGEnvelopeFilter_h
+
+#include "btkProcessObject.h"
+#include "btkAcquisition.h"
+
+#include <list>
+#include <map>
+#include <string>
+
+namespace btk
+{
+  class EMGEnvelopeFilter : public ProcessObject
+  {
+  public:
+    typedef enum {LowPass = 0, MovingRMS} EnvelopeMethod;
+    typedef enum {NoNormalization = 0, PeakNormalization, ReferenceNormalization} Normalization;
+    
+    typedef btkSharedPtr<EMGEnvelopeFilter> Pointer;
+    typedef btkSharedPtr<const EMGEnvelopeFilter> ConstPointer;
+    
+    static Pointer New() {return Pointer(new EMGEnvelopeFilter());};
+    
+    // ~EMGEnvelopeFilter(); // Implicit
+    
+    Acquisition::Pointer GetInput() {return this->GetInput(0);};
+    void SetInput(Acquisition::Pointer input) {this->SetNthInput(0, input);};
+    AnalogCollection::Pointer GetOutput() {return this->GetOutput(0);};
+    
+    const std::list<std::string>& GetLabels() const {return this->m_Labels;};
+    BTK_BASICFILTERS_EXPORT void SetLabels(const std::list<std::string>& labels);
+    Analog::Gain GetGain() const {return this->m_Gain;};
+    BTK_BASICFILTERS_EXPORT void SetGain(Analog::Gain g);
+    
+    bool GetBandPassFilterEnabled() const {return this->m_BandPassFilterEnabled;};
+    BTK_BASICFILTERS_EXPORT void SetBandPassFilterEnabled(bool enabled);
+    double GetBandPassLowFrequency() const {return this->m_BandPassFrequencies[0];};
+    double GetBandPassHighFrequency() const {return this->m_BandPassFrequencies[1];};
+    BTK_BASICFILTERS_EXPORT void SetBandPassFrequencies(double low, double high);
+    int GetBandPassFilterOrder() const {return this->m_BandPassFilterOrder;};
+    BTK_BASICFILTERS_EXPORT void SetBandPassFilterOrder(int order);
+    
+    EnvelopeMethod GetEnvelopeMethod() const {return this->m_EnvelopeMethod;};
+    BTK_BASICFILTERS_EXPORT void SetEnvelopeMethod(EnvelopeMethod method);
+    double GetLowPassFrequency() const {return this->m_LowPassFrequency;};
+    BTK_BASICFILTERS_EXPORT void SetLowPassFrequency(double freq);
+    int GetLowPassFilterOrder() const {return this->m_LowPassFilterOrder;};
+    BTK_BASICFILTERS_EXPORT void SetLowPassFilterOrder(int order);
+    double GetMovingRMSWindow() const {return this->m_MovingRMSWindow;};
+    BTK_BASICFILTERS_EXPORT void SetMovingRMSWindow(double duration);
+    
+    Normalization GetNormalization() const {return this->m_Normalization;};
+    BTK_BASICFILTERS_EXPORT void SetNormalization(Normalization n);
+    BTK_BASICFILTERS_EXPORT double GetReferenceValue(const std::string& label) const;
+    BTK_BASICFILTERS_EXPORT void SetReferenceValue(const std::string& label, double value);
+    BTK_BASICFILTERS_EXPORT void ClearReferenceValues();
+    
+  protected:
+    BTK_BASICFILTERS_EXPORT EMGEnvelopeFilter();
+    
+    Acquisition::Pointer GetInput(int idx) {return static_pointer_cast<Acquisition>(this->GetNthInput(idx));};  
+    AnalogCollection::Pointer GetOutput(int idx) {return static_pointer_cast<AnalogCollection>(this->GetNthOutput(idx));};
+    BTK_BASICFILTERS_EXPORT virtual DataObject::Pointer MakeOutput(int idx);
+    BTK_BASICFILTERS_EXPORT virtual void GenerateData();
+    
+  private:
+    EMGEnvelopeFilter(const EMGEnvelopeFilter& ); // Not implemented.
+    EMGEnvelopeFilter& operator=(const EMGEnvelopeFilter& ); // Not implemented.
+    
+    std::list<std::string> m_Labels;
+    Analog::Gain m_Gain;
+    bool m_BandPassFilterEnabled;
+    double m_BandPassFrequencies[2];
+    int m_BandPassFilterOrder;
+    EnvelopeMethod m_EnvelopeMethod;
+    double m_LowPassFrequency;
+    int m_LowPassFilterOrder;
+    double m_MovingRMSWindow;
+    Normalization m_Normalization;
+    std::map<std::string, double> m_ReferenceValues;
+  };
+};
+
+#endif // __btkEMGEnvelopeFilter_h
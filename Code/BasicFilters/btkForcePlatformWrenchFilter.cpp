@@ -43,7 +43,9 @@ namespace btk
    * @brief Calcule the wrench of the center of the force platform data, expressed in the global frame (by default).
    *
    * Based on the given collection of forceplate set in input, this filter transform the associated analog channels in forces and moments.
-   * This transformation take into account the type of each force platform.
+   * This transformation take into account the type of each force platform. The channels are expected to be already scaled by the 
+   * calibration matrix (see ForcePlatformsExtractor). The types 6 (four 3D sensors), 7 and 11 (same channels than the type 3) and 21 
+   * (same channels than the type 2) are supported. The type 12 is not supported.
    *
    * You can use the method SetTransformToGlobalFrame() to have the wrench expressed in the frame of the force platform.
    *
@@ -93,6 +95,7 @@ namespace btk
     if (this->m_GlobalTransformationActivated == activation)
       return;
     this->m_GlobalTransformationActivated = activation;
+    this->ResetIncrementalState();
     this->Modified();
   };
    
@@ -100,6 +103,28 @@ namespace btk
    * @fn bool ForcePlatformWrenchFilter::GetTransformToGlobalFrame() const
    * Returns the activation flag for the transformation in the global frame.
    */
+  
+  /**
+   * Sets the incremental mode.
+   *
+   * In this mode, the wrenches computed previously are kept and only the frames appended to the 
+   * channels of the force platforms since the last update are computed. A force platform modified 
+   * (or replaced) since the last update is entirely computed. The incremental mode is designed to 
+   * be used with a ForcePlatformsExtractor object also set in incremental mode.
+   */
+  void ForcePlatformWrenchFilter::SetIncrementalMode(bool enabled)
+  {
+    if (this->m_IncrementalMode == enabled)
+      return;
+    this->m_IncrementalMode = enabled;
+    this->ResetIncrementalState();
+    this->Modified();
+  };
+  
+  /**
+   * @fn bool ForcePlatformWrenchFilter::GetIncrementalMode() const
+   * Returns the state of the incremental mode.
+   */
    
   /**
    * Constructor. Sets the number of inputs and outputs to 1.
@@ -110,7 +135,14 @@ namespace btk
     this->SetInputNumber(1);
     this->SetOutputNumber(1);
     this->m_GlobalTransformationActivated = true;
+    this->m_IncrementalMode = false;
   };
+  
+  /**
+   * @fn void ForcePlatformWrenchFilter::ResetIncrementalState()
+   * Forgets the frames already computed. The next update will compute all the frames.
+   * Must be called by the setters modifying the computation of the wrenches.
+   */
 
   /**
    * @fn ForcePlatformCollection::Pointer ForcePlatformWrenchFilter::GetInput(int idx)
@@ -130,6 +162,18 @@ namespace btk
     return WrenchCollection::New();
   };
   
+  /**
+   * Sets @a parameters with the activation of the transformation in the global frame.
+   * The outputs cannot be cached when the incremental mode is activated.
+   */
+  bool ForcePlatformWrenchFilter::GetCacheParameters(std::string& parameters) const
+  {
+    if (this->m_IncrementalMode)
+      return false;
+    parameters = this->m_GlobalTransformationActivated ? "1" : "0";
+    return true;
+  };
+  
   /**
    * Generates the outputs' data.
    */
@@ -146,9 +190,20 @@ namespace btk
         if ((*it)->GetChannelNumber() == 0)
         {
           btkWarningMacro("Unexpected number of analog channels (0) for force platform #" + ToString(inc));
+          if (inc <= static_cast<int>(this->m_ProcessedFrameNumbers.size()))
+            this->m_ProcessedFrameNumbers[inc-1] = 0;
           continue;
         }
         int frameNumber = (*it)->GetChannel(0)->GetFrameNumber();
+        // Incremental mode: only the frames appended since the last update are computed, 
+        // if the force platform was not modified in the meantime.
+        int firstFrame = 0;
+        if (this->m_IncrementalMode
+            && (inc <= static_cast<int>(this->m_ProcessedFrameNumbers.size()))
+            && (inc <= output->GetItemNumber())
+            && ((*it)->GetTimestamp() < this->GetTimestamp())
+            && (this->m_ProcessedFrameNumbers[inc-1] <= frameNumber))
+          firstFrame = this->m_ProcessedFrameNumbers[inc-1];
         Wrench::Pointer wrh;
         if (inc <= output->GetItemNumber())
         {
@@ -163,71 +218,50 @@ namespace btk
         }
         wrh->Modified();
         // Residuals
-        wrh->GetPosition()->GetResiduals().setZero(frameNumber);        
-        wrh->GetForce()->GetResiduals().setZero(frameNumber);
-        wrh->GetMoment()->GetResiduals().setZero(frameNumber);
+        wrh->GetPosition()->GetResiduals().tail(frameNumber - firstFrame).setZero();
+        wrh->GetForce()->GetResiduals().tail(frameNumber - firstFrame).setZero();
+        wrh->GetMoment()->GetResiduals().tail(frameNumber - firstFrame).setZero();
         // Values
+        WrenchComputation wc;
+        wc.MomentAtOrigin = false;
+        wc.PointOfWrenchApplication = false;
+        wc.Origin.setZero();
+        wc.ThresholdActivated = false;
+        wc.ThresholdValue = 0.0;
         switch((*it)->GetType())
         {
           // 6 channels
           case 1:
-            wrh->GetForce()->GetValues().col(0) = (*it)->GetChannel(0)->GetValues();
-            wrh->GetForce()->GetValues().col(1) = (*it)->GetChannel(1)->GetValues();
-            wrh->GetForce()->GetValues().col(2) = (*it)->GetChannel(2)->GetValues();
-            wrh->GetPosition()->GetValues().col(0) = (*it)->GetChannel(3)->GetValues();
-            wrh->GetPosition()->GetValues().col(1) = (*it)->GetChannel(4)->GetValues();
-            wrh->GetPosition()->GetValues().col(2).setZero();
-            wrh->GetMoment()->GetValues().col(0).setZero();
-            wrh->GetMoment()->GetValues().col(1).setZero();
-            wrh->GetMoment()->GetValues().col(2) = (*it)->GetChannel(5)->GetValues();
-            this->FinishTypeI(wrh, *it, inc);
+            this->FinishTypeI(&wc, *it, inc);
             break;
           case 2:
           case 4:
           case 5:
-            wrh->GetForce()->GetValues().col(0) = (*it)->GetChannel(0)->GetValues();
-            wrh->GetForce()->GetValues().col(1) = (*it)->GetChannel(1)->GetValues();
-            wrh->GetForce()->GetValues().col(2) = (*it)->GetChannel(2)->GetValues();
-            wrh->GetMoment()->GetValues().col(0) = (*it)->GetChannel(3)->GetValues();
-            wrh->GetMoment()->GetValues().col(1) = (*it)->GetChannel(4)->GetValues();
-            wrh->GetMoment()->GetValues().col(2) = (*it)->GetChannel(5)->GetValues();
-            this->FinishAMTI(wrh, *it, inc);
+          case 21:
+            this->FinishAMTI(&wc, *it, inc);
             break;
+          // 8 channels
           case 3:
-            // Fx
-            wrh->GetForce()->GetValues().col(0) = (*it)->GetChannel(0)->GetValues() + (*it)->GetChannel(1)->GetValues();
-            // Fy
-            wrh->GetForce()->GetValues().col(1) = (*it)->GetChannel(2)->GetValues() + (*it)->GetChannel(3)->GetValues();
-            // Fz
-            wrh->GetForce()->GetValues().col(2) = (*it)->GetChannel(4)->GetValues() + (*it)->GetChannel(5)->GetValues() + (*it)->GetChannel(6)->GetValues() + (*it)->GetChannel(7)->GetValues();
-            // Mx
-            wrh->GetMoment()->GetValues().col(0) = (*it)->GetOrigin().y() * ((*it)->GetChannel(4)->GetValues() + (*it)->GetChannel(5)->GetValues() - (*it)->GetChannel(6)->GetValues() - (*it)->GetChannel(7)->GetValues());
-            // My
-            wrh->GetMoment()->GetValues().col(1) = (*it)->GetOrigin().x() * ((*it)->GetChannel(5)->GetValues() + (*it)->GetChannel(6)->GetValues() - (*it)->GetChannel(4)->GetValues() - (*it)->GetChannel(7)->GetValues());
-            // Mz
-            wrh->GetMoment()->GetValues().col(2) = (*it)->GetOrigin().y() * ((*it)->GetChannel(1)->GetValues() - (*it)->GetChannel(0)->GetValues()) + (*it)->GetOrigin().x() * ((*it)->GetChannel(2)->GetValues() - (*it)->GetChannel(3)->GetValues());
-            this->FinishKistler(wrh, *it, inc);
-            break;
-          case 6:
-            btkErrorMacro("Force Platform type 6 is not yet supported. Please, report this to the developers");
-            break;
           case 7:
-            btkErrorMacro("Force Platform type 7 is not yet supported. Please, report this to the developers");
-            break;
           case 11:
-            btkErrorMacro("Force Platform type 11 is not yet supported. Please, report this to the developers");
+          // 12 channels
+          case 6:
+            this->FinishKistler(&wc, *it, inc);
             break;
           case 12:
             btkErrorMacro("Force Platform type 12 is not yet supported. Please, report this to the developers");
             break;
-          case 21:
-            btkErrorMacro("Force Platform type 21 is not yet supported. Please, report this to the developers");
+          default:
+            btkErrorMacro("Unsupported force platform type (" + ToString((*it)->GetType()) + ") for force platform #" + ToString(inc) + ".");
             break;
         }
-        if (this->m_GlobalTransformationActivated)
-          this->TransformToGlobal(wrh, (*it)->GetCorners());
+        this->ComputeWrench(wrh, *it, wc, firstFrame);
+        if (static_cast<int>(this->m_ProcessedFrameNumbers.size()) < inc)
+          this->m_ProcessedFrameNumbers.resize(inc, 0);
+        this->m_ProcessedFrameNumbers[inc-1] = frameNumber;
       }
       output->SetItemNumber(input->GetItemNumber());
+      this->m_ProcessedFrameNumbers.resize(input->GetItemNumber(), 0);
     }
   };
   
@@ -235,36 +269,211 @@ namespace btk
    * Finish the computation of the wrench for the force platform type I.
    * Because, it is force platform Type I, the position is not set to the origin, but measured to the COP. The moment must be corrected!
    */
-  void ForcePlatformWrenchFilter::FinishTypeI(Wrench::Pointer wrh , ForcePlatform::Pointer /* fp */, int /* index */)
+  void ForcePlatformWrenchFilter::FinishTypeI(WrenchComputation* wc, ForcePlatform::Pointer /* fp */, int /* index */)
   {
-    typedef Eigen::Array<double, Eigen::Dynamic, 1> Component;
-    Component Fx = wrh->GetForce()->GetValues().col(0).array();
-    Component Fy = wrh->GetForce()->GetValues().col(1).array();
-    Component Fz = wrh->GetForce()->GetValues().col(2).array();
-    Component Mx = wrh->GetMoment()->GetValues().col(0).array();
-    Component My = wrh->GetMoment()->GetValues().col(1).array();
-    Component Mz = wrh->GetMoment()->GetValues().col(2).array();
-    Component Px = wrh->GetPosition()->GetValues().col(0).array();
-    Component Py = wrh->GetPosition()->GetValues().col(1).array();
-    Component Pz = wrh->GetPosition()->GetValues().col(2).array();
-    Mx -= Fy * Pz - Py * Fz;
-    My -= Fz * Px - Pz * Fx;
-    Mz -= Fx * Py - Px * Fy;
-    wrh->GetMoment()->GetValues().col(0) = Mx;
-    wrh->GetMoment()->GetValues().col(1) = My;
-    wrh->GetMoment()->GetValues().col(2) = Mz;
+    wc->MomentAtOrigin = true;
   };
   
   /**
    * Finish the computation of the wrench for the AMTI force platform (nothing to do).
    */
-  void ForcePlatformWrenchFilter::FinishAMTI(Wrench::Pointer /* wrh */, ForcePlatform::Pointer /* fp */, int /* index */)
+  void ForcePlatformWrenchFilter::FinishAMTI(WrenchComputation* /* wc */, ForcePlatform::Pointer /* fp */, int /* index */)
   {};
    
   /**
    * Finish the computation of the wrench for the Kistler force platform (nothing to do).
    */
-  void ForcePlatformWrenchFilter::FinishKistler(Wrench::Pointer /* wrh */, ForcePlatform::Pointer /* fp */, int /* index */)
+  void ForcePlatformWrenchFilter::FinishKistler(WrenchComputation* /* wc */, ForcePlatform::Pointer /* fp */, int /* index */)
   {};
+  
+  /**
+   * Computes the wrench of the force platform @a fp from its analog channels and stores it in @a wrh.
+   * Only the frames starting from the index @a first are computed.
+   *
+   * The frames are processed by blocks small enough to stay in the cache. For each block, the channels
+   * are combined in the local wrench, corrected as set by @a wc (moment at the origin for the type I, 
+   * PWA from Shimba (1984)), expressed in the global frame if requested and finally written in the 
+   * output. Each sample is then read and written only once and no temporary column is allocated.
+   * The suppression of false PWA uses a selection and not a branch to keep the loop vectorizable.
+   */
+  void ForcePlatformWrenchFilter::ComputeWrench(Wrench::Pointer wrh, ForcePlatform::Pointer fp, const WrenchComputation& wc, int first) const
+  {
+    const int blockSize = 128;
+    const int frameNumber = wrh->GetForce()->GetFrameNumber();
+    double* F = wrh->GetForce()->GetValues().data();
+    double* M = wrh->GetMoment()->GetValues().data();
+    double* P = wrh->GetPosition()->GetValues().data();
+    double* res = wrh->GetPosition()->GetResiduals().data();
+    // Raw channels
+    const int type = fp->GetType();
+    const double* c[12] = {0};
+    int channelNumber = 0;
+    switch (type)
+    {
+      case 1: case 2: case 4: case 5: case 21:
+        channelNumber = 6;
+        break;
+      case 3: case 7: case 11:
+        channelNumber = 8;
+        break;
+      case 6:
+        channelNumber = 12;
+        break;
+    }
+    if (fp->GetChannelNumber() < channelNumber)
+    {
+      btkErrorMacro("Unexpected number of analog channels (" + ToString(fp->GetChannelNumber()) + ") for a force platform of type " + ToString(type) + ".");
+      channelNumber = 0;
+    }
+    for (int i = 0 ; i < channelNumber ; ++i)
+      c[i] = fp->GetChannel(i)->GetValues().data();
+    if (channelNumber == 0)
+    {
+      wrh->GetForce()->GetValues().bottomRows(frameNumber - first).setZero();
+      wrh->GetMoment()->GetValues().bottomRows(frameNumber - first).setZero();
+      wrh->GetPosition()->GetValues().bottomRows(frameNumber - first).setZero();
+      return;
+    }
+    // Transformation to the global frame
+    Eigen::Matrix<double, 3, 3> R = Eigen::Matrix<double, 3, 3>::Identity();
+    Eigen::Matrix<double, 3, 1> t = Eigen::Matrix<double, 3, 1>::Zero();
+    if (this->m_GlobalTransformationActivated)
+    {
+      const ForcePlatform::Corners& corners = fp->GetCorners();
+      R.col(0) = corners.col(0) - corners.col(1);
+      R.col(0).normalize();
+      R.col(2) = R.col(0).cross(corners.col(0) - corners.col(3));
+      R.col(2).normalize();
+      R.col(1) = R.col(2).cross(R.col(0));
+      t = (corners.col(0) + corners.col(2)) / 2;
+    }
+    const ForcePlatform::Origin& fo = fp->GetOrigin();
+    const double ox = wc.Origin.x(), oy = wc.Origin.y(), oz = wc.Origin.z();
+    const double threshold = wc.ThresholdActivated ? wc.ThresholdValue : -1.0;
+    double fx[blockSize], fy[blockSize], fz[blockSize];
+    double mx[blockSize], my[blockSize], mz[blockSize];
+    double px[blockSize], py[blockSize], pz[blockSize];
+    for (int b = first ; b < frameNumber ; b += blockSize)
+    {
+      const int n = std::min(blockSize, frameNumber - b);
+      // Local wrench
+      if (type == 1)
+      {
+        for (int i = 0 ; i < n ; ++i)
+        {
+          fx[i] = c[0][b+i]; fy[i] = c[1][b+i]; fz[i] = c[2][b+i];
+          px[i] = c[3][b+i]; py[i] = c[4][b+i]; pz[i] = 0.0;
+          mx[i] = 0.0; my[i] = 0.0; mz[i] = c[5][b+i];
+        }
+      }
+      else if ((type == 3) || (type == 7) || (type == 11))
+      {
+        for (int i = 0 ; i < n ; ++i)
+        {
+          const double c0 = c[0][b+i], c1 = c[1][b+i], c2 = c[2][b+i], c3 = c[3][b+i];
+          const double c4 = c[4][b+i], c5 = c[5][b+i], c6 = c[6][b+i], c7 = c[7][b+i];
+          fx[i] = c0 + c1;
+          fy[i] = c2 + c3;
+          fz[i] = c4 + c5 + c6 + c7;
+          mx[i] = fo.y() * (c4 + c5 - c6 - c7);
+          my[i] = fo.x() * (c5 + c6 - c4 - c7);
+          mz[i] = fo.y() * (c1 - c0) + fo.x() * (c2 - c3);
+          px[i] = 0.0; py[i] = 0.0; pz[i] = 0.0;
+        }
+      }
+      else if (type == 6)
+      {
+        // Four 3D sensors located as for the type 3: (a,b), (-a,b), (-a,-b), (a,-b)
+        for (int i = 0 ; i < n ; ++i)
+        {
+          const double fx1 = c[0][b+i], fx2 = c[1][b+i], fx3 = c[2][b+i], fx4 = c[3][b+i];
+          const double fy1 = c[4][b+i], fy2 = c[5][b+i], fy3 = c[6][b+i], fy4 = c[7][b+i];
+          const double fz1 = c[8][b+i], fz2 = c[9][b+i], fz3 = c[10][b+i], fz4 = c[11][b+i];
+          fx[i] = fx1 + fx2 + fx3 + fx4;
+          fy[i] = fy1 + fy2 + fy3 + fy4;
+          fz[i] = fz1 + fz2 + fz3 + fz4;
+          mx[i] = fo.y() * (fz1 + fz2 - fz3 - fz4);
+          my[i] = fo.x() * (fz2 + fz3 - fz1 - fz4);
+          mz[i] = fo.y() * (fx3 + fx4 - fx1 - fx2) + fo.x() * (fy1 + fy4 - fy2 - fy3);
+          px[i] = 0.0; py[i] = 0.0; pz[i] = 0.0;
+        }
+      }
+      else
+      {
+        for (int i = 0 ; i < n ; ++i)
+        {
+          fx[i] = c[0][b+i]; fy[i] = c[1][b+i]; fz[i] = c[2][b+i];
+          mx[i] = c[3][b+i]; my[i] = c[4][b+i]; mz[i] = c[5][b+i];
+          px[i] = 0.0; py[i] = 0.0; pz[i] = 0.0;
+        }
+      }
+      // Moment expressed at the origin (the position measured by a type I is the COP)
+      if (wc.MomentAtOrigin)
+      {
+        for (int i = 0 ; i < n ; ++i)
+        {
+          mx[i] -= fy[i] * pz[i] - py[i] * fz[i];
+          my[i] -= fz[i] * px[i] - pz[i] * fx[i];
+          mz[i] -= fx[i] * py[i] - px[i] * fy[i];
+        }
+      }
+      // PWA
+      // For explanations of the PWA calculation, see Shimba T. (1984), 
+      // "An estimation of center of gravity from force platform data", 
+      // Journal of Biomechanics 17(1), 53–60.
+      if (wc.PointOfWrenchApplication)
+      {
+        for (int i = 0 ; i < n ; ++i)
+        {
+          const double Fx = fx[i], Fy = fy[i], Fz = fz[i];
+          // Square norm of the forces.
+          const double sNF = Fx * Fx + Fy * Fy + Fz * Fz;
+          // M_s = M_o + F x OS
+          const double Mx = mx[i] + (Fy * oz - oy * Fz);
+          const double My = my[i] + (Fz * ox - oz * Fx);
+          const double Mz = mz[i] + (Fx * oy - ox * Fy);
+          const double x = (Fy * Mz - Fz * My) / sNF - (Fx * Fx * My - Fx * (Fy * Mx)) / (sNF * Fz);
+          const double y = (Fz * Mx - Fx * Mz) / sNF - (Fx * (Fy * My) - Fy * Fy * Mx) / (sNF * Fz);
+          // Suppress false PWA
+          const bool valid = (sNF != 0.0) & !(std::fabs(Fz) <= threshold);
+          const double Px = valid ? x : 0.0;
+          const double Py = valid ? y : 0.0;
+          res[b+i] = valid ? 0.0 : -1.0;
+          // M_pwa = M_s + F_s x PWA
+          mx[i] = Mx + (0.0 - Py * Fz);
+          my[i] = My + (Fz * Px - 0.0);
+          mz[i] = Mz + (Fx * Py - Px * Fy);
+          px[i] = Px; py[i] = Py; pz[i] = 0.0;
+        }
+      }
+      // Output (expressed in the global frame if requested)
+      if (this->m_GlobalTransformationActivated)
+      {
+        for (int i = 0 ; i < n ; ++i)
+        {
+          const int j = b + i;
+          F[j] = fx[i] * R(0,0) + fy[i] * R(0,1) + fz[i] * R(0,2);
+          F[j + frameNumber] = fx[i] * R(1,0) + fy[i] * R(1,1) + fz[i] * R(1,2);
+          F[j + 2 * frameNumber] = fx[i] * R(2,0) + fy[i] * R(2,1) + fz[i] * R(2,2);
+          M[j] = mx[i] * R(0,0) + my[i] * R(0,1) + mz[i] * R(0,2);
+          M[j + frameNumber] = mx[i] * R(1,0) + my[i] * R(1,1) + mz[i] * R(1,2);
+          M[j + 2 * frameNumber] = mx[i] * R(2,0) + my[i] * R(2,1) + mz[i] * R(2,2);
+          P[j] = px[i] * R(0,0) + py[i] * R(0,1) + pz[i] * R(0,2) + t.x();
+          P[j + frameNumber] = px[i] * R(1,0) + py[i] * R(1,1) + pz[i] * R(1,2) + t.y();
+          P[j + 2 * frameNumber] = px[i] * R(2,0) + py[i] * R(2,1) + pz[i] * R(2,2) + t.z();
+        }
+      }
+      else
+      {
+        for (int i = 0 ; i < n ; ++i)
+        {
+          const int j = b + i;
+          F[j] = fx[i]; F[j + frameNumber] = fy[i]; F[j + 2 * frameNumber] = fz[i];
+          M[j] = mx[i]; M[j + frameNumber] = my[i]; M[j + 2 * frameNumber] = mz[i];
+          P[j] = px[i]; P[j + frameNumber] = py[i]; P[j + 2 * frameNumber] = pz[i];
+        }
+      }
+    }
+  };
 };
 
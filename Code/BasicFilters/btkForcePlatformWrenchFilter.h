@@ -43,6 +43,8 @@
 
 #include <Eigen/Geometry>
 
+#include <vector>
+
 namespace btk
 {
   class ForcePlatformWrenchFilter : public ProcessObject
@@ -67,48 +69,43 @@ namespace btk
     
     BTK_BASICFILTERS_EXPORT void SetTransformToGlobalFrame(bool activation = false);
     bool GetTransformToGlobalFrame() const {return this->m_GlobalTransformationActivated;};
+    
+    BTK_BASICFILTERS_EXPORT void SetIncrementalMode(bool enabled = false);
+    bool GetIncrementalMode() const {return this->m_IncrementalMode;};
 
   protected:
+    struct WrenchComputation
+    {
+      bool MomentAtOrigin;
+      bool PointOfWrenchApplication;
+      ForcePlatform::Origin Origin;
+      bool ThresholdActivated;
+      double ThresholdValue;
+    };
+    
     BTK_BASICFILTERS_EXPORT ForcePlatformWrenchFilter();
     
     ForcePlatformCollection::Pointer GetInput(int idx) {return static_pointer_cast<ForcePlatformCollection>(this->GetNthInput(idx));};  
     WrenchCollection::Pointer GetOutput(int idx) {return static_pointer_cast<WrenchCollection>(this->GetNthOutput(idx));};
     BTK_BASICFILTERS_EXPORT virtual DataObject::Pointer MakeOutput(int idx);
     BTK_BASICFILTERS_EXPORT virtual void GenerateData();
+    BTK_BASICFILTERS_EXPORT virtual bool GetCacheParameters(std::string& parameters) const;
+    void ResetIncrementalState() {this->m_ProcessedFrameNumbers.clear();};
     
   private:
     virtual std::string GetWrenchPrefix() const {return "FPW";};
-    virtual void FinishTypeI(Wrench::Pointer wrh, ForcePlatform::Pointer fp, int index);
-    virtual void FinishAMTI(Wrench::Pointer wrh, ForcePlatform::Pointer fp, int index);
-    virtual void FinishKistler(Wrench::Pointer wrh, ForcePlatform::Pointer fp, int index);
-    void TransformToGlobal(Wrench::Pointer wrh, const ForcePlatform::Corners& c) const;
+    virtual void FinishTypeI(WrenchComputation* wc, ForcePlatform::Pointer fp, int index);
+    virtual void FinishAMTI(WrenchComputation* wc, ForcePlatform::Pointer fp, int index);
+    virtual void FinishKistler(WrenchComputation* wc, ForcePlatform::Pointer fp, int index);
+    void ComputeWrench(Wrench::Pointer wrh, ForcePlatform::Pointer fp, const WrenchComputation& wc, int first) const;
 
     bool m_GlobalTransformationActivated;
+    bool m_IncrementalMode;
+    std::vector<int> m_ProcessedFrameNumbers;
 
     ForcePlatformWrenchFilter(const ForcePlatformWrenchFilter& ); // Not implemented.
     ForcePlatformWrenchFilter& operator=(const ForcePlatformWrenchFilter& ); // Not implemented.
   };
-  
-  inline void ForcePlatformWrenchFilter::TransformToGlobal(Wrench::Pointer wrh, const ForcePlatform::Corners& c) const
-  {
-    Eigen::Matrix<double, 3, 3> R;
-    Eigen::Matrix<double, 3, 1> t;
-    R.col(0) = c.col(0) - c.col(1);
-    R.col(0).normalize();
-    R.col(2) = R.col(0).cross(c.col(0) - c.col(3));
-    R.col(2).normalize();
-    R.col(1) = R.col(2).cross(R.col(0));
-    t = (c.col(0) + c.col(2)) / 2;
-    // Forces & Moments rotation
-    wrh->GetForce()->GetValues() *= R.transpose();
-    wrh->GetMoment()->GetValues() *= R.transpose();
-    // Position rotation
-    wrh->GetPosition()->GetValues() *= R.transpose();
-    // Position translation
-    wrh->GetPosition()->GetValues().col(0).array() += t.x();
-    wrh->GetPosition()->GetValues().col(1).array() += t.y();
-    wrh->GetPosition()->GetValues().col(2).array() += t.z();
-  };
 };
 
 #endif // __btkForcePlatformWrenchFilter_h
@@ -63,14 +63,20 @@ namespace btk
    *  - Type 2: 6 channels (FX, FY, FZ, MX, MY, MZ);
    *  - Type 3: 8 channels (FZ1, FZ2, FZ3, FZ4, FX12, FX34, FY14, FY23);
    *  - Type 4: Same as Type-2 + calibration matrix 6 (columns) by 6 (rows);
-   *  - Type 5: Same as Type-3 + calibration matrix 6 (columns) by 8 (rows).
-   *
-   * However, some other types are not yet supported due to the lack of information and data on them:
+   *  - Type 5: Same as Type-3 + calibration matrix 6 (columns) by 8 (rows);
    *  - Type 6: 12 channels (FX[1,2,3,4], FY[1,2,3,4], FZ[1,2,3,4]) + calibration matrix 12 by 12;
    *  - Type 7: 8 channels (FZ1, FZ2, FZ3, FZ4, FX12, FX34, FY14, FY23) + calibration matrix 8 by 8;
-   *  - Type 11: Kistler Split Belt Treadmill: 8 channels + calibration matrix 8X8 + polynomial correction matrix 2x6 + COP translation + COP rotation;
-   *  - Type 12: Gaitway treadmill: 8 channels (Fz11, Fz12, Fz13, Fz14, Fz21, Fz22, Fz23, and Fz24) + calibration matrix 8X8.
-   *  - Type 21: AMTI-Stairs: 2 force plates with 6 channels + a calibration matrix 6x6 + data to locate the corners of the 4 steps.
+   *  - Type 11: Kistler Split Belt Treadmill: 8 channels + calibration matrix 8X8 (the polynomial correction matrix and the COP translation/rotation are not extracted);
+   *  - Type 12: Gaitway treadmill: 8 channels (Fz11, Fz12, Fz13, Fz14, Fz21, Fz22, Fz23, and Fz24) + calibration matrix 8X8;
+   *  - Type 21: AMTI-Stairs: 6 channels + a calibration matrix 6x6 (the data to locate the corners of the steps are not extracted).
+   *
+   * By default, the analog channels are copied in each force platform. Using the method SetSharedChannels(), the force platforms
+   * reference directly the analog channels of the acquisition instead of copying them, unless they have to be scaled by a 
+   * calibration matrix (different than the identity). The filters of the pipeline (e.g. ForcePlatformWrenchFilter) do not modify
+   * their inputs and can work on shared channels. If you need to modify the channels of a force platform without modifying the 
+   * acquisition, use the method Analog::Clone() to get your own copy.
+   *
+   * A type 3 force platform is scaled only if the metadata FORCE_PLATFORM:CAL_MATRIX contains a 8 by 8 matrix for it which is neither null nor the identity.
    *
    * @ingroup BTKBasicFilters
    */
@@ -105,6 +111,44 @@ namespace btk
    * Gets the output created with this process.
    */
   
+  /**
+   * @fn bool ForcePlatformsExtractor::GetSharedChannels() const
+   * Returns true if the force platforms reference the analog channels of the acquisition instead of copying them.
+   */
+  
+  /**
+   * Sets the flag to reference the analog channels of the acquisition in the force platforms instead of copying them.
+   * The channels scaled by a calibration matrix (different than the identity) are always copied.
+   */
+  void ForcePlatformsExtractor::SetSharedChannels(bool shared)
+  {
+    if (this->m_SharedChannels == shared)
+      return;
+    this->m_SharedChannels = shared;
+    this->m_SharedChannelsModified = true;
+    this->Modified();
+  };
+  
+  /**
+   * @fn bool ForcePlatformsExtractor::GetIncrementalMode() const
+   * Returns the state of the incremental mode.
+   */
+  
+  /**
+   * Sets the incremental mode.
+   *
+   * In this mode, if the metadata FORCE_PLATFORM was not modified, the force platforms previously extracted are kept
+   * and only the frames appended to the analog channels since the last update are extracted (and scaled if necessary).
+   * Combined with the shared channels (see SetSharedChannels()), nothing is copied.
+   */
+  void ForcePlatformsExtractor::SetIncrementalMode(bool enabled)
+  {
+    if (this->m_IncrementalMode == enabled)
+      return;
+    this->m_IncrementalMode = enabled;
+    this->Modified();
+  };
+  
   /**
    * Constructor. Sets the number of inputs and outputs to 1.
    */
@@ -113,6 +157,9 @@ namespace btk
   {
     this->SetInputNumber(1);
     this->SetOutputNumber(1);
+    this->m_SharedChannels = false;
+    this->m_SharedChannelsModified = false;
+    this->m_IncrementalMode = false;
   };
 
   /**
@@ -133,6 +180,18 @@ namespace btk
     return ForcePlatformCollection::New();
   };
   
+  /**
+   * The extraction has no parameter. The outputs cannot be cached when the channels are shared with the input 
+   * (see SetSharedChannels()) or when the incremental mode is activated.
+   */
+  bool ForcePlatformsExtractor::GetCacheParameters(std::string& parameters) const
+  {
+    if (this->m_SharedChannels || this->m_IncrementalMode)
+      return false;
+    parameters.clear();
+    return true;
+  };
+  
   /**
    * Generates the outputs' data.
    */
@@ -240,10 +299,27 @@ namespace btk
             break;
           }
         }
-        if (!dataModified && ((*itForcePlatformGr)->GetTimestamp() < this->GetTimestamp()))
+        if (!dataModified && !this->m_SharedChannelsModified && ((*itForcePlatformGr)->GetTimestamp() < this->GetTimestamp()))
           return;
+        // Incremental mode: the frames appended to the analog channels are added to the force platforms already extracted.
+        if (this->m_IncrementalMode && !this->m_SharedChannelsModified && ((*itForcePlatformGr)->GetTimestamp() < this->GetTimestamp()))
+        {
+          bool appended = true;
+          int channelNumberAlreadyExtracted = 0;
+          for (ForcePlatformCollection::Iterator itFP = output->Begin() ; appended && (itFP != output->End()) ; ++itFP)
+          {
+            appended = this->AppendForcePlatformData((*itFP), analogs, channelNumberAlreadyExtracted, channelsIndex);
+            channelNumberAlreadyExtracted += channelStep;
+          }
+          if (appended)
+          {
+            output->Modified();
+            return;
+          }
+        }
       }
       
+      this->m_SharedChannelsModified = false;
       output->Clear();
       output->SetItemNumber(static_cast<int>(numberOfForcePlatforms));
       ForcePlatformCollection::Iterator itFP = output->Begin();
@@ -268,7 +344,14 @@ namespace btk
         case 3:
           (*itFP) = ForcePlatformType3::New();
           this->ExtractForcePlatformDataCommon((*itFP), i, calMatrixCoefficentNumberAleadyExtracted, pOrigin, pCorners, pCalMatrix);
-          noError = this->ExtractForcePlatformData((*itFP), analogs, channelNumberAlreadyExtracted, channelsIndex);
+          // The calibration matrix is optional for the type 3 and is often filled with zeros.
+          if ((calMatrixStep == (*itFP)->GetCalMatrix().size()) && !(*itFP)->GetCalMatrix().isZero(0.0) && !(*itFP)->GetCalMatrix().isIdentity(0.0))
+            noError = this->ExtractForcePlatformDataWithCalibrationMatrix((*itFP), analogs, channelNumberAlreadyExtracted, channelsIndex);
+          else
+          {
+            (*itFP)->GetCalMatrix().setIdentity();
+            noError = this->ExtractForcePlatformData((*itFP), analogs, channelNumberAlreadyExtracted, channelsIndex);
+          }
           break;
         case 4:
           (*itFP) = ForcePlatformType4::New();
@@ -281,44 +364,29 @@ namespace btk
           noError = this->ExtractForcePlatformDataWithCalibrationMatrix((*itFP), analogs, channelNumberAlreadyExtracted, channelsIndex);
           break;
         case 6:
-          {
-          btkErrorMacro("Force Platform type 6 is not yet supported. Please, report this to the developers");
-          //ForcePlatformType6::Pointer fp6 = ForcePlatformType6::New();
-          //this->ExtractForcePlatformData(fp6, analogs, (*itForcePlatformGr));
-          //(*itFP) = fp6;
-          }
+          (*itFP) = ForcePlatformType6::New();
+          this->ExtractForcePlatformDataCommon((*itFP), i, calMatrixCoefficentNumberAleadyExtracted, pOrigin, pCorners, pCalMatrix);
+          noError = this->ExtractForcePlatformDataWithCalibrationMatrix((*itFP), analogs, channelNumberAlreadyExtracted, channelsIndex);
           break;
         case 7:
-          {
-          btkErrorMacro("Force Platform type 7 is not yet supported. Please, report this to the developers");
-          //ForcePlatformType7::Pointer fp7 = ForcePlatformType7::New();
-          //this->ExtractForcePlatformData(fp7, analogs, (*itForcePlatformGr));
-          //(*itFP) = fp7;
-          }
+          (*itFP) = ForcePlatformType7::New();
+          this->ExtractForcePlatformDataCommon((*itFP), i, calMatrixCoefficentNumberAleadyExtracted, pOrigin, pCorners, pCalMatrix);
+          noError = this->ExtractForcePlatformDataWithCalibrationMatrix((*itFP), analogs, channelNumberAlreadyExtracted, channelsIndex);
           break;
         case 11:
-          {
-          btkErrorMacro("Force Platform type 11 is not yet supported. Please, report this to the developers");
-          //ForcePlatformType11::Pointer fp11 = ForcePlatformType11::New();
-          //this->ExtractForcePlatformData(fp11, analogs, (*itForcePlatformGr));
-          //(*itFP) = fp11;
-          }
+          (*itFP) = ForcePlatformType11::New();
+          this->ExtractForcePlatformDataCommon((*itFP), i, calMatrixCoefficentNumberAleadyExtracted, pOrigin, pCorners, pCalMatrix);
+          noError = this->ExtractForcePlatformDataWithCalibrationMatrix((*itFP), analogs, channelNumberAlreadyExtracted, channelsIndex);
           break;
         case 12:
-          {
-          btkErrorMacro("Force Platform type 12 is not yet supported. Please, report this to the developers");
-          //ForcePlatformType12::Pointer fp12 = ForcePlatformType12::New();
-          //this->ExtractForcePlatformData(fp12, analogs, (*itForcePlatformGr));
-          //(*itFP) = fp12;
-          }
+          (*itFP) = ForcePlatformType12::New();
+          this->ExtractForcePlatformDataCommon((*itFP), i, calMatrixCoefficentNumberAleadyExtracted, pOrigin, pCorners, pCalMatrix);
+          noError = this->ExtractForcePlatformDataWithCalibrationMatrix((*itFP), analogs, channelNumberAlreadyExtracted, channelsIndex);
           break;
         case 21:
-          {
-          btkErrorMacro("Force Platform type 21 is not yet supported. Please, report this to the developers");
-          //ForcePlatformType21::Pointer fp21 = ForcePlatformType21::New();
-          //this->ExtractForcePlatformData(fp21, analogs, (*itForcePlatformGr));
-          //(*itFP) = fp21;
-          }
+          (*itFP) = ForcePlatformType21::New();
+          this->ExtractForcePlatformDataCommon((*itFP), i, calMatrixCoefficentNumberAleadyExtracted, pOrigin, pCorners, pCalMatrix);
+          noError = this->ExtractForcePlatformDataWithCalibrationMatrix((*itFP), analogs, channelNumberAlreadyExtracted, channelsIndex);
           break;
         default:
           btkErrorMacro("Unsupported force platform type. Impossible to extract corresponding data");
@@ -395,13 +463,22 @@ namespace btk
     if (noError)
     {
       for (int i = 0 ; i < numberOfChannelToExtract ; ++i)
-        fp->SetChannel(i, channels->GetItem(channelsIndex[i + alreadyExtracted] - 1)->Clone());
+      {
+        Analog::Pointer channel = channels->GetItem(channelsIndex[i + alreadyExtracted] - 1);
+        fp->SetChannel(i, this->m_SharedChannels ? channel : channel->Clone());
+      }
     }
     return noError;
   };
 
+  /**
+   * Extracts the channels of the force platform @a fp and scales them with its calibration matrix.
+   */
   bool ForcePlatformsExtractor::ExtractForcePlatformDataWithCalibrationMatrix(ForcePlatform::Pointer fp, AnalogCollection::Pointer channels, int alreadyExtracted, std::vector<int> channelsIndex)
   {
+    // Nothing to scale
+    if (this->m_SharedChannels && fp->GetCalMatrix().isIdentity(0.0))
+      return this->ExtractForcePlatformData(fp, channels, alreadyExtracted, channelsIndex);
     int numberOfChannelToExtract = fp->GetChannelNumber();
     int numberOfChannels = channels->GetItemNumber();
     bool noError = this->CheckAnalogIndicesForForcePlatform(channelsIndex, alreadyExtracted, numberOfChannelToExtract, numberOfChannels);
@@ -409,23 +486,94 @@ namespace btk
     if (noError)
     {
       int numberOfFrame = channels->GetItem(0)->GetFrameNumber();
-      Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic> data = Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>(numberOfFrame, numberOfChannelToExtract);
+      std::vector<const double*> in(numberOfChannelToExtract);
       for (int i = 0 ; i < numberOfChannelToExtract ; ++i)
       {
-        Analog::Pointer channel = Analog::New();
         Analog::Pointer channelToCopy = channels->GetItem(channelsIndex[i + alreadyExtracted] - 1);
-        channel->SetLabel(channelToCopy->GetLabel());
+        Analog::Pointer channel = Analog::New(channelToCopy->GetLabel(), numberOfFrame);
         channel->SetDescription(channelToCopy->GetDescription());
         fp->SetChannel(i, channel);
-        data.col(i) = channelToCopy->GetValues();
+        in[i] = channelToCopy->GetValues().data();
       }
-      data *= fp->GetCalMatrix().transpose();
-
-      for (int i = 0 ; i < numberOfChannelToExtract ; ++i)
-        fp->GetChannel(i)->SetValues(data.col(i));
+      this->CalibrateChannels(fp, in, 0, numberOfFrame);
     }
     return noError;
   };
+  /**
+   * Appends to the channels of the force platform @a fp the frames added to the analog channels since its extraction.
+   * Returns false if the force platform cannot be updated and must be extracted again.
+   */
+  bool ForcePlatformsExtractor::AppendForcePlatformData(ForcePlatform::Pointer fp, AnalogCollection::Pointer channels, int alreadyExtracted, const std::vector<int>& channelsIndex)
+  {
+    if (!fp)
+      return false;
+    int numberOfChannelToExtract = fp->GetChannelNumber();
+    int numberOfChannels = channels->GetItemNumber();
+    if ((numberOfChannelToExtract == 0) || !this->CheckAnalogIndicesForForcePlatform(channelsIndex, alreadyExtracted, numberOfChannelToExtract, numberOfChannels))
+      return false;
+    // Shared channels are updated with the acquisition.
+    if (fp->GetChannel(0) == channels->GetItem(channelsIndex[alreadyExtracted] - 1))
+    {
+      for (int i = 1 ; i < numberOfChannelToExtract ; ++i)
+      {
+        if (fp->GetChannel(i) != channels->GetItem(channelsIndex[i + alreadyExtracted] - 1))
+          return false;
+      }
+      return true;
+    }
+    int first = fp->GetChannel(0)->GetFrameNumber();
+    int last = channels->GetItem(channelsIndex[alreadyExtracted] - 1)->GetFrameNumber();
+    if (last < first)
+      return false;
+    std::vector<const double*> in(numberOfChannelToExtract);
+    for (int i = 0 ; i < numberOfChannelToExtract ; ++i)
+    {
+      Analog::Pointer channelToCopy = channels->GetItem(channelsIndex[i + alreadyExtracted] - 1);
+      if ((fp->GetChannel(i) == channelToCopy) || (fp->GetChannel(i)->GetFrameNumber() != first) || (channelToCopy->GetFrameNumber() != last))
+        return false;
+      in[i] = channelToCopy->GetValues().data();
+    }
+    if (last == first)
+      return true;
+    for (int i = 0 ; i < numberOfChannelToExtract ; ++i)
+      fp->GetChannel(i)->SetFrameNumber(last);
+    if (fp->GetCalMatrix().isIdentity(0.0))
+    {
+      for (int i = 0 ; i < numberOfChannelToExtract ; ++i)
+        fp->GetChannel(i)->GetValues().segment(first, last - first) = Eigen::Map<const Analog::Values>(in[i] + first, last - first);
+    }
+    else
+      this->CalibrateChannels(fp, in, first, last);
+    return true;
+  };
+  
+  /**
+   * Scales the frames [@a first, @a last[ of the channels @a in with the calibration matrix of the force platform @a fp
+   * and stores the result in its channels.
+   *
+   * The calibration is applied as a matrix-matrix product on blocks of frames (all the channels of a block are 
+   * gathered and multiplied at once) and the result is written directly in the channels.
+   */
+  void ForcePlatformsExtractor::CalibrateChannels(ForcePlatform::Pointer fp, const std::vector<const double*>& in, int first, int last) const
+  {
+    typedef Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic> Block;
+    const int blockSize = 128;
+    const int numberOfChannelToExtract = static_cast<int>(in.size());
+    const ForcePlatform::CalMatrix& cal = fp->GetCalMatrix();
+    // Only the first calibrated components have a channel to be stored in.
+    const int numberOfCalibratedChannel = std::min(static_cast<int>(cal.rows()), numberOfChannelToExtract);
+    Block raw(blockSize, numberOfChannelToExtract), calibrated(blockSize, cal.rows());
+    for (int b = first ; b < last ; b += blockSize)
+    {
+      const int n = std::min(blockSize, last - b);
+      for (int i = 0 ; i < numberOfChannelToExtract ; ++i)
+        raw.col(i).head(n) = Eigen::Map<const Analog::Values>(in[i] + b, n);
+      calibrated.topRows(n).noalias() = raw.topRows(n) * cal.transpose();
+      for (int i = 0 ; i < numberOfCalibratedChannel ; ++i)
+        fp->GetChannel(i)->GetValues().segment(b, n) = calibrated.col(i).head(n);
+    }
+  };
+  
 /*
   void ForcePlatformsExtractor::ExtractForcePlatformData(ForcePlatformType5::Pointer fp, AnalogCollection::Pointer channels, MetaData::Pointer fpGr)
   {
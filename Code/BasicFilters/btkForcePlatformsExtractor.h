@@ -56,6 +56,11 @@ namespace btk
     Acquisition::Pointer GetInput() {return this->GetInput(0);};
     void SetInput(Acquisition::Pointer input) {this->SetNthInput(0, input);};
     ForcePlatformCollection::Pointer GetOutput() {return this->GetOutput(0);};
+    
+    bool GetSharedChannels() const {return this->m_SharedChannels;};
+    BTK_BASICFILTERS_EXPORT void SetSharedChannels(bool shared);
+    bool GetIncrementalMode() const {return this->m_IncrementalMode;};
+    BTK_BASICFILTERS_EXPORT void SetIncrementalMode(bool enabled);
 
   protected:
     BTK_BASICFILTERS_EXPORT ForcePlatformsExtractor();
@@ -64,17 +69,24 @@ namespace btk
     ForcePlatformCollection::Pointer GetOutput(int idx) {return static_pointer_cast<ForcePlatformCollection>(this->GetNthOutput(idx));};
     BTK_BASICFILTERS_EXPORT virtual DataObject::Pointer MakeOutput(int idx);
     BTK_BASICFILTERS_EXPORT virtual void GenerateData();
+    BTK_BASICFILTERS_EXPORT virtual bool GetCacheParameters(std::string& parameters) const;
     
   private:
     void ExtractForcePlatformDataCommon(ForcePlatform::Pointer fp, size_t idx, int coefficientsAlreadyExtracted, MetaData::Pointer pOrigin, MetaData::Pointer pCorners, MetaData::Pointer pCalMatrix);
     bool ExtractForcePlatformData(ForcePlatform::Pointer fp, AnalogCollection::Pointer channels, int alreadyExtracted, std::vector<int> channelsIndex);
     bool ExtractForcePlatformDataWithCalibrationMatrix(ForcePlatform::Pointer fp, AnalogCollection::Pointer channels, int alreadyExtracted, std::vector<int> channelsIndex);
+    bool AppendForcePlatformData(ForcePlatform::Pointer fp, AnalogCollection::Pointer channels, int alreadyExtracted, const std::vector<int>& channelsIndex);
+    void CalibrateChannels(ForcePlatform::Pointer fp, const std::vector<const double*>& in, int first, int last) const;
     //void ExtractForcePlatformData(ForcePlatformType6::Pointer fp, AnalogCollection::Pointer channels, MetaData::Pointer fpGr);
     //void ExtractForcePlatformData(ForcePlatformType7::Pointer fp, AnalogCollection::Pointer channels, MetaData::Pointer fpGr);
     //void ExtractForcePlatformData(ForcePlatformType11::Pointer fp, AnalogCollection::Pointer channels, MetaData::Pointer fpGr);
     //void ExtractForcePlatformData(ForcePlatformType12::Pointer fp, AnalogCollection::Pointer channels, MetaData::Pointer fpGr);
     //void ExtractForcePlatformData(ForcePlatformType21::Pointer fp, AnalogCollection::Pointer channels, MetaData::Pointer fpGr);
     bool CheckAnalogIndicesForForcePlatform(std::vector<int> channelsIndex, int alreadyExtracted, int numberOfChannelToExtract, int numberOfChannels) const;
+    
+    bool m_SharedChannels;
+    bool m_SharedChannelsModified;
+    bool m_IncrementalMode;
 
     ForcePlatformsExtractor(const ForcePlatformsExtractor& ); // Not implemented.
     ForcePlatformsExtractor& operator=(const ForcePlatformsExtractor& ); // Not implemented.
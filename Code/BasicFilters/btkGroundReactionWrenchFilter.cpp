@@ -98,6 +98,7 @@ namespace btk
     if (this->m_ThresholdActivated == activated)
       return;
     this->m_ThresholdActivated = activated;
+    this->ResetIncrementalState();
     this->Modified();
   };
 
@@ -120,6 +121,7 @@ namespace btk
     if (v < 0.0)
       btkWarningMacro("Negative threshold has no effect on the algorithm because it compares the threshold value with the absolute value of Fz.");
     this->m_ThresholdValue = v;
+    this->ResetIncrementalState();
     this->Modified();
   };
 
@@ -136,10 +138,26 @@ namespace btk
   };
   
   /**
-   * Finish the computation of the ground reaction wrench for the force platform type I (nothing to do).
+   * Appends the threshold's state and value to the parameters of the ForcePlatformWrenchFilter class.
    */
-  void GroundReactionWrenchFilter::FinishTypeI(Wrench::Pointer /* wrh */, ForcePlatform::Pointer /* fp */, int /* index */)
+  bool GroundReactionWrenchFilter::GetCacheParameters(std::string& parameters) const
   {
+    if (!this->ForcePlatformWrenchFilter::GetCacheParameters(parameters))
+      return false;
+    std::ostringstream oss;
+    oss.precision(17);
+    oss << "\n" << (this->m_ThresholdActivated ? 1 : 0) << "\n" << this->m_ThresholdValue;
+    parameters += oss.str();
+    return true;
+  };
+  
+  /**
+   * Finish the computation of the ground reaction wrench for the force platform type I.
+   * The measured position is already the COP, so the moment is not transported to the origin.
+   */
+  void GroundReactionWrenchFilter::FinishTypeI(WrenchComputation* wc, ForcePlatform::Pointer /* fp */, int /* index */)
+  {
+    wc->MomentAtOrigin = false;
     /*
     ForcePlatform::Origin origin;
     origin << 0, 0, fp->GetOrigin().z();
@@ -149,13 +167,13 @@ namespace btk
       origin.z() *= -1;
     }
     */
-    //this->FinishGRWComputation(grw, origin);
+    //this->FinishGRWComputation(wc, origin);
   };
   
   /**
    * Finish the computation of the ground reaction wrench for the AMTI force platforms.
    */
-  void GroundReactionWrenchFilter::FinishAMTI(Wrench::Pointer wrh, ForcePlatform::Pointer fp, int index)
+  void GroundReactionWrenchFilter::FinishAMTI(WrenchComputation* wc, ForcePlatform::Pointer fp, int index)
   {
     ForcePlatform::Origin origin = fp->GetOrigin();
     if (origin.z() > 0)
@@ -163,14 +181,13 @@ namespace btk
       btkWarningMacro("Origin for the force platform #" + ToString(index) + " seems to be located from the center of the working surface instead of the inverse. Data are inverted to locate the center of the working surface from the platform's origin.");
       origin *= -1;
     }
-    this->FinishGRWComputation(wrh, origin);
-
+    this->FinishGRWComputation(wc, origin);
   };
    
   /**
    * Finish the computation of the ground reaction wrench for the Kislter force platform.
    */
-  void GroundReactionWrenchFilter::FinishKistler(Wrench::Pointer wrh, ForcePlatform::Pointer fp, int index)
+  void GroundReactionWrenchFilter::FinishKistler(WrenchComputation* wc, ForcePlatform::Pointer fp, int index)
   {
     ForcePlatform::Origin origin;
     origin << 0, 0, fp->GetOrigin().z();
@@ -179,7 +196,7 @@ namespace btk
       btkWarningMacro("Vertical offset between the origin of the force platform #" + ToString(index) + " and the center of the working surface seems to be misconfigured (positive value). The opposite of this offset is used.");
       origin.z() *= -1;
     }
-    this->FinishGRWComputation(wrh, origin);
+    this->FinishGRWComputation(wc, origin);
   };
 };
 
@@ -0,0 +1,355 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "btkKinematicGaitEventDetector.h"
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+#include <cmath>
+
+namespace btk
+{
+  /**
+   * @class KinematicGaitEventDetector btkKinematicGaitEventDetector.h
+   * @brief Detect heel strike and toe-off events during gait from marker trajectories.
+   *
+   * The algorithm is the one proposed by Zeni et al. (2008). For each side, the distance between the heel
+   * (resp. the toe) marker and the sacrum marker is projected on the direction of progression. The heel strikes
+   * correspond to the maxima of the heel distance and the toe-off events to the minima of the toe distance.
+   * This method is useful when the feet do not hit the force platforms or when no force platform is available.
+   *
+   * The labels of the markers can be set with the method SetMarkerLabel(). By default, the labels of the 
+   * Plug-in Gait model are used (SACR, LHEE, LTOE, RHEE, RTOE). If the sacrum marker is not found, the midpoint 
+   * of the markers LPSI and RPSI is used.
+   *
+   * The direction of progression is the horizontal axis of the global frame (X or Y, the vertical axis being Z) with
+   * the largest displacement of the sacrum between its first and last visible frames. A frame is an extremum if it 
+   * is the maximum (or the minimum) of the frames around it (see SetWindowLength()). The frames where one of 
+   * the markers is occluded cannot be extrema.
+   *
+   * As for the class VerticalGroundReactionForceGaitEventDetector, the first frame, the frequency and the 
+   * subject's name must be given with the method SetAcquisitionInformation() to fill exactly the events.
+   *
+   * @par Reference
+   * Zeni J.A., Richards J.G., Higginson J.S.@n
+   * <em>Two simple methods for determining gait events during treadmill and overground walking using kinematic data</em>.@n
+   * Gait & Posture, <b>2008</b>, 27(4), 710-714.
+   *
+   * @ingroup BTKBasicFilters
+   */
+  
+  /**
+   * @var KinematicGaitEventDetector::Marker KinematicGaitEventDetector::Sacrum
+   * Sacrum marker (or midpoint of the posterior superior iliac spines).
+   */
+  /**
+   * @var KinematicGaitEventDetector::Marker KinematicGaitEventDetector::LeftHeel
+   * Left heel marker.
+   */
+  /**
+   * @var KinematicGaitEventDetector::Marker KinematicGaitEventDetector::LeftToe
+   * Left toe marker.
+   */
+  /**
+   * @var KinematicGaitEventDetector::Marker KinematicGaitEventDetector::RightHeel
+   * Right heel marker.
+   */
+  /**
+   * @var KinematicGaitEventDetector::Marker KinematicGaitEventDetector::RightToe
+   * Right toe marker.
+   */
+  
+  /**
+   * @typedef KinematicGaitEventDetector::Pointer
+   * Smart pointer associated with a KinematicGaitEventDetector object.
+   */
+  
+  /**
+   * @typedef KinematicGaitEventDetector::ConstPointer
+   * Smart pointer associated with a const KinematicGaitEventDetector object.
+   */
+    
+  /**
+   * @fn static Pointer KinematicGaitEventDetector::New();
+   * Creates a smart pointer associated with a KinematicGaitEventDetector object.
+   */
+
+  /**
+   * @fn PointCollection::Pointer KinematicGaitEventDetector::GetInput()
+   * Gets the input registered with this process.
+   */
+  
+  /**
+   * @fn void KinematicGaitEventDetector::SetInput(PointCollection::Pointer input)
+   * Sets the input required with this process.
+   */
+  
+  /**
+   * @fn EventCollection::Pointer KinematicGaitEventDetector::GetOutput()
+   * Gets the output created with this process.
+   */
+  
+  /**
+   * Sets the label of the given @a marker.
+   */
+  void KinematicGaitEventDetector::SetMarkerLabel(Marker marker, const std::string& label)
+  {
+    if (this->m_Labels[marker].compare(label) == 0)
+      return;
+    this->m_Labels[marker] = label;
+    this->Modified();
+  };
+  
+  /**
+   * @fn const std::string& KinematicGaitEventDetector::GetMarkerLabel(Marker marker) const
+   * Returns the label of the given @a marker.
+   */
+  
+  /**
+   * Sets the number of frames before and after a frame used to know if it is an extremum.
+   * A length of 0 is not accepted.
+   */
+  void KinematicGaitEventDetector::SetWindowLength(int length)
+  {
+    if (this->m_WindowLength == length)
+      return;
+    if (length <= 0)
+    {
+      btkErrorMacro("The length of the window must be strictly positive.");
+      return;
+    }
+    this->m_WindowLength = length;
+    this->Modified();
+  };
+  
+  /**
+   * @fn int KinematicGaitEventDetector::GetWindowLength() const
+   * Returns the number of frames before and after a frame used to know if it is an extremum.
+   */
+  
+  /**
+   * Set the informations required to set correctly the detected events.
+   */
+  void KinematicGaitEventDetector::SetAcquisitionInformation(int firstFrame, double freq, const std::string& subjectName)
+  {
+    if ((this->m_FirstFrame == firstFrame) && (this->m_FrameRate == freq) && (this->m_SubjectName.compare(subjectName) == 0))
+      return;
+    this->m_FirstFrame = firstFrame;
+    this->m_FrameRate = freq;
+    this->m_SubjectName = subjectName;
+    this->Modified();
+  };
+  
+  /**
+   * Returns the informations required to set correctly the detected events.
+   */
+  void KinematicGaitEventDetector::GetAcquisitionInformation(int& firstFrame, double& freq, std::string& subjectName)
+  {
+    firstFrame = this->m_FirstFrame;
+    freq = this->m_FrameRate;
+    subjectName = this->m_SubjectName;
+  };
+  
+  /**
+   * Constructor.
+   * By default, the labels of the Plug-in Gait model are used and the window length is set to 10 frames.
+   */
+  KinematicGaitEventDetector::KinematicGaitEventDetector()
+  : ProcessObject()
+  {
+    this->SetInputNumber(1);
+    this->SetOutputNumber(1);
+    this->m_Labels[Sacrum] = "SACR";
+    this->m_Labels[LeftHeel] = "LHEE";
+    this->m_Labels[LeftToe] = "LTOE";
+    this->m_Labels[RightHeel] = "RHEE";
+    this->m_Labels[RightToe] = "RTOE";
+    this->m_WindowLength = 10;
+    this->m_FirstFrame = 1;
+    this->m_FrameRate = 0.0; // Hz
+    this->m_SubjectName = "";
+  };
+  
+  /**
+   * @fn PointCollection::Pointer KinematicGaitEventDetector::GetInput(int idx)
+   * Returns the input at the index @a idx.
+   */
+  
+  /**
+   * @fn EventCollection::Pointer KinematicGaitEventDetector::GetOutput(int idx)
+   * Returns the output at the index @a idx.
+   */
+
+  /**
+   * Generate the output used by this filter.
+   */
+  DataObject::Pointer KinematicGaitEventDetector::MakeOutput(int /* idx */)
+  {
+    return EventCollection::New();
+  };
+  
+  struct KinematicGaitEvent_p
+  {
+    int Frame;
+    int Id;
+    bool operator<(const KinematicGaitEvent_p& other) const {return this->Frame < other.Frame;};
+  };
+  
+  /*
+   * Stores in @a extrema the frames where the values @a d are maximal (@a sign equal to 1) or minimal (@a sign equal to -1)
+   * in the window [i-w, i+w]. The first frame of a plateau is kept. A NaN in the window rejects the frame.
+   */
+  static void _btk_kinematic_extrema(std::vector<KinematicGaitEvent_p>* extrema, const std::vector<double>& d, int w, double sign, int id)
+  {
+    const int num = static_cast<int>(d.size());
+    for (int i = w ; i < num - w ; ++i)
+    {
+      const double v = sign * d[i];
+      int extremum = (v == v) ? 1 : 0; // NaN
+      for (int k = 1 ; k <= w ; ++k)
+        extremum &= (v > sign * d[i-k]) & (v >= sign * d[i+k]);
+      if (extremum)
+      {
+        KinematicGaitEvent_p ev = {i, id};
+        extrema->push_back(ev);
+      }
+    }
+  };
+  
+  /**
+   * Detects the gait events from the heel and toe markers of each side.
+   */
+  void KinematicGaitEventDetector::GenerateData()
+  {
+    EventCollection::Pointer output = this->GetOutput();
+    output->Clear();
+    PointCollection::Pointer input = this->GetInput();
+    if (!input)
+    {
+      btkErrorMacro("Input data are missing.");
+      return;
+    }
+    // Markers
+    Point::Pointer markers[5];
+    for (PointCollection::ConstIterator it = input->Begin() ; it != input->End() ; ++it)
+    {
+      for (int i = 0 ; i < 5 ; ++i)
+      {
+        if ((*it)->GetLabel().compare(this->m_Labels[i]) == 0)
+          markers[i] = *it;
+      }
+    }
+    if (!markers[Sacrum])
+    {
+      Point::Pointer lpsi, rpsi;
+      for (PointCollection::ConstIterator it = input->Begin() ; it != input->End() ; ++it)
+      {
+        if ((*it)->GetLabel().compare("LPSI") == 0)
+          lpsi = *it;
+        else if ((*it)->GetLabel().compare("RPSI") == 0)
+          rpsi = *it;
+      }
+      if (lpsi && rpsi && (lpsi->GetFrameNumber() == rpsi->GetFrameNumber()))
+      {
+        markers[Sacrum] = Point::New(this->m_Labels[Sacrum], lpsi->GetFrameNumber());
+        markers[Sacrum]->GetValues() = (lpsi->GetValues() + rpsi->GetValues()) / 2.0;
+        markers[Sacrum]->GetResiduals() = lpsi->GetResiduals().cwiseMin(rpsi->GetResiduals());
+      }
+    }
+    for (int i = 0 ; i < 5 ; ++i)
+    {
+      if (!markers[i])
+      {
+        btkErrorMacro("The marker '" + this->m_Labels[i] + "' is missing. Impossible to detect the gait events.");
+        return;
+      }
+      if (markers[i]->GetFrameNumber() != markers[Sacrum]->GetFrameNumber())
+      {
+        btkErrorMacro("The markers must have the same number of frames.");
+        return;
+      }
+    }
+    const int frameNumber = markers[Sacrum]->GetFrameNumber();
+    const Point::Residuals& sacrumResiduals = markers[Sacrum]->GetResiduals();
+    // Direction of progression
+    int first = 0, last = frameNumber - 1;
+    while ((first < frameNumber) && (sacrumResiduals.coeff(first) < 0.0))
+      ++first;
+    while ((last > first) && (sacrumResiduals.coeff(last) < 0.0))
+      --last;
+    if (first >= last)
+    {
+      btkErrorMacro("Not enough visible frames for the sacrum to know the direction of progression.");
+      return;
+    }
+    const double dx = markers[Sacrum]->GetValues().coeff(last, 0) - markers[Sacrum]->GetValues().coeff(first, 0);
+    const double dy = markers[Sacrum]->GetValues().coeff(last, 1) - markers[Sacrum]->GetValues().coeff(first, 1);
+    const int axis = (std::fabs(dx) >= std::fabs(dy)) ? 0 : 1;
+    const double direction = (((axis == 0) ? dx : dy) >= 0.0) ? 1.0 : -1.0;
+    // Events
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    double t = 0.0;
+    if (this->m_FrameRate > 0.0)
+      t = 1.0 / this->m_FrameRate;
+    const double* s = markers[Sacrum]->GetValues().data() + axis * frameNumber;
+    const double* sr = sacrumResiduals.data();
+    std::vector<double> d(frameNumber);
+    const char* contexts[2] = {"Left", "Right"};
+    for (int side = 0 ; side < 2 ; ++side)
+    {
+      std::vector<KinematicGaitEvent_p> events;
+      for (int j = 0 ; j < 2 ; ++j)
+      {
+        const Point::Pointer& marker = markers[1 + 2 * side + j];
+        const double* m = marker->GetValues().data() + axis * frameNumber;
+        const double* mr = marker->GetResiduals().data();
+        for (int i = 0 ; i < frameNumber ; ++i)
+          d[i] = ((mr[i] >= 0.0) & (sr[i] >= 0.0)) ? direction * (m[i] - s[i]) : nan;
+        // Heel strikes: maxima of the heel distance. Toe-off: minima of the toe distance.
+        _btk_kinematic_extrema(&events, d, this->m_WindowLength, (j == 0) ? 1.0 : -1.0, j + 1);
+      }
+      std::stable_sort(events.begin(), events.end());
+      for (size_t i = 0 ; i < events.size() ; ++i)
+      {
+        int frame = events[i].Frame + this->m_FirstFrame;
+        if (events[i].Id == 1)
+          output->InsertItem(btk::Event::New("Foot Strike", frame*t, frame, contexts[side], Event::Automatic, this->m_SubjectName, "The instant the heel strikes the ground", 1));
+        else
+          output->InsertItem(btk::Event::New("Foot Off", frame*t, frame, contexts[side], Event::Automatic, this->m_SubjectName, "The instant the toe leaves the ground", 2));
+      }
+    }
+  };
+};
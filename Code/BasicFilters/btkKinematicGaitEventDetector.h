@@ -0,0 +1,93 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __btkKinematicGaitEventDetector_h
+#define __btkKinematicGaitEventDetector_h
+
+#include "btkProcessObject.h"
+#include "btkPointCollection.h"
+#include "btkEventCollection.h"
+
+#include <string>
+
+namespace btk
+{
+  class KinematicGaitEventDetector : public ProcessObject
+  {
+  public:
+    typedef enum {Sacrum = 0, LeftHeel, LeftToe, RightHeel, RightToe} Marker;
+    
+    typedef btkSharedPtr<KinematicGaitEventDetector> Pointer;
+    typedef btkSharedPtr<const KinematicGaitEventDetector> ConstPointer;
+
+    static Pointer New() {return Pointer(new KinematicGaitEventDetector());};
+    
+    // ~KinematicGaitEventDetector(); // Implicit
+    
+    PointCollection::Pointer GetInput() {return this->GetInput(0);};
+    void SetInput(PointCollection::Pointer input) {this->SetNthInput(0, input);};
+    EventCollection::Pointer GetOutput() {return this->GetOutput(0);};
+    
+    BTK_BASICFILTERS_EXPORT void SetMarkerLabel(Marker marker, const std::string& label);
+    const std::string& GetMarkerLabel(Marker marker) const {return this->m_Labels[marker];};
+    
+    BTK_BASICFILTERS_EXPORT void SetWindowLength(int length);
+    int GetWindowLength() const {return this->m_WindowLength;};
+    
+    BTK_BASICFILTERS_EXPORT void SetAcquisitionInformation(int firstFrame, double freq, const std::string& subjectName);
+    BTK_BASICFILTERS_EXPORT void GetAcquisitionInformation(int& firstFrame, double& freq, std::string& subjectName);
+    
+  protected:
+    BTK_BASICFILTERS_EXPORT KinematicGaitEventDetector();
+    
+    PointCollection::Pointer GetInput(int idx) {return static_pointer_cast<PointCollection>(this->GetNthInput(idx));};  
+    EventCollection::Pointer GetOutput(int idx) {return static_pointer_cast<EventCollection>(this->GetNthOutput(idx));};
+    BTK_BASICFILTERS_EXPORT virtual DataObject::Pointer MakeOutput(int idx);
+    BTK_BASICFILTERS_EXPORT virtual void GenerateData();
+    
+  private:
+    KinematicGaitEventDetector(const KinematicGaitEventDetector& ); // Not implemented.
+    KinematicGaitEventDetector& operator=(const KinematicGaitEventDetector& ); // Not implemented.
+    
+    std::string m_Labels[5];
+    int m_WindowLength;
+    int m_FirstFrame;
+    double m_FrameRate;
+    std::string m_SubjectName;
+  };
+};
+
+#endif // __btkKinematicGaitEventDetector_h
+
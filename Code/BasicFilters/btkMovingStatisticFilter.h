@@ -0,0 +1,384 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __btkMovingStatisticFilter_h
+#define __btkMovingStatisticFilter_h
+
+#include "btkProcessObject.h"
+#include "btkCollection.h"
+#include "btkLogger.h"
+#include "btkPoint.h"
+
+#include <btkEigen/SignalProcessing/MovingStatistics.h>
+
+namespace btk
+{
+  template <class T>
+  class MovingStatisticFilter : public ProcessObject
+  {
+  public:
+    typedef enum {Mean = 0, RMS, Variance, StandardDeviation, Median, Percentile} Statistic;
+    
+    typedef btkSharedPtr<MovingStatisticFilter> Pointer;
+    typedef btkSharedPtr<const MovingStatisticFilter> ConstPointer;
+    
+    typedef typename Collection<T>::Pointer CollectionPointer;
+    typedef typename Collection<T>::ConstPointer CollectionConstPointer;
+    
+    static Pointer New() {return Pointer(new MovingStatisticFilter());};
+    
+    virtual ~MovingStatisticFilter() {};
+    
+    CollectionPointer GetInput() {return this->GetInput(0);};
+    void SetInput(CollectionPointer input) {this->SetNthInput(0, input);};
+    CollectionPointer GetOutput() {return this->GetOutput(0);};
+    
+    Statistic GetStatistic() const {return this->m_Statistic;};
+    void SetStatistic(Statistic s);
+    int GetWindowLength() const {return this->m_WindowLength;};
+    void SetWindowLength(int len);
+    double GetPercentile() const {return this->m_Percentile;};
+    void SetPercentile(double p);
+    bool GetBaselineRemoval() const {return this->m_BaselineRemoval;};
+    void SetBaselineRemoval(bool enabled);
+    
+  protected:
+    MovingStatisticFilter();
+    
+    CollectionPointer GetInput(int idx) {return static_pointer_cast< Collection<T> >(this->GetNthInput(idx));};  
+    CollectionPointer GetOutput(int idx) {return static_pointer_cast< Collection<T> >(this->GetNthOutput(idx));};
+    virtual DataObject::Pointer MakeOutput(int idx);
+    virtual void GenerateData();
+    
+  private:
+    MovingStatisticFilter(const MovingStatisticFilter& ); // Not implemented.
+    MovingStatisticFilter& operator=(const MovingStatisticFilter& ); // Not implemented.
+    
+    Statistic m_Statistic;
+    int m_WindowLength;
+    double m_Percentile;
+    bool m_BaselineRemoval;
+  };
+  
+  /**
+   * @class MovingStatisticFilter btkMovingStatisticFilter.h
+   * @brief Computes a statistic over a sliding window for each measure of a collection.
+   * @tparam T Must be a class inheriting of btk::Measure (e.g. btk::Analog, btk::Point)
+   *
+   * The statistic (see SetStatistic()) is computed for each sample over a window centered on it (see SetWindowLength()).
+   * Near the first and last samples, the window is truncated and the statistic is computed only with the available samples.
+   * Each component of the measures (e.g. the three coordinates of a point) is processed separately.
+   *
+   * The mean, the RMS, the variance and the standard deviation are computed with cumulative sums, while the median and the percentiles
+   * use sorted sets updated with the samples entering and leaving the window (see the functions in the file btkEigen/SignalProcessing/MovingStatistics.h).
+   * Then the cost of each sample does not depend (or only logarithmically) on the length of the window.
+   *
+   * The baseline removal (see SetBaselineRemoval()) gives the difference between the input and the computed statistic. 
+   * For example, with a moving median, this removes a slow drift of the signals and the remaining peaks can be used to detect spikes.
+   *
+   * The output is a new collection where each measure is a copy of the input's measure with the computed values.
+   * For the points, the residuals are copied and the frames with a negative residual (i.e. invalid) are omitted from the windows
+   * (they are given as NaN to the functions of btkEigen which omit the non-finite samples). These frames stay invalid in the output 
+   * and their values are set to 0.
+   *
+   * @ingroup BTKBasicFilters
+   */
+  
+  /**
+   * @enum MovingStatisticFilter::Statistic
+   * Statistic computed over the sliding window.
+   */
+  /**
+   * @var MovingStatisticFilter::Statistic MovingStatisticFilter::Mean
+   * Moving average.
+   */
+  /**
+   * @var MovingStatisticFilter::Statistic MovingStatisticFilter::RMS
+   * Moving root mean square.
+   */
+  /**
+   * @var MovingStatisticFilter::Statistic MovingStatisticFilter::Variance
+   * Moving variance (normalized by the number of samples minus one).
+   */
+  /**
+   * @var MovingStatisticFilter::Statistic MovingStatisticFilter::StandardDeviation
+   * Moving standard deviation (normalized by the number of samples minus one).
+   */
+  /**
+   * @var MovingStatisticFilter::Statistic MovingStatisticFilter::Median
+   * Moving median.
+   */
+  /**
+   * @var MovingStatisticFilter::Statistic MovingStatisticFilter::Percentile
+   * Moving percentile (see SetPercentile()).
+   */
+  
+  /**
+   * @typedef MovingStatisticFilter<T>::Pointer
+   * Smart pointer associated with a MovingStatisticFilter object.
+   */
+  
+  /**
+   * @typedef MovingStatisticFilter<T>::ConstPointer
+   * Smart pointer associated with a const MovingStatisticFilter object.
+   */
+  
+  /**
+   * @typedef MovingStatisticFilter<T>::CollectionPointer
+   * Smart pointer associated with a Collection<T> object.
+   */
+  
+  /**
+   * @typedef MovingStatisticFilter<T>::CollectionConstPointer
+   * Smart pointer associated with a const Collection<T> object.
+   */
+  
+  /**
+   * @fn template <class T> static Pointer MovingStatisticFilter<T>::New();
+   * Creates a smart pointer associated with a MovingStatisticFilter<T> object.
+   */
+  
+  /**
+   * @fn template <class T> virtual MovingStatisticFilter<T>::~MovingStatisticFilter()
+   * Empty destructor.
+   */
+  
+  /**
+   * @fn template <class T> CollectionPointer MovingStatisticFilter<T>::GetInput()
+   * Gets the input registered with this process.
+   */
+  
+  /**
+   * @fn template <class T> void MovingStatisticFilter<T>::SetInput(CollectionPointer input)
+   * Sets the input required with this process.
+   */
+  
+  /**
+   * @fn template <class T> CollectionPointer MovingStatisticFilter<T>::GetOutput()
+   * Gets the output created with this process.
+   */
+  
+  /**
+   * @fn template <class T> Statistic MovingStatisticFilter<T>::GetStatistic() const
+   * Returns the statistic computed over the sliding window.
+   */
+  
+  /**
+   * Sets the statistic computed over the sliding window (mean by default).
+   */
+  template <class T>
+  void MovingStatisticFilter<T>::SetStatistic(Statistic s)
+  {
+    if (this->m_Statistic == s)
+      return;
+    this->m_Statistic = s;
+    this->Modified();
+  };
+  
+  /**
+   * @fn template <class T> int MovingStatisticFilter<T>::GetWindowLength() const
+   * Returns the number of samples in the sliding window.
+   */
+  
+  /**
+   * Sets the number of samples in the sliding window (5 by default).
+   * For an even length, the window contains one more sample before the current one than after it.
+   */
+  template <class T>
+  void MovingStatisticFilter<T>::SetWindowLength(int len)
+  {
+    if (this->m_WindowLength == len)
+      return;
+    if (len < 1)
+    {
+      btkErrorMacro("The length of the window must be greater than 0.");
+      return;
+    }
+    this->m_WindowLength = len;
+    this->Modified();
+  };
+  
+  /**
+   * @fn template <class T> double MovingStatisticFilter<T>::GetPercentile() const
+   * Returns the percentile computed when the statistic is set to Percentile.
+   */
+  
+  /**
+   * Sets the percentile (between 0 and 100) computed when the statistic is set to Percentile (50 by default).
+   */
+  template <class T>
+  void MovingStatisticFilter<T>::SetPercentile(double p)
+  {
+    if (this->m_Percentile == p)
+      return;
+    if ((p < 0.0) || (p > 100.0))
+    {
+      btkErrorMacro("The percentile must be between 0 and 100.");
+      return;
+    }
+    this->m_Percentile = p;
+    this->Modified();
+  };
+  
+  /**
+   * @fn template <class T> bool MovingStatisticFilter<T>::GetBaselineRemoval() const
+   * Returns true if the output contains the difference between the input and the computed statistic.
+   */
+  
+  /**
+   * Enables or disables the baseline removal (disabled by default). If enabled, the output contains the
+   * difference between the input and the computed statistic.
+   */
+  template <class T>
+  void MovingStatisticFilter<T>::SetBaselineRemoval(bool enabled)
+  {
+    if (this->m_BaselineRemoval == enabled)
+      return;
+    this->m_BaselineRemoval = enabled;
+    this->Modified();
+  };
+  
+  /**
+   * Constructor. Sets the number of inputs and outputs to 1.
+   */
+  template <class T>
+  MovingStatisticFilter<T>::MovingStatisticFilter()
+  : ProcessObject()
+  {
+    this->SetInputNumber(1);
+    this->SetOutputNumber(1);
+    this->m_Statistic = Mean;
+    this->m_WindowLength = 5;
+    this->m_Percentile = 50.0;
+    this->m_BaselineRemoval = false;
+  };
+  
+  /**
+   * @fn template <class T> CollectionPointer MovingStatisticFilter<T>::GetInput(int idx)
+   * Returns the input at the index @a idx.
+   */
+  
+  /**
+   * @fn template <class T> CollectionPointer MovingStatisticFilter<T>::GetOutput(int idx)
+   * Returns the output at the index @a idx.
+   */
+  
+  /**
+   * Creates a Collection<T>::Pointer object and return it as a DataObject::Pointer.
+   */
+  template <class T>
+  DataObject::Pointer MovingStatisticFilter<T>::MakeOutput(int /* idx */)
+  {
+    return Collection<T>::New();
+  };
+  
+  /**
+   * Generic method to set the invalid samples of a measure to NaN (@a masked set to true) or to 0 (@a masked set to false). Does nothing.
+   */
+  template <class T>
+  inline void MovingStatisticMaskInvalidSamples(btkSharedPtr<T> measure, bool masked)
+  {
+    btkNotUsed(measure);
+    btkNotUsed(masked);
+  };
+  
+  /**
+   * Specialized version for the points: the invalid samples are the frames with a negative residual.
+   */
+  template <>
+  inline void MovingStatisticMaskInvalidSamples<Point>(Point::Pointer point, bool masked)
+  {
+    Point::Values& values = point->GetValues();
+    const Point::Residuals& residuals = point->GetResiduals();
+    const double value = masked ? std::numeric_limits<double>::quiet_NaN() : 0.0;
+    for (int i = 0 ; i < residuals.rows() ; ++i)
+    {
+      if (residuals.coeff(i) < 0.0)
+        values.row(i).setConstant(value);
+    }
+  };
+  
+  /**
+   * Generates the outputs' data.
+   */
+  template <class T>
+  void MovingStatisticFilter<T>::GenerateData()
+  {
+    CollectionPointer output = this->GetOutput();
+    output->Clear();
+    CollectionPointer input = this->GetInput();
+    if (!input)
+      return;
+    for (typename Collection<T>::ConstIterator it = input->Begin() ; it != input->End() ; ++it)
+    {
+      typename T::Pointer measure = (*it)->Clone();
+      typename T::Values& values = measure->GetValues();
+      if (values.rows() != 0)
+      {
+        MovingStatisticMaskInvalidSamples<T>(measure, true);
+        typename T::Values stat;
+        switch (this->m_Statistic)
+        {
+        case Mean:
+          btkEigen::movmean(&stat, values, this->m_WindowLength);
+          break;
+        case RMS:
+          btkEigen::movrms(&stat, values, this->m_WindowLength);
+          break;
+        case Variance:
+          btkEigen::movvar(&stat, values, this->m_WindowLength);
+          break;
+        case StandardDeviation:
+          btkEigen::movstd(&stat, values, this->m_WindowLength);
+          break;
+        case Median:
+          btkEigen::movmedian(&stat, values, this->m_WindowLength);
+          break;
+        case Percentile:
+          btkEigen::movprctile(&stat, values, this->m_WindowLength, this->m_Percentile);
+          break;
+        }
+        if (this->m_BaselineRemoval)
+          values -= stat;
+        else
+          values = stat;
+        MovingStatisticMaskInvalidSamples<T>(measure, false);
+      }
+      output->InsertItem(measure);
+    }
+  };
+};
+
+#endif // __btkMovingStatisticFilter_h
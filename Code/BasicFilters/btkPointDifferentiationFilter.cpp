@@ -0,0 +1,300 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "btkPointDifferentiationFilter.h"
+
+#include <btkEigen/SignalProcessing/SGolay.h>
+
+#include <vector>
+
+namespace btk
+{
+  /**
+   * @class PointDifferentiationFilter btkPointDifferentiationFilter.h
+   * @brief Computes the velocity and the acceleration of points with Savitzky-Golay filters.
+   *
+   * For each frame, a polynomial (see SetPolynomialOrder()) is fitted by least squares on a window of 
+   * consecutive frames centered on it (see SetWindowLength()). The velocity and the acceleration correspond to the 
+   * first and second derivatives of this polynomial. As the polynomial fit is linear, these derivatives are computed 
+   * with FIR filters determined once (see the functions btkEigen::sgolay() and btkEigen::sgolayfilt()). 
+   * The coordinates of all the points are gathered in a single matrix and each coefficient of the filters is applied on all of them at once.
+   *
+   * The frames at the beginning and the end of a trajectory use the polynomial fitted on the first (last) window instead of a truncated window.
+   *
+   * The frames with a negative residual (i.e. invalid or occluded) are not used. Each segment of consecutive valid frames 
+   * is differentiated separately. The segments shorter than the window are not differentiated and their frames are set as invalid
+   * (residual set to -1 and values set to 0) in the outputs. For the other frames, the residuals of the input are kept.
+   *
+   * The frequency of the points must be set with the method SetFrequency() to have derivatives per second.
+   *
+   * The velocities and accelerations are stored in two new collections (see GetVelocityOutput() and GetAccelerationOutput()) 
+   * where the points have the same label, description and type than the input points.
+   * 
+   * @ingroup BTKBasicFilters
+   */
+  
+  /**
+   * @typedef PointDifferentiationFilter::Pointer
+   * Smart pointer associated with a PointDifferentiationFilter object.
+   */
+  
+  /**
+   * @typedef PointDifferentiationFilter::ConstPointer
+   * Smart pointer associated with a const PointDifferentiationFilter object.
+   */
+  
+  /**
+   * @fn static Pointer PointDifferentiationFilter::New();
+   * Creates a smart pointer associated with a PointDifferentiationFilter object.
+   */
+  
+  /**
+   * @fn PointCollection::Pointer PointDifferentiationFilter::GetInput()
+   * Gets the input registered with this process.
+   */
+  
+  /**
+   * @fn void PointDifferentiationFilter::SetInput(Point::Pointer input)
+   * Sets the input required with this process. This input is transformed in a collection of points with a single point.
+   */
+  
+  /**
+   * @fn void PointDifferentiationFilter::SetInput(PointCollection::Pointer input)
+   * Sets the input required with this process.
+   */
+  
+  /**
+   * @fn PointCollection::Pointer PointDifferentiationFilter::GetVelocityOutput()
+   * Gets the output containing the velocity of the points.
+   */
+  
+  /**
+   * @fn PointCollection::Pointer PointDifferentiationFilter::GetAccelerationOutput()
+   * Gets the output containing the acceleration of the points.
+   */
+  
+  /**
+   * @fn double PointDifferentiationFilter::GetFrequency() const
+   * Returns the sampling frequency of the points.
+   */
+  
+  /**
+   * Sets the sampling frequency of the points (Hz).
+   */
+  void PointDifferentiationFilter::SetFrequency(double freq)
+  {
+    if (this->m_Frequency == freq)
+      return;
+    this->m_Frequency = freq;
+    this->Modified();
+  };
+  
+  /**
+   * @fn int PointDifferentiationFilter::GetWindowLength() const
+   * Returns the number of frames used to fit the polynomial.
+   */
+  
+  /**
+   * Sets the number of frames used to fit the polynomial (9 by default). The length must be odd and greater than the order of the polynomial.
+   */
+  void PointDifferentiationFilter::SetWindowLength(int len)
+  {
+    if (this->m_WindowLength == len)
+      return;
+    if ((len < 3) || (len % 2 == 0))
+    {
+      btkErrorMacro("The length of the window must be an odd number greater than 1.");
+      return;
+    }
+    this->m_WindowLength = len;
+    this->Modified();
+  };
+  
+  /**
+   * @fn int PointDifferentiationFilter::GetPolynomialOrder() const
+   * Returns the order of the polynomial fitted on each window.
+   */
+  
+  /**
+   * Sets the order of the polynomial fitted on each window (3 by default). The order must be at least 2 to compute the acceleration.
+   */
+  void PointDifferentiationFilter::SetPolynomialOrder(int order)
+  {
+    if (this->m_PolynomialOrder == order)
+      return;
+    if (order < 2)
+    {
+      btkErrorMacro("The order of the polynomial must be greater than 1.");
+      return;
+    }
+    this->m_PolynomialOrder = order;
+    this->Modified();
+  };
+  
+  /**
+   * Constructor. 
+   * Sets the number of inputs to 1 and the number of outputs to 2 (velocities and accelerations).
+   */
+  PointDifferentiationFilter::PointDifferentiationFilter()
+  : ProcessObject()
+  {
+    this->m_Frequency = 0.0;
+    this->m_WindowLength = 9;
+    this->m_PolynomialOrder = 3;
+    this->SetInputNumber(1);
+    this->SetOutputNumber(2);
+  };
+  
+  /**
+   * @fn PointCollection::Pointer PointDifferentiationFilter::GetInput(int idx)
+   * Returns the input at the index @a idx.
+   */
+  
+  /**
+   * @fn PointCollection::Pointer PointDifferentiationFilter::GetOutput(int idx)
+   * Returns the output at the index @a idx.
+   */
+  
+  /**
+   * Creates a PointCollection::Pointer object and return it as a DataObject::Pointer.
+   */
+  DataObject::Pointer PointDifferentiationFilter::MakeOutput(int /* idx */)
+  {
+    return PointCollection::New();
+  };
+  
+  /**
+   * Generates the outputs' data.
+   */
+  void PointDifferentiationFilter::GenerateData()
+  {
+    PointCollection::Pointer velocities = this->GetVelocityOutput();
+    PointCollection::Pointer accelerations = this->GetAccelerationOutput();
+    velocities->Clear();
+    accelerations->Clear();
+    PointCollection::Pointer input = this->GetInput();
+    if (!input || (input->GetItemNumber() == 0))
+      return;
+    if (this->m_Frequency <= 0.0)
+    {
+      btkErrorMacro("The frequency must be set to compute the derivatives.");
+      return;
+    }
+    if (this->m_PolynomialOrder >= this->m_WindowLength)
+    {
+      btkErrorMacro("The order of the polynomial must be lower than the length of the window.");
+      return;
+    }
+    
+    typedef Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic> Matrix;
+    const int window = this->m_WindowLength;
+    Matrix B1, B2;
+    btkEigen::sgolay(&B1, this->m_PolynomialOrder, window, 1);
+    btkEigen::sgolay(&B2, this->m_PolynomialOrder, window, 2);
+    B1 *= this->m_Frequency;
+    B2 *= this->m_Frequency * this->m_Frequency;
+    
+    // The coordinates of all the points are gathered to apply the filters only once.
+    const int frameNumber = input->GetFrontItem()->GetFrameNumber();
+    std::vector<Point::Pointer> points;
+    for (PointCollection::ConstIterator it = input->Begin() ; it != input->End() ; ++it)
+    {
+      if ((*it)->GetFrameNumber() != frameNumber)
+      {
+        btkErrorMacro("All the points must have the same number of frames. Impossible to compute the derivatives.");
+        return;
+      }
+      points.push_back(*it);
+    }
+    const int pointNumber = static_cast<int>(points.size());
+    Matrix X(frameNumber, 3 * pointNumber), V, A;
+    for (int i = 0 ; i < pointNumber ; ++i)
+      X.middleCols(3*i, 3) = points[i]->GetValues();
+    if (frameNumber >= window)
+    {
+      btkEigen::sgolayfilt(&V, X, B1);
+      btkEigen::sgolayfilt(&A, X, B2);
+    }
+    
+    for (int i = 0 ; i < pointNumber ; ++i)
+    {
+      Point::Pointer p = points[i];
+      Point::Pointer vel = Point::New(p->GetLabel(), frameNumber, p->GetType(), p->GetDescription());
+      Point::Pointer acc = Point::New(p->GetLabel(), frameNumber, p->GetType(), p->GetDescription());
+      const Point::Residuals& residuals = p->GetResiduals();
+      if ((frameNumber >= window) && (residuals.minCoeff() >= 0.0))
+      {
+        vel->GetValues() = V.middleCols(3*i, 3);
+        acc->GetValues() = A.middleCols(3*i, 3);
+        vel->GetResiduals() = residuals;
+        acc->GetResiduals() = residuals;
+      }
+      else
+      {
+        // Each segment of valid frames is differentiated separately.
+        vel->GetValues().setZero();
+        acc->GetValues().setZero();
+        vel->GetResiduals().setConstant(-1.0);
+        acc->GetResiduals().setConstant(-1.0);
+        int start = 0;
+        while (start < frameNumber)
+        {
+          if (residuals.coeff(start) < 0.0)
+          {
+            ++start;
+            continue;
+          }
+          int stop = start;
+          while ((stop < frameNumber) && (residuals.coeff(stop) >= 0.0))
+            ++stop;
+          const int len = stop - start;
+          if (len >= window)
+          {
+            Matrix v, a;
+            btkEigen::sgolayfilt(&v, X.block(start, 3*i, len, 3), B1);
+            btkEigen::sgolayfilt(&a, X.block(start, 3*i, len, 3), B2);
+            vel->GetValues().middleRows(start, len) = v;
+            acc->GetValues().middleRows(start, len) = a;
+            vel->GetResiduals().segment(start, len) = residuals.segment(start, len);
+            acc->GetResiduals().segment(start, len) = residuals.segment(start, len);
+          }
+          start = stop;
+        }
+      }
+      velocities->InsertItem(vel);
+      accelerations->InsertItem(acc);
+    }
+  };
+};
@@ -0,0 +1,551 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "btkPointGapFillingFilter.h"
+#include "btkThread_p.h"
+#include "btkConvert.h"
+
+#include <btkEigen/Interpolation/Interp1.h>
+#include <Eigen/Geometry>
+
+#include <vector>
+#include <limits>
+
+namespace btk
+{
+  /**
+   * @class PointGapFillingFilter btkPointGapFillingFilter.h
+   * @brief Fill the gaps of the points' trajectories.
+   *
+   * A gap is a set of consecutive frames where the residual of the point is negative (i.e. occluded or invalid).
+   * Only the gaps with a length lower or equal to the maximum interpolation gap (see SetMaxInterpolationGap()) are filled.
+   * To respect the value stored in the acquisition, you can use the following code:
+   * @code
+   * filter->SetMaxInterpolationGap(acq->GetMaxInterpolationGap());
+   * @endcode
+   *
+   * Four methods are proposed to fill the gaps (see SetMethod()):
+   *  - Linear: Linear interpolation between the frames surrounding the gap ;
+   *  - PCHIP: Piecewise Cubic Hermite Interpolating Polynomial computed on all the valid frames of the point ;
+   *  - Spline: Natural cubic spline computed on all the valid frames of the point ;
+   *  - RigidBody: The missing positions are reconstructed from three other markers of the same rigid body
+   *    (see AppendRigidBody()) visible during the entire gap. The position of the point relative to these donors is 
+   *    taken at the frame before and/or after the gap. When both sides are available, the two reconstructions are 
+   *    linearly blended to not have a discontinuity at the end of the gap.
+   *
+   * The interpolation methods cannot fill the gaps located at the beginning or the end of a trajectory. 
+   * This is not the case for the rigid body method.
+   * The filled frames have their residual set to 0 (interpolated value as specified in the C3D file format).
+   *
+   * The output is a new collection where each point is a copy of the input's point. The points are processed
+   * in parallel. By default, the number of threads corresponds to the number of processors (see SetThreadNumber()).
+   * 
+   * @ingroup BTKBasicFilters
+   */
+  
+  /**
+   * @typedef PointGapFillingFilter::Pointer
+   * Smart pointer associated with a PointGapFillingFilter object.
+   */
+  
+  /**
+   * @typedef PointGapFillingFilter::ConstPointer
+   * Smart pointer associated with a const PointGapFillingFilter object.
+   */
+  
+  /**
+   * @enum PointGapFillingFilter::Method
+   * Enums used to specify the method used to fill the gaps.
+   */
+  /**
+   * @var PointGapFillingFilter::Method PointGapFillingFilter::Linear
+   * Linear interpolation.
+   */
+  /**
+   * @var PointGapFillingFilter::Method PointGapFillingFilter::PCHIP
+   * Piecewise Cubic Hermite Interpolating Polynomial.
+   */
+  /**
+   * @var PointGapFillingFilter::Method PointGapFillingFilter::Spline
+   * Natural cubic spline.
+   */
+  /**
+   * @var PointGapFillingFilter::Method PointGapFillingFilter::RigidBody
+   * Reconstruction based on other markers of the same rigid body.
+   */
+    
+  /**
+   * @fn static Pointer PointGapFillingFilter::New();
+   * Creates a smart pointer associated with a PointGapFillingFilter object.
+   */
+
+  /**
+   * @fn PointCollection::Pointer PointGapFillingFilter::GetInput()
+   * Gets the input registered with this process.
+   */
+
+  /**
+   * @fn void PointGapFillingFilter::SetInput(Point::Pointer input)
+   * Sets the input required with this process. This input is transformed in a collection of points with a single point.
+   */
+  
+  /**
+   * @fn void PointGapFillingFilter::SetInput(PointCollection::Pointer input)
+   * Sets the input required with this process.
+   */
+  
+  /**
+   * @fn PointCollection::Pointer PointGapFillingFilter::GetOutput()
+   * Gets the output created with this process.
+   */
+  
+  /**
+   * @fn Method PointGapFillingFilter::GetMethod() const
+   * Returns the method used to fill the gaps.
+   */
+  
+  /**
+   * Sets the method used to fill the gaps.
+   */
+  void PointGapFillingFilter::SetMethod(Method m)
+  {
+    if (this->m_Method == m)
+      return;
+    this->m_Method = m;
+    this->Modified();
+  };
+  
+  /**
+   * @fn int PointGapFillingFilter::GetMaxInterpolationGap() const
+   * Returns the maximum number of consecutive frames which can be filled.
+   */
+  
+  /**
+   * Sets the maximum number of consecutive frames which can be filled. A negative value removes the limit.
+   */
+  void PointGapFillingFilter::SetMaxInterpolationGap(int gap)
+  {
+    if (this->m_MaxInterpolationGap == gap)
+      return;
+    this->m_MaxInterpolationGap = gap;
+    this->Modified();
+  };
+  
+  /**
+   * Appends the labels of the markers composing a rigid body. These definitions are only used by the method RigidBody.
+   */
+  void PointGapFillingFilter::AppendRigidBody(const std::list<std::string>& labels)
+  {
+    this->m_RigidBodies.push_back(labels);
+    this->Modified();
+  };
+  
+  /**
+   * Sets the definitions of the rigid bodies. These definitions are only used by the method RigidBody.
+   */
+  void PointGapFillingFilter::SetRigidBodies(const std::list< std::list<std::string> >& bodies)
+  {
+    if (this->m_RigidBodies == bodies)
+      return;
+    this->m_RigidBodies = bodies;
+    this->Modified();
+  };
+  
+  /**
+   * @fn const std::list< std::list<std::string> >& PointGapFillingFilter::GetRigidBodies() const
+   * Returns the definitions of the rigid bodies.
+   */
+  
+  /**
+   * @fn int PointGapFillingFilter::GetThreadNumber() const
+   * Returns the number of threads used to process the points. 0 means the number of processors.
+   */
+  
+  /**
+   * Sets the number of threads used to process the points. A value lower or equal to 0 uses the number of processors.
+   */
+  void PointGapFillingFilter::SetThreadNumber(int num)
+  {
+    if (num < 0)
+      num = 0;
+    if (this->m_ThreadNumber == num)
+      return;
+    this->m_ThreadNumber = num;
+    this->Modified();
+  };
+  
+  /**
+   * Constructor. Sets the number of inputs and outputs to 1.
+   * By default, the method is set to PCHIP and the maximum interpolation gap to 10 frames (same default value than in an acquisition).
+   */
+  PointGapFillingFilter::PointGapFillingFilter()
+  : ProcessObject(), m_RigidBodies()
+  {
+    this->SetInputNumber(1);
+    this->SetOutputNumber(1);
+    this->m_Method = PCHIP;
+    this->m_MaxInterpolationGap = 10;
+    this->m_ThreadNumber = 0;
+  };
+
+  /**
+   * @fn PointCollection::Pointer PointGapFillingFilter::GetInput(int idx)
+   * Returns the input at the index @a idx.
+   */
+  
+  /**
+   * @fn PointCollection::Pointer PointGapFillingFilter::GetOutput(int idx)
+   * Returns the output at the index @a idx.
+   */
+  
+  /**
+   * Creates a PointCollection:Pointer object and return it as a DataObject::Pointer.
+   */
+  DataObject::Pointer PointGapFillingFilter::MakeOutput(int /* idx */)
+  {
+    return PointCollection::New();
+  };
+  
+  // ----------------------------------------------------------------------- //
+  
+  struct PointGap_p
+  {
+    PointGap_p(int s, int l) : Start(s), Length(l) {};
+    int Start;
+    int Length;
+  };
+  
+  /*
+   * Detects the gaps from the residuals. The transitions between the valid and invalid frames 
+   * are computed in one pass over the whole vector. Only the transitions are then scanned.
+   */
+  static void _btk_detect_gaps(std::vector<PointGap_p>* gaps, const Point::Residuals& res)
+  {
+    typedef Eigen::Array<int,Eigen::Dynamic,1> Mask;
+    int num = static_cast<int>(res.rows());
+    Mask occluded = Mask::Zero(num+2);
+    occluded.segment(1,num) = (res.array() < 0.0).cast<int>();
+    Mask edges = occluded.tail(num+1) - occluded.head(num+1);
+    int start = -1;
+    for (int i = 0 ; i <= num ; ++i)
+    {
+      if (edges.coeff(i) == 1)
+        start = i;
+      else if (edges.coeff(i) == -1)
+        gaps->push_back(PointGap_p(start, i - start));
+    }
+  };
+  
+  /*
+   * Compute the frame associated with three donors. Returns false if the donors are aligned.
+   */
+  static bool _btk_rigid_frame(Eigen::Matrix3d* R, const Eigen::Vector3d& p0, const Eigen::Vector3d& p1, const Eigen::Vector3d& p2)
+  {
+    Eigen::Vector3d u = p1 - p0;
+    Eigen::Vector3d w = u.cross(p2 - p0);
+    double nu = u.norm(), nw = w.norm();
+    if ((nu <= std::numeric_limits<double>::epsilon()) || (nw <= std::numeric_limits<double>::epsilon()))
+      return false;
+    u /= nu;
+    w /= nw;
+    R->col(0) = u;
+    R->col(1) = w.cross(u);
+    R->col(2) = w;
+    return true;
+  };
+  
+  class PointGapFillingTask_p : public parallel_task_p
+  {
+  public:
+    PointGapFillingTask_p(const std::vector<Point::Pointer>* in, std::vector<Point::Pointer>* out, const std::vector< std::vector<int> >* donors, PointGapFillingFilter::Method method, int maxGap)
+    : mp_Inputs(in), mp_Outputs(out), mp_Donors(donors), m_Method(method), m_MaxGap(maxGap), m_Skipped(in->size(), 0)
+    {};
+    
+    virtual void Run(int idx)
+    {
+      const Point* in = (*this->mp_Inputs)[idx].get();
+      Point* out = (*this->mp_Outputs)[idx].get();
+      if (in->GetFrameNumber() == 0)
+        return;
+      std::vector<PointGap_p> gaps;
+      _btk_detect_gaps(&gaps, in->GetResiduals());
+      if (gaps.empty())
+        return;
+      if (this->m_Method == PointGapFillingFilter::RigidBody)
+        this->FillRigidBody(idx, in, out, gaps);
+      else
+        this->Interpolate(idx, in, out, gaps);
+    };
+    
+    bool IsSkipped(int idx) const {return this->m_Skipped[idx] != 0;};
+    
+  private:
+    bool Fillable(const PointGap_p& gap, int num, bool bracketed) const
+    {
+      if ((this->m_MaxGap >= 0) && (gap.Length > this->m_MaxGap))
+        return false;
+      if (bracketed && ((gap.Start == 0) || (gap.Start + gap.Length == num)))
+        return false;
+      return true;
+    };
+    
+    void Interpolate(int idx, const Point* in, Point* out, const std::vector<PointGap_p>& gaps)
+    {
+      typedef Eigen::Matrix<double,Eigen::Dynamic,1> Vector;
+      typedef Eigen::Matrix<double,Eigen::Dynamic,3> Matrix;
+      int num = in->GetFrameNumber();
+      int numToFill = 0, numOccluded = 0;
+      for (size_t i = 0 ; i < gaps.size() ; ++i)
+      {
+        numOccluded += gaps[i].Length;
+        if (this->Fillable(gaps[i], num, true))
+          numToFill += gaps[i].Length;
+      }
+      if (numToFill == 0)
+        return;
+      int numValid = num - numOccluded;
+      PointGapFillingFilter::Method method = this->m_Method;
+      if ((method != PointGapFillingFilter::Linear) && (numValid < 3))
+        method = PointGapFillingFilter::Linear;
+      if (numValid < 2)
+      {
+        this->m_Skipped[idx] = 1;
+        return;
+      }
+      // Knots: all the valid frames
+      Vector x(numValid);
+      Matrix y(numValid, 3);
+      Vector xi(numToFill);
+      const Point::Values& values = in->GetValues();
+      int inc = 0, prev = 0;
+      for (size_t i = 0 ; i <= gaps.size() ; ++i)
+      {
+        int end = (i < gaps.size()) ? gaps[i].Start : num;
+        int len = end - prev;
+        if (len > 0)
+        {
+          x.segment(inc, len) = Vector::LinSpaced(len, static_cast<double>(prev), static_cast<double>(end-1));
+          y.middleRows(inc, len) = values.middleRows(prev, len);
+          inc += len;
+        }
+        if (i < gaps.size())
+          prev = gaps[i].Start + gaps[i].Length;
+      }
+      inc = 0;
+      for (size_t i = 0 ; i < gaps.size() ; ++i)
+      {
+        if (!this->Fillable(gaps[i], num, true))
+          continue;
+        xi.segment(inc, gaps[i].Length) = Vector::LinSpaced(gaps[i].Length, static_cast<double>(gaps[i].Start), static_cast<double>(gaps[i].Start + gaps[i].Length - 1));
+        inc += gaps[i].Length;
+      }
+      // Interpolation of the three coordinates with a single knot search.
+      Matrix yi;
+      btkEigen::Interp1_knots<Vector> knots(x, xi);
+      if (method == PointGapFillingFilter::Linear)
+        btkEigen::interp1().linear(&yi, knots, y);
+      else if (method == PointGapFillingFilter::PCHIP)
+        btkEigen::interp1().pchip(&yi, knots, y);
+      else
+        btkEigen::interp1().spline(&yi, knots, y);
+      inc = 0;
+      for (size_t i = 0 ; i < gaps.size() ; ++i)
+      {
+        if (!this->Fillable(gaps[i], num, true))
+          continue;
+        out->GetValues().middleRows(gaps[i].Start, gaps[i].Length) = yi.middleRows(inc, gaps[i].Length);
+        out->GetResiduals().segment(gaps[i].Start, gaps[i].Length).setZero();
+        inc += gaps[i].Length;
+      }
+    };
+    
+    bool Visible(int idx, int start, int len) const
+    {
+      const Point* p = (*this->mp_Inputs)[idx].get();
+      if ((start < 0) || (start + len > p->GetFrameNumber()))
+        return false;
+      return (p->GetResiduals().segment(start, len).array() >= 0.0).all();
+    };
+    
+    bool SelectDonors(int* d, const std::vector<int>& candidates, const PointGap_p& gap, int ref1, int ref2) const
+    {
+      int found = 0;
+      for (size_t j = 0 ; (j < candidates.size()) && (found < 3) ; ++j)
+      {
+        int c = candidates[j];
+        if (this->Visible(c, gap.Start, gap.Length)
+            && ((ref1 < 0) || this->Visible(c, ref1, 1))
+            && ((ref2 < 0) || this->Visible(c, ref2, 1)))
+          d[found++] = c;
+      }
+      return (found == 3);
+    };
+    
+    void FillRigidBody(int idx, const Point* in, Point* out, const std::vector<PointGap_p>& gaps)
+    {
+      const std::vector<int>& candidates = (*this->mp_Donors)[idx];
+      if (candidates.size() < 3)
+      {
+        this->m_Skipped[idx] = 1;
+        return;
+      }
+      int num = in->GetFrameNumber();
+      for (size_t i = 0 ; i < gaps.size() ; ++i)
+      {
+        const PointGap_p& gap = gaps[i];
+        if (!this->Fillable(gap, num, false))
+          continue;
+        int before = gap.Start - 1, after = gap.Start + gap.Length;
+        bool useBefore = (before >= 0), useAfter = (after < num);
+        // Three donors visible during the gap and at the reference frame(s)
+        int d[3];
+        if (!(useBefore && useAfter && this->SelectDonors(d, candidates, gap, before, after)))
+        {
+          if (useBefore && this->SelectDonors(d, candidates, gap, before, -1))
+            useAfter = false;
+          else if (useAfter && this->SelectDonors(d, candidates, gap, -1, after))
+            useBefore = false;
+          else
+            continue;
+        }
+        const Point::Values* dv[3] = {&((*this->mp_Inputs)[d[0]]->GetValues()), &((*this->mp_Inputs)[d[1]]->GetValues()), &((*this->mp_Inputs)[d[2]]->GetValues())};
+        Eigen::Matrix3d R;
+        Eigen::Vector3d localBefore, localAfter;
+        if (useBefore)
+        {
+          if (!_btk_rigid_frame(&R, dv[0]->row(before).transpose(), dv[1]->row(before).transpose(), dv[2]->row(before).transpose()))
+            continue;
+          localBefore = R.transpose() * (in->GetValues().row(before) - dv[0]->row(before)).transpose();
+        }
+        if (useAfter)
+        {
+          if (!_btk_rigid_frame(&R, dv[0]->row(after).transpose(), dv[1]->row(after).transpose(), dv[2]->row(after).transpose()))
+            continue;
+          localAfter = R.transpose() * (in->GetValues().row(after) - dv[0]->row(after)).transpose();
+        }
+        for (int k = 0 ; k < gap.Length ; ++k)
+        {
+          int f = gap.Start + k;
+          if (!_btk_rigid_frame(&R, dv[0]->row(f).transpose(), dv[1]->row(f).transpose(), dv[2]->row(f).transpose()))
+            continue;
+          Eigen::Vector3d local;
+          if (useBefore && useAfter)
+          {
+            double w = static_cast<double>(k + 1) / static_cast<double>(gap.Length + 1);
+            local = (1.0 - w) * localBefore + w * localAfter;
+          }
+          else
+            local = useBefore ? localBefore : localAfter;
+          out->GetValues().row(f) = (dv[0]->row(f).transpose() + R * local).transpose();
+          out->GetResiduals().coeffRef(f) = 0.0;
+        }
+      }
+    };
+    
+    const std::vector<Point::Pointer>* mp_Inputs;
+    std::vector<Point::Pointer>* mp_Outputs;
+    const std::vector< std::vector<int> >* mp_Donors;
+    PointGapFillingFilter::Method m_Method;
+    int m_MaxGap;
+    std::vector<int> m_Skipped; // Each thread writes only its own index
+  };
+  
+  /**
+   * Fill the gaps of each point.
+   */
+  void PointGapFillingFilter::GenerateData()
+  {
+    PointCollection::Pointer output = this->GetOutput();
+    output->Clear();
+    PointCollection::Pointer input = this->GetInput();
+    if (!input)
+      return;
+    // The copies are done before the parallel section.
+    std::vector<Point::Pointer> inputs, outputs;
+    inputs.reserve(input->GetItemNumber());
+    outputs.reserve(input->GetItemNumber());
+    for (PointCollection::ConstIterator it = input->Begin() ; it != input->End() ; ++it)
+    {
+      inputs.push_back(*it);
+      outputs.push_back((*it)->Clone());
+    }
+    // Donors for the rigid body method
+    std::vector< std::vector<int> > donors(inputs.size());
+    if (this->m_Method == RigidBody)
+    {
+      for (std::list< std::list<std::string> >::const_iterator itB = this->m_RigidBodies.begin() ; itB != this->m_RigidBodies.end() ; ++itB)
+      {
+        std::vector<int> members;
+        for (std::list<std::string>::const_iterator itL = itB->begin() ; itL != itB->end() ; ++itL)
+        {
+          for (size_t i = 0 ; i < inputs.size() ; ++i)
+          {
+            if (inputs[i]->GetLabel().compare(*itL) == 0)
+            {
+              members.push_back(static_cast<int>(i));
+              break;
+            }
+          }
+        }
+        for (size_t i = 0 ; i < members.size() ; ++i)
+        {
+          for (size_t j = 0 ; j < members.size() ; ++j)
+          {
+            if ((i != j) && (inputs[members[j]]->GetFrameNumber() == inputs[members[i]]->GetFrameNumber()))
+              donors[members[i]].push_back(members[j]);
+          }
+        }
+      }
+    }
+    PointGapFillingTask_p task(&inputs, &outputs, &donors, this->m_Method, this->m_MaxInterpolationGap);
+    if (!parallel_for_p(static_cast<int>(inputs.size()), &task, this->m_ThreadNumber))
+      btkErrorMacro("An error occurred during the filling of the gaps. Some points may not be filled.");
+    for (size_t i = 0 ; i < outputs.size() ; ++i)
+    {
+      if (task.IsSkipped(static_cast<int>(i)))
+      {
+        if (this->m_Method == RigidBody)
+        {
+          btkWarningMacro("Not enough markers in a rigid body to fill the gaps of the point '" + outputs[i]->GetLabel() + "'.");
+        }
+        else
+        {
+          btkWarningMacro("Not enough valid frames to fill the gaps of the point '" + outputs[i]->GetLabel() + "'.");
+        }
+      }
+      output->InsertItem(outputs[i]);
+    }
+  };
+};
@@ -0,0 +1,101 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __btkPointGapFillingFilter_h
+#define __btkPointGapFillingFilter_h
+
+#include "btkProcessObject.h"
+#include "btkPointCollection.h"
+
+#include <list>
+#include <string>
+
+namespace btk
+{
+  class PointGapFillingFilter : public ProcessObject
+  {
+  public:
+    typedef enum {Linear = 0, PCHIP, Spline, RigidBody} Method;
+    
+    typedef btkSharedPtr<PointGapFillingFilter> Pointer;
+    typedef btkSharedPtr<const PointGapFillingFilter> ConstPointer;
+
+    static Pointer New() {return Pointer(new PointGapFillingFilter());};
+    
+    // ~PointGapFillingFilter(); // Implicit
+    
+    PointCollection::Pointer GetInput() {return this->GetInput(0);};
+    void SetInput(Point::Pointer input)
+    {
+      PointCollection::Pointer col = PointCollection::New();
+      col->InsertItem(input);
+      this->SetNthInput(0, col);
+    };
+    void SetInput(PointCollection::Pointer input) {this->SetNthInput(0, input);};
+    PointCollection::Pointer GetOutput() {return this->GetOutput(0);};
+    
+    Method GetMethod() const {return this->m_Method;};
+    BTK_BASICFILTERS_EXPORT void SetMethod(Method m);
+    
+    int GetMaxInterpolationGap() const {return this->m_MaxInterpolationGap;};
+    BTK_BASICFILTERS_EXPORT void SetMaxInterpolationGap(int gap);
+    
+    BTK_BASICFILTERS_EXPORT void AppendRigidBody(const std::list<std::string>& labels);
+    BTK_BASICFILTERS_EXPORT void SetRigidBodies(const std::list< std::list<std::string> >& bodies);
+    const std::list< std::list<std::string> >& GetRigidBodies() const {return this->m_RigidBodies;};
+    
+    int GetThreadNumber() const {return this->m_ThreadNumber;};
+    BTK_BASICFILTERS_EXPORT void SetThreadNumber(int num);
+    
+  protected:
+    BTK_BASICFILTERS_EXPORT PointGapFillingFilter();
+    
+    PointCollection::Pointer GetInput(int idx) {return static_pointer_cast<PointCollection>(this->GetNthInput(idx));};  
+    PointCollection::Pointer GetOutput(int idx) {return static_pointer_cast<PointCollection>(this->GetNthOutput(idx));};
+    BTK_BASICFILTERS_EXPORT virtual DataObject::Pointer MakeOutput(int idx);
+    BTK_BASICFILTERS_EXPORT virtual void GenerateData();
+    
+  private:
+    PointGapFillingFilter(const PointGapFillingFilter& ); // Not implemented.
+    PointGapFillingFilter& operator=(const PointGapFillingFilter& ); // Not implemented.
+    
+    Method m_Method;
+    int m_MaxInterpolationGap;
+    std::list< std::list<std::string> > m_RigidBodies;
+    int m_ThreadNumber;
+  };
+};
+
+#endif // __btkPointGapFillingFilter_h
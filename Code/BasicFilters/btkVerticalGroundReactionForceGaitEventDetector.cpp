@@ -34,6 +34,10 @@
  */
 
 #include "btkVerticalGroundReactionForceGaitEventDetector.h"
+#include "btkForcePlatformsExtractor.h"
+#include "btkGroundReactionWrenchFilter.h"
+#include "btkDownsampleFilter.h"
+#include "btkThread_p.h"
 
 namespace btk
 {
@@ -49,10 +53,29 @@ namespace btk
    *
    * To detect the heel strike and toe-off events you can set some options:
    *  - The threshold value used to known when an event occurred (see SetThresholdValue()).
+   *  - The hysteresis added to the threshold to recognize a contact (see SetHysteresisValue()).
    *  - The mapping between the force plates and the side (left, right, general)  of the events detected (see SetForceplateContextMapping()).
    *  - The region of interest where to detect the events (see SetRegionOfInterest()).
    *
    * The algorithm works as following: Based on the region of interest, the maximum is searched. If the maximum is higher than the threshold set, then the frame of the value on the left side of this maximum lower than the threshold is used to create a heel strike event. On the other hand, the value on the right side of the maximum lower than the threshold is used to create a toe-off event.
+   * If an hysteresis is set, the maximum must be higher than the sum of the threshold and the hysteresis to detect events.
+   * The scans use the vertical forces directly in the input (no copy) and are done by blocks of frames.
+   *
+   * For real-time processing, the incremental mode (see SetIncrementalMode()) can be used. In this mode, the detector 
+   * keeps for each wrench the number of frames already processed and if the foot is in contact with the force platform.
+   * At each update, only the frames appended to the wrenches are processed and the output contains only the events 
+   * newly detected. A heel strike is detected as soon as the vertical force exceeds the threshold plus the hysteresis (the 
+   * event is set to the last frame lower than the threshold) and a toe-off event as soon as the vertical force goes under the threshold. 
+   * Several steps on the same force platform are then detected. The region of interest is not used in this mode.
+   *
+   * To process a large number of trials, the methods DetectEvents() apply the settings of the detector to a list of
+   * wrench collections (or acquisitions) and run the detection in parallel. The pipeline of each trial is updated in its
+   * own thread, so the inputs must not share any data object.
+   * @code
+   * btk::VerticalGroundReactionForceGaitEventDetector::Pointer vgrfged = btk::VerticalGroundReactionForceGaitEventDetector::New();
+   * vgrfged->SetForceplateContextMapping(mapping);
+   * std::vector<btk::EventCollection::Pointer> events = vgrfged->DetectEvents(acquisitions); // One thread by processor
+   * @endcode
    *
    * @note: The design of this class is not perfect as it cannot be used in a pipeline without 
    * to update the part before to know some acquisition's information (first frame, sample frequency, subject's name).
@@ -104,6 +127,7 @@ namespace btk
     if (this->m_Threshold == threshold)
       return;
     this->m_Threshold = threshold;
+    this->m_ContactStates.clear();
     this->Modified();
   };
   
@@ -112,6 +136,30 @@ namespace btk
    * Returns the threshold used to detect gait events.
    */
   
+  /**
+   * Sets the hysteresis used to detect a contact. A contact is detected only if the vertical force exceeds the sum
+   * of the threshold and of the hysteresis. The contact finishes when the vertical force goes under the threshold.
+   * This is useful to not detect several contacts when the vertical force oscillates around the threshold.
+   */
+  void VerticalGroundReactionForceGaitEventDetector::SetHysteresisValue(int hysteresis)
+  {
+    if (this->m_Hysteresis == hysteresis)
+      return;
+    if (hysteresis < 0)
+    {
+      btkErrorMacro("The hysteresis cannot be negative.");
+      return;
+    }
+    this->m_Hysteresis = hysteresis;
+    this->m_ContactStates.clear();
+    this->Modified();
+  };
+  
+  /**
+   * @fn int VerticalGroundReactionForceGaitEventDetector::GetHysteresisValue() const
+   * Returns the hysteresis used to detect a contact.
+   */
+  
   /**
    * Sets the mapping between the given wrenches and the side of the detected events. If no mapping is given, then all the detected events will be set as "General" events.
    */
@@ -169,9 +217,26 @@ namespace btk
     subjectName = this->m_SubjectName;
   };
   
+  /**
+   * Sets the incremental mode. The states of the previous incremental updates are lost.
+   */
+  void VerticalGroundReactionForceGaitEventDetector::SetIncrementalMode(bool enabled)
+  {
+    if (this->m_IncrementalMode == enabled)
+      return;
+    this->m_IncrementalMode = enabled;
+    this->m_ContactStates.clear();
+    this->Modified();
+  };
+  
+  /**
+   * @fn bool VerticalGroundReactionForceGaitEventDetector::GetIncrementalMode() const
+   * Returns the state of the incremental mode.
+   */
+  
   /**
    * Constructor.
-   * By default, the treshold is set to 10 newtons and the algoritm search events on all the frames.
+   * By default, the treshold is set to 10 newtons, without hysteresis, and the algoritm search events on all the frames.
    */
   VerticalGroundReactionForceGaitEventDetector::VerticalGroundReactionForceGaitEventDetector()
   : ProcessObject(), m_ContextMapping()
@@ -179,10 +244,12 @@ namespace btk
     this->SetInputNumber(1);
     this->SetOutputNumber(1);
     this->m_Threshold = 10; // newtons
+    this->m_Hysteresis = 0; // newtons
     this->mp_ROI[0] = -1; this->mp_ROI[1] = -1;
     this->m_FirstFrame = 1;
     this->m_FrameRate = 0.0; // Hz
     this->m_SubjectName = "";
+    this->m_IncrementalMode = false;
   };
   
   /**
@@ -203,6 +270,24 @@ namespace btk
     return EventCollection::New();
   };
   
+  /**
+   * Sets @a parameters with the thresholds, the mapping, the region of interest and the acquisition's informations.
+   * The outputs cannot be cached when the incremental mode is activated.
+   */
+  bool VerticalGroundReactionForceGaitEventDetector::GetCacheParameters(std::string& parameters) const
+  {
+    if (this->m_IncrementalMode)
+      return false;
+    std::ostringstream oss;
+    oss.precision(17);
+    oss << this->m_Threshold << "\n" << this->m_Hysteresis << "\n" << this->mp_ROI[0] << "\n" << this->mp_ROI[1] 
+        << "\n" << this->m_FirstFrame << "\n" << this->m_FrameRate << "\n" << this->m_SubjectName << "\n" << this->m_ContextMapping.size();
+    for (size_t i = 0 ; i < this->m_ContextMapping.size() ; ++i)
+      oss << "\n" << this->m_ContextMapping[i];
+    parameters = oss.str();
+    return true;
+  };
+  
   /**
    * Algorithm used to detect events during the gait.
    */
@@ -218,16 +303,231 @@ namespace btk
     EventCollection::Pointer output = this->GetOutput();
     output->Clear();
     
+    if (this->m_IncrementalMode)
+    {
+      std::vector<std::string> mapping = this->m_ContextMapping;
+      int num = input->GetItemNumber();
+      if (static_cast<int>(mapping.size()) < num)
+      {
+        btkWarningMacro("The mapping between the force plates and the events' context is not complete. The missing are automatically set to the 'General' context.");
+        mapping.resize(num, "General");
+      }
+      this->DetectEventsIncrementally(input, output, mapping);
+      return;
+    }
+    this->DetectEvents(input, output, this->m_FirstFrame, this->m_FrameRate, true);
+  };
+  
+  class VerticalGroundReactionForceGaitEventDetectorTask_p : public parallel_task_p
+  {
+  public:
+    VerticalGroundReactionForceGaitEventDetectorTask_p(const VerticalGroundReactionForceGaitEventDetector* detector, std::vector<EventCollection::Pointer>* outputs)
+    : mp_Detector(detector), mp_Outputs(outputs)
+    {};
+    virtual ~VerticalGroundReactionForceGaitEventDetectorTask_p() {};
+    
+  protected:
+    void DetectEvents(int idx, WrenchCollection::Pointer input, int firstFrame, double frameRate)
+    {
+      this->mp_Detector->DetectEvents(input, (*this->mp_Outputs)[idx], firstFrame, frameRate, false);
+    };
+    
+  private:
+    const VerticalGroundReactionForceGaitEventDetector* mp_Detector;
+    std::vector<EventCollection::Pointer>* mp_Outputs;
+  };
+  
+  class VerticalGroundReactionForceGaitEventDetectorWrenchTask_p : public VerticalGroundReactionForceGaitEventDetectorTask_p
+  {
+  public:
+    VerticalGroundReactionForceGaitEventDetectorWrenchTask_p(const VerticalGroundReactionForceGaitEventDetector* detector, const std::vector<WrenchCollection::Pointer>* inputs, std::vector<EventCollection::Pointer>* outputs, int firstFrame, double frameRate)
+    : VerticalGroundReactionForceGaitEventDetectorTask_p(detector, outputs), mp_Inputs(inputs), m_FirstFrame(firstFrame), m_FrameRate(frameRate)
+    {};
+    
+    virtual void Run(int idx)
+    {
+      WrenchCollection::Pointer input = (*this->mp_Inputs)[idx];
+      if (!input)
+        return;
+      this->DetectEvents(idx, input, this->m_FirstFrame, this->m_FrameRate);
+    };
+    
+  private:
+    const std::vector<WrenchCollection::Pointer>* mp_Inputs;
+    int m_FirstFrame;
+    double m_FrameRate;
+  };
+  
+  class VerticalGroundReactionForceGaitEventDetectorAcquisitionTask_p : public VerticalGroundReactionForceGaitEventDetectorTask_p
+  {
+  public:
+    VerticalGroundReactionForceGaitEventDetectorAcquisitionTask_p(const VerticalGroundReactionForceGaitEventDetector* detector, const std::vector<Acquisition::Pointer>* inputs, std::vector<EventCollection::Pointer>* outputs)
+    : VerticalGroundReactionForceGaitEventDetectorTask_p(detector, outputs), mp_Inputs(inputs)
+    {};
+    
+    virtual void Run(int idx)
+    {
+      Acquisition::Pointer input = (*this->mp_Inputs)[idx];
+      if (!input)
+        return;
+      ForcePlatformsExtractor::Pointer pfe = ForcePlatformsExtractor::New();
+      pfe->SetInput(input);
+      GroundReactionWrenchFilter::Pointer grwf = GroundReactionWrenchFilter::New();
+      grwf->SetInput(pfe->GetOutput());
+      DownsampleFilter<WrenchCollection>::Pointer dswc = DownsampleFilter<WrenchCollection>::New();
+      dswc->SetInput(grwf->GetOutput());
+      dswc->SetUpDownRatio(input->GetNumberAnalogSamplePerFrame());
+      dswc->Update();
+      this->DetectEvents(idx, dswc->GetOutput(), input->GetFirstFrame(), input->GetPointFrequency());
+    };
+    
+  private:
+    const std::vector<Acquisition::Pointer>* mp_Inputs;
+  };
+  
+  /**
+   * Detects the events in each wrench collection of @a inputs using the settings of this detector (threshold, 
+   * hysteresis, mapping, region of interest and acquisition's information). The incremental mode is not used.
+   *
+   * The inputs are first updated one after the other (they can share the same pipeline), then processed in parallel 
+   * using @a threadNumber threads. If @a threadNumber is lower or equal to 0, then the number of processors is used. The warnings related to the mapping or the region of
+   * interest are not displayed. The returned vector contains one collection of events for each input (empty if the input is null).
+   */
+  std::vector<EventCollection::Pointer> VerticalGroundReactionForceGaitEventDetector::DetectEvents(const std::vector<WrenchCollection::Pointer>& inputs, int threadNumber) const
+  {
+    std::vector<EventCollection::Pointer> outputs(inputs.size());
+    for (size_t i = 0 ; i < outputs.size() ; ++i)
+    {
+      outputs[i] = EventCollection::New();
+      if (inputs[i])
+        inputs[i]->Update();
+    }
+    VerticalGroundReactionForceGaitEventDetectorWrenchTask_p task(this, &inputs, &outputs, this->m_FirstFrame, this->m_FrameRate);
+    if (!parallel_for_p(static_cast<int>(inputs.size()), &task, threadNumber))
+      btkErrorMacro("An error occurred during the detection of the events. Some collections may be incomplete.");
+    return outputs;
+  };
+  
+  /**
+   * Detects the events in each acquisition of @a inputs using the settings of this detector (threshold, 
+   * hysteresis, mapping and region of interest). The incremental mode is not used.
+   *
+   * For each acquisition, the ground reaction wrenches are computed (see the classes ForcePlatformsExtractor and 
+   * GroundReactionWrenchFilter) and downsampled to the point frequency. The first frame and the point frequency 
+   * are read in the acquisition, while the subject's name is the one set in this detector.
+   *
+   * The acquisitions are processed in parallel using @a threadNumber threads. If @a threadNumber is 
+   * lower or equal to 0, then the number of processors is used. The warnings related to the mapping or the region of
+   * interest are not displayed. The returned vector contains one collection of events for each input (empty if the input is null).
+   */
+  std::vector<EventCollection::Pointer> VerticalGroundReactionForceGaitEventDetector::DetectEvents(const std::vector<Acquisition::Pointer>& inputs, int threadNumber) const
+  {
+    std::vector<EventCollection::Pointer> outputs(inputs.size());
+    for (size_t i = 0 ; i < outputs.size() ; ++i)
+      outputs[i] = EventCollection::New();
+    VerticalGroundReactionForceGaitEventDetectorAcquisitionTask_p task(this, &inputs, &outputs);
+    if (!parallel_for_p(static_cast<int>(inputs.size()), &task, threadNumber))
+      btkErrorMacro("An error occurred during the detection of the events. Some collections may be incomplete.");
+    return outputs;
+  };
+  
+  // Size of the blocks used to scan the vertical forces.
+  static const int _btk_vgrf_block_size = 16;
+  
+  /*
+   * Returns the index of the first maximum of the values between @a lb and @a ub (included).
+   * The maximum is found by blocks to let the compiler vectorize the inner loop.
+   */
+  static int _btk_vgrf_argmax(const double* fz, int lb, int ub)
+  {
+    double m = fz[lb];
+    int i = lb;
+    for ( ; i + _btk_vgrf_block_size <= ub + 1 ; i += _btk_vgrf_block_size)
+    {
+      double bm = fz[i];
+      for (int k = 1 ; k < _btk_vgrf_block_size ; ++k)
+        bm = (fz[i+k] > bm) ? fz[i+k] : bm;
+      m = (bm > m) ? bm : m;
+    }
+    for ( ; i <= ub ; ++i)
+      m = (fz[i] > m) ? fz[i] : m;
+    for (i = lb ; i <= ub ; ++i)
+    {
+      if (fz[i] == m)
+        break;
+    }
+    return (i > ub) ? lb : i; // NaN values
+  };
+  
+  /*
+   * Returns the index of the first value lower than @a threshold between @a lb and @a ub (included) or -1.
+   * A block is tested entirely before to look for the exact index.
+   */
+  static int _btk_vgrf_find_first_below(const double* fz, int lb, int ub, double threshold)
+  {
+    int i = lb;
+    for ( ; i + _btk_vgrf_block_size <= ub + 1 ; i += _btk_vgrf_block_size)
+    {
+      int below = 0;
+      for (int k = 0 ; k < _btk_vgrf_block_size ; ++k)
+        below |= (fz[i+k] < threshold);
+      if (below)
+        break;
+    }
+    for ( ; i <= ub ; ++i)
+    {
+      if (fz[i] < threshold)
+        return i;
+    }
+    return -1;
+  };
+  
+  /*
+   * Returns the index of the last value lower than @a threshold between @a lb and @a ub (included) or -1.
+   */
+  static int _btk_vgrf_find_last_below(const double* fz, int lb, int ub, double threshold)
+  {
+    int i = ub;
+    for ( ; i - _btk_vgrf_block_size >= lb - 1 ; i -= _btk_vgrf_block_size)
+    {
+      int below = 0;
+      for (int k = 0 ; k < _btk_vgrf_block_size ; ++k)
+        below |= (fz[i-k] < threshold);
+      if (below)
+        break;
+    }
+    for ( ; i >= lb ; --i)
+    {
+      if (fz[i] < threshold)
+        return i;
+    }
+    return -1;
+  };
+  
+  /**
+   * Detects the events in the wrenches of @a input and inserts them in @a output. 
+   * The warnings are displayed only if @a verbose is true.
+   * This method does not modify the detector and can be called concurrently.
+   */
+  void VerticalGroundReactionForceGaitEventDetector::DetectEvents(WrenchCollection::Pointer input, EventCollection::Pointer output, int firstFrame, double frameRate, bool verbose) const
+  {
     std::vector<std::string> mapping = this->m_ContextMapping;
     int num = input->GetItemNumber();
     if (static_cast<int>(mapping.size()) < num)
     {
-      btkWarningMacro("The mapping between the force plates and the events' context is not complete. The missing are automatically set to the 'General' context.");
+      if (verbose)
+      {
+        btkWarningMacro("The mapping between the force plates and the events' context is not complete. The missing are automatically set to the 'General' context.");
+      }
       mapping.resize(num, "General");
     }
+    double t = 0.0;
+    if (frameRate > 0.0)
+      t = 1.0 / frameRate;
+    const double threshold = static_cast<double>(this->m_Threshold);
     int inc = 0;
-    bool warningNegativeLowerBoundDisplayed = false, warningExceededLowerBoundDisplayed = false,
-         warningNegativeUpperBoundDisplayed = false, warningExceededUpperBoundDisplayed = false;
+    bool warningNegativeLowerBoundDisplayed = !verbose, warningExceededLowerBoundDisplayed = !verbose,
+         warningNegativeUpperBoundDisplayed = !verbose, warningExceededUpperBoundDisplayed = !verbose;
     for (WrenchCollection::ConstIterator it = input->Begin() ; it != input->End() ; ++it)
     {
       int frameNumber = (*it)->GetForce()->GetFrameNumber();
@@ -236,67 +536,131 @@ namespace btk
       int ub = frameNumber-1;
       if (this->mp_ROI[0] != -1)
       {
-        if ((this->mp_ROI[0] < 0) && (!warningNegativeLowerBoundDisplayed))
+        if (this->mp_ROI[0] < 0)
         {
-          btkWarningMacro("The lower bound for the frames of interest was set to a negative value and is then reset to 0.");
-          warningNegativeLowerBoundDisplayed = true;
+          if (!warningNegativeLowerBoundDisplayed)
+          {
+            btkWarningMacro("The lower bound for the frames of interest was set to a negative value and is then reset to 0.");
+            warningNegativeLowerBoundDisplayed = true;
+          }
         }
-        else if ((this->mp_ROI[0] >= frameNumber) && (!warningExceededLowerBoundDisplayed))
+        else if (this->mp_ROI[0] >= frameNumber)
         {
-          btkWarningMacro("The lower bound for the frames of interest was set to a value exceeding the number of rows and is reset to 0.");
-          warningExceededLowerBoundDisplayed = true;
+          if (!warningExceededLowerBoundDisplayed)
+          {
+            btkWarningMacro("The lower bound for the frames of interest was set to a value exceeding the number of rows and is reset to 0.");
+            warningExceededLowerBoundDisplayed = true;
+          }
         }
         else
           lb = this->mp_ROI[0];
       }
       if (this->mp_ROI[1] != -1)
       {
-        if ((this->mp_ROI[1] < 0) && (!warningNegativeUpperBoundDisplayed))
+        if (this->mp_ROI[1] < 0)
         {
-          btkWarningMacro("The upper bound for the frames of interest was set to a negative value and is then reset to the greater index available.");
-          warningNegativeUpperBoundDisplayed = true;
+          if (!warningNegativeUpperBoundDisplayed)
+          {
+            btkWarningMacro("The upper bound for the frames of interest was set to a negative value and is then reset to the greater index available.");
+            warningNegativeUpperBoundDisplayed = true;
+          }
         }
-        else if ((this->mp_ROI[1] >= frameNumber) && (!warningExceededUpperBoundDisplayed))
+        else if (this->mp_ROI[1] >= frameNumber)
         {
-          btkWarningMacro("The upper bound for the frames of interest was set to a value exceeding the number of rows and is reset to the greater index available.");
-          warningExceededUpperBoundDisplayed = true;
+          if (!warningExceededUpperBoundDisplayed)
+          {
+            btkWarningMacro("The upper bound for the frames of interest was set to a value exceeding the number of rows and is reset to the greater index available.");
+            warningExceededUpperBoundDisplayed = true;
+          }
         }
         else
           ub = this->mp_ROI[1];
       }
+      if ((frameNumber == 0) || (lb > ub))
+      {
+        ++inc;
+        continue;
+      }
       // Extract the maximum
-      double t = 0.0;
-      if (this->m_FrameRate >= 0.0)
-        t = 1.0 / this->m_FrameRate;
-      int r = 0, c = 0, num = ub-lb;
-      Eigen::Matrix<double,Eigen::Dynamic,1> fz = (*it)->GetForce()->GetValues().col(2).block(lb,0,num+1,1);
-      if (fz.maxCoeff(&r, &c) > this->m_Threshold)
+      const double* fz = (*it)->GetForce()->GetValues().data() + 2 * frameNumber;
+      int r = _btk_vgrf_argmax(fz, lb, ub);
+      if (fz[r] > threshold + static_cast<double>(this->m_Hysteresis))
       {
-        int incr = r;
         // Heel Strike
-        while (incr >= 0)
+        int incr = _btk_vgrf_find_last_below(fz, lb, r, threshold);
+        if (incr != -1)
         {
-          if (fz.coeffRef(incr) < this->m_Threshold)
-          {
-            int frame = incr+lb+this->m_FirstFrame; // No need to remove 1 as 'incr' starts from 0
-            output->InsertItem(btk::Event::New("Foot Strike", frame*t, frame, mapping[inc], Event::Automatic | Event::FromForcePlatform, this->m_SubjectName, "The instant the heel strikes the ground", 1));
-            break;
-          }
-          --incr;
+          int frame = incr+firstFrame; // No need to remove 1 as 'incr' starts from 0
+          output->InsertItem(btk::Event::New("Foot Strike", frame*t, frame, mapping[inc], Event::Automatic | Event::FromForcePlatform, this->m_SubjectName, "The instant the heel strikes the ground", 1));
         }
         // Toe Off
-        incr = r;
-        while (incr <= num)
+        incr = _btk_vgrf_find_first_below(fz, r, ub, threshold);
+        if (incr != -1)
         {
-          if (fz.coeffRef(incr) < this->m_Threshold)
+          int frame = incr+firstFrame;
+          output->InsertItem(btk::Event::New("Foot Off", frame*t, frame, mapping[inc], Event::Automatic | Event::FromForcePlatform, this->m_SubjectName, "The instant the toe leaves the ground", 2));
+        }
+      }
+      ++inc;
+    }
+  };
+  
+  /**
+   * Detects the events only in the frames appended to the wrenches since the last update.
+   */
+  void VerticalGroundReactionForceGaitEventDetector::DetectEventsIncrementally(WrenchCollection::Pointer input, EventCollection::Pointer output, const std::vector<std::string>& mapping)
+  {
+    double t = 0.0;
+    if (this->m_FrameRate > 0.0)
+      t = 1.0 / this->m_FrameRate;
+    const double threshold = static_cast<double>(this->m_Threshold);
+    const double upperThreshold = threshold + static_cast<double>(this->m_Hysteresis);
+    int inc = 0;
+    for (WrenchCollection::ConstIterator it = input->Begin() ; it != input->End() ; ++it)
+    {
+      const Point::Values& values = (*it)->GetForce()->GetValues();
+      const int frameNumber = static_cast<int>(values.rows());
+      if (inc >= static_cast<int>(this->m_ContactStates.size()))
+      {
+        ContactState state = {0, false, -1};
+        this->m_ContactStates.push_back(state);
+      }
+      ContactState& state = this->m_ContactStates[inc];
+      // The wrench was shortened: the previous state cannot be used.
+      if (state.ProcessedFrameNumber > frameNumber)
+      {
+        state.ProcessedFrameNumber = 0;
+        state.Loaded = false;
+        state.LastUnloadedFrame = -1;
+      }
+      for (int i = state.ProcessedFrameNumber ; i < frameNumber ; ++i)
+      {
+        const double fz = values.coeff(i, 2);
+        if (!state.Loaded)
+        {
+          if (fz < threshold)
+            state.LastUnloadedFrame = i;
+          else if (fz > upperThreshold)
           {
-            int frame = incr+lb+this->m_FirstFrame;
-            output->InsertItem(btk::Event::New("Foot Off", frame*t, frame, mapping[inc], Event::Automatic | Event::FromForcePlatform, this->m_SubjectName, "The instant the toe leaves the ground", 2));
-            break;
+            state.Loaded = true;
+            // Heel Strike
+            if (state.LastUnloadedFrame != -1)
+            {
+              int frame = state.LastUnloadedFrame + this->m_FirstFrame;
+              output->InsertItem(btk::Event::New("Foot Strike", frame*t, frame, mapping[inc], Event::Automatic | Event::FromForcePlatform, this->m_SubjectName, "The instant the heel strikes the ground", 1));
+            }
           }
-          ++incr;
+        }
+        else if (fz < threshold)
+        {
+          state.Loaded = false;
+          state.LastUnloadedFrame = i;
+          // Toe Off
+          int frame = i + this->m_FirstFrame;
+          output->InsertItem(btk::Event::New("Foot Off", frame*t, frame, mapping[inc], Event::Automatic | Event::FromForcePlatform, this->m_SubjectName, "The instant the toe leaves the ground", 2));
         }
       }
+      state.ProcessedFrameNumber = frameNumber;
       ++inc;
     }
   };
@@ -39,12 +39,15 @@
 #include "btkProcessObject.h"
 #include "btkWrenchCollection.h"
 #include "btkEventCollection.h"
+#include "btkAcquisition.h"
 
 #include <vector>
 #include <string>
 
 namespace btk
 {
+  class VerticalGroundReactionForceGaitEventDetectorTask_p;
+  
   class VerticalGroundReactionForceGaitEventDetector : public ProcessObject
   {
   public:
@@ -68,6 +71,9 @@ namespace btk
     BTK_BASICFILTERS_EXPORT void SetThresholdValue(int threshold);
     int GetThresholdValue() const {return this->m_Threshold;};
     
+    BTK_BASICFILTERS_EXPORT void SetHysteresisValue(int hysteresis);
+    int GetHysteresisValue() const {return this->m_Hysteresis;};
+    
     BTK_BASICFILTERS_EXPORT void SetForceplateContextMapping(const std::vector<std::string>& mapping);
     const std::vector<std::string>& GetForceplateContextMapping() const {return this->m_ContextMapping;};
     
@@ -76,6 +82,12 @@ namespace btk
     
     BTK_BASICFILTERS_EXPORT void SetAcquisitionInformation(int firstFrame, double freq, const std::string& subjectName);
     BTK_BASICFILTERS_EXPORT void GetAcquisitionInformation(int& firstFrame, double& freq, std::string& subjectName);
+    
+    BTK_BASICFILTERS_EXPORT void SetIncrementalMode(bool enabled = false);
+    bool GetIncrementalMode() const {return this->m_IncrementalMode;};
+    
+    BTK_BASICFILTERS_EXPORT std::vector<EventCollection::Pointer> DetectEvents(const std::vector<WrenchCollection::Pointer>& inputs, int threadNumber = 0) const;
+    BTK_BASICFILTERS_EXPORT std::vector<EventCollection::Pointer> DetectEvents(const std::vector<Acquisition::Pointer>& inputs, int threadNumber = 0) const;
 
   protected:
     BTK_BASICFILTERS_EXPORT VerticalGroundReactionForceGaitEventDetector();
@@ -84,17 +96,33 @@ namespace btk
     EventCollection::Pointer GetOutput(int idx) {return static_pointer_cast<EventCollection>(this->GetNthOutput(idx));};
     BTK_BASICFILTERS_EXPORT virtual DataObject::Pointer MakeOutput(int idx);
     BTK_BASICFILTERS_EXPORT virtual void GenerateData();
+    BTK_BASICFILTERS_EXPORT virtual bool GetCacheParameters(std::string& parameters) const;
     
   private:
+    friend class VerticalGroundReactionForceGaitEventDetectorTask_p;
+    
+    struct ContactState
+    {
+      int ProcessedFrameNumber;
+      bool Loaded;
+      int LastUnloadedFrame;
+    };
+    
+    void DetectEvents(WrenchCollection::Pointer input, EventCollection::Pointer output, int firstFrame, double frameRate, bool verbose) const;
+    void DetectEventsIncrementally(WrenchCollection::Pointer input, EventCollection::Pointer output, const std::vector<std::string>& mapping);
+    
     VerticalGroundReactionForceGaitEventDetector(const VerticalGroundReactionForceGaitEventDetector& ); // Not implemented.
     VerticalGroundReactionForceGaitEventDetector& operator=(const VerticalGroundReactionForceGaitEventDetector& ); // Not implemented.
     
     int m_Threshold;
+    int m_Hysteresis;
     std::vector<std::string> m_ContextMapping;
     int mp_ROI[2];
     int m_FirstFrame;
     double m_FrameRate;
     std::string m_SubjectName;
+    bool m_IncrementalMode;
+    std::vector<ContactState> m_ContactStates;
   };
 };
 
@@ -35,7 +35,9 @@
 
 #include "btkWrenchDirectionAngleFilter.h"
 
-#include <Eigen/Geometry>
+#include <btkEigen/Core/VectorMath.h>
+
+#include <algorithm>
 
 namespace btk
 {
@@ -50,6 +52,10 @@ namespace btk
    *
    * The output angles are expressed in degrees and the range is between 0 and 360 degrees.
    * Then a shift from 360 to 0 is possible if the force turns around itself.
+   *
+   * The angles are computed by blocks of frames. By default, the function std::atan2 is used (accurate mode). 
+   * With the fast mode (see SetMode()), a polynomial approximation of the function atan2 (see btkEigen::atan2_fast())
+   * is used instead. Its maximum error is lower than 3e-6 degrees.
    * 
    * @ingroup BTKBasicFilters
    */
@@ -89,6 +95,32 @@ namespace btk
    * Gets the output created with this process.
    */
   
+  /**
+   * @var WrenchDirectionAngleFilter::Mode WrenchDirectionAngleFilter::Accurate
+   * The function std::atan2 is used to compute the angles.
+   */
+  
+  /**
+   * @var WrenchDirectionAngleFilter::Mode WrenchDirectionAngleFilter::Fast
+   * An approximation of the function atan2 is used to compute the angles (maximum error lower than 3e-6 degrees).
+   */
+  
+  /**
+   * @fn Mode WrenchDirectionAngleFilter::GetMode() const
+   * Returns the mode used to compute the angles.
+   */
+  
+  /**
+   * Sets the mode used to compute the angles.
+   */
+  void WrenchDirectionAngleFilter::SetMode(Mode mode)
+  {
+    if (this->m_Mode == mode)
+      return;
+    this->m_Mode = mode;
+    this->Modified();
+  };
+  
   /**
    * Constructor. Sets the number of inputs and outputs to 1.
    */
@@ -97,6 +129,7 @@ namespace btk
   {
     this->SetInputNumber(1);
     this->SetOutputNumber(1);
+    this->m_Mode = Accurate;
   };
 
   /**
@@ -126,23 +159,42 @@ namespace btk
     output->Clear();
     WrenchCollection::Pointer input = this->GetInput();
     const double radToDeg = 180.0 / M_PI;
+    const bool accurate = (this->m_Mode == Accurate);
+    const int blockSize = 256;
+    double fx[blockSize], fy[blockSize], fz[blockSize];
     if (input)
     {
       for (WrenchCollection::ConstIterator it = input->Begin() ; it != input->End() ; ++it)
       {
         int numFrames = (*it)->GetForce()->GetFrameNumber();
         Point::Pointer dirAngle = Point::New((*it)->GetPosition()->GetLabel() + ".DA", numFrames, Point::Angle);
-        for (int i = 0 ; i < numFrames ; ++i)
+        const double* F = (*it)->GetForce()->GetValues().data();
+        const double* res = (*it)->GetPosition()->GetResiduals().data();
+        double* DA = dirAngle->GetValues().data();
+        double* DAres = dirAngle->GetResiduals().data();
+        for (int b = 0 ; b < numFrames ; b += blockSize)
         {
-          if ((*it)->GetPosition()->GetResiduals().coeff(i) >= 0)
+          const int n = std::min(blockSize, numFrames - b);
+          for (int i = 0 ; i < n ; ++i)
           {
-            dirAngle->GetValues().coeffRef(i,0) = atan2(-(*it)->GetForce()->GetValues().coeff(i,2), -(*it)->GetForce()->GetValues().coeff(i,1)) * radToDeg + 180.0;
-            dirAngle->GetValues().coeffRef(i,1) = atan2(-(*it)->GetForce()->GetValues().coeff(i,2), -(*it)->GetForce()->GetValues().coeff(i,0)) * radToDeg + 180.0;
-            dirAngle->GetValues().coeffRef(i,2) = atan2(-(*it)->GetForce()->GetValues().coeff(i,1), -(*it)->GetForce()->GetValues().coeff(i,0)) * radToDeg + 180.0;
+            fx[i] = -F[b+i];
+            fy[i] = -F[b+i+numFrames];
+            fz[i] = -F[b+i+2*numFrames];
           }
-          else
+          double* dax = DA + b;
+          double* day = DA + b + numFrames;
+          double* daz = DA + b + 2 * numFrames;
+          btkEigen::vatan2(dax, fz, fy, n, accurate);
+          btkEigen::vatan2(day, fz, fx, n, accurate);
+          btkEigen::vatan2(daz, fy, fx, n, accurate);
+          // The angles are not computed for the frames without PWA
+          for (int i = 0 ; i < n ; ++i)
           {
-            dirAngle->GetResiduals().coeffRef(i) = -1.0;
+            const bool valid = (res[b+i] >= 0.0);
+            dax[i] = valid ? dax[i] * radToDeg + 180.0 : 0.0;
+            day[i] = valid ? day[i] * radToDeg + 180.0 : 0.0;
+            daz[i] = valid ? daz[i] * radToDeg + 180.0 : 0.0;
+            DAres[b+i] = valid ? 0.0 : -1.0;
           }
         }
         output->InsertItem(dirAngle);
@@ -150,4 +202,3 @@ namespace btk
     }
   };
 };
-
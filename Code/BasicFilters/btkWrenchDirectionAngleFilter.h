@@ -45,6 +45,8 @@ namespace btk
   class WrenchDirectionAngleFilter : public ProcessObject
   {
   public:
+    typedef enum {Accurate = 0, Fast} Mode;
+    
     typedef btkSharedPtr<WrenchDirectionAngleFilter> Pointer;
     typedef btkSharedPtr<const WrenchDirectionAngleFilter> ConstPointer;
 
@@ -62,6 +64,9 @@ namespace btk
     void SetInput(WrenchCollection::Pointer input) {this->SetNthInput(0, input);};
     PointCollection::Pointer GetOutput() {return this->GetOutput(0);};
     
+    Mode GetMode() const {return this->m_Mode;};
+    BTK_BASICFILTERS_EXPORT void SetMode(Mode mode);
+    
   protected:
     BTK_BASICFILTERS_EXPORT WrenchDirectionAngleFilter();
     
@@ -73,6 +78,8 @@ namespace btk
   private:
     WrenchDirectionAngleFilter(const WrenchDirectionAngleFilter& ); // Not implemented.
     WrenchDirectionAngleFilter& operator=(const WrenchDirectionAngleFilter& ); // Not implemented.
+    
+    Mode m_Mode;
   };
 };
 
@@ -37,8 +37,29 @@
 #include "btkException.h"
 #include "btkConvert.h"
 
+#include <algorithm>
+
 namespace btk
 {
+  // A measure can be recycled only if the acquisition is its only owner (as well as for its data).
+  template <class T>
+  static bool _btk_acquisition_is_recyclable(const typename T::Pointer& measure)
+  {
+    if (!measure.unique())
+      return false;
+    typename T::Data::Pointer data = measure->GetData();
+    return (data.get() == 0) || (data.use_count() == 2); // The measure and the local copy
+  };
+  
+  // Adapt the number of frames of a recycled measure and reset its values.
+  template <class T>
+  static void _btk_acquisition_reset_values(const typename T::Pointer& measure, int frameNumber)
+  {
+    measure->SetFrameNumber(frameNumber);
+    if (frameNumber > 0)
+      measure->GetValues().setZero();
+  };
+  
   /**
    * @class Acquisition btkAcquisition.h
    * @brief Contains the data related to a biomechanical acquisition.
@@ -915,7 +936,20 @@ namespace btk
     const int numPoints = this->GetPointNumber();
     for (int inc = numPoints ; inc < pointNumber ; ++inc)
     {
-      Point::Pointer pt = Point::New(this->m_PointFrameNumber);
+      Point::Pointer pt;
+      if (!this->m_RecycledPoints.empty())
+      {
+        pt = this->m_RecycledPoints.back();
+        this->m_RecycledPoints.pop_back();
+        pt->SetLabel("");
+        pt->SetDescription("");
+        pt->SetType(Point::Marker);
+        _btk_acquisition_reset_values<Point>(pt, this->m_PointFrameNumber);
+        if (this->m_PointFrameNumber > 0)
+          pt->GetResiduals().setZero();
+      }
+      else
+        pt = Point::New(this->m_PointFrameNumber);
       pt->SetParent(this);
       this->m_Points->InsertItem(pt);
     }
@@ -940,7 +974,21 @@ namespace btk
     const int numAnalogs = this->GetAnalogNumber();
     for (int inc = numAnalogs ; inc < analogNumber ; ++inc)
     {
-      Analog::Pointer pt = Analog::New(this->m_PointFrameNumber * this->m_AnalogSampleNumberPerPointFrame);
+      Analog::Pointer pt;
+      if (!this->m_RecycledAnalogs.empty())
+      {
+        pt = this->m_RecycledAnalogs.back();
+        this->m_RecycledAnalogs.pop_back();
+        pt->SetLabel("");
+        pt->SetDescription("");
+        pt->SetUnit("V");
+        pt->SetGain(Analog::Unknown);
+        pt->SetOffset(0.0);
+        pt->SetScale(1.0);
+        _btk_acquisition_reset_values<Analog>(pt, this->m_PointFrameNumber * this->m_AnalogSampleNumberPerPointFrame);
+      }
+      else
+        pt = Analog::New(this->m_PointFrameNumber * this->m_AnalogSampleNumberPerPointFrame);
       pt->SetParent(this);
       this->m_Analogs->InsertItem(pt);
     }
@@ -1030,9 +1078,30 @@ namespace btk
    *
    * To re-populate this acquisition, you need to re-use the Init() method 
    * to set the point and analog number and their frame number.
+   *
+   * If the recycling of the measures is enabled (see SetMeasureRecycling()), the points and analog channels
+   * which are not used elsewhere are kept to be reused by the methods Init(), Resize(), ResizePointNumber() and ResizeAnalogNumber().
    */
   void Acquisition::Reset()
   {
+    if (this->m_MeasureRecycling)
+    {
+      // The measures are stored in the reverse order as they are taken from the end.
+      size_t num = this->m_RecycledPoints.size();
+      for (PointIterator it = this->BeginPoint() ; it != this->EndPoint() ; ++it)
+      {
+        if (_btk_acquisition_is_recyclable<Point>(*it))
+          this->m_RecycledPoints.push_back(*it);
+      }
+      std::reverse(this->m_RecycledPoints.begin() + num, this->m_RecycledPoints.end());
+      num = this->m_RecycledAnalogs.size();
+      for (AnalogIterator it = this->BeginAnalog() ; it != this->EndAnalog() ; ++it)
+      {
+        if (_btk_acquisition_is_recyclable<Analog>(*it))
+          this->m_RecycledAnalogs.push_back(*it);
+      }
+      std::reverse(this->m_RecycledAnalogs.begin() + num, this->m_RecycledAnalogs.end());
+    }
     this->m_Events->SetItemNumber(0);
     this->m_Points->SetItemNumber(0);
     this->m_Analogs->SetItemNumber(0);
@@ -1055,6 +1124,34 @@ namespace btk
     this->Modified();
   };
 
+  /**
+   * @fn bool Acquisition::GetMeasureRecycling() const
+   * Returns true if the points and analog channels removed by the method Reset() are reused.
+   */
+  
+  /**
+   * Enable/disable the recycling of the measures. When enabled, the points and analog channels removed by 
+   * the method Reset() are kept (if they are not used by another object) and reused when new measures are
+   * created by the methods Init(), Resize(), ResizePointNumber() and ResizeAnalogNumber(). 
+   * The reused measures are reset (no label, no description, default type or analog settings, values set to 0) 
+   * and only their number of frames is adapted if necessary.
+   *
+   * This mode is used by the AcquisitionFileReader to refill its output in place (see AcquisitionFileReader::SetOutputRecycling()).
+   * As the readers start by resetting their output, the objects and buffers of the previous file are reused 
+   * when the new file has the same layout. Disabling this mode releases the kept measures.
+   */
+  void Acquisition::SetMeasureRecycling(bool enabled)
+  {
+    if (this->m_MeasureRecycling == enabled)
+      return;
+    this->m_MeasureRecycling = enabled;
+    if (!enabled)
+    {
+      this->m_RecycledPoints.clear();
+      this->m_RecycledAnalogs.clear();
+    }
+  };
+  
   /**
    * @fn double Acquisition::GetDuration() const
    * Returns the duration of the acquisition.
@@ -1270,6 +1367,7 @@ namespace btk
     this->m_Units[Point::Scalar] = "mm";
     // this->m_Units[Point::Reaction] = "";
     this->m_MaxInterpolationGap = 10;
+    this->m_MeasureRecycling = false;
   };
   
   /**
@@ -1324,5 +1422,6 @@ namespace btk
     this->m_AnalogSampleNumberPerPointFrame = toCopy.m_AnalogSampleNumberPerPointFrame;
     this->m_AnalogResolution = toCopy.m_AnalogResolution;
     this->m_MaxInterpolationGap = toCopy.m_MaxInterpolationGap;
+    this->m_MeasureRecycling = toCopy.m_MeasureRecycling;
   };
 }
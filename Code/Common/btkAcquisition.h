@@ -156,6 +156,8 @@ namespace btk
     BTK_COMMON_EXPORT void ResizeFrameNumber(int frameNumber);
     BTK_COMMON_EXPORT void ResizeFrameNumberFromEnd(int frameNumber);
     BTK_COMMON_EXPORT void Reset();
+    bool GetMeasureRecycling() const {return this->m_MeasureRecycling;};
+    BTK_COMMON_EXPORT void SetMeasureRecycling(bool enabled);
     double GetDuration() const {return ((this->m_PointFrequency == 0) ? 0 : 1 / this->m_PointFrequency * this->m_PointFrameNumber);};
     int GetFirstFrame() const {return this->m_FirstFrame;};
     BTK_COMMON_EXPORT void SetFirstFrame(int num, bool adaptEvents=false);
@@ -200,6 +202,9 @@ namespace btk
     AnalogResolution m_AnalogResolution;
     std::vector<std::string> m_Units;
     int m_MaxInterpolationGap;
+    bool m_MeasureRecycling;
+    std::vector<Point::Pointer> m_RecycledPoints;
+    std::vector<Analog::Pointer> m_RecycledAnalogs;
   };
 };
 
@@ -34,6 +34,9 @@
  */
 
 #include "btkAnalog.h"
+#include "btkObjectPool.h"
+
+#include <typeinfo>
 
 namespace btk
 {
@@ -169,6 +172,22 @@ namespace btk
    * @fn virtual Analog::~Analog()
    * Empty destructor.
    */
+  
+  /**
+   * Allocate the memory of a Analog object from the object pool (see ObjectPool::Allocate()).
+   */
+  void* Analog::operator new(size_t size)
+  {
+    return ObjectPool::Allocate(size);
+  };
+  
+  /**
+   * Release the memory of a Analog object in the object pool (see ObjectPool::Deallocate()).
+   */
+  void Analog::operator delete(void* ptr, size_t size)
+  {
+    ObjectPool::Deallocate(ptr, size);
+  };
 
   /**
    * @fn const std::string& Analog::GetUnit() const
@@ -349,9 +368,42 @@ namespace btk
    */
   
   /**
-   * @fn static Pointer MeasureTraits<Analog>::Data::New(int frameNumber)
    * Creates a smart pointer associated with a MeasureTraits<Analog>::Data object.
+   *
+   * When the object pool is enabled (see ObjectPool), a released data with the same number of frames is reused
+   * with its buffers (the values are reset to 0) and the created data will be kept in the pool once released.
    */
+  MeasureTraits<Analog>::Data::Pointer MeasureTraits<Analog>::Data::New(int frameNumber)
+  {
+    Data* data = static_cast<Data*>(ObjectPool::Take(typeid(Data), static_cast<size_t>(frameNumber)));
+    if (data != 0)
+    {
+      data->m_Values.setZero();
+    }
+    else
+      data = new Data(frameNumber);
+    return Pointer(data, &Data::Recycle);
+  };
+  
+  /*
+   * Deleter used by the smart pointers created by the method New(). The data is kept in the object pool if possible.
+   */
+  void MeasureTraits<Analog>::Data::Recycle(Data* data)
+  {
+    if (ObjectPool::IsEnabled())
+    {
+      data->SetParent(0);
+      size_t size = sizeof(Data) + (data->m_Values.size()) * sizeof(double);
+      if (ObjectPool::Store(data, typeid(Data), static_cast<size_t>(data->m_Values.rows()), size, &Data::Delete))
+        return;
+    }
+    delete data;
+  };
+  
+  void MeasureTraits<Analog>::Data::Delete(void* data)
+  {
+    delete static_cast<Data*>(data);
+  };
   
   /**
    * @fn void MeasureTraits<Analog>::Data::Resize(int frameNumber);
@@ -58,7 +58,7 @@ namespace btk
       typedef btkSharedPtr<const Data> ConstPointer;
       typedef btkNullPtr<Data> NullPointer;
       
-      static Pointer New(int frameNumber) {return Pointer(new Data(frameNumber));};
+      BTK_COMMON_EXPORT static Pointer New(int frameNumber);
       
       static NullPointer Null() {return NullPointer();}; 
       
@@ -70,6 +70,9 @@ namespace btk
       Data(int frameNumber) : MeasureData<Analog>(frameNumber) {};
       Data(const Data& toCopy) : MeasureData<Analog>(toCopy) {};
       Data& operator=(const Data& ); // Not implemented.
+      
+      BTK_COMMON_EXPORT static void Recycle(Data* data);
+      static void Delete(void* data);
     };
   };
   
@@ -93,6 +96,9 @@ namespace btk
 
     static NullPointer Null() {return NullPointer();}; 
     
+    BTK_COMMON_EXPORT static void* operator new(size_t size);
+    BTK_COMMON_EXPORT static void operator delete(void* ptr, size_t size);
+    
     virtual ~Analog() {};
     
     const std::string& GetUnit() const {return this->m_Unit;};
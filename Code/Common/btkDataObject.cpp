@@ -36,9 +36,62 @@
 #include "btkDataObject.h"
 #include "btkProcessObject.h"
 #include "btkLogger.h"
+#include "btkCriticalSection_p.h"
 
 namespace btk
 {
+  // The links between the parents and their children are protected by a pool of locks selected from the address 
+  // of the objects. Processes run concurrently (see PipelineExecutor) can pass the same objects to their outputs
+  // and then relink them. Only the objects sharing a lock are serialized.
+  static const int _btk_data_object_links_lock_number = 61;
+  
+  static critical_section_p* _btk_data_object_links_locks()
+  {
+    static critical_section_p locks[_btk_data_object_links_lock_number];
+    return locks;
+  };
+  
+  class data_object_links_lock_p
+  {
+  public:
+    data_object_links_lock_p(const DataObject* obj1, const DataObject* obj2, const DataObject* obj3)
+    {
+      const DataObject* objects[3] = {obj1, obj2, obj3};
+      this->m_Number = 0;
+      for (int i = 0 ; i < 3 ; ++i)
+      {
+        if (objects[i] == 0)
+          continue;
+        int idx = static_cast<int>((reinterpret_cast<size_t>(objects[i]) / sizeof(void*)) % _btk_data_object_links_lock_number);
+        // Sorted insertion without duplicate to always lock in the same order.
+        bool found = false;
+        for (int j = 0 ; !found && (j < this->m_Number) ; ++j)
+          found = (this->m_Indices[j] == idx);
+        if (found)
+          continue;
+        int j = this->m_Number++;
+        while ((j > 0) && (this->m_Indices[j-1] > idx))
+        {
+          this->m_Indices[j] = this->m_Indices[j-1];
+          --j;
+        }
+        this->m_Indices[j] = idx;
+      }
+      critical_section_p* locks = _btk_data_object_links_locks();
+      for (int i = 0 ; i < this->m_Number ; ++i)
+        locks[this->m_Indices[i]].Lock();
+    };
+    ~data_object_links_lock_p()
+    {
+      critical_section_p* locks = _btk_data_object_links_locks();
+      for (int i = this->m_Number - 1 ; i >= 0 ; --i)
+        locks[this->m_Indices[i]].Unlock();
+    };
+  private:
+    int m_Indices[3];
+    int m_Number;
+  };
+  
   /**
    * @class DataObject btkDataObject.h
    * @brief Input and output entry for processes in pipelines.
@@ -98,8 +151,18 @@ namespace btk
       btkErrorMacro("Impossible to set itself as its parent.");
       return;
     }
-    if (this->mp_Parent != 0) this->mp_Parent->RemoveChild(this);
-    if (parent != 0) parent->AddChild(this);
+    for (;;)
+    {
+      DataObject* oldParent = this->mp_Parent;
+      if (parent == oldParent)
+        return;
+      data_object_links_lock_p lock(this, oldParent, parent);
+      if (this->mp_Parent != oldParent) // Relinked concurrently
+        continue;
+      if (oldParent != 0) oldParent->RemoveChild(this);
+      if (parent != 0) parent->AddChild(this);
+      break;
+    }
     this->Modified();
   };
   
@@ -128,24 +191,81 @@ namespace btk
    */
   DataObject::~DataObject()
   {
-    if (this->mp_Parent != 0)
-      this->mp_Parent->RemoveChild(this);
-    for (std::list<DataObject*>::iterator it = this->m_Children.begin() ; it != this->m_Children.end() ; ++it)
-      (*it)->mp_Parent = 0;
-    this->m_Children.clear();
+    if ((this->mp_Parent == 0) && this->m_Children.empty())
+      return;
+    for (;;)
+    {
+      DataObject* oldParent = this->mp_Parent;
+      data_object_links_lock_p lock(this, oldParent, 0);
+      if (this->mp_Parent != oldParent) // Relinked concurrently
+        continue;
+      if (oldParent != 0)
+        oldParent->RemoveChild(this);
+      for (std::list<DataObject*>::iterator it = this->m_Children.begin() ; it != this->m_Children.end() ; ++it)
+        (*it)->mp_Parent = 0;
+      this->m_Children.clear();
+      break;
+    }
   };
   
   /**
    * Tells to its parent that this DataObject has been modified.
    * This method has to be called each time that the DataObject is modified.
+   *
+   * The timestamps of this object and of its ancestors are reserved at once from the global counter. 
+   * The propagation stops at the first ancestor with a deferred modification (see BeginModification()).
    */
   void DataObject::Modified()
   {
-    this->Object::Modified();
-    if (this->mp_Parent != 0)
-      this->mp_Parent->Modified();
+    if (this->m_ModificationDeferral != 0)
+    {
+      this->m_ModificationPending = true;
+      return;
+    }
+    int num = 1;
+    for (DataObject* parent = this->mp_Parent ; (parent != 0) && (parent->m_ModificationDeferral == 0) ; parent = parent->mp_Parent)
+      ++num;
+    unsigned long int ts = Object::ReserveTimestamps(num);
+    this->RaiseTimestamp(ts);
+    for (DataObject* parent = this->mp_Parent ; parent != 0 ; parent = parent->mp_Parent)
+    {
+      if (parent->m_ModificationDeferral != 0)
+      {
+        parent->m_ModificationPending = true;
+        break;
+      }
+      parent->RaiseTimestamp(++ts);
+    }
+  };
+  
+  /**
+   * @fn void DataObject::BeginModification()
+   * Defers the modification of this object and the propagation of the modifications of its children.
+   * Bulk edits (for example, the modification of every point of an acquisition) between this method
+   * and EndModification() set this object as modified only once. The calls can be nested.
+   * The children are still set as modified. These methods must be called by the thread doing the edits.
+   */
+  
+  /**
+   * Ends a deferred modification started with BeginModification(). If the object or one of its 
+   * children was modified meanwhile, the object is set as modified.
+   */
+  void DataObject::EndModification()
+  {
+    if (this->m_ModificationDeferral == 0)
+      return;
+    if ((--this->m_ModificationDeferral == 0) && this->m_ModificationPending)
+    {
+      this->m_ModificationPending = false;
+      this->Modified();
+    }
   };
   
+  /**
+   * @fn bool DataObject::IsModificationDeferred() const
+   * Returns true if a deferred modification was started with BeginModification().
+   */
+  
   void DataObject::AddChild(DataObject* child)
   {
     for (std::list<DataObject*>::iterator it = this->m_Children.begin() ; it != this->m_Children.end() ; ++it)
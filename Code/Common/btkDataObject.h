@@ -62,18 +62,26 @@ namespace btk
     BTK_COMMON_EXPORT void Modified();
     BTK_COMMON_EXPORT void Update();
     
+    void BeginModification() {++this->m_ModificationDeferral;};
+    BTK_COMMON_EXPORT void EndModification();
+    bool IsModificationDeferred() const {return this->m_ModificationDeferral != 0;};
+    
   protected:
     DataObject()
     : Object(), m_Children()
     {
       this->mp_Parent = 0;
       this->mp_Source = 0;
+      this->m_ModificationDeferral = 0;
+      this->m_ModificationPending = false;
     };
     DataObject(const DataObject& toCopy)
     : Object(toCopy), m_Children()
     {
       this->mp_Parent = 0;
       this->mp_Source = 0;
+      this->m_ModificationDeferral = 0;
+      this->m_ModificationPending = false;
     };
     BTK_COMMON_EXPORT virtual ~DataObject();
         
@@ -86,6 +94,8 @@ namespace btk
     DataObject* mp_Parent;
     std::list<DataObject*> m_Children;
     ProcessObject* mp_Source;
+    int m_ModificationDeferral;
+    bool m_ModificationPending;
     
     friend class ProcessObject;
   };
@@ -34,6 +34,7 @@
  */
 
 #include "btkEvent.h"
+#include "btkObjectPool.h"
 
 #include <limits>
 #include <cmath>
@@ -134,6 +135,22 @@ namespace btk
    * @fn Pointer Event::New(const std::string& label, double t, int f, const std::string& context, int detectionFlags = Unknown, const std::string& subject = "", const std::string& desc = "", int id = 0)
    * Creates a smart pointer associated with an Event object.
    */
+  
+  /**
+   * Allocate the memory of an Event object from the object pool (see ObjectPool::Allocate()).
+   */
+  void* Event::operator new(size_t size)
+  {
+    return ObjectPool::Allocate(size);
+  };
+  
+  /**
+   * Release the memory of an Event object in the object pool (see ObjectPool::Deallocate()).
+   */
+  void Event::operator delete(void* ptr, size_t size)
+  {
+    ObjectPool::Deallocate(ptr, size);
+  };
 
   /**
    * @fn const std::string& Event::GetContext() const
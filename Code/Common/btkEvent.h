@@ -61,6 +61,9 @@ namespace btk
     
     static NullPointer Null() {return NullPointer();}; 
     
+    BTK_COMMON_EXPORT static void* operator new(size_t size);
+    BTK_COMMON_EXPORT static void operator delete(void* ptr, size_t size);
+    
     // ~Event(); // Implicit.
     const std::string& GetContext() const {return this->m_Context;};
     BTK_COMMON_EXPORT void SetContext(const std::string& context);
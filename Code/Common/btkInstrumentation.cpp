@@ -0,0 +1,508 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "btkInstrumentation.h"
+#include "btkCriticalSection_p.h"
+#include "btkThread_p.h"
+#include "btkLogger.h"
+
+#include <algorithm> // std::find
+#include <vector>
+#include <sstream>
+#include <cstdlib> // free
+
+#if defined(_WIN32)
+  #ifndef WIN32_LEAN_AND_MEAN
+    #define WIN32_LEAN_AND_MEAN
+  #endif
+  #include <windows.h>
+  #include <psapi.h>
+#else
+  #include <sys/time.h>
+  #include <sys/resource.h>
+#endif
+
+#if defined(__GNUC__)
+  #include <cxxabi.h>
+#endif
+
+static btk::critical_section_p _btk_instrumentation_lock;
+static std::vector<btk::Instrumentation::Sink::Pointer> _btk_instrumentation_sinks;
+static volatile int _btk_instrumentation_enabled = 0;
+
+static std::string _btk_instrumentation_json(const std::string& str)
+{
+  std::string s = "\"";
+  for (size_t i = 0 ; i < str.length() ; ++i)
+  {
+    unsigned char c = static_cast<unsigned char>(str[i]);
+    if ((c == '"') || (c == '\\'))
+      s += '\\';
+    if (c >= 0x20)
+      s += str[i];
+  }
+  return s + "\"";
+};
+
+namespace btk
+{
+  /**
+   * @class Instrumentation btkInstrumentation.h
+   * @brief Opt-in measurement of the time spent and the resources used by the processes and the file IOs.
+   *
+   * The instrumentation is disabled until a sink is added with the method AddSink(). Then, each call to 
+   * ProcessObject::Update() which generates data, and each call to AcquisitionFileIO::Read() or AcquisitionFileIO::Write()
+   * done through the file reader and writer produces a Record sent to all the registered sinks. The C3D file format
+   * sends also a record for each phase of the reading (header, parameters, data, post-processing) and of the writing
+   * (header, parameters, data).
+   *
+   * Three sinks are proposed:
+   *  - Instrumentation::LoggerSink prints each record in the debug stream of the class Logger (even in release mode);
+   *  - Instrumentation::CallbackSink gives each record to a function;
+   *  - Instrumentation::TraceFileSink writes the records in a file with the JSON lines format or the trace format 
+   *    of the Chrome browser (chrome://tracing).
+   *
+   * @code
+   * btk::Instrumentation::TraceFileSink::Pointer trace = btk::Instrumentation::TraceFileSink::New("pipeline.json");
+   * btk::Instrumentation::AddSink(trace);
+   * pipeline->Update();
+   * btk::Instrumentation::RemoveSink(trace); // The file is closed when the sink is destroyed.
+   * @endcode
+   *
+   * When no sink is registered, a measure costs only the check of a flag.
+   *
+   * @ingroup BTKCommon
+   */
+  
+  /**
+   * @struct Instrumentation::Record btkInstrumentation.h
+   * @brief Measure of one call.
+   *
+   * The fields are:
+   *  - Category: "ProcessObject" or "AcquisitionFileIO";
+   *  - Name: the class name of the process, the IO method (e.g. "C3DFileIO::Read") or one of its phase (e.g. "C3DFileIO::Read:data");
+   *  - Detail: additional information like the filename;
+   *  - Start: time when the call started (in seconds, see Instrumentation::GetTime());
+   *  - Duration: wall time of the call (in seconds);
+   *  - Bytes: number of bytes read or written (0 for the processes);
+   *  - Items: number of items produced (points, analog channels, events, force platforms, etc.);
+   *  - PeakMemory: increase of the peak memory used by the program during the call (in bytes). As this value is 
+   *    global to the program, it is only a hint when several threads are running;
+   *  - Thread: identifier of the thread which did the call.
+   */
+  
+  /**
+   * @class Instrumentation::Sink btkInstrumentation.h
+   * @brief Interface of the destinations of the records.
+   *
+   * The method Consume() is called with the records as soon as they are measured. The calls are serialized,
+   * even when the records are measured in several threads.
+   */
+  
+  /**
+   * @fn virtual void Instrumentation::Sink::Consume(const Record& record) = 0;
+   * Receives a record.
+   */
+  
+  /**
+   * @fn virtual void Instrumentation::Sink::Flush()
+   * Writes the pending records if the sink is buffered. Does nothing by default.
+   */
+  
+  /**
+   * @class Instrumentation::LoggerSink btkInstrumentation.h
+   * @brief Prints the records in the debug stream of the Logger.
+   *
+   * The records are printed even if the symbol NDEBUG is defined, but not when the verbose mode of the logger is Logger::Quiet.
+   */
+  
+  /**
+   * Prints the given record as a line of text.
+   */
+  void Instrumentation::LoggerSink::Consume(const Record& record)
+  {
+    if (Logger::GetVerboseMode() == Logger::Quiet)
+      return;
+    std::ostream& os = Logger::GetDebugStream()->GetOutput();
+    os << (Logger::GetPrefix().empty() ? "[" : "[" + Logger::GetPrefix() + " ") << "TRACE] " << record.Name;
+    if (!record.Detail.empty())
+      os << " (" << record.Detail << ")";
+    os << ": " << record.Duration * 1000.0 << " ms";
+    if (record.Bytes != 0)
+      os << ", " << record.Bytes << " bytes";
+    os << ", " << record.Items << " items, peak memory +" << record.PeakMemory << " bytes" << std::endl;
+  };
+  
+  /**
+   * @class Instrumentation::CallbackSink btkInstrumentation.h
+   * @brief Gives the records to a function.
+   *
+   * The function receives also the pointer @a clientData given to the method New().
+   */
+  
+  /**
+   * @class Instrumentation::TraceFileSink btkInstrumentation.h
+   * @brief Writes the records in a file.
+   *
+   * Two formats are available:
+   *  - TraceFileSink::JSONLines: one JSON object per line;
+   *  - TraceFileSink::ChromeTrace: array of complete events which can be loaded in the Chrome browser (chrome://tracing).
+   *
+   * The file is opened by the constructor and closed by the destructor. Use the method IsOpen() to check that the file can be written.
+   */
+  
+  /**
+   * Closes the file.
+   */
+  Instrumentation::TraceFileSink::~TraceFileSink()
+  {
+    if (this->m_Stream.is_open() && (this->m_Format == ChromeTrace))
+      this->m_Stream << "\n]\n";
+    delete this->mp_Lock;
+  };
+  
+  /**
+   * Writes the record in the file.
+   */
+  void Instrumentation::TraceFileSink::Consume(const Record& record)
+  {
+    std::ostringstream oss;
+    oss.precision(15);
+    if (this->m_Format == ChromeTrace)
+    {
+      oss << ((this->m_RecordNumber == 0) ? "" : ",\n") 
+          << "{\"name\": " << _btk_instrumentation_json(record.Name) 
+          << ", \"cat\": " << _btk_instrumentation_json(record.Category)
+          << ", \"ph\": \"X\", \"ts\": " << record.Start * 1.0e6 << ", \"dur\": " << record.Duration * 1.0e6
+          << ", \"pid\": 1, \"tid\": " << record.Thread
+          << ", \"args\": {\"detail\": " << _btk_instrumentation_json(record.Detail)
+          << ", \"bytes\": " << record.Bytes << ", \"items\": " << record.Items << ", \"peak_memory\": " << record.PeakMemory << "}}";
+    }
+    else
+    {
+      oss << "{\"category\": " << _btk_instrumentation_json(record.Category)
+          << ", \"name\": " << _btk_instrumentation_json(record.Name)
+          << ", \"detail\": " << _btk_instrumentation_json(record.Detail)
+          << ", \"start\": " << record.Start << ", \"duration\": " << record.Duration
+          << ", \"bytes\": " << record.Bytes << ", \"items\": " << record.Items
+          << ", \"peak_memory\": " << record.PeakMemory << ", \"thread\": " << record.Thread << "}\n";
+    }
+    this->mp_Lock->Lock();
+    this->m_Stream << oss.str();
+    ++this->m_RecordNumber;
+    this->mp_Lock->Unlock();
+  };
+  
+  /**
+   * Writes the buffered content in the file.
+   */
+  void Instrumentation::TraceFileSink::Flush()
+  {
+    this->mp_Lock->Lock();
+    this->m_Stream.flush();
+    this->mp_Lock->Unlock();
+  };
+  
+  /**
+   * Opens the file @a filename for the format @a format.
+   */
+  Instrumentation::TraceFileSink::TraceFileSink(const std::string& filename, Format format)
+  : Sink(), m_Stream(filename.c_str())
+  {
+    this->m_Format = format;
+    this->m_RecordNumber = 0;
+    this->mp_Lock = new critical_section_p;
+    if (!this->m_Stream.is_open())
+    {
+      btkErrorMacro("Impossible to open the trace file: " + filename);
+    }
+    else if (this->m_Format == ChromeTrace)
+      this->m_Stream << "[\n";
+  };
+  
+  /**
+   * @class Instrumentation::Scope btkInstrumentation.h
+   * @brief Measures the code executed between its construction and its destruction (or the call of the method Stop()).
+   *
+   * Nothing is measured if the instrumentation is disabled when the scope is constructed. The method Next() is
+   * useful to measure successive phases of a function.
+   *
+   * @code
+   * btk::Instrumentation::Scope scope("AcquisitionFileIO", "MyFileIO::Read:header", filename);
+   * // Read the header
+   * scope.Next("MyFileIO::Read:data");
+   * // Read the data
+   * scope.SetItems(output->GetPointNumber());
+   * @endcode
+   */
+  
+  /**
+   * Starts the measure of the function @a name.
+   */
+  Instrumentation::Scope::Scope(const char* category, const char* name, const std::string& detail)
+  : m_Record()
+  {
+    this->m_Active = Instrumentation::IsEnabled();
+    if (this->m_Active)
+    {
+      this->m_Record.Name = name;
+      this->m_Record.Detail = detail;
+      this->Start(category);
+    }
+  };
+  
+  /**
+   * Starts the measure of the object with the type @a type (e.g. typeid(*this)).
+   * If @a method is given, it is appended to the name of the type (e.g. "btk::C3DFileIO::Read").
+   */
+  Instrumentation::Scope::Scope(const char* category, const std::type_info& type, const char* method, const std::string& detail)
+  : m_Record()
+  {
+    this->m_Active = Instrumentation::IsEnabled();
+    if (this->m_Active)
+    {
+      this->m_Record.Name = Instrumentation::GetTypeName(type);
+      if (method != 0)
+        this->m_Record.Name += std::string("::") + method;
+      this->m_Record.Detail = detail;
+      this->Start(category);
+    }
+  };
+  
+  /**
+   * Stops the measure if it is not already done.
+   */
+  Instrumentation::Scope::~Scope()
+  {
+    this->Stop();
+  };
+  
+  /**
+   * @fn bool Instrumentation::Scope::IsActive() const
+   * Returns true if the scope is measuring.
+   */
+  
+  /**
+   * @fn void Instrumentation::Scope::SetDetail(const std::string& detail)
+   * Sets additional information on the measured call (e.g. a filename).
+   */
+  
+  /**
+   * @fn void Instrumentation::Scope::SetBytes(size_t bytes)
+   * Sets the number of bytes read or written.
+   */
+  
+  /**
+   * @fn void Instrumentation::Scope::SetItems(size_t items)
+   * Sets the number of items produced.
+   */
+  
+  /**
+   * Stops the current measure and starts the measure of the next phase @a name.
+   * The category and the detail are kept.
+   */
+  void Instrumentation::Scope::Next(const char* name)
+  {
+    if (!this->m_Active)
+      return;
+    this->Stop();
+    this->m_Active = Instrumentation::IsEnabled();
+    if (this->m_Active)
+    {
+      this->m_Record.Name = name;
+      this->Start(this->m_Record.Category.c_str());
+    }
+  };
+  
+  /**
+   * Stops the measure and sends the record to the sinks.
+   */
+  void Instrumentation::Scope::Stop()
+  {
+    if (!this->m_Active)
+      return;
+    this->m_Active = false;
+    this->m_Record.Duration = Instrumentation::GetTime() - this->m_Record.Start;
+    size_t peak = Instrumentation::GetPeakMemory();
+    this->m_Record.PeakMemory = (peak > this->m_PeakMemory) ? (peak - this->m_PeakMemory) : 0;
+    Instrumentation::Emit(this->m_Record);
+  };
+  
+  void Instrumentation::Scope::Start(const char* category)
+  {
+    this->m_Record.Category = category;
+    this->m_Record.Bytes = 0;
+    this->m_Record.Items = 0;
+    this->m_Record.PeakMemory = 0;
+    this->m_Record.Thread = thread_p::GetCurrentId();
+    this->m_PeakMemory = Instrumentation::GetPeakMemory();
+    this->m_Record.Start = Instrumentation::GetTime();
+  };
+  
+  /**
+   * Returns true if at least one sink is registered.
+   */
+  bool Instrumentation::IsEnabled()
+  {
+    return (_btk_instrumentation_enabled != 0);
+  };
+  
+  /**
+   * Registers the sink @a sink. The instrumentation is enabled with the first sink.
+   */
+  void Instrumentation::AddSink(Sink::Pointer sink)
+  {
+    if (!sink)
+      return;
+    _btk_instrumentation_lock.Lock();
+    if (std::find(_btk_instrumentation_sinks.begin(), _btk_instrumentation_sinks.end(), sink) == _btk_instrumentation_sinks.end())
+      _btk_instrumentation_sinks.push_back(sink);
+    _btk_instrumentation_enabled = 1;
+    _btk_instrumentation_lock.Unlock();
+  };
+  
+  /**
+   * Flushes and unregisters the sink @a sink. The instrumentation is disabled when no more sink is registered.
+   */
+  void Instrumentation::RemoveSink(Sink::Pointer sink)
+  {
+    _btk_instrumentation_lock.Lock();
+    std::vector<Sink::Pointer>::iterator it = std::find(_btk_instrumentation_sinks.begin(), _btk_instrumentation_sinks.end(), sink);
+    if (it != _btk_instrumentation_sinks.end())
+    {
+      (*it)->Flush();
+      _btk_instrumentation_sinks.erase(it);
+    }
+    _btk_instrumentation_enabled = _btk_instrumentation_sinks.empty() ? 0 : 1;
+    _btk_instrumentation_lock.Unlock();
+  };
+  
+  /**
+   * Flushes and unregisters all the sinks. The instrumentation is disabled.
+   */
+  void Instrumentation::ClearSinks()
+  {
+    _btk_instrumentation_lock.Lock();
+    for (size_t i = 0 ; i < _btk_instrumentation_sinks.size() ; ++i)
+      _btk_instrumentation_sinks[i]->Flush();
+    _btk_instrumentation_sinks.clear();
+    _btk_instrumentation_enabled = 0;
+    _btk_instrumentation_lock.Unlock();
+  };
+  
+  /**
+   * Flushes all the registered sinks.
+   */
+  void Instrumentation::Flush()
+  {
+    _btk_instrumentation_lock.Lock();
+    for (size_t i = 0 ; i < _btk_instrumentation_sinks.size() ; ++i)
+      _btk_instrumentation_sinks[i]->Flush();
+    _btk_instrumentation_lock.Unlock();
+  };
+  
+  /**
+   * Sends the record @a record to all the registered sinks.
+   */
+  void Instrumentation::Emit(const Record& record)
+  {
+    _btk_instrumentation_lock.Lock();
+    for (size_t i = 0 ; i < _btk_instrumentation_sinks.size() ; ++i)
+      _btk_instrumentation_sinks[i]->Consume(record);
+    _btk_instrumentation_lock.Unlock();
+  };
+  
+  /**
+   * Returns the wall clock time in seconds. The origin of the time is not specified.
+   */
+  double Instrumentation::GetTime()
+  {
+#if defined(_WIN32)
+    LARGE_INTEGER frequency, counter;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return static_cast<double>(counter.QuadPart) / static_cast<double>(frequency.QuadPart);
+#else
+    struct timeval tv;
+    gettimeofday(&tv, 0);
+    return static_cast<double>(tv.tv_sec) + static_cast<double>(tv.tv_usec) * 1.0e-6;
+#endif
+  };
+  
+  /**
+   * Returns the peak of the memory used by the program since its launch (in bytes).
+   * Returns 0 if this information is not available.
+   */
+  size_t Instrumentation::GetPeakMemory()
+  {
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS info;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &info, sizeof(info)))
+      return static_cast<size_t>(info.PeakWorkingSetSize);
+    return 0;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+      return 0;
+  #if defined(__APPLE__)
+    return static_cast<size_t>(usage.ru_maxrss); // bytes
+  #else
+    return static_cast<size_t>(usage.ru_maxrss) * 1024; // kilobytes
+  #endif
+#endif
+  };
+  
+  /**
+   * Returns the readable name of the type @a type (e.g. "btk::AcquisitionFileReader").
+   */
+  std::string Instrumentation::GetTypeName(const std::type_info& type)
+  {
+    std::string name = type.name();
+#if defined(__GNUC__)
+    int status = 0;
+    char* demangled = abi::__cxa_demangle(type.name(), 0, 0, &status);
+    if (demangled != 0)
+    {
+      if (status == 0)
+        name = demangled;
+      free(demangled);
+    }
+#elif defined(_MSC_VER)
+    if (name.compare(0, 6, "class ") == 0)
+      name = name.substr(6);
+#endif
+    return name;
+  };
+};
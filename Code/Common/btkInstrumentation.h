@@ -0,0 +1,164 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __btkInstrumentation_h
+#define __btkInstrumentation_h
+
+#include "btkSharedPtr.h"
+
+#include <string>
+#include <fstream>
+#include <typeinfo>
+
+namespace btk
+{
+  class critical_section_p;
+  
+  class Instrumentation
+  {
+  public:
+    struct Record
+    {
+      std::string Category;
+      std::string Name;
+      std::string Detail;
+      double Start; // seconds
+      double Duration; // seconds
+      size_t Bytes;
+      size_t Items;
+      size_t PeakMemory; // bytes
+      unsigned long Thread;
+    };
+    
+    class Sink
+    {
+    public:
+      typedef btkSharedPtr<Sink> Pointer;
+      virtual ~Sink() {};
+      virtual void Consume(const Record& record) = 0;
+      virtual void Flush() {};
+    protected:
+      Sink() {};
+    private:
+      Sink(const Sink& ); // Not implemented.
+      Sink& operator=(const Sink& ); // Not implemented.
+    };
+    
+    class LoggerSink : public Sink
+    {
+    public:
+      typedef btkSharedPtr<LoggerSink> Pointer;
+      static Pointer New() {return Pointer(new LoggerSink());};
+      BTK_COMMON_EXPORT virtual void Consume(const Record& record);
+    protected:
+      LoggerSink() : Sink() {};
+    };
+    
+    class CallbackSink : public Sink
+    {
+    public:
+      typedef void (*Callback)(const Record& record, void* clientData);
+      typedef btkSharedPtr<CallbackSink> Pointer;
+      static Pointer New(Callback cb, void* clientData = 0) {return Pointer(new CallbackSink(cb, clientData));};
+      virtual void Consume(const Record& record) {this->mp_Callback(record, this->mp_ClientData);};
+    protected:
+      CallbackSink(Callback cb, void* clientData) : Sink(), mp_Callback(cb), mp_ClientData(clientData) {};
+    private:
+      Callback mp_Callback;
+      void* mp_ClientData;
+    };
+    
+    class TraceFileSink : public Sink
+    {
+    public:
+      typedef enum {JSONLines, ChromeTrace} Format;
+      typedef btkSharedPtr<TraceFileSink> Pointer;
+      static Pointer New(const std::string& filename, Format format = ChromeTrace) {return Pointer(new TraceFileSink(filename, format));};
+      BTK_COMMON_EXPORT virtual ~TraceFileSink();
+      bool IsOpen() const {return this->m_Stream.is_open();};
+      BTK_COMMON_EXPORT virtual void Consume(const Record& record);
+      BTK_COMMON_EXPORT virtual void Flush();
+    protected:
+      BTK_COMMON_EXPORT TraceFileSink(const std::string& filename, Format format);
+    private:
+      std::ofstream m_Stream;
+      Format m_Format;
+      int m_RecordNumber;
+      critical_section_p* mp_Lock;
+    };
+    
+    class Scope
+    {
+    public:
+      BTK_COMMON_EXPORT Scope(const char* category, const char* name, const std::string& detail = std::string());
+      BTK_COMMON_EXPORT Scope(const char* category, const std::type_info& type, const char* method = 0, const std::string& detail = std::string());
+      BTK_COMMON_EXPORT ~Scope();
+      bool IsActive() const {return this->m_Active;};
+      void SetDetail(const std::string& detail) {this->m_Record.Detail = detail;};
+      void SetBytes(size_t bytes) {this->m_Record.Bytes = bytes;};
+      void SetItems(size_t items) {this->m_Record.Items = items;};
+      BTK_COMMON_EXPORT void Next(const char* name);
+      BTK_COMMON_EXPORT void Stop();
+    private:
+      Scope(const Scope& ); // Not implemented.
+      Scope& operator=(const Scope& ); // Not implemented.
+      
+      void Start(const char* category);
+      
+      Record m_Record;
+      size_t m_PeakMemory;
+      bool m_Active;
+    };
+    
+    BTK_COMMON_EXPORT static bool IsEnabled();
+    BTK_COMMON_EXPORT static void AddSink(Sink::Pointer sink);
+    BTK_COMMON_EXPORT static void RemoveSink(Sink::Pointer sink);
+    BTK_COMMON_EXPORT static void ClearSinks();
+    BTK_COMMON_EXPORT static void Flush();
+    BTK_COMMON_EXPORT static void Emit(const Record& record);
+    
+    BTK_COMMON_EXPORT static double GetTime();
+    BTK_COMMON_EXPORT static size_t GetPeakMemory();
+    BTK_COMMON_EXPORT static std::string GetTypeName(const std::type_info& type);
+    
+  private:
+    Instrumentation();
+    ~Instrumentation();
+    Instrumentation(const Instrumentation& ); // Not implemented.
+    Instrumentation& operator=(const Instrumentation& ); // Not implemented.
+  };
+};
+
+#endif // __btkInstrumentation_h
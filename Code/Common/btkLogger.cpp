@@ -34,8 +34,20 @@
  */
 
 #include "btkLogger.h"
+#include "btkThread_p.h"
+#include "btkCriticalSection_p.h"
+#include "btkConvert.h"
 
 #include <iostream>
+#include <map>
+
+// OSAtomic.h optimizations only used in 10.5 and later
+#if defined(__APPLE__)
+  #include <AvailabilityMacros.h>
+  #if MAC_OS_X_VERSION_MAX_ALLOWED >= 1050
+    #include <libkern/OSAtomic.h>
+  #endif
+#endif
 
 #ifdef NDEBUG
   static btk::Logger::VerboseMode _btk_logger_verbose_mode = btk::Logger::Normal;
@@ -49,6 +61,257 @@ static std::string _btk_logger_error_affix = "ERROR";
 static btk::Logger::Stream::Pointer _btk_logger_debug_stream = btk::Logger::Stream::New(&(std::cout));
 static btk::Logger::Stream::Pointer _btk_logger_warning_stream = btk::Logger::Stream::New(&(std::cerr));
 static btk::Logger::Stream::Pointer _btk_logger_error_stream = btk::Logger::Stream::New(&(std::cerr));
+static std::map<unsigned long, std::string> _btk_logger_contexts;
+static btk::critical_section_p _btk_logger_context_lock;
+static volatile size_t _btk_logger_context_number = 0;
+
+namespace btk
+{
+#if !defined(WIN32) && !defined(_WIN32) && !(defined(__APPLE__) && (MAC_OS_X_VERSION_MIN_REQUIRED >= 1050)) && !defined(HAVE_ATOMIC_BUILTINS)
+  static critical_section_p& _btk_logger_atomic_lock()
+  {
+    static critical_section_p cs;
+    return cs;
+  };
+#endif
+  
+  // Atomic read of the given value (with a full memory barrier).
+  static unsigned long _btk_logger_atomic_load(volatile unsigned long* ptr)
+  {
+#if defined(WIN32) || defined(_WIN32)
+    unsigned long value = *ptr;
+    MemoryBarrier();
+    return value;
+#elif defined(__APPLE__) && (MAC_OS_X_VERSION_MIN_REQUIRED >= 1050)
+    unsigned long value = *ptr;
+    OSMemoryBarrier();
+    return value;
+#elif defined(HAVE_ATOMIC_BUILTINS)
+    unsigned long value = *ptr;
+    __sync_synchronize();
+    return value;
+#else
+    critical_section_p& cs = _btk_logger_atomic_lock();
+    cs.Lock();
+    unsigned long value = *ptr;
+    cs.Unlock();
+    return value;
+#endif
+  };
+  
+  // Atomic write of the given value (with a full memory barrier).
+  static void _btk_logger_atomic_store(volatile unsigned long* ptr, unsigned long value)
+  {
+#if defined(WIN32) || defined(_WIN32)
+    MemoryBarrier();
+    *ptr = value;
+#elif defined(__APPLE__) && (MAC_OS_X_VERSION_MIN_REQUIRED >= 1050)
+    OSMemoryBarrier();
+    *ptr = value;
+#elif defined(HAVE_ATOMIC_BUILTINS)
+    __sync_synchronize();
+    *ptr = value;
+#else
+    critical_section_p& cs = _btk_logger_atomic_lock();
+    cs.Lock();
+    *ptr = value;
+    cs.Unlock();
+#endif
+  };
+  
+  // Replace the value pointed by @a ptr by @a desired only if it is equal to @a expected.
+  static bool _btk_logger_atomic_cas(volatile unsigned long* ptr, unsigned long expected, unsigned long desired)
+  {
+#if defined(WIN32) || defined(_WIN32)
+    return (InterlockedCompareExchange(reinterpret_cast<volatile LONG*>(ptr), static_cast<LONG>(desired), static_cast<LONG>(expected)) == static_cast<LONG>(expected));
+#elif defined(__APPLE__) && (MAC_OS_X_VERSION_MIN_REQUIRED >= 1050)
+    return OSAtomicCompareAndSwapLongBarrier(static_cast<long>(expected), static_cast<long>(desired), reinterpret_cast<volatile long*>(ptr));
+#elif defined(HAVE_ATOMIC_BUILTINS)
+    return __sync_bool_compare_and_swap(ptr, expected, desired);
+#else
+    critical_section_p& cs = _btk_logger_atomic_lock();
+    cs.Lock();
+    bool swapped = (*ptr == expected);
+    if (swapped)
+      *ptr = desired;
+    cs.Unlock();
+    return swapped;
+#endif
+  };
+  
+  /*
+   * Bounded queue of formatted messages used by the asynchronous mode of the logger.
+   *
+   * The messages are pushed without lock by any thread (multiple producers) in a ring buffer.
+   * Each slot has a sequence number indicating if it is free to be written (sequence equal to
+   * the position of the producer) or ready to be read (sequence equal to the position of the 
+   * consumer plus one). The messages are written on their stream by a background thread or 
+   * by any thread calling the method Drain(). The output lock guarantees that only one thread 
+   * consumes the messages at a time and that the synchronous messages are not interleaved 
+   * with the asynchronous ones.
+   */
+  class logger_queue_p
+  {
+  public:
+    logger_queue_p();
+    ~logger_queue_p();
+    
+    bool IsRunning() const {return this->m_Running;};
+    void Start();
+    void Stop();
+    
+    bool Push(Logger::Stream::Pointer output, const std::string& line);
+    bool Drain();
+    void Write(Logger::Stream* output, const std::string& line);
+    
+  private:
+    logger_queue_p(const logger_queue_p& ); // Not implemented.
+    logger_queue_p& operator=(const logger_queue_p& ); // Not implemented.
+    
+    bool DrainUnsafe();
+    static void Run(void* data);
+    
+    enum {Size = 1024}; // Must be a power of two
+    
+    struct Entry
+    {
+      volatile unsigned long Sequence;
+      Logger::Stream::Pointer Output;
+      std::string Line;
+    };
+    
+    Entry m_Entries[Size];
+    volatile unsigned long m_EnqueuePosition;
+    unsigned long m_DequeuePosition; // Protected by the output lock.
+    volatile bool m_Running;
+    critical_section_p m_OutputLock;
+    critical_section_p m_StateLock;
+    thread_p m_Thread;
+  };
+  
+  logger_queue_p::logger_queue_p()
+  : m_OutputLock(), m_StateLock(), m_Thread()
+  {
+    for (unsigned long i = 0 ; i < Size ; ++i)
+      this->m_Entries[i].Sequence = i;
+    this->m_EnqueuePosition = 0;
+    this->m_DequeuePosition = 0;
+    this->m_Running = false;
+  };
+  
+  logger_queue_p::~logger_queue_p()
+  {
+    this->Stop();
+  };
+  
+  // Launch the background thread. The mode stays synchronous if the thread cannot be created.
+  void logger_queue_p::Start()
+  {
+    this->m_StateLock.Lock();
+    if (!this->m_Running)
+    {
+      this->m_Running = true;
+      if (!this->m_Thread.Start(&logger_queue_p::Run, this))
+        this->m_Running = false;
+    }
+    this->m_StateLock.Unlock();
+  };
+  
+  // Stop the background thread and write the remaining messages.
+  void logger_queue_p::Stop()
+  {
+    this->m_StateLock.Lock();
+    if (this->m_Running)
+    {
+      this->m_Running = false;
+      this->m_Thread.Join();
+    }
+    this->m_StateLock.Unlock();
+    this->Drain();
+  };
+  
+  // Returns false if the queue is full.
+  bool logger_queue_p::Push(Logger::Stream::Pointer output, const std::string& line)
+  {
+    Entry* entry = 0;
+    unsigned long pos = _btk_logger_atomic_load(&(this->m_EnqueuePosition));
+    for (;;)
+    {
+      entry = &(this->m_Entries[pos & (Size - 1)]);
+      long diff = static_cast<long>(_btk_logger_atomic_load(&(entry->Sequence)) - pos);
+      if (diff == 0)
+      {
+        if (_btk_logger_atomic_cas(&(this->m_EnqueuePosition), pos, pos + 1))
+          break;
+        pos = _btk_logger_atomic_load(&(this->m_EnqueuePosition));
+      }
+      else if (diff < 0)
+        return false;
+      else
+        pos = _btk_logger_atomic_load(&(this->m_EnqueuePosition));
+    }
+    entry->Output = output;
+    entry->Line = line;
+    _btk_logger_atomic_store(&(entry->Sequence), pos + 1);
+    return true;
+  };
+  
+  // Write the pending messages. Returns false if there was no message.
+  bool logger_queue_p::Drain()
+  {
+    this->m_OutputLock.Lock();
+    bool written = this->DrainUnsafe();
+    this->m_OutputLock.Unlock();
+    return written;
+  };
+  
+  // Write a message synchronously, after the pending ones.
+  void logger_queue_p::Write(Logger::Stream* output, const std::string& line)
+  {
+    this->m_OutputLock.Lock();
+    this->DrainUnsafe();
+    output->GetOutput() << line << std::endl;
+    this->m_OutputLock.Unlock();
+  };
+  
+  bool logger_queue_p::DrainUnsafe()
+  {
+    bool written = false;
+    for (;;)
+    {
+      Entry* entry = &(this->m_Entries[this->m_DequeuePosition & (Size - 1)]);
+      if (_btk_logger_atomic_load(&(entry->Sequence)) != this->m_DequeuePosition + 1)
+        break;
+      entry->Output->GetOutput() << entry->Line << std::endl;
+      entry->Output.reset();
+      entry->Line.clear(); // The capacity of the string is kept for the next messages.
+      _btk_logger_atomic_store(&(entry->Sequence), this->m_DequeuePosition + Size);
+      ++this->m_DequeuePosition;
+      written = true;
+    }
+    return written;
+  };
+  
+  void logger_queue_p::Run(void* data)
+  {
+    logger_queue_p* queue = static_cast<logger_queue_p*>(data);
+    int delay = 1;
+    while (queue->m_Running)
+    {
+      if (queue->Drain())
+        delay = 1;
+      else
+      {
+        thread_p::SleepFor(delay);
+        if (delay < 8)
+          delay *= 2;
+      }
+    }
+  };
+};
+
+// Must be declared after the streams as its destruction writes the remaining messages.
+static btk::logger_queue_p _btk_logger_queue;
 
 namespace btk
 {
@@ -85,6 +348,11 @@ namespace btk
    *
    * It is possible to select other output streams than std::cout and std::cerr using the method SetDebugStream(), SetWarningStream(), and SetErrorStream().
    *
+   * The macros check the verbose mode before building the message: nothing is formatted in the Logger::Quiet mode. 
+   * The messages can be written by a background thread (see SetAsynchronousMode()) and a context (e.g. the name of the
+   * processed file) can be set for each thread (see Logger::Context). The logger can be used concurrently by several threads 
+   * (the verbose mode, the prefix, the affixes and the streams should be set before).
+   *
    * An example to use this logger is:
    * @code{.cpp}
    * #include <btkLogger.h>
@@ -131,7 +399,7 @@ namespace btk
 #ifdef NDEBUG
     btkNotUsed(msg);
 #else
-    Logger::PrintMessage(_btk_logger_debug_stream.get(), _btk_logger_debug_affix, msg);
+    Logger::PrintMessage(_btk_logger_debug_stream, _btk_logger_debug_affix, msg);
 #endif
   };
      
@@ -141,7 +409,7 @@ namespace btk
    */
   void Logger::Warning(const std::string& msg)
   {
-    Logger::PrintMessage(_btk_logger_warning_stream.get(), _btk_logger_warning_affix, msg);
+    Logger::PrintMessage(_btk_logger_warning_stream, _btk_logger_warning_affix, msg);
   };
     
   /**
@@ -150,7 +418,7 @@ namespace btk
    */
   void Logger::Error(const std::string& msg)
   {
-    Logger::PrintMessage(_btk_logger_error_stream.get(), _btk_logger_error_affix, msg);
+    Logger::PrintMessage(_btk_logger_error_stream, _btk_logger_error_affix, msg);
   }
   
   /**
@@ -161,7 +429,7 @@ namespace btk
 #ifdef NDEBUG
     btkNotUsed(filename); btkNotUsed(line); btkNotUsed(msg);
 #else
-    Logger::PrintMessage(_btk_logger_debug_stream.get(), _btk_logger_debug_affix, filename, line, msg);
+    Logger::PrintMessage(_btk_logger_debug_stream, _btk_logger_debug_affix, filename, line, msg);
 #endif
   };
   
@@ -170,7 +438,7 @@ namespace btk
    */
   void Logger::Warning(const std::string& filename, int line, const std::string& msg)
   {
-    Logger::PrintMessage(_btk_logger_warning_stream.get(), _btk_logger_warning_affix, filename, line, msg);
+    Logger::PrintMessage(_btk_logger_warning_stream, _btk_logger_warning_affix, filename, line, msg);
   };
   
   /**
@@ -178,7 +446,7 @@ namespace btk
    */
   void Logger::Error(const std::string& filename, int line, const std::string& msg)
   {
-    Logger::PrintMessage(_btk_logger_error_stream.get(), _btk_logger_error_affix, filename, line, msg);
+    Logger::PrintMessage(_btk_logger_error_stream, _btk_logger_error_affix, filename, line, msg);
   };
   
   /**
@@ -197,6 +465,56 @@ namespace btk
     _btk_logger_verbose_mode = mode;
   };
       
+  /**
+   * Returns true if the messages are written asynchronously by a background thread.
+   */
+  bool Logger::GetAsynchronousMode()
+  {
+    return _btk_logger_queue.IsRunning();
+  };
+  
+  /**
+   * Enable/disable the asynchronous mode. In this mode, the messages are formatted by the calling thread and
+   * queued without lock. A background thread writes them on their stream. The calling threads are then not
+   * blocked by the output streams. If the queue is full, the message is written synchronously.
+   * The remaining messages are written when the asynchronous mode is disabled or when the method Flush() is called.
+   *
+   * The mode stays synchronous if the background thread cannot be created (e.g. no thread library).
+   * By default, the logger is synchronous.
+   */
+  void Logger::SetAsynchronousMode(bool enabled)
+  {
+    if (enabled)
+      _btk_logger_queue.Start();
+    else
+      _btk_logger_queue.Stop();
+  };
+  
+  /**
+   * Write the messages still queued by the asynchronous mode. Nothing is done in the synchronous mode.
+   */
+  void Logger::Flush()
+  {
+    _btk_logger_queue.Drain();
+  };
+  
+  /**
+   * Returns the context of the calling thread or an empty string if no context was set (see Logger::Context).
+   */
+  std::string Logger::GetContext()
+  {
+    if (_btk_logger_context_number == 0)
+      return std::string();
+    std::string context;
+    unsigned long id = thread_p::GetCurrentId();
+    _btk_logger_context_lock.Lock();
+    std::map<unsigned long, std::string>::const_iterator it = _btk_logger_contexts.find(id);
+    if (it != _btk_logger_contexts.end())
+      context = it->second;
+    _btk_logger_context_lock.Unlock();
+    return context;
+  };
+  
   /**
    * Returns the prefix used by the logger. The prefix should contain a string for the library or application which use the logger.
    */
@@ -336,32 +654,101 @@ namespace btk
   /**
    * Overload method to print message without information on the file and the line number where the log was written.
    */
-  void Logger::PrintMessage(Stream* level, const std::string& affix, const std::string& msg)
+  void Logger::PrintMessage(const Stream::Pointer& level, const std::string& affix, const std::string& msg)
   {
     Logger::PrintMessage(level, affix, "", 0, msg);
   };
   
  /**
   * Print message on the given stream with the selected verbose mode and other parameters.
+  * In the asynchronous mode, the formatted message is queued and written later by a background thread.
   */
-  void Logger::PrintMessage(Stream* level, const std::string& affix, const std::string& filename, int line, const std::string& msg)
+  void Logger::PrintMessage(const Stream::Pointer& level, const std::string& affix, const std::string& filename, int line, const std::string& msg)
   {
     if (_btk_logger_verbose_mode == Logger::Quiet)
       return;
+    std::string str;
     if (_btk_logger_verbose_mode > Logger::MessageOnly)
     {
-      level->GetOutput() << (_btk_logger_prefix.empty() ? "" : "[" + _btk_logger_prefix + " ")
-                     << (affix.empty() ? "" : affix)
-                     << (_btk_logger_prefix.empty() && affix.empty() ? "" : "] ");
+      str += (_btk_logger_prefix.empty() ? "" : "[" + _btk_logger_prefix + " ");
+      str += affix;
+      str += (_btk_logger_prefix.empty() && affix.empty() ? "" : "] ");
     }
     if ((_btk_logger_verbose_mode == Logger::Detailed) && (!filename.empty()))
     {
-      level->GetOutput() << filename;
+      str += filename;
       if (line > 0)
-        level->GetOutput() << " (" << line << ")";
-      level->GetOutput() << ": ";
+        str += " (" + ToString(line) + ")";
+      str += ": ";
+    }
+    if (_btk_logger_context_number != 0)
+    {
+      std::string context = Logger::GetContext();
+      // The context is not repeated if the message already starts with it (see the macro btkWarningMacro).
+      if (!context.empty() && (msg.compare(0, context.length() + 3, context + " - ") != 0))
+        str += context + " - ";
+    }
+    str += msg;
+    if (!_btk_logger_queue.IsRunning() || !_btk_logger_queue.Push(level, str))
+      _btk_logger_queue.Write(level.get(), str);
+  };
+  
+  // ----------------------------------------------------------------------- //
+  
+  /**
+   * @class Logger::Context btkLogger.h
+   * @brief Set a context to the messages logged by the calling thread during the lifetime of this object.
+   *
+   * The context is added at the beginning of the messages, separated from them by a dash (i.e. context - message).
+   * This is usefull to know which file is processed when several files are read or written concurrently
+   * (see AcquisitionFileReader and AcquisitionFileWriter which set the name of the file as context).
+   * The context is not repeated if the message starts already with it.
+   *
+   * @code
+   * {
+   *   btk::Logger::Context context("foo.c3d");
+   *   btk::Logger::Warning("Bar"); // Print "[BTK WARNING] foo.c3d - Bar"
+   * }
+   * btk::Logger::Warning("Bar"); // Print "[BTK WARNING] Bar"
+   * @endcode
+   *
+   * The contexts can be nested. The previous context of the thread is restored by the destructor.
+   */
+  
+  /**
+   * Constructor. Set @a str as the context of the calling thread.
+   */
+  Logger::Context::Context(const std::string& str)
+  : m_Previous()
+  {
+    unsigned long id = thread_p::GetCurrentId();
+    _btk_logger_context_lock.Lock();
+    std::map<unsigned long, std::string>::iterator it = _btk_logger_contexts.find(id);
+    this->m_Nested = (it != _btk_logger_contexts.end());
+    if (this->m_Nested)
+    {
+      this->m_Previous = it->second;
+      it->second = str;
     }
-    level->GetOutput() << msg << std::endl;
+    else
+      _btk_logger_contexts.insert(std::make_pair(id, str));
+    _btk_logger_context_number = _btk_logger_contexts.size();
+    _btk_logger_context_lock.Unlock();
+  };
+  
+  /**
+   * Destructor. Restore the previous context of the calling thread.
+   */
+  Logger::Context::~Context()
+  {
+    unsigned long id = thread_p::GetCurrentId();
+    _btk_logger_context_lock.Lock();
+    if (this->m_Nested)
+      _btk_logger_contexts[id] = this->m_Previous;
+    else
+      _btk_logger_contexts.erase(id);
+    _btk_logger_context_number = _btk_logger_contexts.size();
+    _btk_logger_context_lock.Unlock();
   };
   
   // ----------------------------------------------------------------------- //
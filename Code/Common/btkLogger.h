@@ -49,6 +49,9 @@
   /* Keep the scope of _argc, _argv only inside the "loop" */ \
   do \
   { \
+    /* The verbose mode is checked before building the message */ \
+    if (btk::Logger::GetVerboseMode() == btk::Logger::Quiet) \
+      break; \
     std::string _argv[] = { __VA_ARGS__ }; \
     int _argc = (sizeof _argv) / (sizeof _argv[0]); \
     if (_argc == 1) \
@@ -66,8 +69,13 @@
  * In this second case, the macro strip the path of the given file to keep only the filename and concat it to the message by using a dash separator between them (i.e. filename - message).
  * The second case is usefull for log messages sent from IO reader/writer to know which processed file has somme issues during batch.
  */
-#define btkDebugMacro(...) \
-  _btkLogMacro(Debug, __FILE__, __LINE__, __VA_ARGS__);
+#ifdef NDEBUG
+  #define btkDebugMacro(...) \
+    do {} while (0);
+#else
+  #define btkDebugMacro(...) \
+    _btkLogMacro(Debug, __FILE__, __LINE__, __VA_ARGS__);
+#endif
 
 /**
  * Send a warning message to the logger with information on its source code location (filename, line number).
@@ -120,6 +128,20 @@ namespace btk
       bool m_Owned;
     };
     
+    class Context
+    {
+    public:
+      BTK_COMMON_EXPORT Context(const std::string& str);
+      BTK_COMMON_EXPORT ~Context();
+      
+    private:
+      Context(const Context&); // Not implemented.
+      Context& operator= (const Context&); // Not implemented.
+      
+      std::string m_Previous;
+      bool m_Nested;
+    };
+    
     BTK_COMMON_EXPORT static void Debug(const std::string& msg);
     BTK_COMMON_EXPORT static void Debug(const std::string& filename, int line, const std::string& msg);
 
@@ -132,6 +154,12 @@ namespace btk
     BTK_COMMON_EXPORT static VerboseMode GetVerboseMode();
     BTK_COMMON_EXPORT static void SetVerboseMode(VerboseMode mode);
     
+    BTK_COMMON_EXPORT static bool GetAsynchronousMode();
+    BTK_COMMON_EXPORT static void SetAsynchronousMode(bool enabled);
+    BTK_COMMON_EXPORT static void Flush();
+    
+    BTK_COMMON_EXPORT static std::string GetContext();
+    
     BTK_COMMON_EXPORT static const std::string& GetPrefix();
     BTK_COMMON_EXPORT static void SetPrefix(const std::string& str);
     
@@ -153,8 +181,8 @@ namespace btk
     BTK_COMMON_EXPORT static void SetErrorAffix(const std::string& str);
     
   private:
-    static void PrintMessage(Stream* level, const std::string& affix, const std::string& msg);
-    static void PrintMessage(Stream* level, const std::string& affix, const std::string& filename, int line, const std::string& msg);
+    static void PrintMessage(const Stream::Pointer& level, const std::string& affix, const std::string& msg);
+    static void PrintMessage(const Stream::Pointer& level, const std::string& affix, const std::string& filename, int line, const std::string& msg);
   };
 };
 
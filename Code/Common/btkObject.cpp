@@ -46,6 +46,57 @@
 
 namespace btk
 {
+#if !defined(WIN32) && !defined(_WIN32) && !(defined(__APPLE__) && (MAC_OS_X_VERSION_MIN_REQUIRED >= 1050)) && !defined(HAVE_ATOMIC_BUILTINS)
+  static critical_section_p& _btk_object_timestamp_lock()
+  {
+    static critical_section_p cs;
+    return cs;
+  };
+#endif
+  
+  // Reserves @a num consecutive timestamps from a global counter and returns the last one. 
+  // No lock is used when atomic operations are available.
+  static unsigned long _btk_object_reserve_timestamps(int num)
+  {
+#if defined(WIN32) || defined(_WIN32)
+    // Windows optimization
+  #if defined(HAVE_64_BIT) 
+    static LONGLONG _atomic_time = 0;
+    return (unsigned long)(InterlockedExchangeAdd64(&_atomic_time, num) + num);
+  #else
+    static LONG _atomic_time = 0;
+    return (unsigned long)(InterlockedExchangeAdd(&_atomic_time, num) + num);
+  #endif
+#elif defined(__APPLE__) && (MAC_OS_X_VERSION_MIN_REQUIRED >= 1050)
+    // Mac optimization
+  #if defined(HAVE_64_BIT) 
+    // NOTE: Comment from VTK library
+    // "m_Timestamp" is "unsigned long", a type that changes sizes
+    // depending on architecture.  The atomic increment is safe, since it
+    // operates on a variable of the exact type needed.  The cast does not
+    // change the size, but does change signedness, which is not ideal.
+    static volatile int64_t _atomic_time = 0;
+    return (unsigned long)OSAtomicAdd64Barrier(num, &_atomic_time);
+  #else
+    static volatile int32_t _atomic_time = 0;
+    return (unsigned long)OSAtomicAdd32Barrier(num, &_atomic_time);
+  #endif
+#elif defined(HAVE_ATOMIC_BUILTINS)
+    // GCC and CLANG intrinsics
+    static volatile unsigned long _atomic_time = 0;
+    return __sync_add_and_fetch(&_atomic_time, static_cast<unsigned long>(num));
+#else
+    // General case
+    static unsigned long _atomic_time = 0;
+    critical_section_p& cs = _btk_object_timestamp_lock();
+    cs.Lock();
+    _atomic_time += num;
+    unsigned long ts = _atomic_time;
+    cs.Unlock();
+    return ts;
+#endif
+  };
+  
   /**
    * @class Object btkObject.h
    * @brief Base for all objects which need to keep track of modified time.
@@ -76,43 +127,65 @@ namespace btk
    * Sets the object as modified (its timestamp is updated and the flag 'modified' 
    * is set to true). It is important to use this method each time a component 
    * of the process is modified.
+   *
+   * The timestamps come from a global counter incremented atomically (a mutex is used 
+   * only on platforms without atomic operations). This method can be used concurrently by several threads.
    */
   void Object::Modified()
+  {
+    this->RaiseTimestamp(_btk_object_reserve_timestamps(1));
+  };
+  
+  /**
+   * Reserves @a num consecutive timestamps with only one operation on the global counter and returns the first one. 
+   * The timestamps are given with the method RaiseTimestamp(). This is used to set several objects as modified
+   * (see DataObject::Modified()).
+   */
+  unsigned long int Object::ReserveTimestamps(int num)
+  {
+    return _btk_object_reserve_timestamps(num) - static_cast<unsigned long>(num) + 1ul;
+  };
+  
+  /**
+   * Sets the timestamp to @a ts only if it is newer than the current one.
+   * The comparison and the assignment are atomic and the timestamp of an object modified concurrently 
+   * cannot go back in time. This method is used with ReserveTimestamps() to set several objects as modified
+   * without requesting a new timestamp for each of them (see DataObject::Modified()).
+   */
+  void Object::RaiseTimestamp(unsigned long int ts)
   {
 #if defined(WIN32) || defined(_WIN32)
-    // Windows optimization
-  #if defined(HAVE_64_BIT) 
-    static LONGLONG _atomic_time = 0;
-    this->m_Timestamp = (unsigned long)InterlockedIncrement64(&_atomic_time);
-  #else
-    static LONG _atomic_time = 0;
-    this->m_Timestamp = (unsigned long)InterlockedIncrement(&_atomic_time);
-  #endif
+    // Windows optimization (unsigned long is always a 32-bit type)
+    LONG current = static_cast<LONG>(this->m_Timestamp);
+    while (static_cast<unsigned long>(current) < ts)
+    {
+      LONG previous = InterlockedCompareExchange(reinterpret_cast<volatile LONG*>(&(this->m_Timestamp)), static_cast<LONG>(ts), current);
+      if (previous == current)
+        break;
+      current = previous;
+    }
 #elif defined(__APPLE__) && (MAC_OS_X_VERSION_MIN_REQUIRED >= 1050)
     // Mac optimization
-  #if defined(HAVE_64_BIT) 
-    // NOTE: Comment from VTK library
-    // "m_Timestamp" is "unsigned long", a type that changes sizes
-    // depending on architecture.  The atomic increment is safe, since it
-    // operates on a variable of the exact type needed.  The cast does not
-    // change the size, but does change signedness, which is not ideal.
-    static volatile int64_t _atomic_time = 0;
-    this->m_Timestamp = (unsigned long)OSAtomicIncrement64Barrier(&_atomic_time);
-  #else
-    static volatile int32_t _atomic_time = 0;
-    this->m_Timestamp = (unsigned long)OSAtomicIncrement32Barrier(&_atomic_time);
-  #endif
+    unsigned long current = this->m_Timestamp;
+    while ((current < ts) && !OSAtomicCompareAndSwapLongBarrier(static_cast<long>(current), static_cast<long>(ts), reinterpret_cast<volatile long*>(&(this->m_Timestamp))))
+      current = this->m_Timestamp;
 #elif defined(HAVE_ATOMIC_BUILTINS)
     // GCC and CLANG intrinsics
-    static volatile unsigned long _atomic_time = 0;
-    this->m_Timestamp = __sync_add_and_fetch(&_atomic_time, 1);
+    unsigned long current = this->m_Timestamp;
+    while (current < ts)
+    {
+      unsigned long previous = __sync_val_compare_and_swap(&(this->m_Timestamp), current, ts);
+      if (previous == current)
+        break;
+      current = previous;
+    }
 #else
     // General case
-    static unsigned long _atomic_time = 0;
-    static btk_critical_section_p _critical_section;
-    _critical_section.Lock();
-    this->m_Timestamp = ++_atomic_time;
-    _critical_section.Unlock();
+    critical_section_p& cs = _btk_object_timestamp_lock();
+    cs.Lock();
+    if (this->m_Timestamp < ts)
+      this->m_Timestamp = ts;
+    cs.Unlock();
 #endif
   };
   
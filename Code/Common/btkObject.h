@@ -60,6 +60,9 @@ namespace btk
     }
     virtual ~Object() {};
     
+    BTK_COMMON_EXPORT static unsigned long int ReserveTimestamps(int num);
+    BTK_COMMON_EXPORT void RaiseTimestamp(unsigned long int ts);
+    
     unsigned long int m_Timestamp;
     
   private:
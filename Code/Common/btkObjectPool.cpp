@@ -0,0 +1,427 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "btkObjectPool.h"
+#include "btkCriticalSection_p.h"
+
+#include <map>
+#include <vector>
+#include <utility> // std::pair
+#include <new> // operator new
+
+// OSAtomic.h optimizations only used in 10.5 and later
+#if defined(__APPLE__)
+  #include <AvailabilityMacros.h>
+  #if MAC_OS_X_VERSION_MAX_ALLOWED >= 1050
+    #include <libkern/OSAtomic.h>
+  #endif
+#endif
+
+namespace btk
+{
+  struct object_pool_key_less_p
+  {
+    bool operator()(const std::pair<const std::type_info*, size_t>& lhs, const std::pair<const std::type_info*, size_t>& rhs) const
+    {
+      if (*(lhs.first) != *(rhs.first))
+        return (lhs.first->before(*(rhs.first)) != 0);
+      return lhs.second < rhs.second;
+    };
+  };
+  
+  struct object_pool_bucket_p
+  {
+    std::vector<void*> Objects;
+    size_t Size;
+    ObjectPool::Deleter Deleter;
+  };
+  
+  typedef std::map<std::pair<const std::type_info*, size_t>, object_pool_bucket_p, object_pool_key_less_p> object_pool_buckets_p;
+  
+  // The buckets are dispatched in several shards, each one with its own lock, based on their key (i.e. the size class).
+  // The threads recycling objects of different sizes do not wait for each other.
+  struct object_pool_shard_p
+  {
+    object_pool_shard_p() : Buckets(), Lock() {this->EntryNumber = 0; this->HitNumber = 0; this->MissNumber = 0;};
+    object_pool_buckets_p Buckets;
+    int EntryNumber;
+    unsigned long HitNumber;
+    unsigned long MissNumber;
+    critical_section_p Lock;
+    char Padding[64]; // Two shards do not share the same cache line.
+  };
+  
+  static const int _btk_object_pool_shard_number = 16;
+  
+  // Statically initialized: the pool is disabled until a budget is set, even during the static initialization.
+  static volatile size_t _btk_object_pool_budget = 0;
+  
+  // The pool is never destroyed as objects can be released during the static destruction.
+  static object_pool_shard_p* _btk_object_pool_shards()
+  {
+    static object_pool_shard_p* shards = new object_pool_shard_p[_btk_object_pool_shard_number];
+    return shards;
+  };
+  
+  static object_pool_shard_p& _btk_object_pool_shard(size_t key)
+  {
+    size_t h = key * 2654435761u;
+    return _btk_object_pool_shards()[(h ^ (h >> 16)) % _btk_object_pool_shard_number];
+  };
+  
+#if !defined(WIN32) && !defined(_WIN32) && !(defined(__APPLE__) && (MAC_OS_X_VERSION_MIN_REQUIRED >= 1050)) && !defined(HAVE_ATOMIC_BUILTINS)
+  static critical_section_p& _btk_object_pool_usage_lock()
+  {
+    static critical_section_p cs;
+    return cs;
+  };
+#endif
+  
+  // Adds @a num bytes to the memory used by the objects kept in the pool and returns the new usage.
+  // No lock is used when atomic operations are available.
+  static long _btk_object_pool_add_usage(long num)
+  {
+#if defined(WIN32) || defined(_WIN32)
+  #if defined(HAVE_64_BIT) 
+    static LONGLONG _atomic_usage = 0;
+    return static_cast<long>(InterlockedExchangeAdd64(&_atomic_usage, num) + num);
+  #else
+    static LONG _atomic_usage = 0;
+    return static_cast<long>(InterlockedExchangeAdd(&_atomic_usage, num) + num);
+  #endif
+#elif defined(__APPLE__) && (MAC_OS_X_VERSION_MIN_REQUIRED >= 1050)
+  #if defined(HAVE_64_BIT) 
+    static volatile int64_t _atomic_usage = 0;
+    return static_cast<long>(OSAtomicAdd64Barrier(num, &_atomic_usage));
+  #else
+    static volatile int32_t _atomic_usage = 0;
+    return static_cast<long>(OSAtomicAdd32Barrier(num, &_atomic_usage));
+  #endif
+#elif defined(HAVE_ATOMIC_BUILTINS)
+    static volatile long _atomic_usage = 0;
+    return __sync_add_and_fetch(&_atomic_usage, num);
+#else
+    static long _atomic_usage = 0;
+    critical_section_p& cs = _btk_object_pool_usage_lock();
+    cs.Lock();
+    _atomic_usage += num;
+    long usage = _atomic_usage;
+    cs.Unlock();
+    return usage;
+#endif
+  };
+  
+  static size_t _btk_object_pool_usage()
+  {
+    return static_cast<size_t>(_btk_object_pool_add_usage(0));
+  };
+  
+  static void _btk_object_pool_delete_block(void* ptr)
+  {
+    ::operator delete(ptr);
+  };
+  
+  // Release objects until the memory usage fits in the budget. The objects of the given type and key (if any) are not released.
+  // The shards are locked one after the other. No lock must be held by the caller.
+  static void _btk_object_pool_evict(size_t budget, const std::type_info* keptType = 0, size_t keptKey = 0)
+  {
+    object_pool_shard_p* shards = _btk_object_pool_shards();
+    for (int i = 0 ; i < _btk_object_pool_shard_number ; ++i)
+    {
+      object_pool_shard_p& shard = shards[i];
+      shard.Lock.Lock();
+      for (object_pool_buckets_p::iterator it = shard.Buckets.begin() ; it != shard.Buckets.end() ; ++it)
+      {
+        if ((keptType != 0) && (it->first.second == keptKey) && (*(it->first.first) == *keptType))
+          continue;
+        object_pool_bucket_p& bucket = it->second;
+        while (!bucket.Objects.empty() && (_btk_object_pool_usage() > budget))
+        {
+          bucket.Deleter(bucket.Objects.back());
+          bucket.Objects.pop_back();
+          _btk_object_pool_add_usage(-static_cast<long>(bucket.Size));
+          --shard.EntryNumber;
+        }
+      }
+      shard.Lock.Unlock();
+      if (_btk_object_pool_usage() <= budget)
+        return;
+    }
+  };
+  
+  /**
+   * @class ObjectPool btkObjectPool.h
+   * @brief Recycle the objects created in large number by the readers (measures' data, points, analog channels, events).
+   *
+   * Reading a file creates thousands of objects and large buffers (the values of each measure) which are released 
+   * when the acquisition is destroyed. When files are read one after the other (batch processing), this pool keeps the 
+   * released objects instead of destroying them so that the next reading can reuse them:
+   *  - The data of the points and analog channels (see Point::Data and Analog::Data) are kept with their buffers. 
+   *    They are reused by the method New() of the data for the same number of frames. Reading the Nth file of a batch 
+   *    with the same shape than the previous ones does not allocate these buffers anymore.
+   *  - The memory of the Point, Analog and Event objects is allocated from free lists of blocks (see Allocate()).
+   *
+   * The pool is disabled by default. It is enabled by setting a memory budget which limits the memory kept by the pool. 
+   * When an object is released while the budget is reached, the objects kept for other kinds or sizes are released first.
+   *
+   * The pool is shared by all the threads. The kept objects are dispatched by size in several parts, each one 
+   * protected by its own lock, so that the threads recycling objects of different sizes do not wait for each other.
+   *
+   * @code
+   * btk::ObjectPool::SetMemoryBudget(256 * 1024 * 1024);
+   * for (size_t i = 0 ; i < filenames.size() ; ++i)
+   * {
+   *   btk::AcquisitionFileReader::Pointer reader = btk::AcquisitionFileReader::New();
+   *   reader->SetFilename(filenames[i]);
+   *   reader->Update();
+   *   // ...
+   * }
+   * btk::ObjectPool::Clear(); // Release the memory kept by the pool
+   * @endcode
+   *
+   * @note The smart pointers used in BTK (TR1 or Boost) do not allow to allocate the reference counter with the object 
+   * (no allocate_shared function). Only the objects and their buffers are recycled.
+   *
+   * @ingroup BTKCommon
+   */
+  
+  /**
+   * @typedef ObjectPool::Deleter
+   * Function used to destroy an object kept by the pool when it is released.
+   */
+  
+  /**
+   * Returns true if a memory budget is set.
+   */
+  bool ObjectPool::IsEnabled()
+  {
+    return _btk_object_pool_budget != 0;
+  };
+  
+  /**
+   * Returns the maximum memory (in bytes) kept by the pool.
+   */
+  size_t ObjectPool::GetMemoryBudget()
+  {
+    return _btk_object_pool_budget;
+  };
+  
+  /**
+   * Sets the maximum memory (in bytes) kept by the pool. Objects are released if the memory usage exceeds the new budget.
+   * Setting a budget of 0 disables the pool and releases all the kept objects.
+   */
+  void ObjectPool::SetMemoryBudget(size_t budget)
+  {
+    _btk_object_pool_budget = budget;
+    _btk_object_pool_evict(budget);
+  };
+  
+  /**
+   * Returns the memory (in bytes) used by the objects kept in the pool.
+   */
+  size_t ObjectPool::GetMemoryUsage()
+  {
+    return _btk_object_pool_usage();
+  };
+  
+  /**
+   * Returns the number of objects kept in the pool.
+   */
+  int ObjectPool::GetEntryNumber()
+  {
+    int num = 0;
+    object_pool_shard_p* shards = _btk_object_pool_shards();
+    for (int i = 0 ; i < _btk_object_pool_shard_number ; ++i)
+    {
+      shards[i].Lock.Lock();
+      num += shards[i].EntryNumber;
+      shards[i].Lock.Unlock();
+    }
+    return num;
+  };
+  
+  /**
+   * Returns the number of objects reused since the last call of ResetStatistics().
+   */
+  unsigned long ObjectPool::GetHitNumber()
+  {
+    unsigned long num = 0;
+    object_pool_shard_p* shards = _btk_object_pool_shards();
+    for (int i = 0 ; i < _btk_object_pool_shard_number ; ++i)
+    {
+      shards[i].Lock.Lock();
+      num += shards[i].HitNumber;
+      shards[i].Lock.Unlock();
+    }
+    return num;
+  };
+  
+  /**
+   * Returns the number of requests (when the pool is enabled) without object to reuse since the last call of ResetStatistics().
+   */
+  unsigned long ObjectPool::GetMissNumber()
+  {
+    unsigned long num = 0;
+    object_pool_shard_p* shards = _btk_object_pool_shards();
+    for (int i = 0 ; i < _btk_object_pool_shard_number ; ++i)
+    {
+      shards[i].Lock.Lock();
+      num += shards[i].MissNumber;
+      shards[i].Lock.Unlock();
+    }
+    return num;
+  };
+  
+  /**
+   * Reset the number of hits and misses.
+   */
+  void ObjectPool::ResetStatistics()
+  {
+    object_pool_shard_p* shards = _btk_object_pool_shards();
+    for (int i = 0 ; i < _btk_object_pool_shard_number ; ++i)
+    {
+      shards[i].Lock.Lock();
+      shards[i].HitNumber = 0;
+      shards[i].MissNumber = 0;
+      shards[i].Lock.Unlock();
+    }
+  };
+  
+  /**
+   * Release all the objects kept by the pool. The budget is not modified.
+   */
+  void ObjectPool::Clear()
+  {
+    object_pool_shard_p* shards = _btk_object_pool_shards();
+    for (int i = 0 ; i < _btk_object_pool_shard_number ; ++i)
+    {
+      object_pool_shard_p& shard = shards[i];
+      shard.Lock.Lock();
+      for (object_pool_buckets_p::iterator it = shard.Buckets.begin() ; it != shard.Buckets.end() ; ++it)
+      {
+        object_pool_bucket_p& bucket = it->second;
+        for (size_t j = 0 ; j < bucket.Objects.size() ; ++j)
+          bucket.Deleter(bucket.Objects[j]);
+        _btk_object_pool_add_usage(-static_cast<long>(bucket.Size * bucket.Objects.size()));
+        shard.EntryNumber -= static_cast<int>(bucket.Objects.size());
+      }
+      shard.Buckets.clear();
+      shard.Lock.Unlock();
+    }
+  };
+  
+  /**
+   * Returns an object of the given @a type stored with the given @a key (e.g. its number of frames) or a null pointer.
+   * The returned object is no more owned by the pool. 
+   * This method is used by the classes which recycle their objects (see Point::Data::New()).
+   */
+  void* ObjectPool::Take(const std::type_info& type, size_t key)
+  {
+    if (_btk_object_pool_budget == 0)
+      return 0;
+    void* object = 0;
+    size_t size = 0;
+    object_pool_shard_p& shard = _btk_object_pool_shard(key);
+    shard.Lock.Lock();
+    object_pool_buckets_p::iterator it = shard.Buckets.find(std::make_pair(&type, key));
+    if ((it != shard.Buckets.end()) && !it->second.Objects.empty())
+    {
+      object = it->second.Objects.back();
+      it->second.Objects.pop_back();
+      size = it->second.Size;
+      --shard.EntryNumber;
+      ++shard.HitNumber;
+    }
+    else
+      ++shard.MissNumber;
+    shard.Lock.Unlock();
+    if (object != 0)
+      _btk_object_pool_add_usage(-static_cast<long>(size));
+    return object;
+  };
+  
+  /**
+   * Keep the given @a object of the given @a type for a future call of Take() with the same @a key.
+   * The @a size is the memory (in bytes) used by the object and the @a deleter is used if the object is finally released.
+   * Returns false if the pool is disabled or if the object cannot be stored without exceeding the budget.
+   * In this case, the object is still owned by the caller.
+   */
+  bool ObjectPool::Store(void* object, const std::type_info& type, size_t key, size_t size, Deleter deleter)
+  {
+    size_t budget = _btk_object_pool_budget;
+    if ((budget == 0) || (size > budget))
+      return false;
+    // The memory is reserved before the storage of the object.
+    if (static_cast<size_t>(_btk_object_pool_add_usage(static_cast<long>(size))) > budget)
+    {
+      _btk_object_pool_evict(budget, &type, key);
+      if (_btk_object_pool_usage() > budget)
+      {
+        _btk_object_pool_add_usage(-static_cast<long>(size));
+        return false;
+      }
+    }
+    object_pool_shard_p& shard = _btk_object_pool_shard(key);
+    shard.Lock.Lock();
+    object_pool_bucket_p& bucket = shard.Buckets[std::make_pair(&type, key)];
+    bucket.Size = size;
+    bucket.Deleter = deleter;
+    bucket.Objects.push_back(object);
+    ++shard.EntryNumber;
+    shard.Lock.Unlock();
+    return true;
+  };
+  
+  /**
+   * Allocate a block of memory of the given @a size. A block previously released with the method 
+   * Deallocate() is returned if possible. This method is used by the operator new of the classes Point, Analog and Event.
+   */
+  void* ObjectPool::Allocate(size_t size)
+  {
+    void* ptr = ObjectPool::Take(typeid(void), size);
+    return (ptr != 0) ? ptr : ::operator new(size);
+  };
+  
+  /**
+   * Release a block of memory allocated with the method Allocate(). The block is kept in the pool if possible.
+   */
+  void ObjectPool::Deallocate(void* ptr, size_t size)
+  {
+    if (ptr == 0)
+      return;
+    if (!ObjectPool::Store(ptr, typeid(void), size, size, &_btk_object_pool_delete_block))
+      ::operator delete(ptr);
+  };
+};
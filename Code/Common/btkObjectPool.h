@@ -0,0 +1,76 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __btkObjectPool_h
+#define __btkObjectPool_h
+
+#include "btkConfigure.h"
+
+#include <cstddef>
+#include <typeinfo>
+
+namespace btk
+{
+  class ObjectPool
+  {
+  public:
+    typedef void (*Deleter)(void* object);
+    
+    BTK_COMMON_EXPORT static bool IsEnabled();
+    BTK_COMMON_EXPORT static size_t GetMemoryBudget();
+    BTK_COMMON_EXPORT static void SetMemoryBudget(size_t budget);
+    BTK_COMMON_EXPORT static size_t GetMemoryUsage();
+    BTK_COMMON_EXPORT static int GetEntryNumber();
+    
+    BTK_COMMON_EXPORT static unsigned long GetHitNumber();
+    BTK_COMMON_EXPORT static unsigned long GetMissNumber();
+    BTK_COMMON_EXPORT static void ResetStatistics();
+    BTK_COMMON_EXPORT static void Clear();
+    
+    BTK_COMMON_EXPORT static void* Take(const std::type_info& type, size_t key);
+    BTK_COMMON_EXPORT static bool Store(void* object, const std::type_info& type, size_t key, size_t size, Deleter deleter);
+    
+    BTK_COMMON_EXPORT static void* Allocate(size_t size);
+    BTK_COMMON_EXPORT static void Deallocate(void* ptr, size_t size);
+    
+  private:
+    ObjectPool();
+    ~ObjectPool();
+    ObjectPool(const ObjectPool& ); // Not implemented.
+    ObjectPool& operator=(const ObjectPool& ); // Not implemented.
+  };
+};
+
+#endif // __btkObjectPool_h
@@ -0,0 +1,294 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "btkPipelineExecutor.h"
+#include "btkThread_p.h"
+#include "btkConvert.h"
+#include "btkLogger.h"
+
+#include <algorithm>
+#include <exception>
+#include <map>
+
+namespace btk
+{
+  class PipelineExecutorTask_p : public parallel_task_p
+  {
+  public:
+    PipelineExecutorTask_p(const std::vector<ProcessObject*>* processes, const std::vector<int>* indices, std::vector<std::string>* errors)
+    : mp_Processes(processes), mp_Indices(indices), mp_Errors(errors)
+    {};
+    virtual void Run(int idx)
+    {
+      const int node = (*this->mp_Indices)[idx];
+      try
+      {
+        PipelineExecutor::UpdateData((*this->mp_Processes)[node]);
+      }
+      catch (std::exception& e)
+      {
+        (*this->mp_Errors)[node] = e.what();
+      }
+      catch (...)
+      {
+        (*this->mp_Errors)[node] = "Unknown exception.";
+      }
+    };
+  private:
+    const std::vector<ProcessObject*>* mp_Processes;
+    const std::vector<int>* mp_Indices;
+    std::vector<std::string>* mp_Errors;
+  };
+  
+  /**
+   * @class PipelineExecutor btkPipelineExecutor.h
+   * @brief Updates the independent branches of one or more pipelines concurrently.
+   *
+   * The method ProcessObject::Update() updates the inputs of a process one after the other. A pipeline which fans out 
+   * (for example, an acquisition used by a force platform chain, an IMU extractor and a unit converter) is then 
+   * updated sequentially even if its branches are independent. This class walks the inputs of the given processes 
+   * (see AddProcess()) to build the graph of their dependencies and sorts the processes by levels. A process is set
+   * in the level following the one of its deepest source. The processes of a same level are independent and 
+   * are updated concurrently. Each level is finished before starting the next one.
+   *
+   * The rules of ProcessObject::Update() are kept: a process generates its data only if it was modified or if one 
+   * of its inputs is newer than it. As with the serial update, a link creating a cycle in the pipeline is ignored.
+   * The processes updated concurrently must not modify their inputs.
+   *
+   * @code
+   * btk::PipelineExecutor::Pointer executor = btk::PipelineExecutor::New();
+   * executor->AddProcess(gaitEventDetector);
+   * executor->AddProcess(imuExtractor);
+   * executor->AddProcess(unitConverter);
+   * executor->Update(); // The reader is updated first, then the three branches concurrently.
+   * @endcode
+   *
+   * @ingroup BTKCommon
+   */
+  
+  /**
+   * @typedef PipelineExecutor::Pointer
+   * Smart pointer associated with a PipelineExecutor object.
+   */
+  
+  /**
+   * @typedef PipelineExecutor::ConstPointer
+   * Smart pointer associated with a const PipelineExecutor object.
+   */
+  
+  /**
+   * @fn static Pointer PipelineExecutor::New()
+   * Creates a smart pointer associated with a PipelineExecutor object.
+   */
+  
+  /**
+   * @fn int PipelineExecutor::GetProcessNumber() const
+   * Returns the number of processes to update (their sources are not counted).
+   */
+  
+  /**
+   * Adds a process to update. Its sources are found during the update and don't need to be added.
+   */
+  void PipelineExecutor::AddProcess(ProcessObject::Pointer process)
+  {
+    if (!process)
+    {
+      btkErrorMacro("Impossible to add a null process.");
+      return;
+    }
+    if (std::find(this->m_Processes.begin(), this->m_Processes.end(), process) == this->m_Processes.end())
+      this->m_Processes.push_back(process);
+  };
+  
+  /**
+   * Removes the given process from the processes to update.
+   */
+  void PipelineExecutor::RemoveProcess(ProcessObject::Pointer process)
+  {
+    std::vector<ProcessObject::Pointer>::iterator it = std::find(this->m_Processes.begin(), this->m_Processes.end(), process);
+    if (it != this->m_Processes.end())
+      this->m_Processes.erase(it);
+  };
+  
+  /**
+   * Removes all the processes to update.
+   */
+  void PipelineExecutor::ClearProcesses()
+  {
+    this->m_Processes.clear();
+  };
+  
+  /**
+   * @fn int PipelineExecutor::GetThreadNumber() const
+   * Returns the number of threads used to update the processes of a same level.
+   */
+  
+  /**
+   * @fn void PipelineExecutor::SetThreadNumber(int num)
+   * Sets the number of threads used to update the processes of a same level. 
+   * A value lower or equal to 0 (default) means that the number of processors is used.
+   */
+  
+  /**
+   * @fn int PipelineExecutor::GetLevelNumber() const
+   * Returns the number of levels found during the last update.
+   */
+  
+  /**
+   * Updates the processes and their sources. Returns false if the generation of the data of at least one process 
+   * thrown an exception. In this case, the processes depending on it are not updated and the exceptions are logged
+   * as errors. The other processes are still updated.
+   */
+  bool PipelineExecutor::Update()
+  {
+    // Graph of the dependencies (depth-first walk without recursion).
+    std::vector<ProcessObject*> processes;
+    std::vector< std::vector<ProcessObject*> > sources;
+    std::vector< std::vector<int> > dependencies;
+    std::vector<int> levels;
+    std::vector<int> states; // 0: not visited, 1: visiting, 2: visited
+    std::map<ProcessObject*, int> indices;
+    std::vector< std::pair<int, size_t> > stack;
+    for (size_t i = 0 ; i < this->m_Processes.size() ; ++i)
+    {
+      ProcessObject* process = this->m_Processes[i].get();
+      do
+      {
+        std::map<ProcessObject*, int>::iterator it = indices.find(process);
+        int node = 0;
+        if (it == indices.end())
+        {
+          node = static_cast<int>(processes.size());
+          indices.insert(std::make_pair(process, node));
+          processes.push_back(process);
+          sources.push_back(std::vector<ProcessObject*>());
+          process->CollectSources(sources.back());
+          dependencies.push_back(std::vector<int>());
+          levels.push_back(0);
+          states.push_back(0);
+        }
+        else
+          node = it->second;
+        if (!stack.empty())
+        {
+          // Like the serial update, a link creating a cycle is ignored.
+          if (states[node] == 1)
+            node = -1;
+          else
+            dependencies[stack.back().first].push_back(node);
+        }
+        if ((node != -1) && (states[node] == 0))
+        {
+          states[node] = 1;
+          stack.push_back(std::make_pair(node, 0));
+        }
+        process = 0;
+        while (!stack.empty() && (process == 0))
+        {
+          const int current = stack.back().first;
+          if (stack.back().second < sources[current].size())
+            process = sources[current][stack.back().second++];
+          else
+          {
+            for (size_t j = 0 ; j < dependencies[current].size() ; ++j)
+              levels[current] = std::max(levels[current], levels[dependencies[current][j]] + 1);
+            states[current] = 2;
+            stack.pop_back();
+          }
+        }
+      }
+      while (process != 0);
+    }
+    
+    // Update level by level
+    this->m_LevelNumber = 0;
+    for (size_t i = 0 ; i < levels.size() ; ++i)
+      this->m_LevelNumber = std::max(this->m_LevelNumber, levels[i] + 1);
+    std::vector< std::vector<int> > nodes(this->m_LevelNumber);
+    for (size_t i = 0 ; i < levels.size() ; ++i)
+    {
+      nodes[levels[i]].push_back(static_cast<int>(i));
+      processes[i]->m_Updating = true; // A process calling the update of its inputs is stopped as with the serial update.
+    }
+    std::vector<std::string> errors(processes.size());
+    std::vector<int> skipped(processes.size(), 0);
+    for (int i = 0 ; i < this->m_LevelNumber ; ++i)
+    {
+      std::vector<int> toUpdate;
+      for (size_t j = 0 ; j < nodes[i].size() ; ++j)
+      {
+        const int node = nodes[i][j];
+        for (size_t k = 0 ; k < dependencies[node].size() ; ++k)
+        {
+          if (!errors[dependencies[node][k]].empty() || skipped[dependencies[node][k]])
+          {
+            skipped[node] = 1;
+            break;
+          }
+        }
+        if (!skipped[node])
+          toUpdate.push_back(node);
+      }
+      PipelineExecutorTask_p task(&processes, &toUpdate, &errors);
+      parallel_for_p(static_cast<int>(toUpdate.size()), &task, this->m_ThreadNumber);
+    }
+    
+    bool succeeded = true;
+    int numSkipped = 0;
+    for (size_t i = 0 ; i < processes.size() ; ++i)
+    {
+      processes[i]->m_Updating = false;
+      if (!errors[i].empty())
+      {
+        btkErrorMacro("The update of a process failed: " + errors[i]);
+        succeeded = false;
+      }
+      numSkipped += skipped[i];
+    }
+    if (numSkipped != 0)
+      btkErrorMacro(ToString(numSkipped) + " process(es) not updated due to the failure of their sources.");
+    return succeeded;
+  };
+  
+  /**
+   * Constructor. No process is set and the number of processors is used.
+   */
+  PipelineExecutor::PipelineExecutor()
+  : m_Processes()
+  {
+    this->m_ThreadNumber = 0;
+    this->m_LevelNumber = 0;
+  };
+};
@@ -0,0 +1,84 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __btkPipelineExecutor_h
+#define __btkPipelineExecutor_h
+
+#include "btkProcessObject.h"
+
+#include <vector>
+
+namespace btk
+{
+  class PipelineExecutor
+  {
+  public:
+    typedef btkSharedPtr<PipelineExecutor> Pointer;
+    typedef btkSharedPtr<const PipelineExecutor> ConstPointer;
+    
+    static Pointer New() {return Pointer(new PipelineExecutor());};
+    
+    // ~PipelineExecutor(); // Implicit
+    
+    int GetProcessNumber() const {return static_cast<int>(this->m_Processes.size());};
+    BTK_COMMON_EXPORT void AddProcess(ProcessObject::Pointer process);
+    BTK_COMMON_EXPORT void RemoveProcess(ProcessObject::Pointer process);
+    BTK_COMMON_EXPORT void ClearProcesses();
+    
+    int GetThreadNumber() const {return this->m_ThreadNumber;};
+    void SetThreadNumber(int num) {this->m_ThreadNumber = num;};
+    
+    int GetLevelNumber() const {return this->m_LevelNumber;};
+    
+    BTK_COMMON_EXPORT bool Update();
+    
+  protected:
+    BTK_COMMON_EXPORT PipelineExecutor();
+    
+  private:
+    PipelineExecutor(const PipelineExecutor& ); // Not implemented.
+    PipelineExecutor& operator=(const PipelineExecutor& ); // Not implemented.
+    
+    static void UpdateData(ProcessObject* process) {process->UpdateData();};
+    
+    std::vector<ProcessObject::Pointer> m_Processes;
+    int m_ThreadNumber;
+    int m_LevelNumber;
+    
+    friend class PipelineExecutorTask_p;
+  };
+};
+
+#endif // __btkPipelineExecutor_h
@@ -61,7 +61,7 @@ namespace btk
       typedef btkSharedPtr<const Data> ConstPointer;
       typedef btkNullPtr<Data> NullPointer;
       
-      static Pointer New(int frameNumber) {return Pointer(new Data(frameNumber));};
+      BTK_COMMON_EXPORT static Pointer New(int frameNumber);
       
       static NullPointer Null() {return NullPointer();}; 
       
@@ -78,6 +78,9 @@ namespace btk
       Data(const Data& toCopy) : MeasureData<Point>(toCopy), m_Residuals(toCopy.m_Residuals) {};
       Data& operator=(const Data& ); // Not implemented.
       
+      BTK_COMMON_EXPORT static void Recycle(Data* data);
+      static void Delete(void* data);
+      
       Residuals m_Residuals;
     };
   };
@@ -99,6 +102,9 @@ namespace btk
     
     static NullPointer Null() {return NullPointer();}; 
     
+    BTK_COMMON_EXPORT static void* operator new(size_t size);
+    BTK_COMMON_EXPORT static void operator delete(void* ptr, size_t size);
+    
     virtual ~Point() {};
     
     void SetDataSlice(int idx, double x, double y, double z, double res = 0.0);
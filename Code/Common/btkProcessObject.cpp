@@ -34,9 +34,38 @@
  */
 
 #include "btkProcessObject.h"
+#include "btkInstrumentation.h"
+#include "btkAcquisition.h"
+#include "btkForcePlatformCollection.h"
+#include "btkWrenchCollection.h"
+#include "btkIMUCollection.h"
 #include "btkConvert.h"
 #include "btkLogger.h"
 
+#include <typeinfo>
+
+// Number of items stored in an output (used by the instrumentation).
+static size_t _btk_process_object_items(btk::DataObject* output)
+{
+  if (output == 0)
+    return 0;
+  else if (btk::Acquisition* acq = dynamic_cast<btk::Acquisition*>(output))
+    return static_cast<size_t>(acq->GetPointNumber() + acq->GetAnalogNumber() + acq->GetEventNumber());
+  else if (btk::PointCollection* points = dynamic_cast<btk::PointCollection*>(output))
+    return static_cast<size_t>(points->GetItemNumber());
+  else if (btk::AnalogCollection* analogs = dynamic_cast<btk::AnalogCollection*>(output))
+    return static_cast<size_t>(analogs->GetItemNumber());
+  else if (btk::EventCollection* events = dynamic_cast<btk::EventCollection*>(output))
+    return static_cast<size_t>(events->GetItemNumber());
+  else if (btk::ForcePlatformCollection* fps = dynamic_cast<btk::ForcePlatformCollection*>(output))
+    return static_cast<size_t>(fps->GetItemNumber());
+  else if (btk::WrenchCollection* wrenches = dynamic_cast<btk::WrenchCollection*>(output))
+    return static_cast<size_t>(wrenches->GetItemNumber());
+  else if (btk::IMUCollection* imus = dynamic_cast<btk::IMUCollection*>(output))
+    return static_cast<size_t>(imus->GetItemNumber());
+  return 1;
+};
+
 namespace btk
 {
   /**
@@ -156,6 +185,9 @@ namespace btk
   /**
    * Recursive method which 1) determines the processes to update and 2) 
    * generate the data by using the GenerateData() method.
+   *
+   * The inputs are updated sequentially. To update the independent branches of a pipeline
+   * concurrently, use the class PipelineExecutor.
    */
   void ProcessObject::Update()
   {
@@ -166,24 +198,9 @@ namespace btk
     for (size_t inc = 0 ; inc < this->m_Inputs.size() ; ++inc)
     {
       if (this->m_Inputs[inc] != DataObject::Null)
-      {
         this->m_Inputs[inc]->Update();
-        if (this->m_Inputs[inc]->m_Timestamp >= this->m_Timestamp)
-          this->m_Modified = true;
-      }
-    }
-    if (this->m_Modified)
-    {
-      unsigned long int ts = this->GetTimestamp();
-      this->GenerateData();
-      this->Object::Modified();
-      for (size_t inc = 0 ; inc < this->m_Outputs.size() ; ++inc)
-      {
-        if ((this->m_Outputs[inc] != DataObject::Null) && (this->m_Outputs[inc]->GetTimestamp() > ts))
-          this->m_Outputs[inc]->m_Timestamp = this->m_Timestamp;
-      }
-      this->m_Modified = false;
     }
+    this->UpdateData();
     this->m_Updating = false;
   };
 
@@ -195,6 +212,27 @@ namespace btk
     this->m_Updating = false;
   };
   
+  /**
+   * @fn ResultCache::Pointer ProcessObject::GetResultCache() const
+   * Returns the cache used to memoize the outputs of this process or a null pointer if no cache is used.
+   */
+  
+  /**
+   * Sets the cache used to memoize the outputs of this process. The same cache can be shared by several processes.
+   * 
+   * Only the processes which implement the method GetCacheParameters() use the cache. When the outputs 
+   * corresponding to the same type of process, the same parameters and the same inputs are found in the cache, 
+   * they are restored instead of generated. Set a null pointer to disable the cache (default).
+   */
+  void ProcessObject::SetResultCache(ResultCache::Pointer cache)
+  {
+    if (this->m_ResultCache == cache)
+      return;
+    this->m_ResultCache = cache;
+    this->m_CacheDigest.clear();
+    this->Modified();
+  };
+  
   /**
    * Process constructor with zero input and output. The inherited class set the number
    * of inputs/ouputs with the functions SetInputNumber() and SetOutputNumber().
@@ -206,6 +244,8 @@ namespace btk
   {
     this->m_Modified = false;
     this->m_Updating = false;
+    this->m_ResultCache = ResultCache::Pointer();
+    this->m_CacheDigest = "";
   };
   
   /**
@@ -381,6 +421,106 @@ namespace btk
     // this->Object::Modified();
   };
   
+  /**
+   * Appends to @a sources the processes which generate the inputs of this process.
+   */
+  void ProcessObject::CollectSources(std::vector<ProcessObject*>& sources) const
+  {
+    for (size_t inc = 0 ; inc < this->m_Inputs.size() ; ++inc)
+    {
+      if ((this->m_Inputs[inc] != DataObject::Null) && (this->m_Inputs[inc]->mp_Source != 0))
+        sources.push_back(this->m_Inputs[inc]->mp_Source);
+    }
+  };
+  
+  /**
+   * Generates the data if the process or one of its inputs was modified since the last generation.
+   * The inputs must be already updated.
+   *
+   * When the instrumentation is enabled, the generation is measured and reported under the category "ProcessObject" (see Instrumentation).
+   */
+  void ProcessObject::UpdateData()
+  {
+    for (size_t inc = 0 ; inc < this->m_Inputs.size() ; ++inc)
+    {
+      if ((this->m_Inputs[inc] != DataObject::Null) && (this->m_Inputs[inc]->m_Timestamp >= this->m_Timestamp))
+        this->m_Modified = true;
+    }
+    if (this->m_Modified)
+    {
+      unsigned long int ts = this->GetTimestamp();
+      Instrumentation::Scope scope("ProcessObject", typeid(*this));
+      std::string key;
+      if (this->m_ResultCache && this->ComputeCacheKey(key))
+      {
+        this->m_CacheDigest = ResultCache::ComputeDigest(key);
+        if (!this->m_ResultCache->Restore(key, this->m_Outputs))
+        {
+          this->GenerateData();
+          this->m_ResultCache->Store(key, this->m_Outputs);
+        }
+        else if (scope.IsActive())
+          scope.SetDetail("Restored from the cache");
+      }
+      else
+      {
+        this->m_CacheDigest.clear();
+        this->GenerateData();
+      }
+      if (scope.IsActive())
+      {
+        size_t items = 0;
+        for (size_t inc = 0 ; inc < this->m_Outputs.size() ; ++inc)
+          items += _btk_process_object_items(this->m_Outputs[inc].get());
+        scope.SetItems(items);
+        scope.Stop();
+      }
+      this->Object::Modified();
+      for (size_t inc = 0 ; inc < this->m_Outputs.size() ; ++inc)
+      {
+        if ((this->m_Outputs[inc] != DataObject::Null) && (this->m_Outputs[inc]->GetTimestamp() > ts))
+          this->m_Outputs[inc]->m_Timestamp = this->m_Timestamp;
+      }
+      this->m_Modified = false;
+    }
+  };
+  
+  /**
+   * Computes the key used to find the outputs of this process in its cache. The key is composed of the type of the 
+   * process, its parameters and the identification of each input. An input generated by a process using a cache and 
+   * not modified since is identified by the key of its source. Other inputs are identified by the digest of their content.
+   * Returns false if the process cannot use a cache.
+   */
+  bool ProcessObject::ComputeCacheKey(std::string& key) const
+  {
+    std::string parameters;
+    if (!this->GetCacheParameters(parameters))
+      return false;
+    key = std::string(typeid(*this).name()) + "\n" + parameters;
+    for (size_t inc = 0 ; inc < this->m_Inputs.size() ; ++inc)
+    {
+      const DataObject* input = this->m_Inputs[inc].get();
+      const ProcessObject* source = (input != 0) ? input->mp_Source : 0;
+      if (input == 0)
+        key += "\n-";
+      else if ((source != 0) && !source->m_CacheDigest.empty() && (input->m_Timestamp <= source->m_Timestamp))
+      {
+        int idx = 0;
+        while ((idx < source->GetOutputNumber()) && (source->m_Outputs[idx].get() != input))
+          ++idx;
+        key += "\nS" + source->m_CacheDigest + ":" + ToString(idx);
+      }
+      else
+      {
+        std::string digest;
+        if (!ResultCache::ComputeContentDigest(this->m_Inputs[inc], digest))
+          return false;
+        key += "\nC" + digest;
+      }
+    }
+    return true;
+  };
+  
   /**
    * @fn bool ProcessObject::IsModified() const
    * Indicates if the process is modified or not.
@@ -395,4 +535,14 @@ namespace btk
    * @fn virtual DataObject::Pointer ProcessObject::MakeOutput(int idx) = 0
    * Creates and returns a DataObject::Pointer for the given index @a idx.
    */
+  
+  /**
+   * Sets @a parameters with a textual representation of the parameters of the process which modify its outputs.
+   * Returns false if the outputs cannot be cached (default). An inherited class has to implement this method 
+   * to use a ResultCache object. It must return false if the outputs depend on a state kept between updates.
+   */
+  bool ProcessObject::GetCacheParameters(std::string& ) const
+  {
+    return false;
+  };
 };
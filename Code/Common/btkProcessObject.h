@@ -38,7 +38,9 @@
 
 #include "btkObject.h"
 #include "btkDataObject.h"
+#include "btkResultCache.h"
 
+#include <string>
 #include <vector>
 
 namespace btk
@@ -57,6 +59,9 @@ namespace btk
     BTK_COMMON_EXPORT void Update();
     BTK_COMMON_EXPORT void ResetState();
     
+    ResultCache::Pointer GetResultCache() const {return this->m_ResultCache;};
+    BTK_COMMON_EXPORT void SetResultCache(ResultCache::Pointer cache);
+    
   protected:
     BTK_COMMON_EXPORT ProcessObject();
     BTK_COMMON_EXPORT virtual ~ProcessObject();
@@ -77,15 +82,24 @@ namespace btk
     bool IsModified() const {return this->m_Modified;};
     BTK_COMMON_EXPORT virtual void GenerateData() = 0;
     BTK_COMMON_EXPORT virtual DataObject::Pointer MakeOutput(int idx) = 0;
+    BTK_COMMON_EXPORT virtual bool GetCacheParameters(std::string& parameters) const;
     
   private:
     ProcessObject(const ProcessObject& ); // Not implemented.
     ProcessObject& operator=(const ProcessObject& ); // Not implemented.
     
+    void CollectSources(std::vector<ProcessObject*>& sources) const;
+    void UpdateData();
+    bool ComputeCacheKey(std::string& key) const;
+    
     std::vector<DataObject::Pointer> m_Inputs;
     std::vector<DataObject::Pointer> m_Outputs;
     bool m_Modified;
     bool m_Updating;
+    ResultCache::Pointer m_ResultCache;
+    std::string m_CacheDigest;
+    
+    friend class PipelineExecutor;
   };
 };
 
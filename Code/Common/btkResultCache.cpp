@@ -0,0 +1,626 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "btkResultCache.h"
+#include "btkCriticalSection_p.h"
+#include "btkAcquisition.h"
+#include "btkForcePlatformCollection.h"
+#include "btkWrenchCollection.h"
+#include "btkIMUCollection.h"
+
+#include <cstdio>
+#include <typeinfo>
+
+namespace btk
+{
+  // 64-bit FNV-1a hash
+  class content_hash_p
+  {
+  public:
+    content_hash_p()
+    {
+      this->m_Value = (static_cast<uint64_t>(0xcbf29ce4u) << 32) | static_cast<uint64_t>(0x84222325u);
+    };
+    void Add(const void* data, size_t size)
+    {
+      const uint64_t prime = (static_cast<uint64_t>(1u) << 40) | static_cast<uint64_t>(0x1b3u);
+      const unsigned char* bytes = static_cast<const unsigned char*>(data);
+      for (size_t i = 0 ; i < size ; ++i)
+      {
+        this->m_Value ^= static_cast<uint64_t>(bytes[i]);
+        this->m_Value *= prime;
+      }
+    };
+    void Add(int value) {this->Add(&value, sizeof(int));};
+    void Add(double value) {this->Add(&value, sizeof(double));};
+    void Add(const std::string& value)
+    {
+      this->Add(static_cast<int>(value.size()));
+      this->Add(value.data(), value.size());
+    };
+    template <typename M> void AddMatrix(const M& m)
+    {
+      this->Add(static_cast<int>(m.rows()));
+      this->Add(static_cast<int>(m.cols()));
+      this->Add(m.data(), sizeof(double) * static_cast<size_t>(m.size()));
+    };
+    std::string GetDigest() const
+    {
+      char digest[17];
+      sprintf(digest, "%08x%08x", static_cast<unsigned int>(this->m_Value >> 32), static_cast<unsigned int>(this->m_Value & 0xffffffffu));
+      return std::string(digest);
+    };
+  private:
+    uint64_t m_Value;
+  };
+  
+  static void _btk_result_cache_hash(content_hash_p& h, const MetaData* md)
+  {
+    h.Add(md->GetLabel());
+    h.Add(md->GetDescription());
+    h.Add(md->GetUnlockState() ? 1 : 0);
+    MetaDataInfo::ConstPointer info = md->GetInfo();
+    if (info)
+    {
+      h.Add(static_cast<int>(info->GetFormat()));
+      const std::vector<uint8_t>& dims = info->GetDimensions();
+      h.Add(static_cast<int>(dims.size()));
+      if (!dims.empty())
+        h.Add(&(dims[0]), dims.size());
+      std::vector<std::string> values;
+      info->ToString(values);
+      for (size_t i = 0 ; i < values.size() ; ++i)
+        h.Add(values[i]);
+    }
+    h.Add(md->GetChildNumber());
+    for (MetaData::ConstIterator it = md->Begin() ; it != md->End() ; ++it)
+      _btk_result_cache_hash(h, it->get());
+  };
+  
+  static void _btk_result_cache_hash(content_hash_p& h, const Point* pt)
+  {
+    h.Add(pt->GetLabel());
+    h.Add(pt->GetDescription());
+    h.Add(static_cast<int>(pt->GetType()));
+    h.AddMatrix(pt->GetValues());
+    h.AddMatrix(pt->GetResiduals());
+  };
+  
+  static void _btk_result_cache_hash(content_hash_p& h, const Analog* an)
+  {
+    h.Add(an->GetLabel());
+    h.Add(an->GetDescription());
+    h.Add(an->GetUnit());
+    h.Add(static_cast<int>(an->GetGain()));
+    h.Add(an->GetOffset());
+    h.Add(an->GetScale());
+    h.AddMatrix(an->GetValues());
+  };
+  
+  static void _btk_result_cache_hash(content_hash_p& h, const Event* evt)
+  {
+    h.Add(evt->GetLabel());
+    h.Add(evt->GetDescription());
+    h.Add(evt->GetContext());
+    h.Add(evt->GetSubject());
+    h.Add(evt->GetTime());
+    h.Add(evt->GetFrame());
+    h.Add(evt->GetDetectionFlags());
+    h.Add(evt->GetId());
+  };
+  
+  static void _btk_result_cache_hash(content_hash_p& h, const ForcePlatform* fp)
+  {
+    h.Add(fp->GetType());
+    h.AddMatrix(fp->GetOrigin());
+    h.AddMatrix(fp->GetCorners());
+    h.AddMatrix(fp->GetCalMatrix());
+    h.Add(fp->GetChannelNumber());
+    for (AnalogCollection::ConstIterator it = fp->GetChannels()->Begin() ; it != fp->GetChannels()->End() ; ++it)
+      _btk_result_cache_hash(h, it->get());
+  };
+  
+  static void _btk_result_cache_hash(content_hash_p& h, const Wrench* wrh)
+  {
+    _btk_result_cache_hash(h, wrh->GetPosition().get());
+    _btk_result_cache_hash(h, wrh->GetForce().get());
+    _btk_result_cache_hash(h, wrh->GetMoment().get());
+  };
+  
+  static void _btk_result_cache_hash(content_hash_p& h, const Acquisition* acq)
+  {
+    h.Add(acq->GetFirstFrame());
+    h.Add(acq->GetPointFrequency());
+    h.Add(acq->GetPointFrameNumber());
+    h.Add(acq->GetNumberAnalogSamplePerFrame());
+    h.Add(static_cast<int>(acq->GetAnalogResolution()));
+    h.Add(acq->GetMaxInterpolationGap());
+    for (size_t i = 0 ; i < acq->GetPointUnits().size() ; ++i)
+      h.Add(acq->GetPointUnits()[i]);
+    h.Add(acq->GetPointNumber());
+    for (Acquisition::PointConstIterator it = acq->BeginPoint() ; it != acq->EndPoint() ; ++it)
+      _btk_result_cache_hash(h, it->get());
+    h.Add(acq->GetAnalogNumber());
+    for (Acquisition::AnalogConstIterator it = acq->BeginAnalog() ; it != acq->EndAnalog() ; ++it)
+      _btk_result_cache_hash(h, it->get());
+    h.Add(acq->GetEventNumber());
+    for (Acquisition::EventConstIterator it = acq->BeginEvent() ; it != acq->EndEvent() ; ++it)
+      _btk_result_cache_hash(h, it->get());
+    _btk_result_cache_hash(h, acq->GetMetaData().get());
+  };
+  
+  template <typename T>
+  static bool _btk_result_cache_hash_collection(content_hash_p& h, const DataObject* obj)
+  {
+    const Collection<T>* col = dynamic_cast<const Collection<T>*>(obj);
+    if (col == 0)
+      return false;
+    h.Add(col->GetItemNumber());
+    for (typename Collection<T>::ConstIterator it = col->Begin() ; it != col->End() ; ++it)
+      _btk_result_cache_hash(h, it->get());
+    return true;
+  };
+  
+  template <typename T>
+  static bool _btk_result_cache_hash_item(content_hash_p& h, const DataObject* obj)
+  {
+    const T* item = dynamic_cast<const T*>(obj);
+    if (item == 0)
+      return false;
+    _btk_result_cache_hash(h, item);
+    return true;
+  };
+  
+  // The type is added to the hash to distinguish the empty objects.
+  static bool _btk_result_cache_hash_object(content_hash_p& h, const DataObject* obj)
+  {
+    if (_btk_result_cache_hash_item<Acquisition>(h, obj)) {h.Add(1); return true;}
+    if (_btk_result_cache_hash_collection<ForcePlatform>(h, obj)) {h.Add(2); return true;}
+    if (_btk_result_cache_hash_collection<Wrench>(h, obj)) {h.Add(3); return true;}
+    if (_btk_result_cache_hash_collection<Event>(h, obj)) {h.Add(4); return true;}
+    if (_btk_result_cache_hash_collection<Point>(h, obj)) {h.Add(5); return true;}
+    if (_btk_result_cache_hash_collection<Analog>(h, obj)) {h.Add(6); return true;}
+    if (_btk_result_cache_hash_item<Wrench>(h, obj)) {h.Add(7); return true;}
+    if (_btk_result_cache_hash_item<ForcePlatform>(h, obj)) {h.Add(8); return true;}
+    if (_btk_result_cache_hash_item<Point>(h, obj)) {h.Add(9); return true;}
+    if (_btk_result_cache_hash_item<Analog>(h, obj)) {h.Add(10); return true;}
+    return false;
+  };
+  
+  // ----------------------------------------------------------------------- //
+  
+  static size_t _btk_result_cache_size(const Point* pt) {return sizeof(Point) + sizeof(double) * static_cast<size_t>(pt->GetValues().size() + pt->GetResiduals().size());};
+  static size_t _btk_result_cache_size(const Analog* an) {return sizeof(Analog) + sizeof(double) * static_cast<size_t>(an->GetValues().size());};
+  static size_t _btk_result_cache_size(const Event* ) {return sizeof(Event);};
+  static size_t _btk_result_cache_size(const IMU* imu) 
+  {
+    size_t size = sizeof(IMU);
+    AnalogCollection::Pointer channels = const_cast<IMU*>(imu)->GetChannels();
+    for (AnalogCollection::ConstIterator it = channels->Begin() ; it != channels->End() ; ++it)
+      size += _btk_result_cache_size(it->get());
+    return size;
+  };
+  static size_t _btk_result_cache_size(const Wrench* wrh) 
+  {
+    return sizeof(Wrench) + _btk_result_cache_size(wrh->GetPosition().get()) + _btk_result_cache_size(wrh->GetForce().get()) + _btk_result_cache_size(wrh->GetMoment().get());
+  };
+  static size_t _btk_result_cache_size(const ForcePlatform* fp) 
+  {
+    size_t size = sizeof(ForcePlatform) + sizeof(double) * static_cast<size_t>(fp->GetCalMatrix().size());
+    for (AnalogCollection::ConstIterator it = fp->GetChannels()->Begin() ; it != fp->GetChannels()->End() ; ++it)
+      size += _btk_result_cache_size(it->get());
+    return size;
+  };
+  static size_t _btk_result_cache_size(const Acquisition* acq) 
+  {
+    size_t size = sizeof(Acquisition);
+    for (Acquisition::PointConstIterator it = acq->BeginPoint() ; it != acq->EndPoint() ; ++it)
+      size += _btk_result_cache_size(it->get());
+    for (Acquisition::AnalogConstIterator it = acq->BeginAnalog() ; it != acq->EndAnalog() ; ++it)
+      size += _btk_result_cache_size(it->get());
+    size += sizeof(Event) * static_cast<size_t>(acq->GetEventNumber());
+    return size;
+  };
+  
+  // ----------------------------------------------------------------------- //
+  
+  template <typename T>
+  static bool _btk_result_cache_clone_collection(const DataObject* obj, DataObject::Pointer& clone, size_t& size)
+  {
+    const Collection<T>* col = dynamic_cast<const Collection<T>*>(obj);
+    if (col == 0)
+      return false;
+    clone = col->Clone();
+    size = sizeof(Collection<T>);
+    for (typename Collection<T>::ConstIterator it = col->Begin() ; it != col->End() ; ++it)
+      size += _btk_result_cache_size(it->get());
+    return true;
+  };
+  
+  template <typename T>
+  static bool _btk_result_cache_clone_item(const DataObject* obj, DataObject::Pointer& clone, size_t& size)
+  {
+    const T* item = dynamic_cast<const T*>(obj);
+    if (item == 0)
+      return false;
+    clone = item->Clone();
+    size = _btk_result_cache_size(item);
+    return true;
+  };
+  
+  // Deep copy of the supported objects with their approximative memory size.
+  static DataObject::Pointer _btk_result_cache_clone(const DataObject* obj, size_t& size)
+  {
+    DataObject::Pointer clone;
+    if (_btk_result_cache_clone_item<Acquisition>(obj, clone, size)
+        || _btk_result_cache_clone_collection<ForcePlatform>(obj, clone, size)
+        || _btk_result_cache_clone_collection<Wrench>(obj, clone, size)
+        || _btk_result_cache_clone_collection<Event>(obj, clone, size)
+        || _btk_result_cache_clone_collection<Point>(obj, clone, size)
+        || _btk_result_cache_clone_collection<Analog>(obj, clone, size)
+        || _btk_result_cache_clone_collection<IMU>(obj, clone, size)
+        || _btk_result_cache_clone_item<Wrench>(obj, clone, size))
+      return clone;
+    return DataObject::Pointer();
+  };
+  
+  template <typename T>
+  static bool _btk_result_cache_assign_collection(DataObject* dst, DataObject::Pointer src)
+  {
+    Collection<T>* col = dynamic_cast<Collection<T>*>(dst);
+    if (col == 0)
+      return false;
+    typename Collection<T>::Pointer items = static_pointer_cast< Collection<T> >(src);
+    col->Clear();
+    for (typename Collection<T>::ConstIterator it = items->Begin() ; it != items->End() ; ++it)
+      col->InsertItem(*it);
+    return true;
+  };
+  
+  // Sets the content of the given output (the same object is kept as it can be used by other processes) 
+  // with the content of a clone of a cached object.
+  static bool _btk_result_cache_assign(DataObject* dst, DataObject::Pointer src)
+  {
+    if (typeid(*dst) != typeid(*src))
+      return false;
+    Acquisition* acq = dynamic_cast<Acquisition*>(dst);
+    if (acq != 0)
+    {
+      Acquisition::Pointer cached = static_pointer_cast<Acquisition>(src);
+      acq->Reset();
+      acq->SetFirstFrame(cached->GetFirstFrame());
+      acq->SetPointFrequency(cached->GetPointFrequency());
+      acq->SetAnalogResolution(cached->GetAnalogResolution());
+      acq->SetPointUnits(cached->GetPointUnits());
+      acq->SetMaxInterpolationGap(cached->GetMaxInterpolationGap());
+      acq->SetEvents(cached->GetEvents());
+      acq->SetMetaData(cached->GetMetaData());
+      acq->SetPoints(cached->GetPoints());
+      acq->SetAnalogs(cached->GetAnalogs());
+      // To set internal variables
+      acq->Resize(cached->GetPointNumber(), cached->GetPointFrameNumber(), cached->GetAnalogNumber(), cached->GetNumberAnalogSamplePerFrame());
+      return true;
+    }
+    Wrench* wrh = dynamic_cast<Wrench*>(dst);
+    if (wrh != 0)
+    {
+      Wrench::Pointer cached = static_pointer_cast<Wrench>(src);
+      wrh->SetPosition(cached->GetPosition());
+      wrh->SetForce(cached->GetForce());
+      wrh->SetMoment(cached->GetMoment());
+      return true;
+    }
+    return _btk_result_cache_assign_collection<ForcePlatform>(dst, src)
+        || _btk_result_cache_assign_collection<Wrench>(dst, src)
+        || _btk_result_cache_assign_collection<Event>(dst, src)
+        || _btk_result_cache_assign_collection<Point>(dst, src)
+        || _btk_result_cache_assign_collection<Analog>(dst, src)
+        || _btk_result_cache_assign_collection<IMU>(dst, src);
+  };
+  
+  // ----------------------------------------------------------------------- //
+  
+  /**
+   * @class ResultCache btkResultCache.h
+   * @brief Memoizes the outputs of processes in memory.
+   *
+   * A cache can be shared by several processes (see ProcessObject::SetResultCache()). Before generating its data,
+   * a process computes a key from its type, its parameters and its inputs. When the same key was already computed, 
+   * the outputs are set with a copy of the cached ones. Otherwise, the data are generated and a copy of the 
+   * outputs is stored in the cache.
+   *
+   * Only the processes which give their parameters (see ProcessObject::GetCacheParameters()) use the cache.
+   * An input generated by a process using a cache is identified by the key of this process (no hashing is needed). 
+   * Other inputs are identified by a digest of their content (see ComputeContentDigest()). 
+   * The supported outputs are Acquisition, Wrench, and the collections of points, analogs, events, force platforms, 
+   * wrenches and IMUs.
+   *
+   * The cached results are kept in memory with a least recently used (LRU) strategy. The total size of the cached
+   * objects cannot exceed the memory budget (see SetMemoryBudget()). Their size is approximated from the number 
+   * of values they store. The number of hits, misses and evictions are given as statistics.
+   *
+   * The methods of this class can be used concurrently by several threads (see PipelineExecutor).
+   *
+   * @ingroup BTKCommon
+   */
+  
+  /**
+   * @typedef ResultCache::Pointer
+   * Smart pointer associated with a ResultCache object.
+   */
+  
+  /**
+   * @typedef ResultCache::ConstPointer
+   * Smart pointer associated with a const ResultCache object.
+   */
+  
+  /**
+   * @fn static Pointer ResultCache::New(size_t budget = 268435456)
+   * Creates a smart pointer associated with a ResultCache object with a memory budget of @a budget bytes (256 MB by default).
+   */
+  
+  /**
+   * Destructor.
+   */
+  ResultCache::~ResultCache()
+  {
+    delete this->mp_Lock;
+  };
+  
+  /**
+   * @fn size_t ResultCache::GetMemoryBudget() const
+   * Returns the maximum number of bytes used by the cached objects.
+   */
+  
+  /**
+   * Sets the maximum number of bytes used by the cached objects. The least recently used objects are evicted if necessary.
+   */
+  void ResultCache::SetMemoryBudget(size_t budget)
+  {
+    this->mp_Lock->Lock();
+    this->m_MemoryBudget = budget;
+    this->Evict(budget);
+    this->mp_Lock->Unlock();
+  };
+  
+  /**
+   * Returns the approximative number of bytes used by the cached objects.
+   */
+  size_t ResultCache::GetMemoryUsage() const
+  {
+    this->mp_Lock->Lock();
+    size_t usage = this->m_MemoryUsage;
+    this->mp_Lock->Unlock();
+    return usage;
+  };
+  
+  /**
+   * Returns the number of cached results.
+   */
+  int ResultCache::GetEntryNumber() const
+  {
+    this->mp_Lock->Lock();
+    int num = static_cast<int>(this->m_Entries.size());
+    this->mp_Lock->Unlock();
+    return num;
+  };
+  
+  /**
+   * Returns the number of results restored from the cache.
+   */
+  unsigned long ResultCache::GetHitNumber() const
+  {
+    this->mp_Lock->Lock();
+    unsigned long num = this->m_HitNumber;
+    this->mp_Lock->Unlock();
+    return num;
+  };
+  
+  /**
+   * Returns the number of results not found in the cache.
+   */
+  unsigned long ResultCache::GetMissNumber() const
+  {
+    this->mp_Lock->Lock();
+    unsigned long num = this->m_MissNumber;
+    this->mp_Lock->Unlock();
+    return num;
+  };
+  
+  /**
+   * Returns the number of results removed from the cache to respect the memory budget.
+   */
+  unsigned long ResultCache::GetEvictionNumber() const
+  {
+    this->mp_Lock->Lock();
+    unsigned long num = this->m_EvictionNumber;
+    this->mp_Lock->Unlock();
+    return num;
+  };
+  
+  /**
+   * Resets the number of hits, misses and evictions.
+   */
+  void ResultCache::ResetStatistics()
+  {
+    this->mp_Lock->Lock();
+    this->m_HitNumber = 0;
+    this->m_MissNumber = 0;
+    this->m_EvictionNumber = 0;
+    this->mp_Lock->Unlock();
+  };
+  
+  /**
+   * Removes all the cached results. The statistics are not reset.
+   */
+  void ResultCache::Clear()
+  {
+    this->mp_Lock->Lock();
+    this->m_Entries.clear();
+    this->m_Index.clear();
+    this->m_MemoryUsage = 0;
+    this->mp_Lock->Unlock();
+  };
+  
+  /**
+   * Sets the content of the given @a outputs with a copy of the results cached for the given @a key.
+   * Returns false if no result corresponds to the key or if the results cannot be copied into the outputs (counted as a miss).
+   */
+  bool ResultCache::Restore(const std::string& key, const std::vector<DataObject::Pointer>& outputs)
+  {
+    std::vector<DataObject::Pointer> cached;
+    bool restored = false;
+    this->mp_Lock->Lock();
+    std::map<std::string, std::list<Entry>::iterator>::iterator it = this->m_Index.find(key);
+    if ((it != this->m_Index.end()) && (it->second->Outputs.size() == outputs.size()))
+    {
+      this->m_Entries.splice(this->m_Entries.begin(), this->m_Entries, it->second);
+      cached = it->second->Outputs;
+      restored = true;
+    }
+    this->mp_Lock->Unlock();
+    // The cached objects are never modified. The outputs are set with copies.
+    for (size_t i = 0 ; restored && (i < outputs.size()) ; ++i)
+    {
+      if (!outputs[i])
+        continue;
+      size_t size = 0;
+      DataObject::Pointer clone = _btk_result_cache_clone(cached[i].get(), size);
+      if (!clone || !_btk_result_cache_assign(outputs[i].get(), clone))
+        restored = false;
+    }
+    this->mp_Lock->Lock();
+    if (restored)
+      ++this->m_HitNumber;
+    else
+      ++this->m_MissNumber;
+    this->mp_Lock->Unlock();
+    return restored;
+  };
+  
+  /**
+   * Stores a copy of the given @a outputs for the given @a key. The least recently used results are evicted 
+   * if necessary. Returns false if one of the outputs is not supported or if the outputs exceed the memory budget.
+   */
+  bool ResultCache::Store(const std::string& key, const std::vector<DataObject::Pointer>& outputs)
+  {
+    Entry entry;
+    entry.Key = key;
+    entry.Size = 0;
+    for (size_t i = 0 ; i < outputs.size() ; ++i)
+    {
+      size_t size = 0;
+      DataObject::Pointer clone;
+      if (outputs[i])
+      {
+        clone = _btk_result_cache_clone(outputs[i].get(), size);
+        if (!clone)
+          return false;
+      }
+      entry.Outputs.push_back(clone);
+      entry.Size += size;
+    }
+    bool stored = false;
+    this->mp_Lock->Lock();
+    if (entry.Size <= this->m_MemoryBudget)
+    {
+      std::map<std::string, std::list<Entry>::iterator>::iterator it = this->m_Index.find(key);
+      if (it != this->m_Index.end())
+      {
+        this->m_MemoryUsage -= it->second->Size;
+        this->m_Entries.erase(it->second);
+        this->m_Index.erase(it);
+      }
+      this->Evict(this->m_MemoryBudget - entry.Size);
+      this->m_Entries.push_front(entry);
+      this->m_Index[key] = this->m_Entries.begin();
+      this->m_MemoryUsage += entry.Size;
+      stored = true;
+    }
+    this->mp_Lock->Unlock();
+    return stored;
+  };
+  
+  /**
+   * Returns the digest (16 hexadecimal characters) of the given data.
+   */
+  std::string ResultCache::ComputeDigest(const std::string& data)
+  {
+    content_hash_p h;
+    h.Add(data.data(), data.size());
+    return h.GetDigest();
+  };
+  
+  /**
+   * Computes the digest of the content of the given object. All the values, labels and metadata are used.
+   * Returns false if the type of the object is not supported.
+   */
+  bool ResultCache::ComputeContentDigest(DataObject::ConstPointer object, std::string& digest)
+  {
+    content_hash_p h;
+    if (!object || !_btk_result_cache_hash_object(h, object.get()))
+      return false;
+    digest = h.GetDigest();
+    return true;
+  };
+  
+  /**
+   * Constructor.
+   */
+  ResultCache::ResultCache(size_t budget)
+  : m_Entries(), m_Index()
+  {
+    this->m_MemoryBudget = budget;
+    this->m_MemoryUsage = 0;
+    this->m_HitNumber = 0;
+    this->m_MissNumber = 0;
+    this->m_EvictionNumber = 0;
+    this->mp_Lock = new critical_section_p;
+  };
+  
+  /**
+   * Removes the least recently used results until the memory usage is lower or equal to @a budget.
+   */
+  void ResultCache::Evict(size_t budget)
+  {
+    while (!this->m_Entries.empty() && (this->m_MemoryUsage > budget))
+    {
+      this->m_MemoryUsage -= this->m_Entries.back().Size;
+      this->m_Index.erase(this->m_Entries.back().Key);
+      this->m_Entries.pop_back();
+      ++this->m_EvictionNumber;
+    }
+  };
+};
@@ -0,0 +1,104 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __btkResultCache_h
+#define __btkResultCache_h
+
+#include "btkDataObject.h"
+
+#include <list>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace btk
+{
+  class critical_section_p;
+  
+  class ResultCache
+  {
+  public:
+    typedef btkSharedPtr<ResultCache> Pointer;
+    typedef btkSharedPtr<const ResultCache> ConstPointer;
+    
+    static Pointer New(size_t budget = 268435456) {return Pointer(new ResultCache(budget));};
+    
+    BTK_COMMON_EXPORT ~ResultCache();
+    
+    size_t GetMemoryBudget() const {return this->m_MemoryBudget;};
+    BTK_COMMON_EXPORT void SetMemoryBudget(size_t budget);
+    BTK_COMMON_EXPORT size_t GetMemoryUsage() const;
+    BTK_COMMON_EXPORT int GetEntryNumber() const;
+    
+    BTK_COMMON_EXPORT unsigned long GetHitNumber() const;
+    BTK_COMMON_EXPORT unsigned long GetMissNumber() const;
+    BTK_COMMON_EXPORT unsigned long GetEvictionNumber() const;
+    BTK_COMMON_EXPORT void ResetStatistics();
+    BTK_COMMON_EXPORT void Clear();
+    
+    BTK_COMMON_EXPORT bool Restore(const std::string& key, const std::vector<DataObject::Pointer>& outputs);
+    BTK_COMMON_EXPORT bool Store(const std::string& key, const std::vector<DataObject::Pointer>& outputs);
+    
+    BTK_COMMON_EXPORT static std::string ComputeDigest(const std::string& data);
+    BTK_COMMON_EXPORT static bool ComputeContentDigest(DataObject::ConstPointer object, std::string& digest);
+    
+  protected:
+    BTK_COMMON_EXPORT ResultCache(size_t budget);
+    
+  private:
+    ResultCache(const ResultCache& ); // Not implemented.
+    ResultCache& operator=(const ResultCache& ); // Not implemented.
+    
+    struct Entry
+    {
+      std::string Key;
+      std::vector<DataObject::Pointer> Outputs;
+      size_t Size;
+    };
+    
+    void Evict(size_t budget);
+    
+    std::list<Entry> m_Entries; // Most recently used first
+    std::map<std::string, std::list<Entry>::iterator> m_Index;
+    size_t m_MemoryBudget;
+    size_t m_MemoryUsage;
+    unsigned long m_HitNumber;
+    unsigned long m_MissNumber;
+    unsigned long m_EvictionNumber;
+    critical_section_p* mp_Lock;
+  };
+};
+
+#endif // __btkResultCache_h
@@ -0,0 +1,245 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "btkThread_p.h"
+#include "btkCriticalSection_p.h"
+#include "btkMacro.h"
+
+#include <vector>
+#include <cstring> // memcpy
+
+#if defined(HAVE_PTHREADS) || defined(HAVE_HP_PTHREADS)
+  #include <unistd.h>
+#endif
+
+namespace btk
+{
+  /*
+   * Minimal portable thread used internally to run some computations in parallel.
+   * The given function is launched when the method Start() is called. The method
+   * Join() waits the end of the function. A thread which is not joined is joined in the destructor.
+   */
+  
+  struct thread_startup_p
+  {
+    thread_p::Function Func;
+    void* Data;
+  };
+  
+#if defined(HAVE_WIN32_THREADS)
+  static DWORD WINAPI _btk_thread_entry(LPVOID data)
+#else
+  static void* _btk_thread_entry(void* data)
+#endif
+  {
+    thread_startup_p* startup = static_cast<thread_startup_p*>(data);
+    thread_p::Function func = startup->Func;
+    void* d = startup->Data;
+    delete startup;
+    func(d);
+    return 0;
+  };
+  
+  thread_p::thread_p()
+  : m_Thread()
+  {
+    this->m_Running = false;
+  };
+  
+  thread_p::~thread_p()
+  {
+    this->Join();
+  };
+  
+  /*
+   * Launch the function @a func with the argument @a data in a new thread.
+   * Returns false if the thread cannot be created (or if no thread library is available).
+   * In this case, the function is not called.
+   */
+  bool thread_p::Start(Function func, void* data)
+  {
+    if (this->m_Running)
+      return false;
+    thread_startup_p* startup = new thread_startup_p;
+    startup->Func = func;
+    startup->Data = data;
+#if defined(HAVE_WIN32_THREADS)
+    this->m_Thread = CreateThread(NULL, 0, &_btk_thread_entry, startup, 0, NULL);
+    this->m_Running = (this->m_Thread != NULL);
+#elif defined(HAVE_PTHREADS) || defined(HAVE_HP_PTHREADS)
+    this->m_Running = (pthread_create(&(this->m_Thread), NULL, &_btk_thread_entry, startup) == 0);
+#endif
+    if (!this->m_Running)
+      delete startup;
+    return this->m_Running;
+  };
+  
+  /*
+   * Wait the end of the thread.
+   */
+  void thread_p::Join()
+  {
+    if (!this->m_Running)
+      return;
+#if defined(HAVE_WIN32_THREADS)
+    WaitForSingleObject(this->m_Thread, INFINITE);
+    CloseHandle(this->m_Thread);
+#elif defined(HAVE_PTHREADS) || defined(HAVE_HP_PTHREADS)
+    pthread_join(this->m_Thread, NULL);
+#endif
+    this->m_Running = false;
+  };
+  
+  /*
+   * Returns the number of processors available on the computer (at least 1).
+   */
+  int thread_p::GetHardwareConcurrency()
+  {
+    int num = 1;
+#if defined(HAVE_WIN32_THREADS)
+    SYSTEM_INFO sysinfo;
+    GetSystemInfo(&sysinfo);
+    num = static_cast<int>(sysinfo.dwNumberOfProcessors);
+#elif (defined(HAVE_PTHREADS) || defined(HAVE_HP_PTHREADS)) && defined(_SC_NPROCESSORS_ONLN)
+    num = static_cast<int>(sysconf(_SC_NPROCESSORS_ONLN));
+#endif
+    return (num < 1) ? 1 : num;
+  };
+  
+  /*
+   * Returns an identifier of the calling thread (0 if no thread library is available).
+   */
+  unsigned long thread_p::GetCurrentId()
+  {
+#if defined(HAVE_WIN32_THREADS)
+    return static_cast<unsigned long>(GetCurrentThreadId());
+#elif defined(HAVE_PTHREADS) || defined(HAVE_HP_PTHREADS)
+    pthread_t self = pthread_self();
+    unsigned long id = 0;
+    memcpy(&id, &self, (sizeof(self) < sizeof(id)) ? sizeof(self) : sizeof(id));
+    return id;
+#else
+    return 0;
+#endif
+  };
+  
+  /*
+   * Suspend the calling thread during (at least) the given number of milliseconds.
+   */
+  void thread_p::SleepFor(int milliseconds)
+  {
+#if defined(HAVE_WIN32_THREADS)
+    Sleep(static_cast<DWORD>(milliseconds));
+#elif defined(HAVE_PTHREADS) || defined(HAVE_HP_PTHREADS)
+    usleep(static_cast<useconds_t>(milliseconds) * 1000);
+#else
+    btkNotUsed(milliseconds);
+#endif
+  };
+  
+  // ----------------------------------------------------------------------- //
+  
+  struct parallel_for_data_p
+  {
+    parallel_task_p* Task;
+    int Num;
+    int Next;
+    bool Failed;
+    critical_section_p Lock;
+  };
+  
+  static void _btk_parallel_for_worker(void* data)
+  {
+    parallel_for_data_p* pfd = static_cast<parallel_for_data_p*>(data);
+    for (;;)
+    {
+      pfd->Lock.Lock();
+      int idx = pfd->Next++;
+      pfd->Lock.Unlock();
+      if (idx >= pfd->Num)
+        break;
+      try
+      {
+        pfd->Task->Run(idx);
+      }
+      catch (...)
+      {
+        pfd->Lock.Lock();
+        pfd->Failed = true;
+        pfd->Lock.Unlock();
+      }
+    }
+  };
+  
+  /*
+   * Run the method parallel_task_p::Run() of the given @a task for each index between 0 and @a num-1.
+   * The indices are dispatched dynamically between @a threadNumber threads (the calling thread included).
+   * If @a threadNumber is lower or equal to 0, then the number of processors is used.
+   * The order of execution is not specified and the task must be safe to be run concurrently on different indices.
+   * Returns false if at least one call of the task thrown an exception (the other indices are still processed).
+   */
+  bool parallel_for_p(int num, parallel_task_p* task, int threadNumber)
+  {
+    if (num <= 0)
+      return true;
+    if (threadNumber <= 0)
+      threadNumber = thread_p::GetHardwareConcurrency();
+    if (threadNumber > num)
+      threadNumber = num;
+    parallel_for_data_p pfd;
+    pfd.Task = task;
+    pfd.Num = num;
+    pfd.Next = 0;
+    pfd.Failed = false;
+    std::vector<thread_p*> threads;
+    for (int i = 1 ; i < threadNumber ; ++i)
+    {
+      thread_p* t = new thread_p;
+      if (!t->Start(&_btk_parallel_for_worker, &pfd))
+      {
+        delete t;
+        break;
+      }
+      threads.push_back(t);
+    }
+    _btk_parallel_for_worker(&pfd); // The calling thread works too
+    for (size_t i = 0 ; i < threads.size() ; ++i)
+    {
+      threads[i]->Join();
+      delete threads[i];
+    }
+    return !pfd.Failed;
+  };
+};
@@ -0,0 +1,89 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __btkThread_p_h
+#define __btkThread_p_h
+
+#include "btkConfigure.h"
+
+#if defined(HAVE_WIN32_THREADS)
+  #ifndef WIN32_LEAN_AND_MEAN
+    #define WIN32_LEAN_AND_MEAN
+  #endif
+  #include <windows.h>
+  typedef HANDLE btk_thread_t;
+#elif defined(HAVE_PTHREADS) || defined(HAVE_HP_PTHREADS)
+  #include <pthread.h>
+  typedef pthread_t btk_thread_t;
+#else
+  typedef int btk_thread_t;
+#endif
+
+namespace btk
+{
+  class thread_p
+  {
+  public:
+    typedef void (*Function)(void* );
+    
+    BTK_COMMON_EXPORT thread_p();
+    BTK_COMMON_EXPORT ~thread_p();
+    BTK_COMMON_EXPORT bool Start(Function func, void* data);
+    BTK_COMMON_EXPORT void Join();
+    bool IsRunning() const {return this->m_Running;};
+    
+    BTK_COMMON_EXPORT static int GetHardwareConcurrency();
+    BTK_COMMON_EXPORT static unsigned long GetCurrentId();
+    BTK_COMMON_EXPORT static void SleepFor(int milliseconds);
+    
+  private:
+    thread_p(const thread_p& ); // Not implemented.
+    thread_p& operator=(const thread_p& ); // Not implemented.
+    
+    btk_thread_t m_Thread;
+    bool m_Running;
+  };
+  
+  class parallel_task_p
+  {
+  public:
+    virtual ~parallel_task_p() {};
+    virtual void Run(int idx) = 0;
+  };
+  
+  BTK_COMMON_EXPORT bool parallel_for_p(int num, parallel_task_p* task, int threadNumber = 0);
+};
+
+#endif // __btkThread_p_h
@@ -38,6 +38,7 @@
 #include "btkMotionAnalysisFileIOUtils_p.h"
 #include "btkConvert.h"
 #include "btkLogger.h"
+#include "btkTextFileStream_p.h"
 
 #include <fstream>
 #include <algorithm>
@@ -48,6 +49,18 @@
 
 namespace btk
 {
+  static void _btk_anc_getline(text_file_p& file, std::string& line)
+  {
+    if (!file.getline(line))
+      throw(ANCFileIOException("Unexpected end of file."));
+  };
+  
+  static void _btk_anc_gettoken(text_file_p& file, text_range_p* token)
+  {
+    if (!file.gettoken(token))
+      throw(ANCFileIOException("Unexpected end of file."));
+  };
+  
   /**
    * @class ANCFileIOException btkANCFileIO.h
    * @brief Exception class for the ANCFileIO class.
@@ -131,15 +144,15 @@ namespace btk
   void ANCFileIO::Read(const std::string& filename, Acquisition::Pointer output)
   {
     output->Reset();
-    // Open the stream
-    std::ifstream ifs;
-    ifs.exceptions(std::ios_base::eofbit | std::ios_base::failbit | std::ios_base::badbit);
+    // Open the file (mapped in memory)
+    text_file_p file;
     try
     {
       std::string line;
-      ifs.open(filename.c_str());
+      if (!file.open(filename))
+        throw(ANCFileIOException("Invalid file path."));
     // Check the first header keyword: "File_Type:"
-      std::getline(ifs, line);
+      _btk_anc_getline(file, line);
       if (line.substr(0,41).compare("File_Type:	Analog R/C ASCII	Generation#:	") != 0)
         throw(ANCFileIOException("Invalid ANC file."));
     // Check the file generation.
@@ -148,23 +161,23 @@ namespace btk
         throw(ANCFileIOException("Unknown ANC file generation: " + line.substr(42,43) + "."));
     // Extract header data
       // Board_Type & Polarity
-      std::getline(ifs, line);
+      _btk_anc_getline(file, line);
       std::string boardType = this->ExtractKeywordValue(line, "Board_Type:	");
       std::string polarity = this->ExtractKeywordValue(line, "Polarity:	");
       // Trial_Name, Trial#, Duration(Sec.), #Channels
-      std::getline(ifs, line);
+      _btk_anc_getline(file, line);
       double duration = FromString<double>(this->ExtractKeywordValue(line, "Duration(Sec.):	"));
       size_t numberOfChannels = FromString<size_t>(this->ExtractKeywordValue(line, "#Channels:	"));
 
       // BitDepth & PreciseRate
-      std::getline(ifs, line);
+      _btk_anc_getline(file, line);
       int bitDepth = FromString<int>(this->ExtractKeywordValue(line, "BitDepth:	"));
       double preciseRate = FromString<double>(this->ExtractKeywordValue(line, "PreciseRate:	"));
       // Four next lines are empty
-      std::getline(ifs, line);
-      std::getline(ifs, line);
-      std::getline(ifs, line);
-      std::getline(ifs, line);
+      _btk_anc_getline(file, line);
+      _btk_anc_getline(file, line);
+      _btk_anc_getline(file, line);
+      _btk_anc_getline(file, line);
 
       // DEVELOPER CHECK
       // Check polarity's value. Only Bipolar is supported for the moment.
@@ -176,7 +189,7 @@ namespace btk
       {
         // Analog channels' label
         std::list<std::string> labels, rates, ranges;
-        std::getline(ifs, line);
+        _btk_anc_getline(file, line);
         this->ExtractDataInfo(line, "Name", labels);
         size_t numberOfLabels = labels.size();
         if (numberOfChannels != numberOfLabels)
@@ -185,10 +198,10 @@ namespace btk
           numberOfChannels = numberOfLabels;
         }
         // Analog channels' rate
-        std::getline(ifs, line);
+        _btk_anc_getline(file, line);
         this->ExtractDataInfo(line, "Rate", rates);
         // Analog channels' range
-        std::getline(ifs, line);
+        _btk_anc_getline(file, line);
         this->ExtractDataInfo(line, "Range", ranges);
         double nf = duration * preciseRate; // Must be separate in two step due to some rounding errors
         size_t numberOfFrames = static_cast<size_t>(nf) + 1;
@@ -210,15 +223,25 @@ namespace btk
         ANxFileIOStoreHeader_p(output, filename, preciseRate, numberOfFrames, numberOfChannels, channelLabel, channelRate, channelRange, boardType, bitDepth, this->m_Generation);
         
         // Extract values
-        std::string buf;
+        std::vector<double*> values(output->GetAnalogNumber());
+        std::vector<double> scales(values.size());
+        inc = 0;
+        for (AnalogCollection::Iterator it = output->BeginAnalog() ; it != output->EndAnalog() ; ++it)
+        {
+          values[inc] = (*it)->GetValues().data();
+          scales[inc++] = (*it)->GetScale();
+        }
+        text_range_p token;
         double val = 0.0;
         for(size_t i = 0 ; i < numberOfFrames ; ++i)
         {
-          ifs >> buf; // Time's value          
-          for (AnalogCollection::Iterator it = output->BeginAnalog() ; it != output->EndAnalog() ; ++it)
+          _btk_anc_gettoken(file, &token); // Time's value
+          for (size_t j = 0 ; j < values.size() ; ++j)
           {
-            ifs >> val;
-            (*it)->GetValues().coeffRef(static_cast<int>(i)) = val * (*it)->GetScale();
+            _btk_anc_gettoken(file, &token);
+            if (text_to_double_p(token.begin, token.end, &val) == 0)
+              throw(ANCFileIOException("Invalid analog value: '" + token.str() + "'."));
+            values[j][i] = val * scales[j];
           }
         }
       }
@@ -226,41 +249,24 @@ namespace btk
       MetaData::Pointer btkPointConfig = MetaDataCreateChild(output->GetMetaData(), "BTK_POINT_CONFIG");
       MetaDataCreateChild(btkPointConfig, "NO_FIRST_FRAME", static_cast<int8_t>(1));
     }
-    catch (std::fstream::failure& )
-    {
-      std::string excmsg; 
-      if (!ifs.is_open())
-        excmsg = "Invalid file path.";
-      else if (ifs.eof())
-        excmsg = "Unexpected end of file.";
-      else if(ifs.bad())
-        excmsg = "Loss of integrity of the file stream.";
-      else if(ifs.fail())
-        excmsg = "Internal logic operation error on the stream associated with the file.";
-      else
-        excmsg = "Unknown error associated with the file stream.";
-      
-      if (ifs.is_open()) ifs.close();    
-      throw(ANCFileIOException(excmsg));
-    }
     catch (ANCFileIOException& )
     {
-      if (ifs.is_open()) ifs.close(); 
+      file.close();
       throw;
     }
     catch (ANxFileIOException& e)
     {
-      if (ifs.is_open()) ifs.close();
+      file.close();
       throw(ANCFileIOException(e.what()));
     }
     catch (std::exception& e)
     {
-      if (ifs.is_open()) ifs.close(); 
+      file.close();
       throw(ANCFileIOException("Unexpected exception occurred: " + std::string(e.what())));
     }
     catch(...)
     {
-      if (ifs.is_open()) ifs.close(); 
+      file.close();
       throw(ANCFileIOException("Unknown exception"));
     }
   };
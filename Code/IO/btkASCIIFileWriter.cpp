@@ -34,10 +34,95 @@
  */
 
 #include "btkASCIIFileWriter.h"
+#include "btkTextFileStream_p.h"
 #include "btkConvert.h"
 
 namespace btk
 {
+  // Rows of the points (time and X/Y/Z values).
+  class ASCIIFileWriterPointRows_p : public text_row_formatter_p
+  {
+  public:
+    ASCIIFileWriterPointRows_p(PointCollection::Pointer points, const std::string& sep, int ffi, int firstFrame, double t)
+    : m_Separator(sep), m_Values(), m_Residuals(), m_Rows()
+    {
+      for (PointCollection::ConstIterator it = points->Begin() ; it != points->End() ; ++it)
+      {
+        this->m_Values.push_back((*it)->GetValues().data());
+        this->m_Residuals.push_back((*it)->GetResiduals().data());
+        this->m_Rows.push_back(static_cast<int>((*it)->GetValues().rows()));
+      }
+      this->m_FirstIndex = ffi;
+      this->m_FirstFrame = firstFrame;
+      this->m_Period = t;
+    };
+    virtual void format(std::string* out, int row) const
+    {
+      int i = this->m_FirstIndex + row;
+      text_append_general_p(out, static_cast<double>(i + this->m_FirstFrame - 1) * this->m_Period);
+      for (size_t j = 0 ; j < this->m_Values.size() ; ++j)
+      {
+        if (this->m_Residuals[j][i] >= 0.0)
+        {
+          for (int k = 0 ; k < 3 ; ++k)
+          {
+            out->append(this->m_Separator);
+            text_append_general_p(out, this->m_Values[j][i + k * this->m_Rows[j]]);
+          }
+        }
+        else
+        {
+          for (int k = 0 ; k < 3 ; ++k)
+          {
+            out->append(this->m_Separator);
+            out->push_back('0');
+          }
+        }
+      }
+      out->push_back('\n');
+    };
+  private:
+    const std::string& m_Separator;
+    std::vector<const double*> m_Values;
+    std::vector<const double*> m_Residuals;
+    std::vector<int> m_Rows;
+    int m_FirstIndex;
+    int m_FirstFrame;
+    double m_Period;
+  };
+  
+  // Rows of the analog channels (time and values).
+  class ASCIIFileWriterAnalogRows_p : public text_row_formatter_p
+  {
+  public:
+    ASCIIFileWriterAnalogRows_p(Acquisition::Pointer acq, const std::string& sep, int ffi, double t)
+    : m_Separator(sep), m_Values()
+    {
+      for (Acquisition::AnalogConstIterator it = acq->BeginAnalog() ; it != acq->EndAnalog() ; ++it)
+        this->m_Values.push_back((*it)->GetValues().data());
+      this->m_FirstIndex = ffi;
+      this->m_FirstSample = (acq->GetFirstFrame() - 1) * acq->GetNumberAnalogSamplePerFrame();
+      this->m_Period = t;
+    };
+    virtual void format(std::string* out, int row) const
+    {
+      int i = this->m_FirstIndex + row;
+      text_append_general_p(out, static_cast<double>(i + this->m_FirstSample) * this->m_Period);
+      for (size_t j = 0 ; j < this->m_Values.size() ; ++j)
+      {
+        out->append(this->m_Separator);
+        text_append_general_p(out, this->m_Values[j][i]);
+      }
+      out->push_back('\n');
+    };
+  private:
+    const std::string& m_Separator;
+    std::vector<const double*> m_Values;
+    int m_FirstIndex;
+    int m_FirstSample;
+    double m_Period;
+  };
+  
   /**
    * @class ASCIIFileWriterException btkASCIIFileWriter.h
    * @brief Exception class for the ASCIIFileWriter class.
@@ -181,14 +266,35 @@ namespace btk
     }
   };
   
+  /**
+   * @fn int ASCIIFileWriter::GetThreadNumber() const
+   * Returns the number of threads used to format the values. 0 means the number of processors.
+   */
+  
+  /**
+   * Sets the number of threads used to format the values. A value lower or equal to 0 uses the number of processors.
+   * The rows are formatted by blocks in parallel and written in order. The content of the file is the same whatever the number of threads.
+   */
+  void ASCIIFileWriter::SetThreadNumber(int num)
+  {
+    if (num < 0)
+      num = 0;
+    if (this->m_ThreadNumber == num)
+      return;
+    this->m_ThreadNumber = num;
+    this->Modified();
+  };
+  
   /**
    * Constructor. Sets the number of outputs equal to one. No input. Separator set to common (,).
+   * By default, the number of threads used to format the values corresponds to the number of processors.
    */
   ASCIIFileWriter::ASCIIFileWriter()
   : m_Filename(), m_Separator(",")
   {
     this->m_FOI[0] = -1;
     this->m_FOI[1] = -1;
+    this->m_ThreadNumber = 0;
     this->SetInputNumber(1);
   };
   
@@ -254,17 +360,22 @@ namespace btk
     
     try
     {
-      std::ofstream ofs(this->m_Filename.c_str());
-      if (!ofs)
+      text_output_p output;
+      if (!output.open(this->m_Filename))
         throw ASCIIFileWriterException("File can't be opened. Have you the permission to write this file?\nFilename: " + this->m_Filename);
       
+      std::string text;
       if (writeHeader)
       {
-        ofs << "Frame number" << this->m_Separator << lf - ff + 1 << "\n";
-        ofs << "First frame" << this->m_Separator << ff << "\n";
-        ofs << "Point frequency" << this->m_Separator << input->GetPointFrequency() << "\n";
-        ofs << "Analog frequency" << this->m_Separator << input->GetAnalogFrequency() << "\n";
-        ofs << std::endl;
+        text += "Frame number" + this->m_Separator;
+        text_append_int_p(&text, lf - ff + 1);
+        text += "\nFirst frame" + this->m_Separator;
+        text_append_int_p(&text, ff);
+        text += "\nPoint frequency" + this->m_Separator;
+        text_append_general_p(&text, input->GetPointFrequency());
+        text += "\nAnalog frequency" + this->m_Separator;
+        text_append_general_p(&text, input->GetAnalogFrequency());
+        text += "\n\n";
       }
       
       if (writeEvent)
@@ -392,14 +503,18 @@ namespace btk
           // Export the events
           for (size_t i = 0 ; i < labels_sorted.size() ; ++i)
           {
-            ofs << labels_sorted[i];
+            text += labels_sorted[i];
             for (size_t j = 0 ; j < times_sorted[i].size() ; ++j)
-              ofs << this->m_Separator << times_sorted[i][j];
-            ofs << "\n";
+            {
+              text += this->m_Separator;
+              text_append_general_p(&text, times_sorted[i][j]);
+            }
+            text += "\n";
           }
-          ofs << std::endl;
+          text += "\n";
         }
       }
+      output.write(text);
       
       if (writePoint)
       {
@@ -425,40 +540,37 @@ namespace btk
             points->InsertItem(*it);
         }
         if (!points->IsEmpty())
-          this->WritePoints(&ofs, ff, lf, input, points);
+          this->WritePoints(&output, ff, lf, input, points);
         if (!forceplates->IsEmpty())
-          this->WritePoints(&ofs, ff, lf, input, forceplates);
+          this->WritePoints(&output, ff, lf, input, forceplates);
       }
       
       if (writeAnalog && !input->IsEmptyAnalog())
       {
-        ofs << "Time";
+        text = "Time";
         // Label
         for (btk::AnalogCollection::ConstIterator it = input->BeginAnalog() ; it != input->EndAnalog() ; ++it)
-          ofs << this->m_Separator << (*it)->GetLabel();
-        ofs << std::endl;
+          text += this->m_Separator + (*it)->GetLabel();
         // Unit
-        ofs << "s";
+        text += "\ns";
         for (btk::AnalogCollection::ConstIterator it = input->BeginAnalog() ; it != input->EndAnalog() ; ++it)
-          ofs << this->m_Separator << (*it)->GetUnit();
-        ofs << std::endl;
+          text += this->m_Separator + (*it)->GetUnit();
+        text += "\n";
+        output.write(text);
         // Data
         int ffi = (ff - input->GetFirstFrame()) * input->GetNumberAnalogSamplePerFrame();
         int lfi = (lf - input->GetFirstFrame() + 1) * input->GetNumberAnalogSamplePerFrame();
         double t = 0.0;
         if (input->GetAnalogFrequency() != 0.0)
           t = 1.0 / input->GetAnalogFrequency();
-        for (int i = ffi ; i < lfi ; ++i)
-        {
-          ofs << static_cast<double>(i + (input->GetFirstFrame()-1) * input->GetNumberAnalogSamplePerFrame()) * t;
-          for (btk::AnalogCollection::ConstIterator it = input->BeginAnalog() ; it != input->EndAnalog() ; ++it)
-            ofs << this->m_Separator << (*it)->GetValues().coeff(i);
-          ofs << std::endl;
-        }
-        ofs << std::endl;
+        ASCIIFileWriterAnalogRows_p rows(input, this->m_Separator, ffi, t);
+        if (!text_write_rows_p(&output, lfi - ffi, &rows, this->m_ThreadNumber))
+          throw ASCIIFileWriterException("Unexpected error during the formatting of the analog channels.");
+        output.write("\n", 1);
       }
       
-      ofs.close();
+      if (!output.close())
+        throw ASCIIFileWriterException("Error during the writing of the file.\nFilename: " + this->m_Filename);
     }
     catch (ASCIIFileWriterException& )
     {
@@ -474,43 +586,34 @@ namespace btk
     }
   };
   
-  void ASCIIFileWriter::WritePoints(std::ofstream* ofs, int ff, int lf, Acquisition::Pointer acq, PointCollection::Pointer points)
+  void ASCIIFileWriter::WritePoints(text_output_p* output, int ff, int lf, Acquisition::Pointer acq, PointCollection::Pointer points)
   {
-    *ofs << "Time";
+    std::string text = "Time";
     // Label
     for (btk::PointCollection::ConstIterator it = points->Begin() ; it != points->End() ; ++it)
-      *ofs << this->m_Separator << (*it)->GetLabel() << this->m_Separator << this->m_Separator;
-    *ofs << std::endl;
+      text += this->m_Separator + (*it)->GetLabel() + this->m_Separator + this->m_Separator;
     // Unit
-    *ofs << "s";
+    text += "\ns";
     for (btk::PointCollection::ConstIterator it = points->Begin() ; it != points->End() ; ++it)
     {
       std::string unit = acq->GetPointUnit((*it)->GetType());
-      *ofs << this->m_Separator << unit << this->m_Separator << unit << this->m_Separator << unit;
+      text += this->m_Separator + unit + this->m_Separator + unit + this->m_Separator + unit;
     }
-    *ofs << std::endl;
+    text += "\n";
     // X/Y/Z
     for (btk::PointCollection::ConstIterator it = points->Begin() ; it != points->End() ; ++it)
-      *ofs << this->m_Separator << "X" << this->m_Separator << "Y" << this->m_Separator << "Z";
-    *ofs << std::endl;
+      text += this->m_Separator + "X" + this->m_Separator + "Y" + this->m_Separator + "Z";
+    text += "\n";
+    output->write(text);
     // Data
     double t = 0.0;
     if (acq->GetPointFrequency() != 0.0)
       t = 1.0 / acq->GetPointFrequency();
     int ffi = ff - acq->GetFirstFrame();
     int lfi = lf - acq->GetFirstFrame();
-    for (int i = ffi ; i <= lfi ; ++i)
-    {
-      *ofs << static_cast<double>(i + acq->GetFirstFrame() - 1) * t;
-      for (btk::PointCollection::ConstIterator it = points->Begin() ; it != points->End() ; ++it)
-      {
-        if ((*it)->GetResiduals().coeff(i) >= 0.0)
-          *ofs << this->m_Separator << (*it)->GetValues().coeff(i,0) << this->m_Separator << (*it)->GetValues().coeff(i,1) << this->m_Separator << (*it)->GetValues().coeff(i,2);
-        else
-          *ofs << this->m_Separator << 0 << this->m_Separator << 0 << this->m_Separator << 0;
-      }
-      *ofs << std::endl;
-    }
-    *ofs << std::endl;
+    ASCIIFileWriterPointRows_p rows(points, this->m_Separator, ffi, acq->GetFirstFrame(), t);
+    if (!text_write_rows_p(output, lfi - ffi + 1, &rows, this->m_ThreadNumber))
+      throw ASCIIFileWriterException("Unexpected error during the formatting of the points.");
+    output->write("\n", 1);
   };
 };
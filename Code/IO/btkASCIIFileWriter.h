@@ -44,6 +44,8 @@
 
 namespace btk
 {
+  class text_output_p;
+  
   class ASCIIFileWriterException : public Exception
   {
   public:
@@ -76,6 +78,9 @@ namespace btk
     const int* GetFramesOfInterest() const {return this->m_FOI;};
     void GetFramesOfInterest(int& ff, int& lf) const {ff = this->m_FOI[0]; lf = this->m_FOI[1];};
     BTK_IO_EXPORT void SetFramesOfInterest(int ff = -1, int lf = -1);
+    
+    int GetThreadNumber() const {return this->m_ThreadNumber;};
+    BTK_IO_EXPORT void SetThreadNumber(int num);
   
   protected:
     BTK_IO_EXPORT ASCIIFileWriter();
@@ -84,7 +89,7 @@ namespace btk
     BTK_IO_EXPORT virtual void GenerateData();
     
   private:
-    void WritePoints(std::ofstream* ofs, int ff, int lf, Acquisition::Pointer acq, PointCollection::Pointer points);
+    void WritePoints(text_output_p* output, int ff, int lf, Acquisition::Pointer acq, PointCollection::Pointer points);
     
     ASCIIFileWriter(const ASCIIFileWriter& ); // Not implemented.
     ASCIIFileWriter& operator=(const ASCIIFileWriter& ); // Not implemented.
@@ -92,6 +97,7 @@ namespace btk
     std::string m_Filename;
     std::string m_Separator;
     int m_FOI[2];
+    int m_ThreadNumber;
   };
 };
 
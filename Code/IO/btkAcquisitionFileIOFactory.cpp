@@ -36,8 +36,80 @@
 #include "btkAcquisitionFileIOFactory.h"
 #include "btkAcquisitionFileIOFactory_p.h"
 
+#include <fstream>
+#include <algorithm>
+#include <cstring>
+
 namespace btk
 {
+  // Signatures of the file formats which can be identified by their first bytes.
+  // The description is used when several file formats share the same extension.
+  struct _btk_signature
+  {
+    const char* extension;
+    const char* description;
+    int offset;
+    const char* bytes;
+    int length;
+  };
+  
+  static const int _btk_signature_prefix_size = 64;
+  
+  static const _btk_signature _btk_signatures[] = {
+    {"c3d", 0, 1, "\x50", 1},
+    {"anb", 0, 0, "\x00\x00\x00\x00\x00\x80", 6},
+    {"anc", 0, 0, "File_Type:\tAnalog R/C ASCII\tGeneration#:\t", 41},
+    {"trb", 0, 0, "\x00\x00\x00\x00\xFF\xFF\xFF\xFF", 8},
+    {"trc", 0, 0, "PathFileType", 12},
+    {"xls", "OrthoTrak", 0, "Version\t", 8},
+    {"tdf", 0, 0, "\x82\x4B\x60\x41\xD3\x11\x84\xCA\x60\x00\xB6\xAC\x16\x68\x0C\x08", 16},
+    {"emg", "Delsys", 0, "DEMG", 4},
+    {"hpf", "Delsys", 16, "datx", 4},
+    {"bsf", "AMTI", 0, "\x64\x00\x00\x00", 4},
+    {"clb", "Contec", 0, "CONTEC DATA LOGGER", 18},
+    {"emf", "Ascension", 0, "EMF1.0     ## HyperVision EMF ASCII Format", 42}
+  };
+  
+  static std::string _btk_lowercase_extension(const std::string& filename)
+  {
+    std::string::size_type pos = filename.find_last_of('.');
+    std::string::size_type sep = filename.find_last_of("/\\");
+    if ((pos == std::string::npos) || ((sep != std::string::npos) && (pos < sep)))
+      return "";
+    std::string ext = filename.substr(pos + 1);
+    std::transform(ext.begin(), ext.end(), ext.begin(), tolower);
+    return ext;
+  };
+  
+  // The character '*' in the pattern corresponds to any sequence of characters (e.g. "gr*").
+  static bool _btk_match_extension(const char* pattern, const char* ext)
+  {
+    if (*pattern == '\0')
+      return (*ext == '\0');
+    if (*pattern == '*')
+      return _btk_match_extension(pattern + 1, ext) || ((*ext != '\0') && _btk_match_extension(pattern, ext + 1));
+    return (*pattern == *ext) && _btk_match_extension(pattern + 1, ext + 1);
+  };
+  
+  static AcquisitionFileIOHandles::Detection _btk_detection(AcquisitionFileIOHandle::Pointer handle)
+  {
+    AcquisitionFileIOHandles::Detection d;
+    d.handle = handle;
+    const AcquisitionFileIO::Extensions& exts = handle->GetFileIO()->GetSupportedExtensions();
+    for (AcquisitionFileIO::Extensions::ConstIterator it = exts.Begin() ; it != exts.End() ; ++it)
+    {
+      std::string name = it->name;
+      std::transform(name.begin(), name.end(), name.begin(), tolower);
+      d.extensions.push_back(name);
+      for (int i = 0 ; i < static_cast<int>(sizeof(_btk_signatures) / sizeof(_btk_signature)) ; ++i)
+      {
+        if ((name.compare(_btk_signatures[i].extension) == 0) && ((_btk_signatures[i].description == 0) || (it->desc.compare(_btk_signatures[i].description) == 0)))
+          d.signatures.push_back(i);
+      }
+    }
+    return d;
+  };
+  
   /**
    * @class AcquisitionFileIOFactory btkAcquisitionFileIOFactory.h
    * @brief Manage all the acquisition file IOs and detect if a file is readable or writable.
@@ -68,25 +140,91 @@ namespace btk
    */
   
   /**
-   * Try to find the AcquisitionFileIO helper to read/write the file. This method has
-   * to be modified each time a new AcquisitionFileIO is added in this library. The order
-   * of the IO is important as the first AcquisitionFileIO which can read/write the file
-   * is returned.
+   * Try to find the AcquisitionFileIO helper to read/write the file.
+   *
+   * In read mode, the first bytes of the file are read once and compared with the signatures 
+   * known for the registered file formats. The file IOs are then sorted: first the ones which 
+   * support the extension of the file and which match the signature, then the ones supporting 
+   * only the extension, then the ones matching only the signature, and finally the others. 
+   * The ones with a known signature which doesn't match are tested at the end. The first 
+   * AcquisitionFileIO which confirms that it can read the file (see AcquisitionFileIO::CanReadFile()) 
+   * is returned. For the same rank, the order of registration is kept.
+   *
+   * In write mode, the first AcquisitionFileIO which can write the file is returned. The order
+   * of registration is important.
+   *
+   * This method can be called concurrently by several threads.
    */
   AcquisitionFileIO::Pointer AcquisitionFileIOFactory::CreateAcquisitionIO(const std::string& filename, OpenMode mode)
   {
+    AcquisitionFileIOHandles* handles = AcquisitionFileIOFactory::GetInfoIOs();
     AcquisitionFileIO::Pointer io;
     if (mode == ReadMode)
     {
-      for (AcquisitionFileIOHandles::ConstIterator it = AcquisitionFileIOFactory::GetInfoIOs()->list.begin() ; it != AcquisitionFileIOFactory::GetInfoIOs()->list.end() ; ++it)
+      char prefix[_btk_signature_prefix_size];
+      std::ifstream ifs(filename.c_str(), std::ios_base::in | std::ios_base::binary);
+      if (!ifs.is_open())
+        return io;
+      ifs.read(prefix, _btk_signature_prefix_size);
+      int prefixSize = static_cast<int>(ifs.gcount());
+      ifs.close();
+      std::string ext = _btk_lowercase_extension(filename);
+      
+      handles->lock.Lock();
+      if (!handles->detectionUpToDate)
       {
-        if ((*it)->HasReadOperation() && (io = (*it)->GetFileIO())->CanReadFile(filename))
+        handles->detection.clear();
+        for (AcquisitionFileIOHandles::ConstIterator it = handles->list.begin() ; it != handles->list.end() ; ++it)
+        {
+          if ((*it)->HasReadOperation())
+            handles->detection.push_back(_btk_detection((*it)));
+        }
+        handles->detectionUpToDate = true;
+      }
+      std::vector<AcquisitionFileIOHandles::Detection> detection = handles->detection;
+      handles->lock.Unlock();
+      
+      std::vector< std::pair<int,int> > candidates(detection.size()); // (-rank, index)
+      for (size_t i = 0 ; i < detection.size() ; ++i)
+      {
+        int rank = 0;
+        for (size_t j = 0 ; j < detection[i].extensions.size() ; ++j)
+        {
+          if (_btk_match_extension(detection[i].extensions[j].c_str(), ext.c_str()))
+          {
+            rank += 2;
+            break;
+          }
+        }
+        if (!detection[i].signatures.empty())
+        {
+          bool matched = false;
+          for (size_t j = 0 ; j < detection[i].signatures.size() ; ++j)
+          {
+            const _btk_signature& sig = _btk_signatures[detection[i].signatures[j]];
+            if ((sig.offset + sig.length <= prefixSize) && (memcmp(prefix + sig.offset, sig.bytes, sig.length) == 0))
+            {
+              matched = true;
+              break;
+            }
+          }
+          rank += (matched ? 1 : -2);
+        }
+        candidates[i] = std::make_pair(-rank, static_cast<int>(i));
+      }
+      std::sort(candidates.begin(), candidates.end()); // The index keeps the order of registration for the same rank.
+      for (size_t i = 0 ; i < candidates.size() ; ++i)
+      {
+        if ((io = detection[candidates[i].second].handle->GetFileIO())->CanReadFile(filename))
           return io;
       }
     }
     else
     {
-      for (AcquisitionFileIOHandles::ConstIterator it = AcquisitionFileIOFactory::GetInfoIOs()->list.begin() ; it != AcquisitionFileIOFactory::GetInfoIOs()->list.end() ; ++it)
+      handles->lock.Lock();
+      std::vector<AcquisitionFileIOHandle::Pointer> writers(handles->list.begin(), handles->list.end());
+      handles->lock.Unlock();
+      for (std::vector<AcquisitionFileIOHandle::Pointer>::const_iterator it = writers.begin() ; it != writers.end() ; ++it)
       {
         if ((*it)->HasWriteOperation() && (io = (*it)->GetFileIO())->CanWriteFile(filename))
           return io;
@@ -102,13 +240,24 @@ namespace btk
    */
   bool AcquisitionFileIOFactory::AddFileIO(AcquisitionFileIOHandle::Pointer infoIO)
   {
-    for (AcquisitionFileIOHandles::ConstIterator it = AcquisitionFileIOFactory::GetInfoIOs()->list.begin() ; it != AcquisitionFileIOFactory::GetInfoIOs()->list.end() ; ++it)
+    AcquisitionFileIOHandles* handles = AcquisitionFileIOFactory::GetInfoIOs();
+    bool added = true;
+    handles->lock.Lock();
+    for (AcquisitionFileIOHandles::ConstIterator it = handles->list.begin() ; it != handles->list.end() ; ++it)
     {
       if ((*it)->GetFunctor() == infoIO->GetFunctor())
-        return false;
+      {
+        added = false;
+        break;
+      }
+    }
+    if (added)
+    {
+      handles->list.push_front(infoIO);
+      handles->detectionUpToDate = false;
     }
-    AcquisitionFileIOFactory::GetInfoIOs()->list.push_front(infoIO);
-    return true;
+    handles->lock.Unlock();
+    return added;
   };
   
   /**
@@ -118,15 +267,21 @@ namespace btk
    */
   bool AcquisitionFileIOFactory::RemoveFileIO(AcquisitionFileIOHandle::Pointer infoIO)
   {
-    for (AcquisitionFileIOHandles::Iterator it = AcquisitionFileIOFactory::GetInfoIOs()->list.begin() ; it != AcquisitionFileIOFactory::GetInfoIOs()->list.end() ; ++it)
+    AcquisitionFileIOHandles* handles = AcquisitionFileIOFactory::GetInfoIOs();
+    bool removed = false;
+    handles->lock.Lock();
+    for (AcquisitionFileIOHandles::Iterator it = handles->list.begin() ; it != handles->list.end() ; ++it)
     {
       if ((*it)->GetFunctor() == infoIO->GetFunctor())
       {
-        AcquisitionFileIOFactory::GetInfoIOs()->list.erase(it);
-        return true;
+        handles->list.erase(it);
+        handles->detectionUpToDate = false;
+        removed = true;
+        break;
       }
     }
-    return false;
+    handles->lock.Unlock();
+    return removed;
   };
   
   /**
@@ -136,12 +291,15 @@ namespace btk
    */
   AcquisitionFileIO::Extensions AcquisitionFileIOFactory::GetSupportedReadExtensions()
   {
+    AcquisitionFileIOHandles* handles = AcquisitionFileIOFactory::GetInfoIOs();
     AcquisitionFileIO::Extensions exts;
-    for (AcquisitionFileIOHandles::Iterator it = AcquisitionFileIOFactory::GetInfoIOs()->list.begin() ; it != AcquisitionFileIOFactory::GetInfoIOs()->list.end() ; ++it)
+    handles->lock.Lock();
+    for (AcquisitionFileIOHandles::ConstIterator it = handles->list.begin() ; it != handles->list.end() ; ++it)
     {
       if ((*it)->HasReadOperation())
         exts.Append((*it)->GetFileIO()->GetSupportedExtensions());
     }
+    handles->lock.Unlock();
     return exts;
   };
   
@@ -152,12 +310,15 @@ namespace btk
    */
   AcquisitionFileIO::Extensions AcquisitionFileIOFactory::GetSupportedWrittenExtensions()
   {
+    AcquisitionFileIOHandles* handles = AcquisitionFileIOFactory::GetInfoIOs();
     AcquisitionFileIO::Extensions exts;
-    for (AcquisitionFileIOHandles::Iterator it = AcquisitionFileIOFactory::GetInfoIOs()->list.begin() ; it != AcquisitionFileIOFactory::GetInfoIOs()->list.end() ; ++it)
+    handles->lock.Lock();
+    for (AcquisitionFileIOHandles::ConstIterator it = handles->list.begin() ; it != handles->list.end() ; ++it)
     {
       if ((*it)->HasWriteOperation())
         exts.Append((*it)->GetFileIO()->GetSupportedExtensions());
     }
+    handles->lock.Unlock();
     return exts;
   };
   
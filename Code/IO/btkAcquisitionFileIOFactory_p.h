@@ -37,13 +37,16 @@
 #define __btkAcquisitionFileIOFactory_p_h
 
 #include "btkAcquisitionFileIORegister.h"
+#include "btkCriticalSection_p.h"
+
+#include <vector>
 
 #define BTK_REGISTER_ACQUISITION_FILE_IO(classname) \
   this->list.push_back(btk::AcquisitionFileIORegister<classname>::New());
    
 #define BTK_ACQUISITON_FILE_IO_FACTORY_INIT \
    AcquisitionFileIOHandles::AcquisitionFileIOHandles() \
-   : list()
+   : list(), lock(), detection(), detectionUpToDate(false)
 
 namespace btk
 {
@@ -52,8 +55,18 @@ namespace btk
   public:
     typedef std::list<AcquisitionFileIOHandle::Pointer>::iterator Iterator;
     typedef std::list<AcquisitionFileIOHandle::Pointer>::const_iterator ConstIterator;
+    // Precomputed informations used to sort the file IOs before to call their method CanReadFile().
+    struct Detection
+    {
+      AcquisitionFileIOHandle::Pointer handle;
+      std::vector<std::string> extensions; // lowercase
+      std::vector<int> signatures; // Indices in the table of known signatures
+    };
     AcquisitionFileIOHandles();
     std::list<AcquisitionFileIOHandle::Pointer> list;
+    critical_section_p lock; // Must be locked to access to the other members
+    std::vector<Detection> detection;
+    bool detectionUpToDate;
   };
 }
 
@@ -35,8 +35,13 @@
 
 #include "btkAcquisitionFileReader.h"
 #include "btkAcquisitionFileIOFactory.h"
+#include "btkInstrumentation.h"
+#include "btkLogger.h"
+#include "btkConvert.h"
 
 #include <fstream>
+#include <typeinfo>
+#include <sys/stat.h>
 
 namespace btk
 {
@@ -115,6 +120,33 @@ namespace btk
    * Enable/disable exception for the missing of the filename.
    */
   
+  /**
+   * @fn bool AcquisitionFileReader::GetOutputRecycling() const
+   * Returns true if the output is refilled in place by reusing its points and analog channels.
+   */
+  
+  /**
+   * @fn void AcquisitionFileReader::SetOutputRecycling(bool enabled)
+   * Enable/disable the refilling in place of the output. When enabled, the points and analog channels 
+   * of the previous reading are reused (with their values' buffers) for the next file (see Acquisition::SetMeasureRecycling()).
+   * Only the measures which are not used by another object (e.g. kept by the user or by a downstream filter) are reused.
+   * When successive files have the same layout (e.g. the trials of a session recorded with the same marker set), 
+   * reading them with the same reader doesn't reallocate the measures.
+   *
+   * @code
+   * btk::AcquisitionFileReader::Pointer reader = btk::AcquisitionFileReader::New();
+   * reader->SetOutputRecycling(true);
+   * for (size_t i = 0 ; i < filenames.size() ; ++i)
+   * {
+   *   reader->SetFilename(filenames[i]);
+   *   reader->Update();
+   *   // Process the output...
+   * }
+   * @endcode
+   *
+   * @warning The points and analog channels of the previous reading are modified. Keep a reference on them (or clone them) if you need them after the next reading.
+   */
+  
   /**
    * @fn const std::string& AcquisitionFileReader::GetFilename() const
    * Gets the filename of the file to read.
@@ -165,6 +197,7 @@ namespace btk
   {
     this->SetOutputNumber(1);
     this->m_FilenameExtensionDisabled = false;
+    this->m_OutputRecycling = false;
   };
   
   /**
@@ -184,6 +217,9 @@ namespace btk
   /**
    * Check the file integrety, find a AcquisitionIO helper class if no one has
    * been specified and finally read the file.
+   *
+   * When the instrumentation is enabled, the duration, the number of bytes read and the number of
+   * items are reported under the category "AcquisitionFileIO" (see Instrumentation).
    */
   void AcquisitionFileReader::GenerateData()
   {
@@ -195,6 +231,9 @@ namespace btk
         return;
     }
     
+    // The warnings sent during the reading are attributed to the file.
+    Logger::Context context(btkStripPathMacro(this->m_Filename.c_str()));
+    
     std::ifstream ifs;
     ifs.open(this->m_Filename.c_str());
     // check if the file exists
@@ -212,6 +251,48 @@ namespace btk
         throw AcquisitionFileReaderException("No IO found, the file is not supported or valid or the file suffix is misspelled (Some IO use it to verify they can read the file)\nFilename: " + this->m_Filename);
     }
     
+    this->GetOutput()->SetMeasureRecycling(this->m_OutputRecycling);
+    
+    Instrumentation::Scope scope("AcquisitionFileIO", typeid(*(this->m_AcquisitionIO)), "Read", this->m_Filename);
     this->m_AcquisitionIO->Read(this->m_Filename, this->GetOutput());
+    if (scope.IsActive())
+    {
+      struct stat info;
+      Acquisition::Pointer acq = this->GetOutput();
+      scope.SetBytes((stat(this->m_Filename.c_str(), &info) == 0) ? static_cast<size_t>(info.st_size) : 0);
+      scope.SetItems(static_cast<size_t>(acq->GetPointNumber() + acq->GetAnalogNumber() + acq->GetEventNumber()));
+    }
+  };
+  
+  /**
+   * Identifies the read file by its name, its size and its last modification time (with a nanosecond resolution 
+   * when the system provides it). The type of the AcquisitionIO (if one is set) and its generic options (byte order, 
+   * storage format and internals update options), as well as the options of this reader, are also used. The options 
+   * specific to an AcquisitionIO are not taken into account. If the output is restored from a cache 
+   * (see ProcessObject::SetResultCache()), the file is not read and no AcquisitionIO is created.
+   * Returns false if the file doesn't exist.
+   */
+  bool AcquisitionFileReader::GetCacheParameters(std::string& parameters) const
+  {
+    struct stat info;
+    if (this->m_Filename.empty() || (stat(this->m_Filename.c_str(), &info) != 0))
+      return false;
+#if defined(__APPLE__)
+    long mtimeNs = static_cast<long>(info.st_mtimespec.tv_nsec);
+#elif defined(__linux__) || defined(__CYGWIN__)
+    long mtimeNs = static_cast<long>(info.st_mtim.tv_nsec);
+#else
+    long mtimeNs = 0;
+#endif
+    parameters = this->m_Filename + "\n" + ToString(static_cast<unsigned long>(info.st_size)) + "\n" + ToString(static_cast<long>(info.st_mtime)) + "." + ToString(mtimeNs);
+    if (this->m_AcquisitionIO)
+    {
+      parameters += "\n" + std::string(typeid(*(this->m_AcquisitionIO)).name())
+                  + "\n" + ToString(static_cast<int>(this->m_AcquisitionIO->GetByteOrder()))
+                  + "\n" + ToString(static_cast<int>(this->m_AcquisitionIO->GetStorageFormat()))
+                  + "\n" + ToString(this->m_AcquisitionIO->GetInternalsUpdateOptions());
+    }
+    parameters += "\n" + ToString(static_cast<int>(this->m_FilenameExtensionDisabled)) + ToString(static_cast<int>(this->m_OutputRecycling));
+    return true;
   };
 };
@@ -67,6 +67,8 @@ namespace btk
    
     bool GetDisableFilenameExceptionState() const {return this->m_FilenameExtensionDisabled;};
     void SetDisableFilenameExceptionState(bool s) {this->m_FilenameExtensionDisabled = s;};
+    bool GetOutputRecycling() const {return this->m_OutputRecycling;};
+    void SetOutputRecycling(bool enabled) {this->m_OutputRecycling = enabled;};
     const std::string& GetFilename() const {return this->m_Filename;};
     BTK_IO_EXPORT void SetFilename(const std::string& filename);
     AcquisitionFileIO::Pointer GetAcquisitionIO() {return this->m_AcquisitionIO;};
@@ -79,6 +81,7 @@ namespace btk
     Acquisition::Pointer GetOutput(int idx) {return static_pointer_cast<Acquisition>(this->GetNthOutput(idx));};
     BTK_IO_EXPORT virtual DataObject::Pointer MakeOutput(int idx);
     BTK_IO_EXPORT virtual void GenerateData();
+    BTK_IO_EXPORT virtual bool GetCacheParameters(std::string& parameters) const;
     
     AcquisitionFileIO::Pointer m_AcquisitionIO;
     std::string m_Filename;
@@ -88,6 +91,7 @@ namespace btk
     AcquisitionFileReader& operator=(const AcquisitionFileReader& ); // Not implemented.
 
     bool m_FilenameExtensionDisabled;
+    bool m_OutputRecycling;
   };
 };
 
@@ -35,8 +35,12 @@
 
 #include "btkAcquisitionFileWriter.h"
 #include "btkAcquisitionFileIOFactory.h"
+#include "btkInstrumentation.h"
+#include "btkLogger.h"
 
 #include <fstream>
+#include <typeinfo>
+#include <sys/stat.h>
 
 namespace btk
 {
@@ -191,12 +195,18 @@ namespace btk
   /**
    * Check the file integrety, find a AcquisitionIO helper class if no one has
    * been specified and finally read the file.
+   *
+   * When the instrumentation is enabled, the duration, the number of bytes written and the number of
+   * items are reported under the category "AcquisitionFileIO" (see Instrumentation).
    */
   void AcquisitionFileWriter::GenerateData()
   {
     if (this->m_Filename.empty())
       throw AcquisitionFileWriterException("Filename must be specified.");
     
+    // The warnings sent during the writing are attributed to the file.
+    Logger::Context context(btkStripPathMacro(this->m_Filename.c_str()));
+    
     std::ofstream ofs(this->m_Filename.c_str());
     // check if the file exists
     if (!ofs)
@@ -210,6 +220,14 @@ namespace btk
         throw AcquisitionFileWriterException("No IO found, the file is not supported or the file suffix is misspelled (IOs use it to verify they can write the file)\nFilename: " + this->m_Filename);
     }
     
+    Instrumentation::Scope scope("AcquisitionFileIO", typeid(*(this->m_AcquisitionIO)), "Write", this->m_Filename);
     this->m_AcquisitionIO->Write(this->m_Filename, this->GetInput());
+    if (scope.IsActive())
+    {
+      struct stat info;
+      Acquisition::Pointer acq = this->GetInput();
+      scope.SetBytes((stat(this->m_Filename.c_str(), &info) == 0) ? static_cast<size_t>(info.st_size) : 0);
+      scope.SetItems(static_cast<size_t>(acq->GetPointNumber() + acq->GetAnalogNumber() + acq->GetEventNumber()));
+    }
   };
 };
@@ -37,6 +37,7 @@
 #include "btkMetaDataUtils.h"
 #include "btkConvert.h"
 #include "btkLogger.h"
+#include "btkInstrumentation.h"
 
 #include <algorithm>
 #include <cctype>
@@ -216,6 +217,7 @@ namespace btk
     // Open the stream
     BinaryFileStream* ibfs = new NativeBinaryFileStream();
     Format* fdf = 0; // C3D file data format
+    Instrumentation::Scope phase("AcquisitionFileIO", "btk::C3DFileIO::Read:header", filename);
     ibfs->SetExceptions(BinaryFileStream::EndFileBit | BinaryFileStream::FailBit | BinaryFileStream::BadBit);
     try
     {
@@ -328,6 +330,12 @@ namespace btk
         ibfs->ReadU8();
         ibfs->ReadI8();
       }
+      if (phase.IsActive())
+      {
+        phase.SetBytes(512 * (parameterFirstBlock - 1));
+        phase.SetItems(output->GetEventNumber());
+        phase.Next("btk::C3DFileIO::Read:parameters");
+      }
       uint8_t blockNumber = ibfs->ReadU8();
       ibfs->ReadU8(); // Processor type
       size_t totalBytesRead = 4; // the four bytes read previously.
@@ -641,6 +649,12 @@ namespace btk
         }
       }
     // Data
+      if (phase.IsActive())
+      {
+        phase.SetBytes(512 * blockNumber);
+        phase.SetItems(groupIds.size() + parameters.size());
+        phase.Next("btk::C3DFileIO::Read:data");
+      }
       if (dataFirstBlock != 0)
       {
         if (dataFirstBlock < (parameterFirstBlock + blockNumber))
@@ -808,6 +822,14 @@ namespace btk
           else
             throw;
         }
+        if (phase.IsActive())
+        {
+          std::streamoff end = static_cast<std::streamoff>(ibfs->TellRead());
+          if (end > 0)
+            phase.SetBytes(static_cast<size_t>(end) - 512 * (dataFirstBlock - 1));
+          phase.SetItems(output->GetPointNumber() + output->GetAnalogNumber());
+          phase.Next("btk::C3DFileIO::Read:post-processing");
+        }
     // Label, description, unit and type
         size_t inc = 0; 
         std::vector<std::string> collapsed;
@@ -1023,6 +1045,7 @@ namespace btk
 
     BinaryFileStream* obfs = 0;
     Format* fdf = 0; // C3D file data format
+    Instrumentation::Scope phase("AcquisitionFileIO", "btk::C3DFileIO::Write:preparation", filename);
     try
     {
       // Binary stream selection
@@ -1089,6 +1112,7 @@ namespace btk
         btkWarningMacro("The internals (i.e. points' scale and analog channels ADC parameters) were not generated as no option was given to do it. Default values are used.");
       }
       
+      phase.Next("btk::C3DFileIO::Write:header");
       // Acquisition
       bool templateFile = true;
       size_t writtenBytes = 0;
@@ -1179,6 +1203,12 @@ namespace btk
         // Fill the end of the header section with 0x00
         obfs->Fill(512 - writtenBytes);
       }
+      if (phase.IsActive())
+      {
+        phase.SetBytes(templateFile ? 0 : 512);
+        phase.SetItems(input->GetEventNumber());
+        phase.Next("btk::C3DFileIO::Write:parameters");
+      }
       // -= PARAMETER =-
       writtenBytes = 0;
       // The number of the first block of the Parameter data in the Parameter section
@@ -1242,6 +1272,11 @@ namespace btk
       }
       if (writtenBytes > (255 * 512)) // 255 * 512 = max size
         throw(C3DFileIOException("Total size reserved for the parameters was exceeded. Impossible to write the acquisition in a C3D file."));
+      if (phase.IsActive())
+      {
+        phase.SetBytes(writtenBytes);
+        phase.Next("btk::C3DFileIO::Write:data");
+      }
       // -= DATA =-
       if (!templateFile)
       {
@@ -1289,6 +1324,11 @@ namespace btk
             }
           }
         }
+        if (phase.IsActive())
+        {
+          phase.SetBytes(static_cast<size_t>(frameNumber) * (input->GetPointNumber() * 4 + input->GetAnalogNumber() * numberSamplesPerAnalogChannel) * ((this->m_StorageFormat == Integer) ? 2 : 4));
+          phase.SetItems(input->GetPointNumber() + input->GetAnalogNumber());
+        }
       }
     }
     catch (C3DFileIOException& )
@@ -36,16 +36,95 @@
 #include "btkTRCFileIO.h"
 #include "btkConvert.h"
 #include "btkLogger.h"
+#include "btkTextFileStream_p.h"
 
 #include <fstream>
 #include <algorithm>
 #include <cctype>
+#include <cmath>
 #include <iostream>
 #include <map>
 #include <sstream>
 
 namespace btk
 {
+  static void _btk_trc_getline(text_file_p& file, std::string& line)
+  {
+    if (!file.getline(line))
+      throw(TRCFileIOException("Unexpected end of file."));
+  };
+  
+  // Extract the values of the next frame (the columns Frame# and Time are skipped, as well as the empty lines).
+  static void _btk_trc_get_frame_values(text_file_p& file, text_range_p* values)
+  {
+    do
+    {
+      if (!file.getline(values))
+        throw(TRCFileIOException("Unexpected end of file."));
+    }
+    while (text_is_blank_p(*values));
+    text_range_p token;
+    text_next_token_p(values, &token); // Frame#
+    text_next_token_p(values, &token); // Time
+    if (!values->empty())
+      ++(values->begin); // Separator
+  };
+  
+  // Rows of the markers' coordinates. The time of each frame is computed before the formatting.
+  class TRCFileIOMarkerRows_p : public text_row_formatter_p
+  {
+  public:
+    TRCFileIOMarkerRows_p(PointCollection::Pointer markers, int frameNumber, double stepTime)
+    : m_Values(), m_Residuals(), m_Times(frameNumber)
+    {
+      for (PointCollection::ConstIterator it = markers->Begin() ; it != markers->End() ; ++it)
+      {
+        this->m_Values.push_back((*it)->GetValues().data());
+        this->m_Residuals.push_back((*it)->GetResiduals().data());
+      }
+      this->m_FrameNumber = frameNumber;
+      double time = 0.0;
+      for (int frame = 0 ; frame < frameNumber ; ++frame)
+      {
+        this->m_Times[frame] = time;
+        time += stepTime;
+      }
+    };
+    virtual void format(std::string* out, int row) const
+    {
+      out->push_back('\n');
+      text_append_int_p(out, row + 1);
+      out->push_back('\t');
+      text_append_fixed_p(out, this->m_Times[row], 3);
+      for (size_t j = 0 ; j < this->m_Values.size() ; ++j)
+      {
+        const double* x = this->m_Values[j] + row;
+        const double* y = x + this->m_FrameNumber;
+        const double* z = y + this->m_FrameNumber;
+        if (this->IsZero(*x) && this->IsZero(*y) && this->IsZero(*z) && (this->m_Residuals[j][row] == -1))
+          out->append("\t\t\t");
+        else
+        {
+          out->push_back('\t');
+          text_append_fixed_p(out, *x, 5);
+          out->push_back('\t');
+          text_append_fixed_p(out, *y, 5);
+          out->push_back('\t');
+          text_append_fixed_p(out, *z, 5);
+        }
+      }
+      out->push_back(' ');
+    };
+  private:
+    // Same comparison than the method isZero() of Eigen.
+    static bool IsZero(double v) {return std::fabs(v) <= Eigen::NumTraits<double>::dummy_precision();};
+    
+    std::vector<const double*> m_Values;
+    std::vector<const double*> m_Residuals;
+    std::vector<double> m_Times;
+    int m_FrameNumber;
+  };
+  
   /**
    * @class TRCFileIOException btkTRCFileIO.h
    * @brief Exception class for the TRCFileIO class.
@@ -119,23 +198,23 @@ namespace btk
   void TRCFileIO::Read(const std::string& filename, Acquisition::Pointer output)
   {
     output->Reset();
-    // Open the stream
-    std::ifstream ifs;
-    ifs.exceptions(std::ios_base::eofbit | std::ios_base::failbit | std::ios_base::badbit);
+    // Open the file (mapped in memory)
+    text_file_p file;
     try
     {
       std::string line;
-      ifs.open(filename.c_str());
+      if (!file.open(filename))
+        throw(TRCFileIOException("Invalid file path."));
     // Check the first header keyword: "PathFileType"
-      std::getline(ifs, line);
+      _btk_trc_getline(file, line);
       if (line.substr(0,12).compare("PathFileType") != 0)
         throw(TRCFileIOException("Invalid TRC file."));
     // Extract header data
       // Required TRC keywords : DataRate, NumFrames, NumMarkers, Units, OrigDataStartFrame
       std::map<std::string, std::string> keywords;
       std::string k, v;
-      std::getline(ifs, k); // keywords
-      std::getline(ifs, v); // corresponding values
+      _btk_trc_getline(file, k); // keywords
+      _btk_trc_getline(file, v); // corresponding values
       size_t kf2 = -1, kf1 = 0, vf2 = -1, vf1 = 0;
       char sep = '\t';
       while(1)
@@ -169,17 +248,17 @@ namespace btk
         btkWarningMacro(filename, "No 'Units' keyword. Default unit is millimeter (mm)");
         output->SetPointUnit("mm");
       }
+      text_range_p values;
       if (numberOfPoints != 0)
       {
-        std::getline(ifs, line);
-        std::istringstream iss(line.substr(0, line.length() - 1), std::istringstream::in); // No need of the carriage return character
+        _btk_trc_getline(file, line); // The carriage return character is already removed
+        std::istringstream iss(line, std::istringstream::in);
         std::string buf;
         std::list<std::string> labels;
         iss >> buf; // Frame#
         iss >> buf; // Time
-        while (iss)
+        while (std::getline(iss, buf, '\t'))
         {
-          std::getline(iss, buf, '\t');
           if (!buf.empty())
           {
             btkTrimString(&buf);
@@ -192,7 +271,7 @@ namespace btk
           btkWarningMacro(filename, "Mismatch between the number of points and the number of labels extracted. Final number of points corresponds to the number of labels extracted.");
           numberOfPoints = numberOfLabels;
         }
-        std::getline(ifs, line); // Coordinate's label (X1, Y1, Z1, ...)
+        _btk_trc_getline(file, line); // Coordinate's label (X1, Y1, Z1, ...)
         output->Init(numberOfPoints, numberOfFrames);
         std::list<std::string>::const_iterator itLabel = labels.begin();
         for (PointCollection::Iterator it = output->BeginPoint() ; it != output->EndPoint() ; ++it)
@@ -200,18 +279,10 @@ namespace btk
           (*it)->SetLabel(*itLabel);
           ++itLabel;
         }
-        ifs.exceptions(std::ios_base::goodbit); // Remove exceptions
         for(int i = 0 ; i < numberOfFrames ; ++i)
         {
-          if (ifs.eof())
-            throw(TRCFileIOException("Unexpected end of file."));
-          
-          ifs >> buf; // Frame#
-          ifs >> buf; // Time
-          std::getline(ifs, line);
-          line[0] = ' '; // was '\t'
-          line[line.length() - 1] = '\t'; // was '\n'
-          this->ExtractValuesForFrame(line, output, i);
+          _btk_trc_get_frame_values(file, &values);
+          this->ExtractValuesForFrame(values, output, i);
         }
       }
       // In case there is only unlabel markers in the TRC file (see issue #70 - https://code.google.com/p/b-tk/issues/detail?id=70)
@@ -219,27 +290,18 @@ namespace btk
       {
         btkWarningMacro(filename, "Number of point is null but the number of frames. Trying to find values for unlabeled markers...")
         output->Init(0, numberOfFrames); 
-        std::getline(ifs, line); // Frame#, Time and normaly markers' labels
-        std::getline(ifs, line); // Coordinate's label (X1, Y1, Z1, ...)
-        ifs.exceptions(std::ios_base::goodbit); // Remove exceptions
+        _btk_trc_getline(file, line); // Frame#, Time and normaly markers' labels
+        _btk_trc_getline(file, line); // Coordinate's label (X1, Y1, Z1, ...)
         for(int i = 0 ; i < numberOfFrames ; ++i)
         {
-          if (ifs.eof())
-            throw(TRCFileIOException("Unexpected end of file."));
-          
-          std::string buf;
-          ifs >> buf; // Frame#
-          ifs >> buf; // Time
-          std::getline(ifs, line);
-          line[0] = ' '; // was '\t'
-          line[line.length() - 1] = '\t'; // was '\n'
-          if (line.size() == 2) // correspond to " \t"
+          _btk_trc_get_frame_values(file, &values);
+          if (values.empty())
             continue;
-          // Count the number of tab
-          int numTabs = 0;
-          for (size_t j = 0 ; j < line.length() ; ++j)
+          // Count the number of tab (the last value is followed by a virtual tab)
+          int numTabs = 1;
+          for (const char* c = values.begin ; c != values.end ; ++c)
           {
-            if (line[j] == '\t')
+            if (*c == '\t')
               ++numTabs;
           }
           int numMarkers = numTabs / 3;
@@ -253,40 +315,23 @@ namespace btk
             }
           }
           if (numMarkers > 0)
-            this->ExtractValuesForFrame(line, output, i);
+            this->ExtractValuesForFrame(values, output, i);
         }
       }
     }
-    catch (std::fstream::failure& )
-    {
-      std::string excmsg; 
-      if (!ifs.is_open())
-        excmsg = "Invalid file path.";
-      else if (ifs.eof())
-        excmsg = "Unexpected end of file.";
-      else if(ifs.bad())
-        excmsg = "Loss of integrity of the file stream.";
-      else if(ifs.fail())
-        excmsg = "Internal logic operation error on the stream associated with the file.";
-      else
-        excmsg = "Unknown error associated with the file stream.";
-      
-      if (ifs.is_open()) ifs.close();    
-      throw(TRCFileIOException(excmsg));
-    }
     catch (TRCFileIOException& )
     {
-      if (ifs.is_open()) ifs.close(); 
+      file.close();
       throw;
     }
     catch (std::exception& e)
     {
-      if (ifs.is_open()) ifs.close(); 
+      file.close();
       throw(TRCFileIOException("Unexpected exception occurred: " + std::string(e.what())));
     }
     catch(...)
     {
-      if (ifs.is_open()) ifs.close(); 
+      file.close();
       throw(TRCFileIOException("Unknown exception"));
     }
   };
@@ -301,8 +346,8 @@ namespace btk
       btkErrorMacro("Impossible to write a null input into a file.");
       return;
     }
-    std::ofstream ofs(filename.c_str());
-    if (!ofs) 
+    text_output_p output;
+    if (!output.open(filename))
       throw(TRCFileIOException("Invalid file path."));
     PointCollection::Pointer markers = PointCollection::New();
     for (PointCollection::ConstIterator it = input->BeginPoint() ; it != input->EndPoint() ; ++it)
@@ -324,11 +369,12 @@ namespace btk
     else
       btkWarningMacro(filename, "Points' frequency is not set. Default frequency is set to 100Hz");
     double stepTime = 1.0 / freq;
-    ofs << static_cast<std::string>("PathFileType\t4\t(X/Y/Z)\t") << btkStripPathMacro(filename.c_str());
-    ofs << static_cast<std::string>("\t\nDataRate\tCameraRate\tNumFrames\tNumMarkers\tUnits\tOrigDataRate\tOrigDataStartFrame\tOrigNumFrames\t\n");
-    ofs.setf(std::ios::fixed, std::ios::floatfield);
-    ofs.precision(2);
-    ofs << input->GetPointFrequency() /* DataRate */ << "\t"
+    std::ostringstream oss;
+    oss << static_cast<std::string>("PathFileType\t4\t(X/Y/Z)\t") << btkStripPathMacro(filename.c_str());
+    oss << static_cast<std::string>("\t\nDataRate\tCameraRate\tNumFrames\tNumMarkers\tUnits\tOrigDataRate\tOrigDataStartFrame\tOrigNumFrames\t\n");
+    oss.setf(std::ios::fixed, std::ios::floatfield);
+    oss.precision(2);
+    oss << input->GetPointFrequency() /* DataRate */ << "\t"
         << input->GetPointFrequency() /* CameraRate */ << "\t"
         << input->GetPointFrameNumber() /* NumFrames */ << "\t"
         << markers->GetItemNumber() /* NumMarkers */ << "\t"
@@ -336,58 +382,57 @@ namespace btk
         << freq /* OrigDataRate */ << "\t"
         << input->GetFirstFrame() /* OrigDataStartFrame */ << "\t"
         << input->GetPointFrameNumber() /* OrigNumFrames */<< "\t\n";
-    ofs << "Frame#\tTime\t";
+    oss << "Frame#\tTime\t";
     for (PointCollection::ConstIterator it = markers->Begin() ; it != markers->End() ; ++it)
-      ofs << (*it)->GetLabel() << "\t\t\t";
-    ofs << "\n\t\t";
+      oss << (*it)->GetLabel() << "\t\t\t";
+    oss << "\n\t\t";
     int idx = 1;
     for (PointCollection::ConstIterator it = markers->Begin() ; it != markers->End() ; ++it)
     {
-      ofs << "X" << idx << "\t" << "Y" << idx << "\t" << "Z" << idx << "\t";
+      oss << "X" << idx << "\t" << "Y" << idx << "\t" << "Z" << idx << "\t";
       ++idx;
     }
-    ofs << "\n";
-    double time = 0.0;
-    for (int frame = 0 ; frame < input->GetPointFrameNumber() ; ++frame)
-    {
-      ofs.precision(3);
-      ofs << std::endl << frame + 1 << "\t" << time;
-      ofs.precision(5);
-
-      for (PointCollection::ConstIterator it = markers->Begin() ; it != markers->End() ; ++it)
-      {
-        if ((*it)->GetValues().row(frame).isZero() && ((*it)->GetResiduals().coeff(frame) == -1))
-          ofs << "\t\t\t";
-        else
-           ofs << "\t" << (*it)->GetValues().coeff(frame, 0)
-               << "\t" << (*it)->GetValues().coeff(frame, 1)
-               << "\t" << (*it)->GetValues().coeff(frame, 2);
-      };
-      ofs << " ";
-      time += stepTime;
-    };
-    ofs << std::endl;
-    ofs.close();
+    oss << "\n";
+    output.write(oss.str());
+    TRCFileIOMarkerRows_p rows(markers, input->GetPointFrameNumber(), stepTime);
+    if (!text_write_rows_p(&output, input->GetPointFrameNumber(), &rows, this->m_ThreadNumber))
+      throw(TRCFileIOException("Unexpected error during the formatting of the markers."));
+    output.write("\n", 1);
+    if (!output.close())
+      throw(TRCFileIOException("Error during the writing of the file."));
   };
   
   /**
-   * Constructor.
+   * @fn int TRCFileIO::GetThreadNumber() const
+   * Returns the number of threads used to format the coordinates during the writing. 0 means the number of processors.
+   */
+  
+  /**
+   * @fn void TRCFileIO::SetThreadNumber(int num)
+   * Sets the number of threads used to format the coordinates during the writing. A value lower or equal to 0 uses the 
+   * number of processors. Set it to 1 when several files are written in parallel.
+   */
+  
+  /**
+   * Constructor. By default, the number of threads used to format the coordinates corresponds to the number of processors.
    */
   TRCFileIO::TRCFileIO()
   : AcquisitionFileIO(AcquisitionFileIO::ASCII)
-  {};
+  {
+    this->m_ThreadNumber = 0;
+  };
   
-  void TRCFileIO::ExtractValuesForFrame(std::string& line, Acquisition::Pointer output, int frameIdx)
+  void TRCFileIO::ExtractValuesForFrame(text_range_p& values, Acquisition::Pointer output, int frameIdx)
   {
-    std::istringstream iss(line, std::istringstream::in);
+    text_range_p x, y, z;
     for (PointCollection::Iterator it = output->BeginPoint() ; it != output->EndPoint() ; ++it)
     {
-      std::string x="", y="", z="";
-      std::getline(iss, x, '\t');
-      std::getline(iss, y, '\t');
-      std::getline(iss, z, '\t');
+      x = y = z = text_range_p();
+      text_next_field_p(&values, '\t', &x);
+      text_next_field_p(&values, '\t', &y);
+      text_next_field_p(&values, '\t', &z);
       
-      if (x.empty() || y.empty() || z.empty()) // occlusion
+      if (text_is_blank_p(x) || text_is_blank_p(y) || text_is_blank_p(z)) // occlusion
       {
         (*it)->GetValues().coeffRef(frameIdx, 0) = 0.0;
         (*it)->GetValues().coeffRef(frameIdx, 1) = 0.0;
@@ -396,9 +441,10 @@ namespace btk
       }
       else
       {
-        FromString(x, (*it)->GetValues().coeffRef(frameIdx, 0));
-        FromString(y, (*it)->GetValues().coeffRef(frameIdx, 1));
-        FromString(z, (*it)->GetValues().coeffRef(frameIdx, 2));
+        if ((text_to_double_p(x.begin, x.end, &((*it)->GetValues().coeffRef(frameIdx, 0))) == 0)
+            || (text_to_double_p(y.begin, y.end, &((*it)->GetValues().coeffRef(frameIdx, 1))) == 0)
+            || (text_to_double_p(z.begin, z.end, &((*it)->GetValues().coeffRef(frameIdx, 2))) == 0))
+          throw(ConversionError("Error during type conversion from a string"));
         (*it)->GetResiduals().coeffRef(frameIdx) = 0.0;
       }
     }
@@ -41,6 +41,8 @@
 
 namespace btk
 {
+  struct text_range_p;
+  
   class TRCFileIOException : public Exception
   {
   public:
@@ -68,14 +70,19 @@ namespace btk
     BTK_IO_EXPORT virtual void Read(const std::string& filename, Acquisition::Pointer output);
     BTK_IO_EXPORT virtual void Write(const std::string& filename, Acquisition::Pointer input);
     
+    int GetThreadNumber() const {return this->m_ThreadNumber;};
+    void SetThreadNumber(int num) {this->m_ThreadNumber = (num < 0) ? 0 : num;};
+    
   protected:
     BTK_IO_EXPORT TRCFileIO();
     
   private:
-    inline void ExtractValuesForFrame(std::string& line, Acquisition::Pointer output, int frameIndex);
+    inline void ExtractValuesForFrame(text_range_p& values, Acquisition::Pointer output, int frameIndex);
     
     TRCFileIO(const TRCFileIO& ); // Not implemented.
     TRCFileIO& operator=(const TRCFileIO& ); // Not implemented. 
+    
+    int m_ThreadNumber;
    };
 };
 
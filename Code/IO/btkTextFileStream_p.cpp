@@ -0,0 +1,735 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "btkTextFileStream_p.h"
+#include "btkThread_p.h"
+
+#include <fstream>
+#include <sstream>
+#include <locale>
+#include <cstring> // memchr
+#include <cmath>
+#include <algorithm> // std::min
+
+namespace btk
+{
+  // Powers of 10 exactly representable with a double.
+  static const double _btk_text_pow10[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+  };
+  
+  // Powers of 10 as integers (up to the maximum precision used by the fast formatting).
+  static const unsigned long long _btk_text_ipow10[] = {
+    1ull, 10ull, 100ull, 1000ull, 10000ull, 100000ull, 1000000ull, 10000000ull, 100000000ull,
+    1000000000ull, 10000000000ull, 100000000000ull, 1000000000000ull, 10000000000000ull,
+    100000000000000ull, 1000000000000000ull, 10000000000000000ull, 100000000000000000ull
+  };
+  
+  // Size of the chunks written by text_output_p.
+  static const size_t _btk_text_output_chunk = 1048576;
+  
+  // Number of rows formatted by each task of text_write_rows_p.
+  static const int _btk_text_rows_per_block = 512;
+  
+  static inline bool _btk_text_is_space(char c)
+  {
+    return (c == ' ') || (c == '\t') || (c == '\r') || (c == '\n') || (c == '\v') || (c == '\f');
+  };
+  
+  static inline bool _btk_text_is_digit(char c)
+  {
+    return (c >= '0') && (c <= '9');
+  };
+  
+  /**
+   * @class text_file_p btkTextFileStream_p.h
+   * @brief Read-only text file split in lines and tokens without copy.
+   *
+   * The file is mapped in memory when the OS supports it (see mmfilebuf), otherwise 
+   * (or if the mapping failed, for example with an empty file) its content is loaded in one call.
+   * The extracted lines and tokens are ranges of characters inside this buffer. 
+   * They are valid until the file is closed.
+   *
+   * This class is used by the readers of text file formats (TRC, ANC) to parse 
+   * their numerical tables without the overhead of the streams (std::getline, std::istringstream).
+   */
+  
+  /**
+   * Constructor.
+   */
+  text_file_p::text_file_p()
+  : m_Buffer()
+  {
+    this->mp_Begin = 0;
+    this->mp_Current = 0;
+    this->mp_End = 0;
+    this->m_Opened = false;
+  };
+  
+  /**
+   * @fn text_file_p::~text_file_p()
+   * Destructor. Close the file if opened.
+   */
+  
+  /**
+   * Open the file @a filename and map its content.
+   * Returns false if the file cannot be opened or read.
+   */
+  bool text_file_p::open(const std::string& filename)
+  {
+    if (this->m_Opened)
+      return false;
+#if !defined(BTK_NO_MEMORY_MAPPED_FILESTREAM)
+    if (this->m_Map.open(filename.c_str(), std::ios_base::in) != 0)
+    {
+      this->mp_Begin = this->m_Map.data();
+      this->mp_End = this->mp_Begin + this->m_Map.size();
+    }
+    else
+#endif
+    {
+      std::ifstream ifs(filename.c_str(), std::ios_base::in | std::ios_base::binary);
+      if (!ifs.is_open())
+        return false;
+      ifs.seekg(0, std::ios_base::end);
+      std::streamoff num = ifs.tellg();
+      ifs.seekg(0, std::ios_base::beg);
+      if (num < 0)
+        return false;
+      this->m_Buffer.resize(static_cast<size_t>(num));
+      if ((num != 0) && !ifs.read(&(this->m_Buffer[0]), num))
+      {
+        this->m_Buffer.clear();
+        return false;
+      }
+      this->mp_Begin = this->m_Buffer.empty() ? 0 : &(this->m_Buffer[0]);
+      this->mp_End = this->mp_Begin + this->m_Buffer.size();
+    }
+    this->mp_Current = this->mp_Begin;
+    this->m_Opened = true;
+    return true;
+  };
+  
+  /**
+   * @fn bool text_file_p::is_open() const
+   * Returns true if the file is opened.
+   */
+  
+  /**
+   * Close the file and release its content.
+   */
+  void text_file_p::close()
+  {
+    if (!this->m_Opened)
+      return;
+#if !defined(BTK_NO_MEMORY_MAPPED_FILESTREAM)
+    if (this->m_Map.is_open())
+      this->m_Map.close();
+#endif
+    std::vector<char>().swap(this->m_Buffer);
+    this->mp_Begin = 0;
+    this->mp_Current = 0;
+    this->mp_End = 0;
+    this->m_Opened = false;
+  };
+  
+  /**
+   * @fn size_t text_file_p::size() const
+   * Returns the size of the file in bytes.
+   */
+  
+  /**
+   * @fn bool text_file_p::eof() const
+   * Returns true if all the content of the file was extracted.
+   */
+  
+  /**
+   * Extracts the next line and sets it into @a line without its end of line characters (LF or CR+LF).
+   * Returns false if there is no more line.
+   */
+  bool text_file_p::getline(text_range_p* line)
+  {
+    if (this->mp_Current == this->mp_End)
+      return false;
+    const char* lf = static_cast<const char*>(memchr(this->mp_Current, '\n', this->mp_End - this->mp_Current));
+    line->begin = this->mp_Current;
+    if (lf == 0)
+    {
+      line->end = this->mp_End;
+      this->mp_Current = this->mp_End;
+    }
+    else
+    {
+      line->end = lf;
+      this->mp_Current = lf + 1;
+    }
+    if ((line->end != line->begin) && (*(line->end - 1) == '\r'))
+      --line->end;
+    return true;
+  };
+  
+  /**
+   * Convenient method to extract the next line as a string.
+   */
+  bool text_file_p::getline(std::string& line)
+  {
+    text_range_p range;
+    if (!this->getline(&range))
+      return false;
+    line.assign(range.begin, range.end);
+    return true;
+  };
+  
+  /**
+   * Extracts the next token separated by whitespaces (including the end of lines).
+   * Returns false if there is no more token.
+   */
+  bool text_file_p::gettoken(text_range_p* token)
+  {
+    text_range_p remaining(this->mp_Current, this->mp_End);
+    bool found = text_next_token_p(&remaining, token);
+    this->mp_Current = remaining.begin;
+    return found;
+  };
+  
+  /**
+   * Extracts from @a line the characters until the separator @a sep and removes them (and the separator) from @a line.
+   * Returns false if @a line was empty.
+   */
+  bool text_next_field_p(text_range_p* line, char sep, text_range_p* field)
+  {
+    if (line->empty())
+      return false;
+    const char* s = static_cast<const char*>(memchr(line->begin, sep, line->size()));
+    field->begin = line->begin;
+    if (s == 0)
+    {
+      field->end = line->end;
+      line->begin = line->end;
+    }
+    else
+    {
+      field->end = s;
+      line->begin = s + 1;
+    }
+    return true;
+  };
+  
+  /**
+   * Extracts from @a line the next token separated by whitespaces and removes it from @a line.
+   * The character following the token is not removed.
+   * Returns false if there is no more token.
+   */
+  bool text_next_token_p(text_range_p* line, text_range_p* token)
+  {
+    const char* c = line->begin;
+    while ((c != line->end) && _btk_text_is_space(*c))
+      ++c;
+    token->begin = c;
+    while ((c != line->end) && !_btk_text_is_space(*c))
+      ++c;
+    token->end = c;
+    line->begin = c;
+    return !token->empty();
+  };
+  
+  /**
+   * Returns true if @a range contains only whitespaces.
+   */
+  bool text_is_blank_p(const text_range_p& range)
+  {
+    for (const char* c = range.begin ; c != range.end ; ++c)
+    {
+      if (!_btk_text_is_space(*c))
+        return false;
+    }
+    return true;
+  };
+  
+  /**
+   * Converts the number written at the beginning of the characters [@a begin, @a end) and sets it in @a value.
+   * The leading whitespaces are skipped and the characters following the number are ignored (as the extraction 
+   * operator of the streams). The decimal separator is always the dot, whatever the locale.
+   * Returns the position following the number or 0 if no number was found.
+   *
+   * The common cases (up to 19 significant digits and a power of 10 exactly representable) are computed with one 
+   * multiplication or division which gives the correctly rounded value. The other cases use the classic locale of the streams.
+   */
+  const char* text_to_double_p(const char* begin, const char* end, double* value)
+  {
+    const char* c = begin;
+    while ((c != end) && _btk_text_is_space(*c))
+      ++c;
+    const char* start = c;
+    bool negative = false;
+    if ((c != end) && ((*c == '-') || (*c == '+')))
+    {
+      negative = (*c == '-');
+      ++c;
+    }
+    unsigned long long mantissa = 0ull;
+    int digits = 0, exponent = 0;
+    bool exact = true, found = false;
+    for ( ; (c != end) && _btk_text_is_digit(*c) ; ++c)
+    {
+      found = true;
+      if (digits < 19)
+      {
+        mantissa = mantissa * 10ull + static_cast<unsigned long long>(*c - '0');
+        if (mantissa != 0ull)
+          ++digits;
+      }
+      else
+      {
+        ++exponent;
+        exact &= (*c == '0');
+      }
+    }
+    if ((c != end) && (*c == '.'))
+    {
+      ++c;
+      for ( ; (c != end) && _btk_text_is_digit(*c) ; ++c)
+      {
+        found = true;
+        if (digits < 19)
+        {
+          mantissa = mantissa * 10ull + static_cast<unsigned long long>(*c - '0');
+          if (mantissa != 0ull)
+            ++digits;
+          --exponent;
+        }
+        else
+          exact &= (*c == '0');
+      }
+    }
+    if (!found)
+      return 0;
+    if ((c != end) && ((*c == 'e') || (*c == 'E')))
+    {
+      const char* e = c + 1;
+      bool negativeExponent = false;
+      if ((e != end) && ((*e == '-') || (*e == '+')))
+      {
+        negativeExponent = (*e == '-');
+        ++e;
+      }
+      if ((e != end) && _btk_text_is_digit(*e))
+      {
+        int exp = 0;
+        for ( ; (e != end) && _btk_text_is_digit(*e) ; ++e)
+        {
+          if (exp < 100000)
+            exp = exp * 10 + (*e - '0');
+        }
+        exponent += negativeExponent ? -exp : exp;
+        c = e;
+      }
+    }
+    if (exact && (mantissa <= (1ull << 53)) && (exponent >= -22) && (exponent <= 22))
+    {
+      double v = static_cast<double>(mantissa);
+      if (exponent < 0)
+        v /= _btk_text_pow10[-exponent];
+      else
+        v *= _btk_text_pow10[exponent];
+      *value = negative ? -v : v;
+    }
+    else
+    {
+      std::istringstream iss(std::string(start, c));
+      iss.imbue(std::locale::classic());
+      double v = 0.0;
+      iss >> v;
+      *value = v;
+    }
+    return c;
+  };
+  
+  // Writes the digits of @a value before @a end and returns the position of the first digit.
+  static char* _btk_text_format_uint(unsigned long long value, char* end)
+  {
+    do
+    {
+      *--end = static_cast<char>('0' + (value % 10ull));
+      value /= 10ull;
+    }
+    while (value != 0ull);
+    return end;
+  };
+  
+  static inline bool _btk_text_is_negative(double value)
+  {
+    return (value < 0.0) || ((value == 0.0) && (1.0 / value < 0.0)); // Negative zero
+  };
+  
+  // Rounds @a scaled to the nearest integer. Returns false if the computed value is too close to a tie
+  // to know in which direction the exact value has to be rounded.
+  static inline bool _btk_text_round(double scaled, unsigned long long* rounded)
+  {
+    double integer = std::floor(scaled);
+    double frac = scaled - integer;
+    if (std::fabs(frac - 0.5) <= scaled * 4.5e-16)
+      return false;
+    *rounded = static_cast<unsigned long long>(integer) + ((frac > 0.5) ? 1ull : 0ull);
+    return true;
+  };
+  
+  // Uses the streams (as done before the fast formatting) for the cases not managed by it.
+  static void _btk_text_append_stream(std::string* out, double value, int precision, bool fixed)
+  {
+    std::ostringstream oss;
+    oss.imbue(std::locale::classic());
+    if (fixed)
+      oss.setf(std::ios::fixed, std::ios::floatfield);
+    oss.precision(precision);
+    oss << value;
+    out->append(oss.str());
+  };
+  
+  /**
+   * @class text_output_p btkTextFileStream_p.h
+   * @brief Text file written by large chunks.
+   *
+   * The content is accumulated in a buffer of 1 MB before to be written in the file.
+   * The formatting of the numbers is done by the functions text_append_int_p(), text_append_fixed_p() 
+   * and text_append_general_p(), and the numerical tables are written by the function text_write_rows_p().
+   */
+  
+  /**
+   * Constructor.
+   */
+  text_output_p::text_output_p()
+  : m_Stream(), m_Buffer()
+  {};
+  
+  /**
+   * @fn text_output_p::~text_output_p()
+   * Destructor. Write the remaining content and close the file.
+   */
+  
+  /**
+   * Open (and truncate) the file @a filename.
+   * Returns false if the file cannot be opened.
+   */
+  bool text_output_p::open(const std::string& filename)
+  {
+    if (this->m_Stream.is_open())
+      return false;
+    this->m_Stream.open(filename.c_str());
+    if (!this->m_Stream.is_open())
+      return false;
+    this->m_Buffer.reserve(_btk_text_output_chunk + _btk_text_output_chunk / 4);
+    return true;
+  };
+  
+  /**
+   * Write the remaining content and close the file.
+   * Returns false if an error occurred during the writing.
+   */
+  bool text_output_p::close()
+  {
+    if (!this->m_Stream.is_open())
+      return true;
+    this->flush();
+    bool ok = !this->m_Stream.fail();
+    this->m_Stream.close();
+    std::string().swap(this->m_Buffer);
+    return ok && !this->m_Stream.fail();
+  };
+  
+  /**
+   * Append the characters [@a s, @a s + @a n) to the file.
+   */
+  void text_output_p::write(const char* s, size_t n)
+  {
+    if (n >= _btk_text_output_chunk)
+    {
+      this->flush();
+      this->m_Stream.write(s, n);
+      return;
+    }
+    this->m_Buffer.append(s, n);
+    if (this->m_Buffer.size() >= _btk_text_output_chunk)
+      this->flush();
+  };
+  
+  void text_output_p::flush()
+  {
+    if (!this->m_Buffer.empty())
+    {
+      this->m_Stream.write(this->m_Buffer.data(), this->m_Buffer.size());
+      this->m_Buffer.clear();
+    }
+  };
+  
+  /**
+   * Append the integer @a value to @a out.
+   */
+  void text_append_int_p(std::string* out, long value)
+  {
+    char buffer[24];
+    char* end = buffer + sizeof(buffer);
+    unsigned long long v = (value < 0) ? (0ull - static_cast<unsigned long long>(value)) : static_cast<unsigned long long>(value);
+    char* begin = _btk_text_format_uint(v, end);
+    if (value < 0)
+      *--begin = '-';
+    out->append(begin, end);
+  };
+  
+  /**
+   * Append @a value written with @a precision digits after the decimal point to @a out.
+   * The result is the same than the one given by a stream using the fixed notation (std::ios::fixed), with the classic locale.
+   */
+  void text_append_fixed_p(std::string* out, double value, int precision)
+  {
+    double a = std::fabs(value);
+    unsigned long long rounded = 0ull;
+    // The rounded value must be exactly computed with a 64-bit integer.
+    if ((precision < 0) || (precision > 15) || !(a < 1e17 / _btk_text_pow10[precision])
+        || !_btk_text_round(a * _btk_text_pow10[precision], &rounded))
+    {
+      _btk_text_append_stream(out, value, precision, true);
+      return;
+    }
+    char buffer[48];
+    char* end = buffer + sizeof(buffer);
+    char* begin = end;
+    if (precision > 0)
+    {
+      unsigned long long frac = rounded % _btk_text_ipow10[precision];
+      rounded /= _btk_text_ipow10[precision];
+      for (int i = 0 ; i < precision ; ++i)
+      {
+        *--begin = static_cast<char>('0' + (frac % 10ull));
+        frac /= 10ull;
+      }
+      *--begin = '.';
+    }
+    begin = _btk_text_format_uint(rounded, begin);
+    if (_btk_text_is_negative(value))
+      *--begin = '-';
+    out->append(begin, end);
+  };
+  
+  /**
+   * Append @a value written with @a precision significant digits to @a out.
+   * The result is the same than the one given by a stream using the default notation, with the classic locale 
+   * (the precision of 6 digits corresponds to the default precision of the streams).
+   */
+  void text_append_general_p(std::string* out, double value, int precision)
+  {
+    if (precision == 0)
+      precision = 1;
+    double a = std::fabs(value);
+    if (a == 0.0)
+    {
+      out->append(_btk_text_is_negative(value) ? "-0" : "0");
+      return;
+    }
+    // Only the common values are managed. The others use the streams.
+    if ((precision < 0) || (precision > 17) || !(a >= 1e-4) || !(a < 1e15))
+    {
+      _btk_text_append_stream(out, value, precision, false);
+      return;
+    }
+    int exponent = static_cast<int>(std::floor(std::log10(a)));
+    int s = precision - 1 - exponent;
+    double scaled = (s >= 0) ? a * _btk_text_pow10[s] : a / _btk_text_pow10[-s];
+    if (scaled < _btk_text_pow10[precision - 1]) // Wrong estimation of the exponent
+    {
+      --exponent; ++s;
+      scaled = (s >= 0) ? a * _btk_text_pow10[s] : a / _btk_text_pow10[-s];
+    }
+    else if (scaled >= _btk_text_pow10[precision])
+    {
+      ++exponent; --s;
+      scaled = (s >= 0) ? a * _btk_text_pow10[s] : a / _btk_text_pow10[-s];
+    }
+    unsigned long long rounded = 0ull;
+    if ((s > 22) || (s < -22) || !_btk_text_round(scaled, &rounded))
+    {
+      _btk_text_append_stream(out, value, precision, false);
+      return;
+    }
+    if (rounded >= _btk_text_ipow10[precision]) // 9.999995 -> 10.0000
+    {
+      rounded /= 10ull;
+      ++exponent;
+    }
+    // Significant digits
+    char digits[24];
+    char* dend = digits + sizeof(digits);
+    char* dbegin = _btk_text_format_uint(rounded, dend);
+    while ((dend - dbegin) < precision) // Only if the estimation of the exponent was wrong twice.
+      *--dbegin = '0';
+    int num = precision;
+    while ((num > 1) && (dbegin[num - 1] == '0')) // Trailing zeros are removed
+      --num;
+    char buffer[48];
+    char* c = buffer;
+    if (_btk_text_is_negative(value))
+      *c++ = '-';
+    if ((exponent < precision) && (exponent >= -4))
+    {
+      if (exponent >= 0)
+      {
+        for (int i = 0 ; i <= exponent ; ++i)
+          *c++ = (i < num) ? dbegin[i] : '0';
+        if (num > exponent + 1)
+        {
+          *c++ = '.';
+          for (int i = exponent + 1 ; i < num ; ++i)
+            *c++ = dbegin[i];
+        }
+      }
+      else
+      {
+        *c++ = '0';
+        *c++ = '.';
+        for (int i = 0 ; i < -exponent - 1 ; ++i)
+          *c++ = '0';
+        for (int i = 0 ; i < num ; ++i)
+          *c++ = dbegin[i];
+      }
+    }
+    else // Scientific notation
+    {
+      *c++ = dbegin[0];
+      if (num > 1)
+      {
+        *c++ = '.';
+        for (int i = 1 ; i < num ; ++i)
+          *c++ = dbegin[i];
+      }
+      *c++ = 'e';
+      *c++ = (exponent < 0) ? '-' : '+';
+      int e = (exponent < 0) ? -exponent : exponent;
+      if (e < 10)
+        *c++ = '0';
+      char exp[8];
+      char* eend = exp + sizeof(exp);
+      char* ebegin = _btk_text_format_uint(static_cast<unsigned long long>(e), eend);
+      while (ebegin != eend)
+        *c++ = *ebegin++;
+    }
+    out->append(buffer, c);
+  };
+  
+  /**
+   * @class text_row_formatter_p btkTextFileStream_p.h
+   * @brief Interface to format the rows of a numerical table written by the function text_write_rows_p().
+   *
+   * The method format() must be safe to be called concurrently for different rows.
+   */
+  
+  class text_write_rows_task_p : public parallel_task_p
+  {
+  public:
+    text_write_rows_task_p(const text_row_formatter_p* formatter, int rowNumber, std::vector<std::string>* blocks)
+    : mp_Formatter(formatter), mp_Blocks(blocks)
+    {
+      this->m_RowNumber = rowNumber;
+      this->m_First = 0;
+    };
+    void SetFirstBlock(int idx) {this->m_First = idx;};
+    virtual void Run(int idx)
+    {
+      std::string* block = &((*this->mp_Blocks)[idx]);
+      block->clear();
+      int begin = (this->m_First + idx) * _btk_text_rows_per_block;
+      int end = std::min(begin + _btk_text_rows_per_block, this->m_RowNumber);
+      for (int i = begin ; i < end ; ++i)
+        this->mp_Formatter->format(block, i);
+    };
+  private:
+    const text_row_formatter_p* mp_Formatter;
+    std::vector<std::string>* mp_Blocks;
+    int m_RowNumber;
+    int m_First;
+  };
+  
+  /**
+   * Write the @a rowNumber rows of a numerical table in @a output. Each row is formatted by @a formatter.
+   * The rows are formatted by blocks of 512 rows, which are dispatched between @a threadNumber threads and then written in order.
+   * If @a threadNumber is lower or equal to 0, then the number of processors is used.
+   * Returns false if the formatting of a row thrown an exception.
+   */
+  bool text_write_rows_p(text_output_p* output, int rowNumber, const text_row_formatter_p* formatter, int threadNumber)
+  {
+    if (rowNumber <= 0)
+      return true;
+    if (threadNumber <= 0)
+      threadNumber = thread_p::GetHardwareConcurrency();
+    int blockNumber = (rowNumber + _btk_text_rows_per_block - 1) / _btk_text_rows_per_block;
+    if ((threadNumber <= 1) || (blockNumber == 1))
+    {
+      std::string block;
+      block.reserve(_btk_text_output_chunk / 4);
+      try
+      {
+        for (int i = 0 ; i < rowNumber ; ++i)
+        {
+          formatter->format(&block, i);
+          if ((i % _btk_text_rows_per_block) == (_btk_text_rows_per_block - 1))
+          {
+            output->write(block);
+            block.clear();
+          }
+        }
+      }
+      catch (...)
+      {
+        return false;
+      }
+      output->write(block);
+      return true;
+    }
+    // The blocks are formatted by groups to limit the memory used.
+    int groupSize = std::min(blockNumber, threadNumber * 4);
+    std::vector<std::string> blocks(groupSize);
+    text_write_rows_task_p task(formatter, rowNumber, &blocks);
+    for (int first = 0 ; first < blockNumber ; first += groupSize)
+    {
+      int num = std::min(groupSize, blockNumber - first);
+      task.SetFirstBlock(first);
+      if (!parallel_for_p(num, &task, threadNumber))
+        return false;
+      for (int i = 0 ; i < num ; ++i)
+        output->write(blocks[i]);
+    }
+    return true;
+  };
+};
@@ -0,0 +1,133 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __btkTextFileStream_p_h
+#define __btkTextFileStream_p_h
+
+#include "btkBinaryFileStream.h" // mmfilebuf
+
+#include <string>
+#include <vector>
+#include <fstream>
+
+namespace btk
+{
+  // Range of characters inside the buffer of a text_file_p object (nothing is copied).
+  struct text_range_p
+  {
+    text_range_p() : begin(0), end(0) {};
+    text_range_p(const char* b, const char* e) : begin(b), end(e) {};
+    bool empty() const {return this->begin == this->end;};
+    size_t size() const {return static_cast<size_t>(this->end - this->begin);};
+    std::string str() const {return std::string(this->begin, this->end);};
+    const char* begin;
+    const char* end;
+  };
+  
+  class text_file_p
+  {
+  public:
+    BTK_IO_EXPORT text_file_p();
+    ~text_file_p() {this->close();};
+    
+    BTK_IO_EXPORT bool open(const std::string& filename);
+    bool is_open() const {return this->m_Opened;};
+    BTK_IO_EXPORT void close();
+    
+    size_t size() const {return static_cast<size_t>(this->mp_End - this->mp_Begin);};
+    bool eof() const {return this->mp_Current == this->mp_End;};
+    
+    BTK_IO_EXPORT bool getline(text_range_p* line);
+    BTK_IO_EXPORT bool getline(std::string& line);
+    BTK_IO_EXPORT bool gettoken(text_range_p* token);
+    
+  private:
+    text_file_p(const text_file_p& ); // Not implemented.
+    text_file_p& operator=(const text_file_p& ); // Not implemented.
+    
+#if !defined(BTK_NO_MEMORY_MAPPED_FILESTREAM)
+    mmfilebuf m_Map;
+#endif
+    std::vector<char> m_Buffer;
+    const char* mp_Begin;
+    const char* mp_Current;
+    const char* mp_End;
+    bool m_Opened;
+  };
+  
+  BTK_IO_EXPORT bool text_next_field_p(text_range_p* line, char sep, text_range_p* field);
+  BTK_IO_EXPORT bool text_next_token_p(text_range_p* line, text_range_p* token);
+  BTK_IO_EXPORT bool text_is_blank_p(const text_range_p& range);
+  BTK_IO_EXPORT const char* text_to_double_p(const char* begin, const char* end, double* value);
+  
+  class text_output_p
+  {
+  public:
+    BTK_IO_EXPORT text_output_p();
+    ~text_output_p() {this->close();};
+    
+    BTK_IO_EXPORT bool open(const std::string& filename);
+    bool is_open() const {return this->m_Stream.is_open();};
+    BTK_IO_EXPORT bool close();
+    bool fail() const {return this->m_Stream.fail();};
+    
+    BTK_IO_EXPORT void write(const char* s, size_t n);
+    void write(const std::string& s) {this->write(s.data(), s.length());};
+    
+  private:
+    text_output_p(const text_output_p& ); // Not implemented.
+    text_output_p& operator=(const text_output_p& ); // Not implemented.
+    
+    void flush();
+    
+    std::ofstream m_Stream;
+    std::string m_Buffer;
+  };
+  
+  BTK_IO_EXPORT void text_append_int_p(std::string* out, long value);
+  BTK_IO_EXPORT void text_append_fixed_p(std::string* out, double value, int precision);
+  BTK_IO_EXPORT void text_append_general_p(std::string* out, double value, int precision = 6);
+  
+  class text_row_formatter_p
+  {
+  public:
+    virtual ~text_row_formatter_p() {};
+    virtual void format(std::string* out, int row) const = 0;
+  };
+  
+  BTK_IO_EXPORT bool text_write_rows_p(text_output_p* output, int rowNumber, const text_row_formatter_p* formatter, int threadNumber = 0);
+};
+
+#endif // __btkTextFileStream_p_h
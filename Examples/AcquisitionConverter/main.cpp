@@ -35,55 +35,416 @@
 
 #include <btkAcquisitionFileReader.h>
 #include <btkAcquisitionFileWriter.h>
+#include <btkAcquisitionFileIOFactory.h>
+#include <btkTRCFileIO.h>
+#include <btkThread_p.h>
+#include <btkCriticalSection_p.h>
 #include <btkMacro.h> // btkStripPathMacro
 
 #include <iostream> // std::cerr
+#include <fstream>
 #include <cstdio> // Include std::remove for Linux
+#include <cstdlib> // std::atoi
+#include <map>
+#include <set>
+#include <vector>
+#include <algorithm>
+#include <sys/stat.h>
 
-int main(int argc, char *argv[])
+#if defined(_WIN32)
+  #ifndef WIN32_LEAN_AND_MEAN
+    #define WIN32_LEAN_AND_MEAN
+  #endif
+  #include <windows.h>
+  static const char PathSeparator = '\\';
+#else
+  #include <sys/time.h>
+  #include <glob.h>
+  static const char PathSeparator = '/';
+#endif
+
+// Wall clock time in seconds.
+static double Now()
+{
+#if defined(_WIN32)
+  LARGE_INTEGER frequency, counter;
+  QueryPerformanceFrequency(&frequency);
+  QueryPerformanceCounter(&counter);
+  return static_cast<double>(counter.QuadPart) / static_cast<double>(frequency.QuadPart);
+#else
+  struct timeval tv;
+  gettimeofday(&tv, 0);
+  return static_cast<double>(tv.tv_sec) + static_cast<double>(tv.tv_usec) * 1.0e-6;
+#endif
+};
+
+static double FileSize(const std::string& filename)
+{
+  struct stat info;
+  if (stat(filename.c_str(), &info) != 0)
+    return 0.0;
+  return static_cast<double>(info.st_size);
+};
+
+static std::string::size_type FilenamePosition(const std::string& filename)
+{
+  std::string::size_type pos = filename.find_last_of("/\\");
+  return (pos == std::string::npos) ? 0 : pos + 1;
+};
+
+static std::string Extension(const std::string& filename)
 {
-  if (argc != 3)
+  std::string::size_type pos = filename.find_last_of('.');
+  if ((pos == std::string::npos) || (pos < FilenamePosition(filename)))
+    return "";
+  std::string ext = filename.substr(pos + 1);
+  std::transform(ext.begin(), ext.end(), ext.begin(), tolower);
+  return ext;
+};
+
+// Appends the files matching the given pattern ('*' and '?' wildcards). A pattern without wildcard is appended as is.
+static void ExpandPattern(const std::string& pattern, std::vector<std::string>& files)
+{
+  if (pattern.find_first_of("*?") == std::string::npos)
   {
-    std::cerr << "No enough input arguements.\n\n"
-              << "Usage: " << btkStripPathMacro(argv[0]) << " input output\n\n"
-              << "Convert an acquisition file into another one, whatever the formats used."
-              << std::endl;
-    return -1;
+    files.push_back(pattern);
+    return;
+  }
+#if defined(_WIN32)
+  std::string dir = pattern.substr(0, FilenamePosition(pattern));
+  WIN32_FIND_DATAA data;
+  HANDLE h = FindFirstFileA(pattern.c_str(), &data);
+  if (h == INVALID_HANDLE_VALUE)
+    return;
+  std::vector<std::string> matches;
+  do
+  {
+    if ((data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) == 0)
+      matches.push_back(dir + data.cFileName);
+  }
+  while (FindNextFileA(h, &data));
+  FindClose(h);
+  std::sort(matches.begin(), matches.end());
+  files.insert(files.end(), matches.begin(), matches.end());
+#else
+  glob_t g;
+  if (glob(pattern.c_str(), 0, 0, &g) == 0)
+  {
+    for (size_t i = 0 ; i < g.gl_pathc ; ++i)
+      files.push_back(g.gl_pathv[i]);
+  }
+  globfree(&g);
+#endif
+};
+
+// Appends the files listed (one per line) in the given file. Each line can be a pattern.
+static bool ReadFileList(const std::string& filename, std::vector<std::string>& files)
+{
+  std::ifstream ifs(filename.c_str());
+  if (!ifs)
+    return false;
+  std::string line;
+  while (std::getline(ifs, line))
+  {
+    std::string::size_type first = line.find_first_not_of(" \t\r");
+    if ((first == std::string::npos) || (line[first] == '#'))
+      continue;
+    std::string::size_type last = line.find_last_not_of(" \t\r");
+    ExpandPattern(line.substr(first, last - first + 1), files);
   }
- 
-  // New instantiation of an acquisition file reader. 
-  btk::AcquisitionFileReader::Pointer reader = btk::AcquisitionFileReader::New();
-  // Set the path of the acquisition to read.
-  reader->SetFilename(argv[1]);
-  // New instamtiation of an acquisition file writer
-  btk::AcquisitionFileWriter::Pointer writer = btk::AcquisitionFileWriter::New();
-  // Set the path of the file to write. The acquisition will be exported in this file.
-  writer->SetFilename(argv[2]);
-  // Link the writer with the reader.
-  writer->SetInput(reader->GetOutput());
+  return true;
+};
 
-  // Manage possible exceptions during the update of the pipeline.
-  try 
+// Converts a list of files with a fixed number of workers. Each worker reads the next file 
+// in a second thread while it writes the current one.
+class BatchConverter : public btk::parallel_task_p
+{
+public:
+  struct Job
+  {
+    std::string Input;
+    std::string Output;
+    bool Succeeded;
+    std::string Message;
+    double ReadTime;
+    double WriteTime;
+    double Size;
+  };
+  
+  // The writers use @a writerThreadNumber threads (0: number of processors) to format the data when it is possible.
+  BatchConverter(std::vector<Job>& jobs, bool verbose, int writerThreadNumber)
+  : m_Jobs(jobs), m_NextLock(), m_ReportLock()
+  {
+    this->m_Next = 0;
+    this->m_Verbose = verbose;
+    this->m_WriterThreadNumber = writerThreadNumber;
+  };
+  
+  virtual void Run(int )
+  {
+    // The IOs are reused while they can read the files with the same extension.
+    ReaderIOs ios;
+    int idx = this->NextJob();
+    if (idx == -1)
+      return;
+    btk::Acquisition::Pointer acq = this->Read(idx, ios);
+    while (idx != -1)
+    {
+      Prefetch prefetch;
+      prefetch.Converter = this;
+      prefetch.IOs = &ios;
+      prefetch.Index = this->NextJob();
+      btk::thread_p thread;
+      bool threaded = false;
+      if (prefetch.Index != -1)
+        threaded = thread.Start(&BatchConverter::RunPrefetch, &prefetch);
+      this->Write(idx, acq);
+      if (threaded)
+        thread.Join();
+      else if (prefetch.Index != -1)
+        BatchConverter::RunPrefetch(&prefetch);
+      idx = prefetch.Index;
+      acq = prefetch.Output;
+    }
+  };
+  
+private:
+  typedef std::map<std::string, btk::AcquisitionFileIO::Pointer> ReaderIOs;
+  
+  struct Prefetch
   {
-    writer->Update();
+    BatchConverter* Converter;
+    ReaderIOs* IOs;
+    int Index;
+    btk::Acquisition::Pointer Output;
+  };
+  
+  static void RunPrefetch(void* data)
+  {
+    Prefetch* prefetch = static_cast<Prefetch*>(data);
+    prefetch->Output = prefetch->Converter->Read(prefetch->Index, *(prefetch->IOs));
+  };
+  
+  int NextJob()
+  {
+    this->m_NextLock.Lock();
+    int idx = (this->m_Next < static_cast<int>(this->m_Jobs.size())) ? this->m_Next++ : -1;
+    this->m_NextLock.Unlock();
+    return idx;
+  };
+  
+  btk::Acquisition::Pointer Read(int idx, ReaderIOs& ios)
+  {
+    Job& job = this->m_Jobs[idx];
+    double start = Now();
+    btk::Acquisition::Pointer acq;
+    try
+    {
+      btk::AcquisitionFileReader::Pointer reader = btk::AcquisitionFileReader::New();
+      std::string ext = Extension(job.Input);
+      ReaderIOs::iterator it = ios.find(ext);
+      if ((it != ios.end()) && it->second->CanReadFile(job.Input))
+        reader->SetAcquisitionIO(it->second);
+      reader->SetFilename(job.Input);
+      reader->Update();
+      ios[ext] = reader->GetAcquisitionIO();
+      acq = reader->GetOutput();
+      job.Succeeded = true;
+    }
+    catch (std::exception& e)
+    {
+      job.Message = e.what();
+    }
+    catch (...)
+    {
+      job.Message = "Unknown exception";
+    }
+    job.ReadTime = Now() - start;
+    job.Size = FileSize(job.Input);
+    return acq;
+  };
+  
+  // The writer IOs are not reused: their internal settings are updated from the written acquisition.
+  void Write(int idx, btk::Acquisition::Pointer acq)
+  {
+    Job& job = this->m_Jobs[idx];
+    if (job.Succeeded)
+    {
+      double start = Now();
+      job.Succeeded = false;
+      try
+      {
+        btk::AcquisitionFileWriter::Pointer writer = btk::AcquisitionFileWriter::New();
+        btk::AcquisitionFileIO::Pointer io = btk::AcquisitionFileIOFactory::CreateAcquisitionIO(job.Output, btk::AcquisitionFileIOFactory::WriteMode);
+        btk::TRCFileIO* trc = dynamic_cast<btk::TRCFileIO*>(io.get());
+        if (trc != 0)
+          trc->SetThreadNumber(this->m_WriterThreadNumber);
+        if (io)
+          writer->SetAcquisitionIO(io);
+        writer->SetFilename(job.Output);
+        writer->SetInput(acq);
+        writer->Update();
+        job.Succeeded = true;
+      }
+      catch (std::exception& e)
+      {
+        job.Message = e.what();
+      }
+      catch (...)
+      {
+        job.Message = "Unknown exception";
+      }
+      job.WriteTime = Now() - start;
+      if (!job.Succeeded)
+        std::remove(job.Output.c_str());
+    }
+    this->Report(job);
+  };
+  
+  void Report(const Job& job)
+  {
+    this->m_ReportLock.Lock();
+    if (!job.Succeeded)
+      std::cerr << "[failed] " << job.Input << ": " << job.Message << std::endl;
+    else if (this->m_Verbose)
+    {
+      double total = job.ReadTime + job.WriteTime;
+      std::cout << "[ok] " << job.Input << " -> " << job.Output
+                << " (read " << job.ReadTime * 1000.0 << " ms, write " << job.WriteTime * 1000.0 << " ms, "
+                << job.Size / 1048576.0 << " MB, " << ((total > 0.0) ? job.Size / 1048576.0 / total : 0.0) << " MB/s)" << std::endl;
+    }
+    this->m_ReportLock.Unlock();
+  };
+  
+  std::vector<Job>& m_Jobs;
+  int m_Next;
+  bool m_Verbose;
+  int m_WriterThreadNumber;
+  btk::critical_section_p m_NextLock;
+  btk::critical_section_p m_ReportLock;
+};
+
+static void PrintUsage(const char* name)
+{
+  std::cerr << "Usage: " << name << " input output\n"
+            << "       " << name << " [options] -t format input1 [input2 ...]\n\n"
+            << "Convert acquisition files into another format, whatever the formats used.\n\n"
+            << "Options:\n"
+            << "  -t format  Extension of the converted files (e.g. c3d, trc)\n"
+            << "  -o dir     Directory of the converted files (default: the directory of each input)\n"
+            << "  -l file    File listing the inputs (one per line)\n"
+            << "  -j num     Number of workers (default: number of cores)\n"
+            << "  -q         Report only the failures\n\n"
+            << "The inputs can contain the wildcards '*' and '?'."
+            << std::endl;
+};
+
+int main(int argc, char *argv[])
+{
+  std::vector<std::string> inputs;
+  std::string format, outputDir, output;
+  int threadNumber = 0;
+  bool verbose = true;
+  for (int i = 1 ; i < argc ; ++i)
+  {
+    std::string arg = argv[i];
+    if ((arg == "-t") || (arg == "-o") || (arg == "-l") || (arg == "-j"))
+    {
+      if (++i >= argc)
+      {
+        std::cerr << "Missing value for the option " << arg << ".\n\n";
+        PrintUsage(btkStripPathMacro(argv[0]));
+        return -1;
+      }
+      if (arg == "-t")
+        format = argv[i];
+      else if (arg == "-o")
+        outputDir = argv[i];
+      else if (arg == "-j")
+        threadNumber = atoi(argv[i]);
+      else if (!ReadFileList(argv[i], inputs))
+      {
+        std::cerr << "Impossible to read the list of files: " << argv[i] << std::endl;
+        return -1;
+      }
+    }
+    else if (arg == "-q")
+      verbose = false;
+    else
+      ExpandPattern(arg, inputs);
   }
-  catch(btk::Exception& e)
+  // Conversion of one file (backward compatibility)
+  if (format.empty() && outputDir.empty() && (inputs.size() == 2))
   {
-    std::cerr << "Exception: " << e.what() << std::endl;
-    std::remove(argv[2]);    
-    return -2;
+    output = inputs.back();
+    inputs.pop_back();
+    verbose = false;
   }
-  catch(std::exception& e)
+  else if (format.empty() || inputs.empty())
   {
-    std::cerr << "Unknown exception: " << e.what() << std::endl;
-    std::remove(argv[2]);    
-    return -3;
+    std::cerr << "No enough input arguements.\n\n";
+    PrintUsage(btkStripPathMacro(argv[0]));
+    return -1;
   }
-  catch(...)
+  
+  std::vector<BatchConverter::Job> jobs(inputs.size());
+  std::set<std::string> outputs;
+  for (size_t i = 0 ; i < inputs.size() ; ++i)
   {
-    std::cerr << "Unknown exception";
-    return -3;
+    BatchConverter::Job& job = jobs[i];
+    job.Input = inputs[i];
+    if (!output.empty())
+      job.Output = output;
+    else
+    {
+      std::string::size_type pos = FilenamePosition(job.Input);
+      std::string name = job.Input.substr(pos);
+      name = name.substr(0, name.find_last_of('.')) + "." + format;
+      if (outputDir.empty())
+        job.Output = job.Input.substr(0, pos) + name;
+      else
+        job.Output = outputDir + ((outputDir[outputDir.length()-1] == PathSeparator) ? "" : std::string(1, PathSeparator)) + name;
+    }
+    job.Succeeded = false;
+    job.ReadTime = 0.0;
+    job.WriteTime = 0.0;
+    job.Size = 0.0;
+    if (job.Output == job.Input)
+    {
+      std::cerr << "The converted file would replace the input: " << job.Input << std::endl;
+      return -1;
+    }
+    // The workers would write the same file.
+    if (!outputs.insert(job.Output).second)
+    {
+      std::cerr << "Several inputs would be converted into the same file: " << job.Output << std::endl;
+      return -1;
+    }
   }
-
-  return 0;
+  
+  // Registers the file formats before the start of the workers.
+  btk::AcquisitionFileIOFactory::GetSupportedReadExtensions();
+  double start = Now();
+  // The workers already use all the processors when several files are converted.
+  BatchConverter converter(jobs, verbose, (jobs.size() > 1) ? 1 : 0);
+  int workerNumber = (threadNumber > 0) ? threadNumber : btk::thread_p::GetHardwareConcurrency();
+  btk::parallel_for_p(std::min(workerNumber, static_cast<int>(jobs.size())), &converter, workerNumber);
+  double elapsed = Now() - start;
+  
+  int failed = 0;
+  double size = 0.0;
+  for (size_t i = 0 ; i < jobs.size() ; ++i)
+  {
+    if (!jobs[i].Succeeded)
+      ++failed;
+    else
+      size += jobs[i].Size;
+  }
+  if (!output.empty())
+    return (failed == 0) ? 0 : -2;
+  std::cout << (jobs.size() - failed) << " file(s) converted, " << failed << " failed in " << elapsed << " s";
+  if (elapsed > 0.0)
+    std::cout << " (" << static_cast<double>(jobs.size() - failed) / elapsed << " files/s, " << size / 1048576.0 / elapsed << " MB/s)";
+  std::cout << std::endl;
+  return (failed == 0) ? 0 : -2;
 };
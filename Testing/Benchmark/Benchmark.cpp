@@ -0,0 +1,761 @@
+#include "SyntheticAcquisition.h"
+
+#include <btkAcquisitionFileReader.h>
+#include <btkAcquisitionFileWriter.h>
+#include <btkC3DFileIO.h>
+#include <btkTRCFileIO.h>
+#include <btkANBFileIO.h>
+#include <btkANCFileIO.h>
+#include <btkForcePlatformsExtractor.h>
+#include <btkGroundReactionWrenchFilter.h>
+#include <btkMergeAcquisitionFilter.h>
+#include <btkSubAcquisitionFilter.h>
+#include <btkAcquisitionUnitConverter.h>
+#include <btkLogger.h>
+#include <btkObjectPool.h>
+#include <btkThread_p.h>
+#include <btkConvert.h>
+#include <btkMacro.h> // btkStripPathMacro
+#include <btkConfigure.h> // BTK_VERSION_STRING
+
+#include <btkEigen/SignalProcessing/FiltFilt.h>
+#include <btkEigen/SignalProcessing/IIRFilterDesign.h>
+#include <btkEigen/Interpolation/Interp1.h>
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cstdio> // std::remove
+#include <cstdlib> // std::atoi, std::atof
+#include <stdexcept> // std::runtime_error
+#include <vector>
+#include <algorithm> // std::max
+#include <sys/stat.h>
+
+#if defined(_WIN32)
+  #ifndef WIN32_LEAN_AND_MEAN
+    #define WIN32_LEAN_AND_MEAN
+  #endif
+  #include <windows.h>
+  static const char PathSeparator = '\\';
+#else
+  #include <sys/time.h>
+  static const char PathSeparator = '/';
+#endif
+
+// Wall clock time in seconds.
+static double Now()
+{
+#if defined(_WIN32)
+  LARGE_INTEGER frequency, counter;
+  QueryPerformanceFrequency(&frequency);
+  QueryPerformanceCounter(&counter);
+  return static_cast<double>(counter.QuadPart) / static_cast<double>(frequency.QuadPart);
+#else
+  struct timeval tv;
+  gettimeofday(&tv, 0);
+  return static_cast<double>(tv.tv_sec) + static_cast<double>(tv.tv_usec) * 1.0e-6;
+#endif
+};
+
+static double FileSize(const std::string& filename)
+{
+  struct stat info;
+  if (stat(filename.c_str(), &info) != 0)
+    return 0.0;
+  return static_cast<double>(info.st_size);
+};
+
+static int CountMetaData(btk::MetaData::ConstPointer md)
+{
+  int num = 0;
+  for (btk::MetaData::ConstIterator it = md->Begin() ; it != md->End() ; ++it)
+    num += 1 + CountMetaData(*it);
+  return num;
+};
+
+/**
+ * Base class of the benchmarks.
+ * SetUp() and TearDown() are not timed. Run() is executed until the minimum duration is reached.
+ * The throughput is computed from the number of items and bytes processed by each run.
+ */
+class Benchmark
+{
+public:
+  Benchmark(const std::string& name, const std::string& unit)
+  : m_Name(name), m_Unit(unit)
+  {
+    this->m_ItemNumber = 0.0;
+    this->m_ByteNumber = 0.0;
+  };
+  virtual ~Benchmark() {};
+
+  const std::string& GetName() const {return this->m_Name;};
+  const std::string& GetUnit() const {return this->m_Unit;};
+  double GetItemNumber() const {return this->m_ItemNumber;};
+  double GetByteNumber() const {return this->m_ByteNumber;};
+
+  virtual void SetUp() {};
+  virtual void Run() = 0;
+  virtual void TearDown() {};
+
+protected:
+  std::string m_Name;
+  std::string m_Unit;
+  double m_ItemNumber;
+  double m_ByteNumber;
+};
+
+/**
+ * Description of a file format and of its storage options.
+ */
+struct FileFormat
+{
+  FileFormat(const std::string& name, const std::string& ext, btk::AcquisitionFileIO::StorageFormat s = btk::AcquisitionFileIO::StorageNotApplicable, btk::AcquisitionFileIO::ByteOrder b = btk::AcquisitionFileIO::OrderNotApplicable)
+  : Name(name), Extension(ext), Storage(s), Order(b)
+  {};
+
+  btk::AcquisitionFileIO::Pointer CreateIO() const
+  {
+    btk::AcquisitionFileIO::Pointer io;
+    if (this->Extension == "c3d")
+      io = btk::C3DFileIO::New();
+    else if (this->Extension == "trc")
+      io = btk::TRCFileIO::New();
+    else if (this->Extension == "anb")
+      io = btk::ANBFileIO::New();
+    else if (this->Extension == "anc")
+      io = btk::ANCFileIO::New();
+    if (this->Storage != btk::AcquisitionFileIO::StorageNotApplicable)
+      io->SetStorageFormat(this->Storage);
+    if (this->Order != btk::AcquisitionFileIO::OrderNotApplicable)
+      io->SetByteOrder(this->Order);
+    return io;
+  };
+
+  std::string Name;
+  std::string Extension;
+  btk::AcquisitionFileIO::StorageFormat Storage;
+  btk::AcquisitionFileIO::ByteOrder Order;
+};
+
+static void WriteAcquisition(btk::Acquisition::Pointer acq, const FileFormat& format, const std::string& filename)
+{
+  btk::AcquisitionFileWriter::Pointer writer = btk::AcquisitionFileWriter::New();
+  writer->SetAcquisitionIO(format.CreateIO());
+  writer->SetInput(acq);
+  writer->SetFilename(filename);
+  writer->Update();
+};
+
+class FileWriteBenchmark : public Benchmark
+{
+public:
+  FileWriteBenchmark(btk::Acquisition::Pointer acq, const FileFormat& format, const std::string& path)
+  : Benchmark("write/" + format.Name, "frames"), m_Acquisition(acq), m_Format(format)
+  {
+    this->m_Filename = path + "btk_benchmark_write_" + format.Name + "." + format.Extension;
+  };
+  virtual void SetUp() {this->m_ItemNumber = this->m_Acquisition->GetPointFrameNumber();};
+  virtual void Run()
+  {
+    WriteAcquisition(this->m_Acquisition, this->m_Format, this->m_Filename);
+    this->m_ByteNumber = FileSize(this->m_Filename);
+  };
+  virtual void TearDown() {std::remove(this->m_Filename.c_str());};
+private:
+  btk::Acquisition::Pointer m_Acquisition;
+  FileFormat m_Format;
+  std::string m_Filename;
+};
+
+class FileReadBenchmark : public Benchmark
+{
+public:
+  FileReadBenchmark(btk::Acquisition::Pointer acq, const FileFormat& format, const std::string& path)
+  : Benchmark("read/" + format.Name, "frames"), m_Acquisition(acq), m_Format(format)
+  {
+    this->m_Filename = path + "btk_benchmark_read_" + format.Name + "." + format.Extension;
+  };
+  virtual void SetUp()
+  {
+    WriteAcquisition(this->m_Acquisition, this->m_Format, this->m_Filename);
+    this->m_ItemNumber = this->m_Acquisition->GetPointFrameNumber();
+    this->m_ByteNumber = FileSize(this->m_Filename);
+  };
+  virtual void Run()
+  {
+    btk::AcquisitionFileReader::Pointer reader = btk::AcquisitionFileReader::New();
+    reader->SetFilename(this->m_Filename);
+    reader->Update();
+  };
+  virtual void TearDown() {std::remove(this->m_Filename.c_str());};
+private:
+  btk::Acquisition::Pointer m_Acquisition;
+  FileFormat m_Format;
+  std::string m_Filename;
+};
+
+/**
+ * Reads a C3D file containing only one frame but a large parameter section.
+ */
+class MetaDataBenchmark : public Benchmark
+{
+public:
+  MetaDataBenchmark(const SyntheticAcquisitionParameters& parameters, const std::string& path)
+  : Benchmark("metadata/c3d", "entries"), m_Parameters(parameters)
+  {
+    this->m_Filename = path + "btk_benchmark_metadata.c3d";
+    this->m_Parameters.FrameNumber = 1;
+  };
+  virtual void SetUp()
+  {
+    WriteAcquisition(GenerateSyntheticAcquisition(this->m_Parameters), FileFormat("c3d", "c3d"), this->m_Filename);
+    btk::AcquisitionFileReader::Pointer reader = btk::AcquisitionFileReader::New();
+    reader->SetFilename(this->m_Filename);
+    reader->Update();
+    this->m_ItemNumber = CountMetaData(reader->GetOutput()->GetMetaData());
+    this->m_ByteNumber = FileSize(this->m_Filename);
+  };
+  virtual void Run()
+  {
+    btk::AcquisitionFileReader::Pointer reader = btk::AcquisitionFileReader::New();
+    reader->SetFilename(this->m_Filename);
+    reader->Update();
+  };
+  virtual void TearDown() {std::remove(this->m_Filename.c_str());};
+private:
+  SyntheticAcquisitionParameters m_Parameters;
+  std::string m_Filename;
+};
+
+// The pipelines are built for each run, otherwise the filters would not be updated.
+class ForcePlatformChainBenchmark : public Benchmark
+{
+public:
+  ForcePlatformChainBenchmark(btk::Acquisition::Pointer acq)
+  : Benchmark("filter/force_platform_chain", "samples"), m_Acquisition(acq)
+  {};
+  virtual void SetUp()
+  {
+    btk::ForcePlatformsExtractor::Pointer extractor = btk::ForcePlatformsExtractor::New();
+    extractor->SetInput(this->m_Acquisition);
+    extractor->Update();
+    this->m_ItemNumber = 0.0;
+    for (btk::ForcePlatformCollection::ConstIterator it = extractor->GetOutput()->Begin() ; it != extractor->GetOutput()->End() ; ++it)
+      this->m_ItemNumber += static_cast<double>((*it)->GetChannelNumber() * this->m_Acquisition->GetAnalogFrameNumber());
+  };
+  virtual void Run()
+  {
+    btk::ForcePlatformsExtractor::Pointer extractor = btk::ForcePlatformsExtractor::New();
+    extractor->SetInput(this->m_Acquisition);
+    btk::GroundReactionWrenchFilter::Pointer grwf = btk::GroundReactionWrenchFilter::New();
+    grwf->SetInput(extractor->GetOutput());
+    grwf->Update();
+  };
+private:
+  btk::Acquisition::Pointer m_Acquisition;
+};
+
+class MergeBenchmark : public Benchmark
+{
+public:
+  MergeBenchmark(btk::Acquisition::Pointer acq)
+  : Benchmark("filter/merge", "frames"), m_Acquisition(acq)
+  {};
+  virtual void SetUp()
+  {
+    // The second acquisition uses other labels to be concatenated with the first one.
+    this->m_Other = this->m_Acquisition->Clone();
+    for (btk::Acquisition::PointIterator it = this->m_Other->BeginPoint() ; it != this->m_Other->EndPoint() ; ++it)
+      (*it)->SetLabel((*it)->GetLabel() + "_B");
+    for (btk::Acquisition::AnalogIterator it = this->m_Other->BeginAnalog() ; it != this->m_Other->EndAnalog() ; ++it)
+      (*it)->SetLabel((*it)->GetLabel() + "_B");
+    this->m_ItemNumber = this->m_Acquisition->GetPointFrameNumber();
+  };
+  virtual void Run()
+  {
+    btk::MergeAcquisitionFilter::Pointer merger = btk::MergeAcquisitionFilter::New();
+    merger->SetInput(0, this->m_Acquisition);
+    merger->SetInput(1, this->m_Other);
+    merger->Update();
+  };
+  virtual void TearDown() {this->m_Other.reset();};
+private:
+  btk::Acquisition::Pointer m_Acquisition;
+  btk::Acquisition::Pointer m_Other;
+};
+
+class SubAcquisitionBenchmark : public Benchmark
+{
+public:
+  SubAcquisitionBenchmark(btk::Acquisition::Pointer acq)
+  : Benchmark("filter/sub_acquisition", "frames"), m_Acquisition(acq)
+  {};
+  virtual void SetUp()
+  {
+    int num = this->m_Acquisition->GetPointFrameNumber();
+    this->m_Bounds[0] = num / 4;
+    this->m_Bounds[1] = (3 * num) / 4;
+    this->m_ItemNumber = this->m_Bounds[1] - this->m_Bounds[0] + 1;
+  };
+  virtual void Run()
+  {
+    btk::SubAcquisitionFilter::Pointer sub = btk::SubAcquisitionFilter::New();
+    sub->SetInput(this->m_Acquisition);
+    sub->SetFramesIndex(this->m_Bounds[0], this->m_Bounds[1]);
+    sub->Update();
+  };
+private:
+  btk::Acquisition::Pointer m_Acquisition;
+  int m_Bounds[2];
+};
+
+class UnitConverterBenchmark : public Benchmark
+{
+public:
+  UnitConverterBenchmark(btk::Acquisition::Pointer acq)
+  : Benchmark("filter/unit_converter", "frames"), m_Acquisition(acq)
+  {};
+  virtual void SetUp() {this->m_ItemNumber = this->m_Acquisition->GetPointFrameNumber();};
+  virtual void Run()
+  {
+    btk::AcquisitionUnitConverter::Pointer converter = btk::AcquisitionUnitConverter::New();
+    converter->SetInput(this->m_Acquisition);
+    converter->SetUnit(btk::AcquisitionUnitConverter::Length, "m");
+    converter->SetUnit(btk::AcquisitionUnitConverter::Moment, "Nm");
+    converter->Update();
+  };
+private:
+  btk::Acquisition::Pointer m_Acquisition;
+};
+
+/**
+ * Zero-phase 4th order Butterworth low pass filter applied on all the analog channels.
+ */
+class FiltFiltBenchmark : public Benchmark
+{
+public:
+  FiltFiltBenchmark(btk::Acquisition::Pointer acq)
+  : Benchmark("eigen/filtfilt", "samples"), m_Acquisition(acq)
+  {};
+  virtual void SetUp()
+  {
+    this->m_Data.resize(this->m_Acquisition->GetAnalogFrameNumber(), this->m_Acquisition->GetAnalogNumber());
+    int inc = 0;
+    for (btk::Acquisition::AnalogConstIterator it = this->m_Acquisition->BeginAnalog() ; it != this->m_Acquisition->EndAnalog() ; ++it)
+      this->m_Data.col(inc++) = (*it)->GetValues();
+    btkEigen::butter(&this->m_B, &this->m_A, 4, 0.1);
+    this->m_ItemNumber = static_cast<double>(this->m_Data.size());
+  };
+  virtual void Run()
+  {
+    this->m_Result = btkEigen::filtfilt(this->m_B, this->m_A, this->m_Data);
+  };
+  virtual void TearDown() {this->m_Data.resize(0,0); this->m_Result.resize(0,0);};
+private:
+  btk::Acquisition::Pointer m_Acquisition;
+  Eigen::Matrix<double, Eigen::Dynamic, 1> m_B, m_A;
+  Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic> m_Data, m_Result;
+};
+
+/**
+ * Markers' coordinates resampled at twice the point frequency.
+ */
+class Interp1Benchmark : public Benchmark
+{
+public:
+  typedef enum {Linear, Pchip, Spline} Method;
+
+  Interp1Benchmark(btk::Acquisition::Pointer acq, Method m)
+  : Benchmark(std::string("eigen/interp1_") + ((m == Linear) ? "linear" : ((m == Pchip) ? "pchip" : "spline")), "samples"), m_Acquisition(acq), m_Method(m)
+  {};
+  virtual void SetUp()
+  {
+    const int num = this->m_Acquisition->GetPointFrameNumber();
+    this->m_X.resize(num);
+    for (int i = 0 ; i < num ; ++i)
+      this->m_X.coeffRef(i) = static_cast<double>(i);
+    this->m_Xi.resize(2 * num - 1);
+    for (int i = 0 ; i < this->m_Xi.rows() ; ++i)
+      this->m_Xi.coeffRef(i) = 0.5 * static_cast<double>(i);
+    this->m_Y.resize(num, 3 * this->m_Acquisition->GetPointNumber());
+    int inc = 0;
+    for (btk::Acquisition::PointConstIterator it = this->m_Acquisition->BeginPoint() ; it != this->m_Acquisition->EndPoint() ; ++it)
+    {
+      this->m_Y.middleCols(inc, 3) = (*it)->GetValues();
+      inc += 3;
+    }
+    this->m_ItemNumber = static_cast<double>(this->m_Xi.rows() * this->m_Y.cols());
+  };
+  virtual void Run()
+  {
+    Eigen::Matrix<double, Eigen::Dynamic, 1> y, yi;
+    for (int i = 0 ; i < this->m_Y.cols() ; ++i)
+    {
+      y = this->m_Y.col(i);
+      if (this->m_Method == Linear)
+        btkEigen::interp1().linear(&yi, this->m_X, y, this->m_Xi);
+      else if (this->m_Method == Pchip)
+        btkEigen::interp1().pchip(&yi, this->m_X, y, this->m_Xi);
+      else
+        btkEigen::interp1().spline(&yi, this->m_X, y, this->m_Xi);
+    }
+  };
+  virtual void TearDown() {this->m_Y.resize(0,0);};
+private:
+  btk::Acquisition::Pointer m_Acquisition;
+  Method m_Method;
+  Eigen::Matrix<double, Eigen::Dynamic, 1> m_X, m_Xi;
+  Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic> m_Y;
+};
+
+/**
+ * Median and 95th percentile of each analog channel.
+ */
+class PercentileBenchmark : public Benchmark
+{
+public:
+  PercentileBenchmark(btk::Acquisition::Pointer acq)
+  : Benchmark("eigen/percentile", "samples"), m_Acquisition(acq), m_Sum(0.0)
+  {};
+  virtual void SetUp() {this->m_ItemNumber = static_cast<double>(this->m_Acquisition->GetAnalogFrameNumber() * this->m_Acquisition->GetAnalogNumber());};
+  virtual void Run()
+  {
+    for (btk::Acquisition::AnalogConstIterator it = this->m_Acquisition->BeginAnalog() ; it != this->m_Acquisition->EndAnalog() ; ++it)
+      this->m_Sum += (*it)->GetValues().percentile(50.0) + (*it)->GetValues().percentile(95.0);
+  };
+private:
+  btk::Acquisition::Pointer m_Acquisition;
+  double m_Sum; // Keeps the results alive
+};
+
+/**
+ * Clones of the acquisition created and released concurrently by all the processors (at least 4 threads).
+ * Used with an object pool (option -P), the threads recycle the same kinds of objects at the same time.
+ */
+class ConcurrentCloneBenchmark : public Benchmark
+{
+public:
+  ConcurrentCloneBenchmark(btk::Acquisition::Pointer acq)
+  : Benchmark("pool/concurrent_clone", "acquisitions"), m_Task(acq)
+  {
+    this->m_ThreadNumber = std::max(4, btk::thread_p::GetHardwareConcurrency());
+  };
+  virtual void SetUp() {this->m_ItemNumber = static_cast<double>(this->m_ThreadNumber * CloneTask::CloneNumber);};
+  virtual void Run()
+  {
+    if (!btk::parallel_for_p(this->m_ThreadNumber, &(this->m_Task), this->m_ThreadNumber))
+      throw std::runtime_error("Error during the cloning of the acquisition.");
+  };
+private:
+  class CloneTask : public btk::parallel_task_p
+  {
+  public:
+    enum {CloneNumber = 4};
+    CloneTask(btk::Acquisition::Pointer acq) : m_Acquisition(acq) {};
+    virtual void Run(int )
+    {
+      for (int i = 0 ; i < CloneNumber ; ++i)
+        this->m_Acquisition->Clone();
+    };
+  private:
+    btk::Acquisition::Pointer m_Acquisition;
+  };
+  
+  CloneTask m_Task;
+  int m_ThreadNumber;
+};
+
+struct BenchmarkResult
+{
+  std::string Name;
+  std::string Unit;
+  int Iterations;
+  double Mean; // seconds
+  double Min; // seconds
+  double Items;
+  double Bytes;
+  std::string Error;
+};
+
+static BenchmarkResult RunBenchmark(Benchmark* b, double minTime)
+{
+  BenchmarkResult result;
+  result.Name = b->GetName();
+  result.Unit = b->GetUnit();
+  result.Iterations = 0;
+  result.Mean = 0.0;
+  result.Min = 0.0;
+  try
+  {
+    b->SetUp();
+    b->Run(); // Warm-up
+    double total = 0.0;
+    do
+    {
+      double start = Now();
+      b->Run();
+      double elapsed = Now() - start;
+      total += elapsed;
+      if ((result.Iterations == 0) || (elapsed < result.Min))
+        result.Min = elapsed;
+      ++result.Iterations;
+    }
+    while ((total < minTime) && (result.Iterations < 1000000));
+    result.Mean = total / static_cast<double>(result.Iterations);
+  }
+  catch (std::exception& e)
+  {
+    result.Error = e.what();
+  }
+  catch (...)
+  {
+    result.Error = "Unknown exception";
+  }
+  result.Items = b->GetItemNumber();
+  result.Bytes = b->GetByteNumber();
+  try
+  {
+    b->TearDown();
+  }
+  catch (...)
+  {}
+  return result;
+};
+
+static std::string JSONString(const std::string& str)
+{
+  std::string s = "\"";
+  for (size_t i = 0 ; i < str.length() ; ++i)
+  {
+    if ((str[i] == '"') || (str[i] == '\\'))
+      s += '\\';
+    if (static_cast<unsigned char>(str[i]) >= 0x20)
+      s += str[i];
+  }
+  return s + "\"";
+};
+
+static void PrintCSV(std::ostream& os, const std::vector<BenchmarkResult>& results)
+{
+  os << "benchmark,iterations,mean_ms,min_ms,items,unit,items_per_s,bytes,mb_per_s,error\n";
+  for (size_t i = 0 ; i < results.size() ; ++i)
+  {
+    const BenchmarkResult& r = results[i];
+    os << r.Name << "," << r.Iterations << "," << r.Mean * 1000.0 << "," << r.Min * 1000.0 << ","
+       << r.Items << "," << r.Unit << "," << ((r.Mean > 0.0) ? r.Items / r.Mean : 0.0) << ","
+       << r.Bytes << "," << ((r.Mean > 0.0) ? r.Bytes / 1048576.0 / r.Mean : 0.0) << ","
+       << JSONString(r.Error) << "\n";
+  }
+};
+
+static void PrintJSON(std::ostream& os, const SyntheticAcquisitionParameters& parameters, double minTime, const std::vector<BenchmarkResult>& results)
+{
+  os << "{\n  \"version\": " << JSONString(BTK_VERSION_STRING) << ",\n"
+     << "  \"parameters\": {\"points\": " << parameters.PointNumber << ", \"analogs\": " << parameters.AnalogNumber
+     << ", \"frames\": " << parameters.FrameNumber << ", \"sample_ratio\": " << parameters.SampleRatio
+     << ", \"frequency\": " << parameters.PointFrequency << ", \"occlusion_rate\": " << parameters.OcclusionRate
+     << ", \"force_platform_types\": [";
+  for (size_t i = 0 ; i < parameters.ForcePlatformTypes.size() ; ++i)
+    os << ((i == 0) ? "" : ", ") << parameters.ForcePlatformTypes[i];
+  os << "], \"metadata_entries\": " << parameters.MetaDataEntryNumber << ", \"seed\": " << parameters.Seed
+     << ", \"min_time\": " << minTime << "},\n  \"results\": [";
+  for (size_t i = 0 ; i < results.size() ; ++i)
+  {
+    const BenchmarkResult& r = results[i];
+    os << ((i == 0) ? "\n" : ",\n") << "    {\"benchmark\": " << JSONString(r.Name) << ", \"iterations\": " << r.Iterations
+       << ", \"mean_ms\": " << r.Mean * 1000.0 << ", \"min_ms\": " << r.Min * 1000.0
+       << ", \"items\": " << r.Items << ", \"unit\": " << JSONString(r.Unit)
+       << ", \"items_per_s\": " << ((r.Mean > 0.0) ? r.Items / r.Mean : 0.0)
+       << ", \"bytes\": " << r.Bytes << ", \"mb_per_s\": " << ((r.Mean > 0.0) ? r.Bytes / 1048576.0 / r.Mean : 0.0);
+    if (!r.Error.empty())
+      os << ", \"error\": " << JSONString(r.Error);
+    os << "}";
+  }
+  os << "\n  ]\n}\n";
+};
+
+static void PrintUsage(const char* name)
+{
+  std::cerr << "Usage: " << name << " [options]\n\n"
+            << "Time the main operations of BTK on a synthetic acquisition.\n\n"
+            << "Synthetic acquisition:\n"
+            << "  -p num     Number of markers (default: 40)\n"
+            << "  -a num     Number of analog channels in addition of the force platforms' channels (default: 8)\n"
+            << "  -n num     Number of frames (default: 1000)\n"
+            << "  -r num     Number of analog samples per frame (default: 10)\n"
+            << "  -c rate    Ratio of occluded marker samples, between 0 and 1 (default: 0.02)\n"
+            << "  -t types   Comma separated force platform types among 1, 2, 3 and 4 (default: 2,2)\n"
+            << "  -m num     Number of parameters used by the metadata benchmark (default: 1000)\n"
+            << "  -s seed    Seed of the generator (default: 12345)\n\n"
+            << "Options:\n"
+            << "  -b filter  Run only the benchmarks containing this text (e.g. read/, filter/)\n"
+            << "  -d dir     Directory of the temporary files (default: current directory)\n"
+            << "  -T sec     Minimum duration of each benchmark (default: 0.5)\n"
+            << "  -P mb      Memory budget of the object pool in megabytes (default: 0, disabled)\n"
+            << "  -o file    Write the results in a file instead of the standard output\n"
+            << "  -json      Use the JSON format instead of CSV\n"
+            << "  -v         Display BTK warnings and errors\n"
+            << "  -l         List the benchmarks and exit"
+            << std::endl;
+};
+
+int main(int argc, char *argv[])
+{
+  SyntheticAcquisitionParameters parameters;
+  int metaDataEntryNumber = 1000;
+  std::string filter, path, output;
+  double minTime = 0.5;
+  int poolBudget = 0;
+  bool json = false, verbose = false, list = false;
+  for (int i = 1 ; i < argc ; ++i)
+  {
+    std::string arg = argv[i];
+    if (arg == "-json")
+      json = true;
+    else if (arg == "-v")
+      verbose = true;
+    else if (arg == "-l")
+      list = true;
+    else if ((arg.length() == 2) && (std::string("panrctmsbdToP").find(arg[1]) != std::string::npos) && (arg[0] == '-'))
+    {
+      if (++i >= argc)
+      {
+        std::cerr << "Missing value for the option " << arg << ".\n\n";
+        PrintUsage(btkStripPathMacro(argv[0]));
+        return -1;
+      }
+      std::string value = argv[i];
+      switch (arg[1])
+      {
+      case 'p': parameters.PointNumber = atoi(value.c_str()); break;
+      case 'a': parameters.AnalogNumber = atoi(value.c_str()); break;
+      case 'n': parameters.FrameNumber = atoi(value.c_str()); break;
+      case 'r': parameters.SampleRatio = atoi(value.c_str()); break;
+      case 'c': parameters.OcclusionRate = atof(value.c_str()); break;
+      case 'm': metaDataEntryNumber = atoi(value.c_str()); break;
+      case 's': parameters.Seed = static_cast<unsigned int>(atoi(value.c_str())); break;
+      case 'b': filter = value; break;
+      case 'd': path = value; break;
+      case 'T': minTime = atof(value.c_str()); break;
+      case 'o': output = value; break;
+      case 'P': poolBudget = atoi(value.c_str()); break;
+      case 't':
+        {
+        parameters.ForcePlatformTypes.clear();
+        std::istringstream iss(value);
+        std::string type;
+        while (std::getline(iss, type, ','))
+        {
+          int t = atoi(type.c_str());
+          if ((t < 1) || (t > 4))
+          {
+            std::cerr << "Unsupported force platform type: " << type << std::endl;
+            return -1;
+          }
+          parameters.ForcePlatformTypes.push_back(t);
+        }
+        }
+        break;
+      }
+    }
+    else
+    {
+      std::cerr << "Unknown option: " << arg << ".\n\n";
+      PrintUsage(btkStripPathMacro(argv[0]));
+      return -1;
+    }
+  }
+  if ((parameters.FrameNumber < 16) || (parameters.SampleRatio < 1) || (parameters.PointNumber < 1))
+  {
+    std::cerr << "The synthetic acquisition requires at least 16 frames, 1 marker and 1 analog sample per frame." << std::endl;
+    return -1;
+  }
+  if (!path.empty() && (path[path.length()-1] != PathSeparator) && (path[path.length()-1] != '/'))
+    path += PathSeparator;
+  if (!verbose)
+    btk::Logger::SetVerboseMode(btk::Logger::Quiet);
+  if (poolBudget > 0)
+    btk::ObjectPool::SetMemoryBudget(static_cast<size_t>(poolBudget) * 1048576);
+
+  btk::Acquisition::Pointer acq = GenerateSyntheticAcquisition(parameters);
+  SyntheticAcquisitionParameters metaDataParameters = parameters;
+  metaDataParameters.MetaDataEntryNumber = metaDataEntryNumber;
+
+  std::vector<FileFormat> formats;
+  formats.push_back(FileFormat("c3d_integer_pc", "c3d", btk::AcquisitionFileIO::Integer, btk::AcquisitionFileIO::IEEE_LittleEndian));
+  formats.push_back(FileFormat("c3d_integer_dec", "c3d", btk::AcquisitionFileIO::Integer, btk::AcquisitionFileIO::VAX_LittleEndian));
+  formats.push_back(FileFormat("c3d_integer_mips", "c3d", btk::AcquisitionFileIO::Integer, btk::AcquisitionFileIO::IEEE_BigEndian));
+  formats.push_back(FileFormat("c3d_float_pc", "c3d", btk::AcquisitionFileIO::Float, btk::AcquisitionFileIO::IEEE_LittleEndian));
+  formats.push_back(FileFormat("c3d_float_dec", "c3d", btk::AcquisitionFileIO::Float, btk::AcquisitionFileIO::VAX_LittleEndian));
+  formats.push_back(FileFormat("c3d_float_mips", "c3d", btk::AcquisitionFileIO::Float, btk::AcquisitionFileIO::IEEE_BigEndian));
+  formats.push_back(FileFormat("trc", "trc"));
+  formats.push_back(FileFormat("anb", "anb"));
+  formats.push_back(FileFormat("anc", "anc"));
+
+  std::vector<Benchmark*> benchmarks;
+  for (size_t i = 0 ; i < formats.size() ; ++i)
+    benchmarks.push_back(new FileWriteBenchmark(acq, formats[i], path));
+  for (size_t i = 0 ; i < formats.size() ; ++i)
+    benchmarks.push_back(new FileReadBenchmark(acq, formats[i], path));
+  benchmarks.push_back(new MetaDataBenchmark(metaDataParameters, path));
+  if (!parameters.ForcePlatformTypes.empty())
+    benchmarks.push_back(new ForcePlatformChainBenchmark(acq));
+  benchmarks.push_back(new MergeBenchmark(acq));
+  benchmarks.push_back(new SubAcquisitionBenchmark(acq));
+  benchmarks.push_back(new UnitConverterBenchmark(acq));
+  if (acq->GetAnalogNumber() != 0)
+    benchmarks.push_back(new FiltFiltBenchmark(acq));
+  benchmarks.push_back(new Interp1Benchmark(acq, Interp1Benchmark::Linear));
+  benchmarks.push_back(new Interp1Benchmark(acq, Interp1Benchmark::Pchip));
+  benchmarks.push_back(new Interp1Benchmark(acq, Interp1Benchmark::Spline));
+  if (acq->GetAnalogNumber() != 0)
+    benchmarks.push_back(new PercentileBenchmark(acq));
+  benchmarks.push_back(new ConcurrentCloneBenchmark(acq));
+
+  std::vector<BenchmarkResult> results;
+  int failed = 0;
+  for (size_t i = 0 ; i < benchmarks.size() ; ++i)
+  {
+    if (filter.empty() || (benchmarks[i]->GetName().find(filter) != std::string::npos))
+    {
+      if (list)
+        std::cout << benchmarks[i]->GetName() << std::endl;
+      else
+      {
+        results.push_back(RunBenchmark(benchmarks[i], minTime));
+        if (!results.back().Error.empty())
+        {
+          std::cerr << "[failed] " << results.back().Name << ": " << results.back().Error << std::endl;
+          ++failed;
+        }
+      }
+    }
+    delete benchmarks[i];
+  }
+  if (list)
+    return 0;
+
+  if (output.empty())
+  {
+    if (json)
+      PrintJSON(std::cout, metaDataParameters, minTime, results);
+    else
+      PrintCSV(std::cout, results);
+  }
+  else
+  {
+    std::ofstream ofs(output.c_str());
+    if (!ofs)
+    {
+      std::cerr << "Impossible to write the results in the file: " << output << std::endl;
+      return -1;
+    }
+    if (json)
+      PrintJSON(ofs, metaDataParameters, minTime, results);
+    else
+      PrintCSV(ofs, results);
+  }
+  return (failed == 0) ? 0 : 1;
+};
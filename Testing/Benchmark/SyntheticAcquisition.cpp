@@ -0,0 +1,325 @@
+#include "SyntheticAcquisition.h"
+
+#include <btkMetaDataUtils.h>
+#include <btkConvert.h>
+
+#include <cmath> // sin, sqrt, log, fmod
+#include <sstream>
+#include <iomanip> // std::setw, std::setfill
+
+static const double SyntheticPi = 3.14159265358979323846;
+static const double SyntheticCycleDuration = 1.1; // Duration of a gait cycle (s)
+static const double SyntheticStanceRatio = 0.6; // Part of the gait cycle in contact with the ground
+
+/**
+ * Linear congruential generator. Its sequence does not depend on the platform or the C library.
+ */
+class SyntheticRandom
+{
+public:
+  SyntheticRandom(unsigned int seed) : m_State(seed & 0xFFFFFFFFu) {};
+
+  // Uniform number in [0, 1[.
+  double Uniform()
+  {
+    this->m_State = (1664525u * this->m_State + 1013904223u) & 0xFFFFFFFFu;
+    return static_cast<double>(this->m_State >> 8) / 16777216.0;
+  };
+
+  double Uniform(double lb, double ub) {return lb + (ub - lb) * this->Uniform();};
+
+  // Normal distribution (Box-Muller transform).
+  double Normal()
+  {
+    double u = 1.0 - this->Uniform(); // ]0, 1]
+    double v = this->Uniform();
+    return std::sqrt(-2.0 * std::log(u)) * std::cos(2.0 * SyntheticPi * v);
+  };
+
+private:
+  unsigned int m_State;
+};
+
+static std::string SyntheticLabel(const std::string& prefix, int num, int width)
+{
+  std::ostringstream oss;
+  oss << prefix << std::setw(width) << std::setfill('0') << num;
+  return oss.str();
+};
+
+static int SyntheticForcePlatformChannelNumber(int type)
+{
+  return (type == 3) ? 8 : 6;
+};
+
+// Phase (between 0 and 1) in the stance of the given foot, or -1 during its swing.
+static double SyntheticStancePhase(double t, int foot)
+{
+  double c = std::fmod(t + static_cast<double>(foot) * 0.5 * SyntheticCycleDuration, SyntheticCycleDuration) / SyntheticCycleDuration;
+  return (c < SyntheticStanceRatio) ? (c / SyntheticStanceRatio) : -1.0;
+};
+
+/**
+ * Default parameters: 40 markers, 8 EMG channels, 1000 frames at 100 Hz, 10 analog samples per frame, 2% of occlusion and two force platforms (type 2).
+ */
+SyntheticAcquisitionParameters::SyntheticAcquisitionParameters()
+: ForcePlatformTypes(2, 2)
+{
+  this->PointNumber = 40;
+  this->AnalogNumber = 8;
+  this->FrameNumber = 1000;
+  this->SampleRatio = 10;
+  this->PointFrequency = 100.0;
+  this->OcclusionRate = 0.02;
+  this->MetaDataEntryNumber = 0;
+  this->Seed = 12345u;
+};
+
+/**
+ * Generates an acquisition with the markers' trajectories of a walking subject, the channels of the force platforms,
+ * some EMG channels, the gait events and the corresponding metadata.
+ *
+ * The trajectories contain gaps (residual set to -1 and coordinates to 0) of 10 frames on average, so that the ratio
+ * of occluded samples tends to @a OcclusionRate. Each force platform receives the stance of one foot (alternating
+ * right and left). The calibration matrices of the type 4 are set to the identity.
+ */
+btk::Acquisition::Pointer GenerateSyntheticAcquisition(const SyntheticAcquisitionParameters& parameters)
+{
+  SyntheticRandom rng(parameters.Seed);
+  const int frameNumber = (parameters.FrameNumber > 0) ? parameters.FrameNumber : 1;
+  const int ratio = (parameters.SampleRatio > 0) ? parameters.SampleRatio : 1;
+  const int analogFrameNumber = frameNumber * ratio;
+  const double frequency = parameters.PointFrequency;
+  const double analogFrequency = frequency * static_cast<double>(ratio);
+
+  std::vector<int> types;
+  int fpChannelNumber = 0, channelStep = 0;
+  bool withCalMatrix = false;
+  for (size_t i = 0 ; i < parameters.ForcePlatformTypes.size() ; ++i)
+  {
+    int type = parameters.ForcePlatformTypes[i];
+    if ((type < 1) || (type > 4))
+      continue;
+    types.push_back(type);
+    int num = SyntheticForcePlatformChannelNumber(type);
+    fpChannelNumber += num;
+    channelStep = (num > channelStep) ? num : channelStep;
+    withCalMatrix |= (type == 4);
+  }
+  const int pointNumber = (parameters.PointNumber > 0) ? parameters.PointNumber : 0;
+  const int analogNumber = fpChannelNumber + ((parameters.AnalogNumber > 0) ? parameters.AnalogNumber : 0);
+
+  btk::Acquisition::Pointer acq = btk::Acquisition::New();
+  acq->Init(pointNumber, frameNumber, analogNumber, ratio);
+  acq->SetPointFrequency(frequency);
+
+  // Markers
+  const double meanGapLength = 10.0;
+  const double occlusion = (parameters.OcclusionRate < 0.0) ? 0.0 : ((parameters.OcclusionRate > 0.9) ? 0.9 : parameters.OcclusionRate);
+  const double gapProbability = occlusion / (meanGapLength * (1.0 - occlusion));
+  int inc = 0;
+  for (btk::Acquisition::PointIterator it = acq->BeginPoint() ; it != acq->EndPoint() ; ++it)
+  {
+    (*it)->SetLabel(SyntheticLabel("M", ++inc, 3));
+    (*it)->SetDescription("Synthetic marker");
+    btk::Point::Values& values = (*it)->GetValues();
+    btk::Point::Residuals& residuals = (*it)->GetResiduals();
+    double base[3] = {rng.Uniform(-200.0, 200.0), rng.Uniform(-300.0, 300.0), rng.Uniform(50.0, 1500.0)};
+    double amplitude[3] = {rng.Uniform(10.0, 80.0), rng.Uniform(5.0, 30.0), rng.Uniform(5.0, 40.0)};
+    double phase = rng.Uniform(0.0, 2.0 * SyntheticPi);
+    int gap = 0;
+    for (int i = 0 ; i < frameNumber ; ++i)
+    {
+      if ((gap == 0) && (gapProbability > 0.0) && (rng.Uniform() < gapProbability))
+        gap = 1 + static_cast<int>(rng.Uniform() * (2.0 * meanGapLength - 1.0));
+      if (gap > 0)
+      {
+        values.row(i).setZero();
+        residuals.coeffRef(i) = -1.0;
+        --gap;
+        continue;
+      }
+      double t = static_cast<double>(i) / frequency;
+      double w = 2.0 * SyntheticPi * t / SyntheticCycleDuration + phase;
+      values.coeffRef(i,0) = base[0] + 1200.0 * t + amplitude[0] * std::sin(w) + 0.5 * rng.Normal();
+      values.coeffRef(i,1) = base[1] + amplitude[1] * std::sin(w + 0.5 * SyntheticPi) + 0.5 * rng.Normal();
+      values.coeffRef(i,2) = base[2] + amplitude[2] * std::sin(2.0 * w) + 0.5 * rng.Normal();
+      residuals.coeffRef(i) = rng.Uniform(0.2, 1.5);
+    }
+  }
+
+  // Force platforms' channels
+  const double halfLength = 250.0, halfWidth = 200.0;
+  btk::Acquisition::AnalogIterator itAnalog = acq->BeginAnalog();
+  for (size_t p = 0 ; p < types.size() ; ++p)
+  {
+    static const char* labels2[] = {"Fx", "Fy", "Fz", "Mx", "My", "Mz"};
+    static const char* labels1[] = {"Fx", "Fy", "Fz", "Px", "Py", "Mz"};
+    static const char* labels3[] = {"Fz1", "Fz2", "Fz3", "Fz4", "Fx12", "Fx34", "Fy14", "Fy23"};
+    static const char* units2[] = {"N", "N", "N", "Nmm", "Nmm", "Nmm"};
+    static const char* units1[] = {"N", "N", "N", "mm", "mm", "Nmm"};
+    const char** labels = (types[p] == 1) ? labels1 : ((types[p] == 3) ? labels3 : labels2);
+    const char** units = (types[p] == 1) ? units1 : units2;
+    const int num = SyntheticForcePlatformChannelNumber(types[p]);
+    std::vector<btk::Analog::Values*> channels(num);
+    for (int c = 0 ; c < num ; ++c)
+    {
+      (*itAnalog)->SetLabel(labels[c] + btk::ToString(p + 1));
+      (*itAnalog)->SetUnit((types[p] == 3) ? "N" : units[c]);
+      (*itAnalog)->SetDescription("Synthetic force platform channel");
+      (*itAnalog)->SetGain(btk::Analog::PlusMinus10);
+      channels[c] = &((*itAnalog)->GetValues());
+      ++itAnalog;
+    }
+    for (int i = 0 ; i < analogFrameNumber ; ++i)
+    {
+      double s = SyntheticStancePhase(static_cast<double>(i) / analogFrequency, static_cast<int>(p % 2));
+      double f[3] = {0.0, 0.0, 0.0}, cop[2] = {0.0, 0.0}, mz = 0.0;
+      if (s >= 0.0)
+      {
+        f[0] = 150.0 * std::sin(2.0 * SyntheticPi * s);
+        f[1] = 40.0 * std::sin(SyntheticPi * s);
+        f[2] = 700.0 * (std::sin(SyntheticPi * s) + 0.25 * std::sin(3.0 * SyntheticPi * s));
+        cop[0] = (s - 0.5) * 200.0;
+        cop[1] = 20.0 * std::sin(SyntheticPi * s);
+        mz = 3000.0 * std::sin(2.0 * SyntheticPi * s);
+      }
+      for (int j = 0 ; j < 3 ; ++j)
+        f[j] += 0.5 * rng.Normal();
+      switch (types[p])
+      {
+      case 1:
+        channels[0]->coeffRef(i) = f[0];
+        channels[1]->coeffRef(i) = f[1];
+        channels[2]->coeffRef(i) = f[2];
+        channels[3]->coeffRef(i) = cop[0];
+        channels[4]->coeffRef(i) = cop[1];
+        channels[5]->coeffRef(i) = mz;
+        break;
+      case 3:
+        {
+        double x = cop[0] / halfLength, y = cop[1] / halfWidth;
+        channels[0]->coeffRef(i) = 0.25 * f[2] * (1.0 + x) * (1.0 + y);
+        channels[1]->coeffRef(i) = 0.25 * f[2] * (1.0 - x) * (1.0 + y);
+        channels[2]->coeffRef(i) = 0.25 * f[2] * (1.0 - x) * (1.0 - y);
+        channels[3]->coeffRef(i) = 0.25 * f[2] * (1.0 + x) * (1.0 - y);
+        channels[4]->coeffRef(i) = 0.5 * f[0];
+        channels[5]->coeffRef(i) = 0.5 * f[0];
+        channels[6]->coeffRef(i) = 0.5 * f[1];
+        channels[7]->coeffRef(i) = 0.5 * f[1];
+        }
+        break;
+      default: // Type 2 and 4 (identity calibration matrix)
+        channels[0]->coeffRef(i) = f[0];
+        channels[1]->coeffRef(i) = f[1];
+        channels[2]->coeffRef(i) = f[2];
+        channels[3]->coeffRef(i) = f[2] * cop[1];
+        channels[4]->coeffRef(i) = -f[2] * cop[0];
+        channels[5]->coeffRef(i) = mz;
+        break;
+      }
+    }
+  }
+
+  // EMG channels
+  inc = 0;
+  for ( ; itAnalog != acq->EndAnalog() ; ++itAnalog)
+  {
+    (*itAnalog)->SetLabel(SyntheticLabel("EMG", ++inc, 2));
+    (*itAnalog)->SetUnit("V");
+    (*itAnalog)->SetDescription("Synthetic EMG channel");
+    (*itAnalog)->SetGain(btk::Analog::PlusMinus10);
+    btk::Analog::Values& values = (*itAnalog)->GetValues();
+    double phase = rng.Uniform(0.0, SyntheticPi);
+    for (int i = 0 ; i < analogFrameNumber ; ++i)
+    {
+      double envelope = std::sin(SyntheticPi * static_cast<double>(i) / (analogFrequency * SyntheticCycleDuration) + phase);
+      values.coeffRef(i) = 0.1 * (0.2 + envelope * envelope) * rng.Normal();
+    }
+  }
+
+  // Gait events
+  for (int foot = 0 ; foot < 2 ; ++foot)
+  {
+    const std::string context = (foot == 0) ? "Right" : "Left";
+    double offset = (foot == 0) ? 0.0 : 0.5 * SyntheticCycleDuration;
+    for (double t = SyntheticCycleDuration - offset ; t * frequency < static_cast<double>(frameNumber) ; t += SyntheticCycleDuration)
+    {
+      double off = t + SyntheticStanceRatio * SyntheticCycleDuration;
+      acq->AppendEvent(btk::Event::New("Foot Strike", t, static_cast<int>(t * frequency + 0.5) + 1, context, btk::Event::Automatic, "Synthetic", "", 1));
+      if (off * frequency < static_cast<double>(frameNumber))
+        acq->AppendEvent(btk::Event::New("Foot Off", off, static_cast<int>(off * frequency + 0.5) + 1, context, btk::Event::Automatic, "Synthetic", "", 2));
+    }
+  }
+
+  // Force platforms' metadata
+  if (!types.empty())
+  {
+    const int fpNumber = static_cast<int>(types.size());
+    btk::MetaData::Pointer fp = btk::MetaDataCreateChild(acq->GetMetaData(), "FORCE_PLATFORM");
+    btk::MetaDataCreateChild(fp, "USED", static_cast<int16_t>(fpNumber));
+    std::vector<int16_t> typeValues(types.begin(), types.end());
+    btk::MetaDataCreateChild(fp, "TYPE", typeValues);
+    std::vector<int16_t> channel(channelStep * fpNumber, 0);
+    std::vector<float> corners(12 * fpNumber), origin(3 * fpNumber);
+    int first = 1;
+    for (int p = 0 ; p < fpNumber ; ++p)
+    {
+      for (int c = 0 ; c < SyntheticForcePlatformChannelNumber(types[p]) ; ++c)
+        channel[p * channelStep + c] = static_cast<int16_t>(first++);
+      float cx = static_cast<float>(halfLength * (2 * p + 1)), cy = static_cast<float>(halfWidth);
+      const float sx[4] = {1.0f, -1.0f, -1.0f, 1.0f}, sy[4] = {1.0f, 1.0f, -1.0f, -1.0f};
+      for (int k = 0 ; k < 4 ; ++k)
+      {
+        corners[p * 12 + k * 3] = cx + sx[k] * static_cast<float>(halfLength);
+        corners[p * 12 + k * 3 + 1] = cy + sy[k] * static_cast<float>(halfWidth);
+        corners[p * 12 + k * 3 + 2] = 0.0f;
+      }
+      origin[p * 3] = (types[p] == 3) ? static_cast<float>(halfLength) : 0.0f;
+      origin[p * 3 + 1] = (types[p] == 3) ? static_cast<float>(halfWidth) : 0.0f;
+      origin[p * 3 + 2] = -40.0f;
+    }
+    btk::MetaDataCreateChild(fp, "CHANNEL", channel, channelStep);
+    std::vector<uint8_t> dims(3); dims[0] = 3; dims[1] = 4; dims[2] = static_cast<uint8_t>(fpNumber);
+    fp->AppendChild(btk::MetaData::New("CORNERS", dims, corners));
+    btk::MetaDataCreateChild(fp, "ORIGIN", origin, 3);
+    if (withCalMatrix)
+    {
+      std::vector<float> cal(36 * fpNumber, 0.0f);
+      for (int p = 0 ; p < fpNumber ; ++p)
+        for (int k = 0 ; k < 6 ; ++k)
+          cal[p * 36 + k * 7] = 1.0f;
+      dims[0] = 6; dims[1] = 6;
+      fp->AppendChild(btk::MetaData::New("CAL_MATRIX", dims, cal));
+    }
+  }
+
+  // Additional metadata
+  if (parameters.MetaDataEntryNumber > 0)
+  {
+    btk::MetaData::Pointer group = btk::MetaDataCreateChild(acq->GetMetaData(), "SYNTHETIC");
+    for (int i = 0 ; i < parameters.MetaDataEntryNumber ; ++i)
+    {
+      std::string label = SyntheticLabel("P", i + 1, 4);
+      switch (i % 3)
+      {
+      case 0:
+        btk::MetaDataCreateChild(group, label, static_cast<int16_t>(i % 32768));
+        break;
+      case 1:
+        {
+        std::vector<float> values(8);
+        for (size_t j = 0 ; j < values.size() ; ++j)
+          values[j] = static_cast<float>(rng.Uniform(-1000.0, 1000.0));
+        btk::MetaDataCreateChild(group, label, values);
+        }
+        break;
+      default:
+        btk::MetaDataCreateChild(group, label, std::string("Synthetic parameter #") + btk::ToString(i + 1));
+        break;
+      }
+    }
+  }
+
+  return acq;
+};
@@ -0,0 +1,29 @@
+#ifndef SyntheticAcquisition_h
+#define SyntheticAcquisition_h
+
+#include <btkAcquisition.h>
+
+#include <vector>
+
+/**
+ * Parameters of the synthetic acquisitions used by the benchmarks.
+ * The same parameters (including the seed) always give the same acquisition.
+ */
+struct SyntheticAcquisitionParameters
+{
+  SyntheticAcquisitionParameters();
+  
+  int PointNumber;
+  int AnalogNumber; // Channels added after the force platforms' channels
+  int FrameNumber;
+  int SampleRatio; // Number of analog samples per point frame
+  double PointFrequency;
+  double OcclusionRate; // Ratio of occluded samples for each marker (between 0 and 1)
+  std::vector<int> ForcePlatformTypes; // Supported types: 1, 2, 3 and 4
+  int MetaDataEntryNumber; // Additional parameters stored in the group SYNTHETIC
+  unsigned int Seed;
+};
+
+btk::Acquisition::Pointer GenerateSyntheticAcquisition(const SyntheticAcquisitionParameters& parameters);
+
+#endif // SyntheticAcquisition_h
@@ -4,6 +4,7 @@
 #include <btkAcquisitionFileWriter.h>
 #include <btkAcquisitionFileReader.h>
 #include <btkANCFileIO.h>
+#include <btkConvert.h>
 
 CXXTEST_SUITE(ANCFileWriterTest)
 {
@@ -189,6 +190,38 @@ CXXTEST_SUITE(ANCFileWriterTest)
       TS_ASSERT_DELTA(acq->GetAnalog(5)->GetValues()(j), acq2->GetAnalog(5)->GetValues()(j) * s6, 1e-5);
     }
   };
+  
+  CXXTEST_TEST(Synthetic_rewrited)
+  {
+    btk::Acquisition::Pointer acq = btk::Acquisition::New();
+    acq->Init(0, 50, 3, 2);
+    acq->SetPointFrequency(100.0);
+    for (int i = 0 ; i < 3 ; ++i)
+    {
+      acq->GetAnalog(i)->SetLabel("CH" + btk::ToString(i + 1));
+      acq->GetAnalog(i)->SetScale(0.0048828125); // +/- 10 V on 12 bits
+      for (int j = 0 ; j < 100 ; ++j)
+        acq->GetAnalog(i)->GetValues()(j) = static_cast<double>((j * 7 + i * 13) % 2001 - 1000) * acq->GetAnalog(i)->GetScale();
+    }
+    btk::AcquisitionFileWriter::Pointer writer = btk::AcquisitionFileWriter::New();
+    writer->SetInput(acq);
+    writer->SetFilename(ANCFilePathOUT + "Synthetic_rewrited.anc");
+    writer->Update();
+    btk::AcquisitionFileReader::Pointer reader = btk::AcquisitionFileReader::New();
+    reader->SetFilename(ANCFilePathOUT + "Synthetic_rewrited.anc");
+    reader->Update();
+    btk::Acquisition::Pointer acq2 = reader->GetOutput();
+    
+    TS_ASSERT_EQUALS(acq2->GetAnalogFrequency(), 200.0);
+    TS_ASSERT_EQUALS(acq2->GetAnalogNumber(), 3);
+    TS_ASSERT_EQUALS(acq2->GetAnalogFrameNumber(), 100);
+    TS_ASSERT_EQUALS(acq2->GetAnalog(2)->GetLabel(), "CH3");
+    for (int i = 0 ; i < 3 ; ++i)
+    {
+      for (int j = 0 ; j < 100 ; ++j)
+        TS_ASSERT_DELTA(acq->GetAnalog(i)->GetValues()(j), acq2->GetAnalog(i)->GetValues()(j), 1e-6);
+    }
+  };
 };
 
 CXXTEST_SUITE_REGISTRATION(ANCFileWriterTest)
@@ -198,5 +231,6 @@ CXXTEST_TEST_REGISTRATION(ANCFileWriterTest, NoFileWithIO)
 CXXTEST_TEST_REGISTRATION(ANCFileWriterTest, Gait_rewrited)
 CXXTEST_TEST_REGISTRATION(ANCFileWriterTest, Gait_from_c3d)
 CXXTEST_TEST_REGISTRATION(ANCFileWriterTest, Res16bits_rewrited)
-CXXTEST_TEST_REGISTRATION(ANCFileWriterTest, Shd01_from_c3d) 
+CXXTEST_TEST_REGISTRATION(ANCFileWriterTest, Shd01_from_c3d)
+CXXTEST_TEST_REGISTRATION(ANCFileWriterTest, Synthetic_rewrited) 
 #endif
@@ -0,0 +1,99 @@
+#ifndef AcquisitionFileIOFactoryTest_h
+#define AcquisitionFileIOFactoryTest_h
+
+#include <btkAcquisitionFileIOFactory.h>
+#include <btkAcquisitionFileWriter.h>
+#include <btkC3DFileIO.h>
+#include <btkTRCFileIO.h>
+#include <btkANCFileIO.h>
+#include <btkThread_p.h>
+
+#include <cstdio>
+
+static void AcquisitionFileIOFactoryTest_Write(const std::string& filename)
+{
+  btk::Acquisition::Pointer acq = btk::Acquisition::New();
+  acq->Init(2, 10, 2, 1);
+  acq->SetPointFrequency(100.0);
+  btk::AcquisitionFileWriter::Pointer writer = btk::AcquisitionFileWriter::New();
+  writer->SetInput(acq);
+  writer->SetFilename(filename);
+  writer->Update();
+};
+
+class AcquisitionFileIOFactoryTest_Task : public btk::parallel_task_p
+{
+public:
+  AcquisitionFileIOFactoryTest_Task(const std::string& filename) : m_Filename(filename), m_Results(64, 0) {};
+  virtual void Run(int idx)
+  {
+    btk::AcquisitionFileIO::Pointer io = btk::AcquisitionFileIOFactory::CreateAcquisitionIO(this->m_Filename, btk::AcquisitionFileIOFactory::ReadMode);
+    this->m_Results[idx] = (dynamic_cast<btk::C3DFileIO*>(io.get()) != 0) ? 1 : 0;
+  };
+  std::string m_Filename;
+  std::vector<int> m_Results;
+};
+
+CXXTEST_SUITE(AcquisitionFileIOFactoryTest)
+{
+  CXXTEST_TEST(NoFile)
+  {
+    btk::AcquisitionFileIO::Pointer io = btk::AcquisitionFileIOFactory::CreateAcquisitionIO(C3DFilePathOUT + "FactoryNoFile.c3d", btk::AcquisitionFileIOFactory::ReadMode);
+    TS_ASSERT(io.get() == 0);
+  };
+  
+  CXXTEST_TEST(WriteMode)
+  {
+    btk::AcquisitionFileIO::Pointer io = btk::AcquisitionFileIOFactory::CreateAcquisitionIO("Foo.TRC", btk::AcquisitionFileIOFactory::WriteMode);
+    TS_ASSERT(dynamic_cast<btk::TRCFileIO*>(io.get()) != 0);
+    io = btk::AcquisitionFileIOFactory::CreateAcquisitionIO("Foo.unknown", btk::AcquisitionFileIOFactory::WriteMode);
+    TS_ASSERT(io.get() == 0);
+  };
+  
+  CXXTEST_TEST(Extension)
+  {
+    AcquisitionFileIOFactoryTest_Write(C3DFilePathOUT + "Factory.c3d");
+    AcquisitionFileIOFactoryTest_Write(TRCFilePathOUT + "Factory.trc");
+    AcquisitionFileIOFactoryTest_Write(ANCFilePathOUT + "Factory.anc");
+    btk::AcquisitionFileIO::Pointer io = btk::AcquisitionFileIOFactory::CreateAcquisitionIO(C3DFilePathOUT + "Factory.c3d", btk::AcquisitionFileIOFactory::ReadMode);
+    TS_ASSERT(dynamic_cast<btk::C3DFileIO*>(io.get()) != 0);
+    io = btk::AcquisitionFileIOFactory::CreateAcquisitionIO(TRCFilePathOUT + "Factory.trc", btk::AcquisitionFileIOFactory::ReadMode);
+    TS_ASSERT(dynamic_cast<btk::TRCFileIO*>(io.get()) != 0);
+    io = btk::AcquisitionFileIOFactory::CreateAcquisitionIO(ANCFilePathOUT + "Factory.anc", btk::AcquisitionFileIOFactory::ReadMode);
+    TS_ASSERT(dynamic_cast<btk::ANCFileIO*>(io.get()) != 0);
+  };
+  
+  CXXTEST_TEST(Signature)
+  {
+    // Wrong extensions: the signature is used.
+    AcquisitionFileIOFactoryTest_Write(C3DFilePathOUT + "FactorySignature.c3d");
+    AcquisitionFileIOFactoryTest_Write(TRCFilePathOUT + "FactorySignature.trc");
+    std::remove((C3DFilePathOUT + "FactorySignature.anc").c_str());
+    std::remove((TRCFilePathOUT + "FactorySignature.c3d").c_str());
+    TS_ASSERT_EQUALS(std::rename((C3DFilePathOUT + "FactorySignature.c3d").c_str(), (C3DFilePathOUT + "FactorySignature.anc").c_str()), 0);
+    TS_ASSERT_EQUALS(std::rename((TRCFilePathOUT + "FactorySignature.trc").c_str(), (TRCFilePathOUT + "FactorySignature.c3d").c_str()), 0);
+    btk::AcquisitionFileIO::Pointer io = btk::AcquisitionFileIOFactory::CreateAcquisitionIO(C3DFilePathOUT + "FactorySignature.anc", btk::AcquisitionFileIOFactory::ReadMode);
+    TS_ASSERT(dynamic_cast<btk::C3DFileIO*>(io.get()) != 0);
+    io = btk::AcquisitionFileIOFactory::CreateAcquisitionIO(TRCFilePathOUT + "FactorySignature.c3d", btk::AcquisitionFileIOFactory::ReadMode);
+    TS_ASSERT(dynamic_cast<btk::TRCFileIO*>(io.get()) != 0);
+  };
+  
+  CXXTEST_TEST(Concurrency)
+  {
+    AcquisitionFileIOFactoryTest_Write(C3DFilePathOUT + "FactoryConcurrency.c3d");
+    AcquisitionFileIOFactoryTest_Task task(C3DFilePathOUT + "FactoryConcurrency.c3d");
+    TS_ASSERT_EQUALS(btk::parallel_for_p(64, &task, 8), true);
+    int found = 0;
+    for (size_t i = 0 ; i < task.m_Results.size() ; ++i)
+      found += task.m_Results[i];
+    TS_ASSERT_EQUALS(found, 64);
+  };
+};
+
+CXXTEST_SUITE_REGISTRATION(AcquisitionFileIOFactoryTest)
+CXXTEST_TEST_REGISTRATION(AcquisitionFileIOFactoryTest, NoFile)
+CXXTEST_TEST_REGISTRATION(AcquisitionFileIOFactoryTest, WriteMode)
+CXXTEST_TEST_REGISTRATION(AcquisitionFileIOFactoryTest, Extension)
+CXXTEST_TEST_REGISTRATION(AcquisitionFileIOFactoryTest, Signature)
+CXXTEST_TEST_REGISTRATION(AcquisitionFileIOFactoryTest, Concurrency)
+#endif
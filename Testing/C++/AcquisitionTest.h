@@ -158,6 +158,49 @@ CXXTEST_SUITE(AcquisitionTest)
     TS_ASSERT_EQUALS(test->GetPoint(1)->GetParent(), test.get());
     TS_ASSERT_EQUALS(test->GetPoint(2)->GetParent(), test.get());
   }
+  
+  CXXTEST_TEST(MeasureRecycling)
+  {
+    btk::Acquisition::Pointer test = btk::Acquisition::New();
+    TS_ASSERT_EQUALS(test->GetMeasureRecycling(), false);
+    test->SetMeasureRecycling(true);
+    test->Init(2,10,1,2);
+    test->GetPoint(0)->SetLabel("foo");
+    test->GetPoint(0)->GetValues().setConstant(1.0);
+    test->GetPoint(0)->GetResiduals().setConstant(-1.0);
+    test->GetAnalog(0)->SetUnit("N");
+    test->GetAnalog(0)->GetValues().setConstant(2.0);
+    btk::Point* point = test->GetPoint(0).get();
+    const double* values = test->GetPoint(0)->GetValues().data();
+    btk::Analog* analog = test->GetAnalog(0).get();
+    btk::Point::Pointer kept = test->GetPoint(1);
+    test->Reset();
+    TS_ASSERT_EQUALS(test->GetPointNumber(), 0);
+    test->Init(2,10,1,2);
+    TS_ASSERT_EQUALS(test->GetPoint(0).get(), point);
+    TS_ASSERT_EQUALS(test->GetPoint(0)->GetValues().data(), values);
+    TS_ASSERT_EQUALS(test->GetPoint(0)->GetParent(), test.get());
+    TS_ASSERT_EQUALS(test->GetPoint(0)->GetLabel(), "uname*1");
+    TS_ASSERT(test->GetPoint(0)->GetValues().isZero());
+    TS_ASSERT(test->GetPoint(0)->GetResiduals().isZero());
+    TS_ASSERT(test->GetPoint(1) != kept);
+    TS_ASSERT_EQUALS(test->GetAnalog(0).get(), analog);
+    TS_ASSERT_EQUALS(test->GetAnalog(0)->GetUnit(), "V");
+    TS_ASSERT_EQUALS(test->GetAnalog(0)->GetFrameNumber(), 20);
+    TS_ASSERT(test->GetAnalog(0)->GetValues().isZero());
+    // Different number of frames
+    test->Reset();
+    test->Init(2,5);
+    TS_ASSERT_EQUALS(test->GetPoint(0).get(), point);
+    TS_ASSERT_EQUALS(test->GetPoint(0)->GetFrameNumber(), 5);
+    TS_ASSERT_EQUALS(test->GetPoint(0)->GetValues().rows(), 5);
+    test->Reset();
+    test->SetMeasureRecycling(false);
+    TS_ASSERT_EQUALS(test->GetMeasureRecycling(), false);
+    test->Init(2,5);
+    TS_ASSERT_EQUALS(test->GetPointNumber(), 2);
+    TS_ASSERT(test->GetPoint(0)->GetValues().isZero());
+  }
 };
 
 CXXTEST_SUITE_REGISTRATION(AcquisitionTest)
@@ -172,4 +215,5 @@ CXXTEST_TEST_REGISTRATION(AcquisitionTest, ResizeFromEnd)
 CXXTEST_TEST_REGISTRATION(AcquisitionTest, RemoveLastPoint)
 CXXTEST_TEST_REGISTRATION(AcquisitionTest, SetFirstFrameAdaptEvent)
 CXXTEST_TEST_REGISTRATION(AcquisitionTest, ResizeParent)
+CXXTEST_TEST_REGISTRATION(AcquisitionTest, MeasureRecycling)
 #endif
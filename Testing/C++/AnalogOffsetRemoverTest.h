@@ -3,6 +3,21 @@
 
 #include <btkAnalogOffsetRemover.h>
 
+// Unloaded period between 300 and 500 (with an outlier at the sample 350) and loaded elsewhere.
+void AnalogOffsetRemoverTest_Fill(btk::Acquisition::Pointer acq, int first, int last)
+{
+  for (int i = first ; i < last ; ++i)
+  {
+    const double noise = 0.01 * ((i % 7) - 3);
+    const bool unloaded = (i >= 300) && (i < 500);
+    acq->GetAnalog(0)->GetValues().coeffRef(i) = 2.0 + noise + (unloaded ? 0.0 : 100.0 + 50.0 * sin(i * 0.05));
+    acq->GetAnalog(1)->GetValues().coeffRef(i) = -1.5 + noise + (unloaded ? 0.0 : 10.0 * cos(i * 0.03));
+    acq->GetAnalog(2)->GetValues().coeffRef(i) = 0.5 + 0.1 * sin(i * 0.2);
+  }
+  if ((first <= 350) && (last > 350))
+    acq->GetAnalog(0)->GetValues().coeffRef(350) = 25.0;
+};
+
 CXXTEST_SUITE(AnalogOffsetRemoverTest)
 {
   CXXTEST_TEST(Test0)
@@ -157,6 +172,182 @@ CXXTEST_SUITE(AnalogOffsetRemoverTest)
     TS_ASSERT_EQUALS(output->GetAnalog(1)->GetValues().sum() / 25.0, 0.0);
     TS_ASSERT_EQUALS(output->GetAnalog(2)->GetValues().sum() / 25.0, 0.0);
   };
+  
+  CXXTEST_TEST(QuietestWindowNoOffsetInput)
+  {
+    btk::Acquisition::Pointer acq = btk::Acquisition::New();
+    acq->Init(0,100,3,10);
+    AnalogOffsetRemoverTest_Fill(acq, 0, 1000);
+    
+    btk::AnalogOffsetRemover::Pointer remover = btk::AnalogOffsetRemover::New();
+    remover->SetRawInput(acq);
+    remover->SetEstimation(btk::AnalogOffsetRemover::QuietestWindow);
+    remover->Update();
+    
+    btk::Acquisition::Pointer output = remover->GetOutput();
+    TS_ASSERT_EQUALS(output->GetAnalogNumber(), 3);
+    TS_ASSERT_EQUALS(remover->GetOffsets().size(), 3u);
+    // Window [400,500[ (no outlier)
+    TS_ASSERT_DELTA(remover->GetOffsets()[0], 2.0, 1e-12);
+    TS_ASSERT_DELTA(remover->GetOffsets()[1], -1.5, 1e-12);
+    TS_ASSERT_DELTA(output->GetAnalog(0)->GetValues().segment(400,100).sum() / 100.0, acq->GetAnalog(0)->GetValues().segment(400,100).sum() / 100.0 - 2.0, 1e-10);
+    TS_ASSERT_DELTA(output->GetAnalog(1)->GetValues()(450), acq->GetAnalog(1)->GetValues()(450) + 1.5, 1e-12);
+    // The input is not modified
+    TS_ASSERT_DELTA(acq->GetAnalog(0)->GetValues()(450), 2.0 + 0.01 * ((450 % 7) - 3), 1e-12);
+  };
+  
+  CXXTEST_TEST(QuietestWindowStatistic)
+  {
+    btk::Acquisition::Pointer acq = btk::Acquisition::New();
+    acq->Init(0,100,3,10);
+    AnalogOffsetRemoverTest_Fill(acq, 0, 1000);
+    // Only the window with the outlier is available for the first channel.
+    for (int i = 400 ; i < 500 ; ++i)
+      acq->GetAnalog(0)->GetValues().coeffRef(i) += 80.0 * sin(static_cast<double>(i));
+    
+    btk::AnalogOffsetRemover::Pointer remover = btk::AnalogOffsetRemover::New();
+    remover->SetRawInput(acq);
+    remover->SetEstimation(btk::AnalogOffsetRemover::QuietestWindow);
+    remover->SetWindowLength(50);
+    remover->Update();
+    TS_ASSERT_DELTA(remover->GetOffsets()[0], 2.0, 1e-12);
+    
+    remover->SetStatistic(btk::AnalogOffsetRemover::TrimmedMean);
+    remover->Update();
+    TS_ASSERT_DELTA(remover->GetOffsets()[0], 2.0, 1e-3);
+    
+    remover->SetTrimmingProportion(0.0);
+    remover->Update();
+    TS_ASSERT_DELTA(remover->GetOffsets()[0], 2.0, 1e-3); // Window [300,350[
+    
+    remover->SetWindowLength(100);
+    remover->Update();
+    TS_ASSERT_DELTA(remover->GetOffsets()[0], (acq->GetAnalog(0)->GetValues().segment(300,100).sum()) / 100.0, 1e-12);
+    TS_ASSERT(remover->GetOffsets()[0] > 2.2);
+    
+    remover->SetTrimmingProportion(0.5);
+    TS_ASSERT_EQUALS(remover->GetTrimmingProportion(), 0.0);
+    remover->SetWindowLength(0);
+    TS_ASSERT_EQUALS(remover->GetWindowLength(), 100);
+  };
+  
+  CXXTEST_TEST(QuietestWindowChannelLabels)
+  {
+    btk::Acquisition::Pointer acq = btk::Acquisition::New();
+    acq->Init(0,100,3,10);
+    acq->GetAnalog(0)->SetLabel("Fz1");
+    acq->GetAnalog(1)->SetLabel("Fx1");
+    acq->GetAnalog(2)->SetLabel("EMG");
+    AnalogOffsetRemoverTest_Fill(acq, 0, 1000);
+    
+    btk::AnalogOffsetRemover::Pointer remover = btk::AnalogOffsetRemover::New();
+    remover->SetRawInput(acq);
+    remover->SetEstimation(btk::AnalogOffsetRemover::QuietestWindow);
+    std::vector<std::string> labels(1, "Fz1");
+    labels.push_back("Fx1");
+    remover->SetChannelLabels(labels);
+    remover->Update();
+    
+    btk::Acquisition::Pointer output = remover->GetOutput();
+    TS_ASSERT_EQUALS(output->GetAnalogNumber(), 3);
+    TS_ASSERT_DELTA(remover->GetOffsets()[0], 2.0, 1e-12);
+    TS_ASSERT_DELTA(remover->GetOffsets()[1], -1.5, 1e-12);
+    TS_ASSERT_EQUALS(remover->GetOffsets()[2], 0.0);
+    TS_ASSERT_EQUALS(output->GetAnalog(2), acq->GetAnalog(2));
+  };
+  
+  CXXTEST_TEST(QuietestWindowShortSignal)
+  {
+    btk::Acquisition::Pointer acq = btk::Acquisition::New();
+    acq->Init(0,5,1,5);
+    for (int i = 0 ; i < 25 ; ++i)
+      acq->GetAnalog(0)->GetValues().coeffRef(i) = static_cast<double>(i);
+    
+    btk::AnalogOffsetRemover::Pointer remover = btk::AnalogOffsetRemover::New();
+    remover->SetRawInput(acq);
+    remover->SetEstimation(btk::AnalogOffsetRemover::QuietestWindow);
+    remover->Update();
+    TS_ASSERT_EQUALS(remover->GetOffsets()[0], 12.0);
+    TS_ASSERT_EQUALS(remover->GetOutput()->GetAnalog(0)->GetValues().sum(), 0.0);
+  };
+  
+  CXXTEST_TEST(QuietestWindowIncremental)
+  {
+    btk::Acquisition::Pointer acq = btk::Acquisition::New();
+    acq->Init(0,100,3,10);
+    AnalogOffsetRemoverTest_Fill(acq, 0, 1000);
+    
+    btk::AnalogOffsetRemover::Pointer batch = btk::AnalogOffsetRemover::New();
+    batch->SetRawInput(acq);
+    batch->SetEstimation(btk::AnalogOffsetRemover::QuietestWindow);
+    batch->SetStatistic(btk::AnalogOffsetRemover::TrimmedMean);
+    batch->SetWindowLength(64);
+    batch->Update();
+    
+    btk::Acquisition::Pointer stream = btk::Acquisition::New();
+    stream->Init(0,0,3,10);
+    btk::AnalogOffsetRemover::Pointer remover = btk::AnalogOffsetRemover::New();
+    remover->SetRawInput(stream);
+    remover->SetEstimation(btk::AnalogOffsetRemover::QuietestWindow);
+    remover->SetStatistic(btk::AnalogOffsetRemover::TrimmedMean);
+    remover->SetWindowLength(64);
+    remover->SetIncrementalMode(true);
+    const int chunks[] = {7, 13, 25, 30, 25};
+    int frames = 0;
+    for (int c = 0 ; c < 5 ; ++c)
+    {
+      frames += chunks[c];
+      stream->ResizeFrameNumber(frames);
+      AnalogOffsetRemoverTest_Fill(stream, (frames - chunks[c]) * 10, frames * 10);
+      stream->Modified();
+      remover->Update();
+    }
+    TS_ASSERT_EQUALS(stream->GetAnalogFrameNumber(), 1000);
+    for (int i = 0 ; i < 3 ; ++i)
+    {
+      TS_ASSERT_EQUALS(remover->GetOffsets()[i], batch->GetOffsets()[i]);
+      TS_ASSERT(remover->GetOutput()->GetAnalog(i)->GetValues().isApprox(batch->GetOutput()->GetAnalog(i)->GetValues()));
+    }
+    TS_ASSERT_DELTA(remover->GetOffsets()[0], 2.0, 1e-3);
+  };
+  
+  CXXTEST_TEST(QuietestWindowIncrementalNewTrial)
+  {
+    btk::Acquisition::Pointer trial1 = btk::Acquisition::New();
+    trial1->Init(0,100,3,10);
+    AnalogOffsetRemoverTest_Fill(trial1, 0, 1000);
+    // Second trial with the same length but other offsets and quiet period.
+    btk::Acquisition::Pointer trial2 = btk::Acquisition::New();
+    trial2->Init(0,100,3,10);
+    AnalogOffsetRemoverTest_Fill(trial2, 0, 1000);
+    for (int i = 0 ; i < 1000 ; ++i)
+    {
+      const bool unloaded = (i >= 700) && (i < 900);
+      trial2->GetAnalog(0)->GetValues().coeffRef(i) = -4.0 + 0.01 * ((i % 5) - 2) + (unloaded ? 0.0 : 80.0 + 20.0 * sin(i * 0.07));
+    }
+    
+    btk::AnalogOffsetRemover::Pointer batch = btk::AnalogOffsetRemover::New();
+    batch->SetRawInput(trial2);
+    batch->SetEstimation(btk::AnalogOffsetRemover::QuietestWindow);
+    batch->SetWindowLength(64);
+    batch->Update();
+    
+    btk::AnalogOffsetRemover::Pointer remover = btk::AnalogOffsetRemover::New();
+    remover->SetRawInput(trial1);
+    remover->SetEstimation(btk::AnalogOffsetRemover::QuietestWindow);
+    remover->SetWindowLength(64);
+    remover->SetIncrementalMode(true);
+    remover->Update();
+    TS_ASSERT_DELTA(remover->GetOffsets()[0], 2.0, 1e-3);
+    remover->SetRawInput(trial2);
+    remover->Update();
+    for (int i = 0 ; i < 3 ; ++i)
+    {
+      TS_ASSERT_EQUALS(remover->GetOffsets()[i], batch->GetOffsets()[i]);
+      TS_ASSERT(remover->GetOutput()->GetAnalog(i)->GetValues().isApprox(batch->GetOutput()->GetAnalog(i)->GetValues()));
+    }
+    TS_ASSERT_DELTA(remover->GetOffsets()[0], -4.0, 1e-3);
+  };
 };
 
 CXXTEST_SUITE_REGISTRATION(AnalogOffsetRemoverTest)
@@ -166,5 +357,11 @@ CXXTEST_TEST_REGISTRATION(AnalogOffsetRemoverTest, Test3Over4)
 CXXTEST_TEST_REGISTRATION(AnalogOffsetRemoverTest, Test4Over3)
 CXXTEST_TEST_REGISTRATION(AnalogOffsetRemoverTest, TestNoCommonLabel)
 CXXTEST_TEST_REGISTRATION(AnalogOffsetRemoverTest, TestOneCommonLabel)
+CXXTEST_TEST_REGISTRATION(AnalogOffsetRemoverTest, QuietestWindowNoOffsetInput)
+CXXTEST_TEST_REGISTRATION(AnalogOffsetRemoverTest, QuietestWindowStatistic)
+CXXTEST_TEST_REGISTRATION(AnalogOffsetRemoverTest, QuietestWindowChannelLabels)
+CXXTEST_TEST_REGISTRATION(AnalogOffsetRemoverTest, QuietestWindowShortSignal)
+CXXTEST_TEST_REGISTRATION(AnalogOffsetRemoverTest, QuietestWindowIncremental)
+CXXTEST_TEST_REGISTRATION(AnalogOffsetRemoverTest, QuietestWindowIncrementalNewTrial)
 
 #endif // AnalogOffsetRemoverTest_h
\ No newline at end of file
@@ -1864,6 +1864,59 @@ CXXTEST_SUITE(C3DFileWriterTest)
     
     TS_ASSERT(acq->GetAnalog(0)->GetValues().cwiseAbs().maxCoeff() <= 1e-5);
   };
+  
+  CXXTEST_TEST(OutputRecycling)
+  {
+    btk::AcquisitionFileWriter::Pointer writer = btk::AcquisitionFileWriter::New();
+    for (int i = 0 ; i < 2 ; ++i)
+    {
+      btk::Acquisition::Pointer acq = btk::Acquisition::New();
+      acq->Init(3,20,2,2);
+      acq->SetPointFrequency(100.0);
+      acq->GetPoint(0)->SetLabel("RASI" + btk::ToString(i));
+      acq->GetPoint(1)->GetValues().setConstant(static_cast<double>(i + 1));
+      acq->GetAnalog(1)->GetValues().setConstant(0.5 * static_cast<double>(i));
+      writer->SetInput(acq);
+      writer->SetFilename(C3DFilePathOUT + "OutputRecycling" + btk::ToString(i) + ".c3d");
+      writer->Update();
+    }
+    
+    btk::AcquisitionFileReader::Pointer reader = btk::AcquisitionFileReader::New();
+    TS_ASSERT_EQUALS(reader->GetOutputRecycling(), false);
+    reader->SetOutputRecycling(true);
+    reader->SetFilename(C3DFilePathOUT + "OutputRecycling0.c3d");
+    reader->Update();
+    btk::Acquisition::Pointer acq = reader->GetOutput();
+    TS_ASSERT_EQUALS(acq->GetMeasureRecycling(), true);
+    btk::Point* point = acq->GetPoint(1).get();
+    const double* values = acq->GetPoint(1)->GetValues().data();
+    btk::Analog* analog = acq->GetAnalog(1).get();
+    btk::Point::Pointer kept = acq->GetPoint(2);
+    
+    reader->SetFilename(C3DFilePathOUT + "OutputRecycling1.c3d");
+    reader->Update();
+    TS_ASSERT_EQUALS(reader->GetOutput().get(), acq.get());
+    TS_ASSERT_EQUALS(acq->GetPointNumber(), 3);
+    TS_ASSERT_EQUALS(acq->GetAnalogNumber(), 2);
+    TS_ASSERT_EQUALS(acq->GetPoint(0)->GetLabel(), "RASI1");
+    TS_ASSERT_EQUALS(acq->GetPoint(1).get(), point);
+    TS_ASSERT_EQUALS(acq->GetPoint(1)->GetValues().data(), values);
+    TS_ASSERT_EQUALS(acq->GetPoint(1)->GetParent(), acq.get());
+    TS_ASSERT_DELTA(acq->GetPoint(1)->GetValues().maxCoeff(), 2.0, 1e-4);
+    TS_ASSERT_DELTA(acq->GetPoint(1)->GetValues().minCoeff(), 2.0, 1e-4);
+    TS_ASSERT_EQUALS(acq->GetAnalog(1).get(), analog);
+    TS_ASSERT_DELTA(acq->GetAnalog(1)->GetValues().minCoeff(), 0.5, 1e-3);
+    // The point kept by the user is not modified.
+    TS_ASSERT(acq->GetPoint(2) != kept);
+    TS_ASSERT_EQUALS(kept->GetFrameNumber(), 20);
+    
+    reader->SetOutputRecycling(false);
+    reader->SetFilename(C3DFilePathOUT + "OutputRecycling0.c3d");
+    reader->Update();
+    TS_ASSERT_EQUALS(acq->GetMeasureRecycling(), false);
+    TS_ASSERT_EQUALS(acq->GetPoint(0)->GetLabel(), "RASI0");
+    TS_ASSERT_DELTA(acq->GetPoint(1)->GetValues().maxCoeff(), 1.0, 1e-4);
+  };
 };
 
 CXXTEST_SUITE_REGISTRATION(C3DFileWriterTest)
@@ -1909,4 +1962,5 @@ CXXTEST_TEST_REGISTRATION(C3DFileWriterTest, InternalsUpdateUpdateMetaDataBased)
 CXXTEST_TEST_REGISTRATION(C3DFileWriterTest, InternalsUpdateUpdateMetaDataBased_EventsHeader)
 CXXTEST_TEST_REGISTRATION(C3DFileWriterTest, AnalogOffsetStoredAsReal_12Bits)
 CXXTEST_TEST_REGISTRATION(C3DFileWriterTest, AnalogOffsetStoredAsReal_16Bits)
+CXXTEST_TEST_REGISTRATION(C3DFileWriterTest, OutputRecycling)
 #endif
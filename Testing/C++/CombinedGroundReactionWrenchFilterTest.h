@@ -0,0 +1,163 @@
+#ifndef CombinedGroundReactionWrenchFilterTest_h
+#define CombinedGroundReactionWrenchFilterTest_h
+
+#include <btkCombinedGroundReactionWrenchFilter.h>
+
+#include <Eigen/Geometry>
+
+CXXTEST_SUITE(CombinedGroundReactionWrenchFilterTest)
+{
+  CXXTEST_TEST(NoInput)
+  {
+    btk::CombinedGroundReactionWrenchFilter::Pointer cgrwf = btk::CombinedGroundReactionWrenchFilter::New();
+    cgrwf->SetInput(btk::WrenchCollection::New());
+    cgrwf->Update();
+    TS_ASSERT_EQUALS(cgrwf->GetOutput()->GetForce()->GetFrameNumber(), 0);
+  };
+  
+  CXXTEST_TEST(TwoPlates)
+  {
+    btk::Wrench::Pointer w1 = btk::Wrench::New(3);
+    w1->GetForce()->GetValues().col(2).setConstant(100.0);
+    w1->GetPosition()->GetValues().col(2).setConstant(5.0);
+    btk::Wrench::Pointer w2 = btk::Wrench::New(3);
+    w2->GetForce()->GetValues().col(2).setConstant(300.0);
+    w2->GetPosition()->GetValues().col(0).setConstant(1000.0);
+    w2->GetPosition()->GetValues().col(2).setConstant(5.0);
+    w2->GetMoment()->GetValues().col(2).setConstant(2.0);
+    // No force on the second frame
+    w1->GetForce()->GetValues().row(1).setZero();
+    w2->GetForce()->GetValues().row(1).setZero();
+    // Small force on the third frame
+    w1->GetForce()->GetValues()(2,2) = 1.0;
+    w2->GetForce()->GetValues()(2,2) = 3.0;
+    btk::WrenchCollection::Pointer input = btk::WrenchCollection::New();
+    input->InsertItem(w1);
+    input->InsertItem(w2);
+    
+    btk::CombinedGroundReactionWrenchFilter::Pointer cgrwf = btk::CombinedGroundReactionWrenchFilter::New();
+    cgrwf->SetInput(input);
+    btk::Wrench::Pointer output = cgrwf->GetOutput();
+    output->Update();
+    
+    TS_ASSERT_EQUALS(output->GetForce()->GetFrameNumber(), 3);
+    TS_ASSERT_DELTA(output->GetForce()->GetValues()(0,2), 400.0, 1e-15);
+    TS_ASSERT_DELTA(output->GetPosition()->GetValues()(0,0), 750.0, 1e-10);
+    TS_ASSERT_DELTA(output->GetPosition()->GetValues()(0,1), 0.0, 1e-10);
+    TS_ASSERT_DELTA(output->GetPosition()->GetValues()(0,2), 5.0, 1e-15);
+    TS_ASSERT_EQUALS(output->GetPosition()->GetResiduals()(0), 0.0);
+    TS_ASSERT_DELTA(output->GetMoment()->GetValues()(0,0), 0.0, 1e-10);
+    TS_ASSERT_DELTA(output->GetMoment()->GetValues()(0,1), 0.0, 1e-10);
+    TS_ASSERT_DELTA(output->GetMoment()->GetValues()(0,2), 2.0, 1e-10);
+    TS_ASSERT_EQUALS(output->GetPosition()->GetResiduals()(1), -1.0);
+    TS_ASSERT_DELTA(output->GetPosition()->GetValues()(2,0), 750.0, 1e-10);
+    TS_ASSERT_EQUALS(output->GetPosition()->GetResiduals()(2), 0.0);
+    
+    cgrwf->SetThresholdValue(5.0);
+    cgrwf->SetThresholdState(true);
+    output->Update();
+    TS_ASSERT_EQUALS(output->GetPosition()->GetResiduals()(0), 0.0);
+    TS_ASSERT_EQUALS(output->GetPosition()->GetResiduals()(1), -1.0);
+    TS_ASSERT_EQUALS(output->GetPosition()->GetResiduals()(2), -1.0);
+    TS_ASSERT_DELTA(output->GetPosition()->GetValues()(2,0), 0.0, 1e-15);
+    TS_ASSERT_DELTA(output->GetPosition()->GetValues()(2,2), 5.0, 1e-15);
+    // Moment expressed at (0,0,5)
+    TS_ASSERT_DELTA(output->GetMoment()->GetValues()(2,1), -3000.0, 1e-10);
+    TS_ASSERT_DELTA(output->GetMoment()->GetValues()(2,2), 2.0, 1e-10);
+  };
+  
+  CXXTEST_TEST(InvalidPosition)
+  {
+    btk::Wrench::Pointer w1 = btk::Wrench::New(2);
+    w1->GetForce()->GetValues().col(2).setConstant(100.0);
+    w1->GetPosition()->GetValues().col(0).setConstant(200.0);
+    w1->GetPosition()->GetValues().col(2).setConstant(5.0);
+    // Unloaded second plate: false PWA set to zero
+    btk::Wrench::Pointer w2 = btk::Wrench::New(2);
+    w2->GetPosition()->GetResiduals().setConstant(-1.0);
+    // No valid position on the second frame
+    w1->GetForce()->GetValues().row(1).setZero();
+    w1->GetPosition()->GetValues().row(1).setZero();
+    w1->GetPosition()->GetResiduals()(1) = -1.0;
+    btk::WrenchCollection::Pointer input = btk::WrenchCollection::New();
+    input->InsertItem(w1);
+    input->InsertItem(w2);
+    
+    btk::CombinedGroundReactionWrenchFilter::Pointer cgrwf = btk::CombinedGroundReactionWrenchFilter::New();
+    cgrwf->SetInput(input);
+    btk::Wrench::Pointer output = cgrwf->GetOutput();
+    output->Update();
+    
+    TS_ASSERT_DELTA(output->GetPosition()->GetValues()(0,0), 200.0, 1e-10);
+    TS_ASSERT_DELTA(output->GetPosition()->GetValues()(0,2), 5.0, 1e-15);
+    TS_ASSERT_EQUALS(output->GetPosition()->GetResiduals()(0), 0.0);
+    TS_ASSERT_DELTA(output->GetMoment()->GetValues()(0,1), 0.0, 1e-10);
+    TS_ASSERT_DELTA(output->GetPosition()->GetValues()(1,2), 0.0, 1e-15);
+    TS_ASSERT_EQUALS(output->GetPosition()->GetResiduals()(1), -1.0);
+  };
+  
+  CXXTEST_TEST(FrameNumberMismatch)
+  {
+    btk::WrenchCollection::Pointer input = btk::WrenchCollection::New();
+    input->InsertItem(btk::Wrench::New(10));
+    input->InsertItem(btk::Wrench::New(10));
+    btk::CombinedGroundReactionWrenchFilter::Pointer cgrwf = btk::CombinedGroundReactionWrenchFilter::New();
+    cgrwf->SetInput(input);
+    cgrwf->Update();
+    TS_ASSERT_EQUALS(cgrwf->GetOutput()->GetForce()->GetFrameNumber(), 10);
+    input->SetItem(1, btk::Wrench::New(5));
+    cgrwf->Update();
+    TS_ASSERT_EQUALS(cgrwf->GetOutput()->GetForce()->GetFrameNumber(), 0);
+    TS_ASSERT_EQUALS(cgrwf->GetOutput()->GetPosition()->GetFrameNumber(), 0);
+  };
+  
+  CXXTEST_TEST(Resultant)
+  {
+    const int frameNumber = 50;
+    btk::WrenchCollection::Pointer input = btk::WrenchCollection::New();
+    for (int i = 0 ; i < 4 ; ++i)
+    {
+      btk::Wrench::Pointer w = btk::Wrench::New(frameNumber);
+      w->GetForce()->GetValues().setRandom();
+      w->GetForce()->GetValues().col(2).array() += 2.0;
+      w->GetMoment()->GetValues().setRandom();
+      w->GetPosition()->GetValues().setRandom();
+      w->GetPosition()->GetValues().col(2).setConstant(-2.5);
+      input->InsertItem(w);
+    }
+    
+    btk::CombinedGroundReactionWrenchFilter::Pointer cgrwf = btk::CombinedGroundReactionWrenchFilter::New();
+    cgrwf->SetInput(input);
+    btk::Wrench::Pointer output = cgrwf->GetOutput();
+    output->Update();
+    
+    for (int i = 0 ; i < frameNumber ; ++i)
+    {
+      Eigen::Vector3d F = Eigen::Vector3d::Zero(), Mo = Eigen::Vector3d::Zero();
+      for (btk::WrenchCollection::ConstIterator it = input->Begin() ; it != input->End() ; ++it)
+      {
+        Eigen::Vector3d f = (*it)->GetForce()->GetValues().row(i).transpose();
+        Eigen::Vector3d p = (*it)->GetPosition()->GetValues().row(i).transpose();
+        F += f;
+        Mo += (*it)->GetMoment()->GetValues().row(i).transpose() + p.cross(f);
+      }
+      Eigen::Vector3d f = output->GetForce()->GetValues().row(i).transpose();
+      Eigen::Vector3d m = output->GetMoment()->GetValues().row(i).transpose();
+      Eigen::Vector3d p = output->GetPosition()->GetValues().row(i).transpose();
+      TS_ASSERT(f.isApprox(F));
+      TS_ASSERT(Mo.isApprox(m + p.cross(f)));
+      TS_ASSERT_DELTA(p.z(), -2.5, 1e-15);
+      // The moment at the PWA is colinear with the force.
+      TS_ASSERT_DELTA(m.cross(f).norm(), 0.0, 1e-10);
+    }
+  };
+};
+
+CXXTEST_SUITE_REGISTRATION(CombinedGroundReactionWrenchFilterTest)
+CXXTEST_TEST_REGISTRATION(CombinedGroundReactionWrenchFilterTest, NoInput)
+CXXTEST_TEST_REGISTRATION(CombinedGroundReactionWrenchFilterTest, TwoPlates)
+CXXTEST_TEST_REGISTRATION(CombinedGroundReactionWrenchFilterTest, InvalidPosition)
+CXXTEST_TEST_REGISTRATION(CombinedGroundReactionWrenchFilterTest, FrameNumberMismatch)
+CXXTEST_TEST_REGISTRATION(CombinedGroundReactionWrenchFilterTest, Resultant)
+
+#endif // CombinedGroundReactionWrenchFilterTest_h
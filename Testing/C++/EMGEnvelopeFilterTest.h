@@ -0,0 +1,191 @@
+#ifndef EMGEnvelopeFilterTest_h
+#define EMGEnvelopeFilterTest_h
+
+#include <btkEMGEnvelopeFilter.h>
+#include <btkConvert.h>
+
+#include <btkEigen/SignalProcessing/FiltFilt.h>
+#include <btkEigen/SignalProcessing/IIRFilterDesign.h>
+
+static void generateEMGAcquisition(btk::Acquisition::Pointer acq, int frameNumber, int channelNumber)
+{
+  acq->Init(0, frameNumber, channelNumber, 10);
+  acq->SetPointFrequency(100.0); // Analog sample frequency: 1000 Hz
+  for (int i = 0 ; i < channelNumber ; ++i)
+  {
+    btk::Analog::Pointer analog = acq->GetAnalog(i);
+    analog->SetLabel("EMG" + btk::ToString(i+1));
+    analog->SetGain(btk::Analog::PlusMinus5);
+    for (int j = 0 ; j < analog->GetFrameNumber() ; ++j)
+    {
+      const double t = static_cast<double>(j) / 1000.0;
+      // Burst modulated by a slow sine wave with a baseline offset 
+      analog->GetValues().coeffRef(j) = 0.1 + (1.0 + static_cast<double>(i)) * std::sin(2.0 * M_PI * t) * std::sin(2.0 * M_PI * (80.0 + 10.0 * i) * t);
+    }
+  }
+};
+
+CXXTEST_SUITE(EMGEnvelopeFilterTest)
+{
+  CXXTEST_TEST(Constructor)
+  {
+    btk::EMGEnvelopeFilter::Pointer filter = btk::EMGEnvelopeFilter::New();
+    TS_ASSERT_EQUALS(filter->GetLabels().empty(), true);
+    TS_ASSERT_EQUALS(filter->GetGain(), btk::Analog::Unknown);
+    TS_ASSERT_EQUALS(filter->GetBandPassFilterEnabled(), true);
+    TS_ASSERT_EQUALS(filter->GetBandPassLowFrequency(), 20.0);
+    TS_ASSERT_EQUALS(filter->GetBandPassHighFrequency(), 450.0);
+    TS_ASSERT_EQUALS(filter->GetBandPassFilterOrder(), 2);
+    TS_ASSERT_EQUALS(filter->GetEnvelopeMethod(), btk::EMGEnvelopeFilter::LowPass);
+    TS_ASSERT_EQUALS(filter->GetLowPassFrequency(), 6.0);
+    TS_ASSERT_EQUALS(filter->GetLowPassFilterOrder(), 2);
+    TS_ASSERT_EQUALS(filter->GetMovingRMSWindow(), 0.1);
+    TS_ASSERT_EQUALS(filter->GetNormalization(), btk::EMGEnvelopeFilter::NoNormalization);
+    TS_ASSERT_EQUALS(filter->GetOutput()->GetItemNumber(), 0);
+  };
+  
+  CXXTEST_TEST(SelectionByGain)
+  {
+    btk::Acquisition::Pointer acq = btk::Acquisition::New();
+    generateEMGAcquisition(acq, 200, 3);
+    acq->GetAnalog(1)->SetGain(btk::Analog::PlusMinus10);
+    
+    btk::EMGEnvelopeFilter::Pointer filter = btk::EMGEnvelopeFilter::New();
+    filter->SetInput(acq);
+    filter->Update();
+    TS_ASSERT_EQUALS(filter->GetOutput()->GetItemNumber(), 3);
+    
+    filter->SetGain(btk::Analog::PlusMinus5);
+    filter->Update();
+    TS_ASSERT_EQUALS(filter->GetOutput()->GetItemNumber(), 2);
+    TS_ASSERT_EQUALS(filter->GetOutput()->GetItem(0)->GetLabel(), "EMG1");
+    TS_ASSERT_EQUALS(filter->GetOutput()->GetItem(1)->GetLabel(), "EMG3");
+    TS_ASSERT_EQUALS(filter->GetOutput()->GetItem(1)->GetFrameNumber(), 2000);
+  };
+  
+  CXXTEST_TEST(SelectionByLabel)
+  {
+    btk::Acquisition::Pointer acq = btk::Acquisition::New();
+    generateEMGAcquisition(acq, 200, 3);
+    
+    std::list<std::string> labels;
+    labels.push_back("EMG3");
+    labels.push_back("Foo");
+    labels.push_back("EMG2");
+    btk::EMGEnvelopeFilter::Pointer filter = btk::EMGEnvelopeFilter::New();
+    filter->SetInput(acq);
+    filter->SetLabels(labels);
+    filter->SetGain(btk::Analog::PlusMinus10); // Not used as some labels are given
+    filter->Update();
+    TS_ASSERT_EQUALS(filter->GetOutput()->GetItemNumber(), 2);
+    TS_ASSERT_EQUALS(filter->GetOutput()->GetItem(0)->GetLabel(), "EMG3");
+    TS_ASSERT_EQUALS(filter->GetOutput()->GetItem(1)->GetLabel(), "EMG2");
+  };
+  
+  CXXTEST_TEST(LowPass)
+  {
+    btk::Acquisition::Pointer acq = btk::Acquisition::New();
+    generateEMGAcquisition(acq, 200, 4);
+    
+    btk::EMGEnvelopeFilter::Pointer filter = btk::EMGEnvelopeFilter::New();
+    filter->SetInput(acq);
+    filter->Update();
+    TS_ASSERT_EQUALS(filter->GetOutput()->GetItemNumber(), 4);
+    
+    // Same computation channel by channel
+    Eigen::Matrix<double,Eigen::Dynamic,1> b, a;
+    double wn[2] = {20.0 / 500.0, 450.0 / 500.0};
+    btkEigen::butter(&b, &a, 2, wn, btkEigen::BandPass);
+    Eigen::Matrix<double,Eigen::Dynamic,1> b2, a2;
+    int n = 4; double wn2 = 6.0 / 500.0;
+    btkEigen::adjustZeroLagButterworth(n, wn2);
+    btkEigen::butter(&b2, &a2, n, wn2, btkEigen::LowPass);
+    for (int i = 0 ; i < 4 ; ++i)
+    {
+      Eigen::Matrix<double,Eigen::Dynamic,1> x = btkEigen::filtfilt(b, a, acq->GetAnalog(i)->GetValues()).cwiseAbs();
+      x = btkEigen::filtfilt(b2, a2, x);
+      const btk::Analog::Values& y = filter->GetOutput()->GetItem(i)->GetValues();
+      TS_ASSERT_EQUALS(y.rows(), x.rows());
+      for (int j = 0 ; j < x.rows() ; ++j)
+        TSM_ASSERT_DELTA("Channel #" + btk::ToString(i) + " - Sample #" + btk::ToString(j), y.coeff(j), x.coeff(j), 1e-12);
+    }
+    // The envelope follows the slow modulation (maximum at 0.25 s and 0.75 s, minimum at 0.5 s)
+    const btk::Analog::Values& y = filter->GetOutput()->GetItem(1)->GetValues();
+    TS_ASSERT(y.coeff(250) > 5.0 * y.coeff(500));
+    TS_ASSERT(y.coeff(750) > 5.0 * y.coeff(500));
+  };
+  
+  CXXTEST_TEST(MovingRMS)
+  {
+    btk::Acquisition::Pointer acq = btk::Acquisition::New();
+    acq->Init(0, 100, 2, 10);
+    acq->SetPointFrequency(100.0);
+    for (int j = 0 ; j < 1000 ; ++j)
+    {
+      acq->GetAnalog(0)->GetValues().coeffRef(j) = 2.0 * std::sin(2.0 * M_PI * 50.0 * static_cast<double>(j) / 1000.0);
+      acq->GetAnalog(1)->GetValues().coeffRef(j) = (j % 2 == 0) ? 3.0 : -3.0;
+    }
+    
+    btk::EMGEnvelopeFilter::Pointer filter = btk::EMGEnvelopeFilter::New();
+    filter->SetInput(acq);
+    filter->SetBandPassFilterEnabled(false);
+    filter->SetEnvelopeMethod(btk::EMGEnvelopeFilter::MovingRMS);
+    filter->SetMovingRMSWindow(0.1);
+    filter->Update();
+    TS_ASSERT_EQUALS(filter->GetOutput()->GetItemNumber(), 2);
+    const btk::Analog::Values& y0 = filter->GetOutput()->GetItem(0)->GetValues();
+    const btk::Analog::Values& y1 = filter->GetOutput()->GetItem(1)->GetValues();
+    for (int j = 0 ; j < 1000 ; ++j)
+    {
+      TS_ASSERT_DELTA(y1.coeff(j), 3.0, 1e-12);
+      if ((j >= 50) && (j < 950))
+        TS_ASSERT_DELTA(y0.coeff(j), std::sqrt(2.0), 1e-12);
+    }
+  };
+  
+  CXXTEST_TEST(Normalization)
+  {
+    btk::Acquisition::Pointer acq = btk::Acquisition::New();
+    generateEMGAcquisition(acq, 200, 2);
+    
+    btk::EMGEnvelopeFilter::Pointer filter = btk::EMGEnvelopeFilter::New();
+    filter->SetInput(acq);
+    filter->Update();
+    const double peak0 = filter->GetOutput()->GetItem(0)->GetValues().maxCoeff();
+    const double peak1 = filter->GetOutput()->GetItem(1)->GetValues().maxCoeff();
+    
+    filter->SetNormalization(btk::EMGEnvelopeFilter::PeakNormalization);
+    filter->Update();
+    TS_ASSERT_DELTA(filter->GetOutput()->GetItem(0)->GetValues().maxCoeff(), 1.0, 1e-15);
+    TS_ASSERT_DELTA(filter->GetOutput()->GetItem(1)->GetValues().maxCoeff(), 1.0, 1e-15);
+    
+    filter->SetNormalization(btk::EMGEnvelopeFilter::ReferenceNormalization);
+    filter->SetReferenceValue("EMG1", 2.0 * peak0);
+    TS_ASSERT_EQUALS(filter->GetReferenceValue("EMG1"), 2.0 * peak0);
+    TS_ASSERT_EQUALS(filter->GetReferenceValue("EMG2"), 0.0);
+    filter->Update();
+    TS_ASSERT_DELTA(filter->GetOutput()->GetItem(0)->GetValues().maxCoeff(), 0.5, 1e-15);
+    TS_ASSERT_DELTA(filter->GetOutput()->GetItem(1)->GetValues().maxCoeff(), peak1, 1e-15);
+  };
+  
+  CXXTEST_TEST(NoFrequency)
+  {
+    btk::Acquisition::Pointer acq = btk::Acquisition::New();
+    acq->Init(0, 200, 2, 10);
+    btk::EMGEnvelopeFilter::Pointer filter = btk::EMGEnvelopeFilter::New();
+    filter->SetInput(acq);
+    filter->Update();
+    TS_ASSERT_EQUALS(filter->GetOutput()->GetItemNumber(), 0);
+  };
+};
+
+CXXTEST_SUITE_REGISTRATION(EMGEnvelopeFilterTest)
+CXXTEST_TEST_REGISTRATION(EMGEnvelopeFilterTest, Constructor)
+CXXTEST_TEST_REGISTRATION(EMGEnvelopeFilterTest, SelectionByGain)
+CXXTEST_TEST_REGISTRATION(EMGEnvelopeFilterTest, SelectionByLabel)
+CXXTEST_TEST_REGISTRATION(EMGEnvelopeFilterTest, LowPass)
+CXXTEST_TEST_REGISTRATION(EMGEnvelopeFilterTest, MovingRMS)
+CXXTEST_TEST_REGISTRATION(EMGEnvelopeFilterTest, Normalization)
+CXXTEST_TEST_REGISTRATION(EMGEnvelopeFilterTest, NoFrequency)
+
+#endif
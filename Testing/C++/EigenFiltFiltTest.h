@@ -123,6 +123,28 @@ CXXTEST_SUITE(EigenFiltFiltTest)
       TSM_ASSERT_DELTA("Row #" + btk::ToString(i), signal(i), ref(i), 5e-15); // 5e-15: Due to the differences in the computation of the initial state of the filter?
     }
   }
+  
+  CXXTEST_TEST(FiltFiltMultichannel)
+  {
+    Eigen::Matrix<double,Eigen::Dynamic,1> x;
+    generateRawData(x);
+    Eigen::Matrix<double,Eigen::Dynamic,Eigen::Dynamic> X(3,x.rows());
+    X.row(0) = x.transpose();
+    X.row(1) = 2.0 * x.transpose();
+    X.row(2) = x.reverse().transpose();
+    Eigen::Matrix<double,Eigen::Dynamic,1> a,b;
+    btkEigen::butter(&b, &a, 7, 0.4);
+    Eigen::Matrix<double,Eigen::Dynamic,Eigen::Dynamic> Y = X;
+    btkEigen::filtfilt_multichannel(b, a, &Y);
+    TS_ASSERT_EQUALS(Y.rows(), 3);
+    TS_ASSERT_EQUALS(Y.cols(), x.rows());
+    for (int i = 0 ; i < 3 ; ++i)
+    {
+      Eigen::Matrix<double,Eigen::Dynamic,1> y = btkEigen::filtfilt(b, a, Eigen::Matrix<double,Eigen::Dynamic,1>(X.row(i).transpose()));
+      for (int j = 0 ; j < x.rows() ; ++j)
+        TSM_ASSERT_DELTA("Channel #" + btk::ToString(i) + " - Sample #" + btk::ToString(j), Y.coeff(i,j), y.coeff(j), 1e-14);
+    }
+  };
 };
 
 CXXTEST_SUITE_REGISTRATION(EigenFiltFiltTest)
@@ -131,5 +153,6 @@ CXXTEST_TEST_REGISTRATION(EigenFiltFiltTest, Butterworth_LowPass_7_0Dot4)
 CXXTEST_TEST_REGISTRATION(EigenFiltFiltTest, FiltFiltWindowAverage_FixedSize)
 CXXTEST_TEST_REGISTRATION(EigenFiltFiltTest, FiltFiltOrder2_FixedSize)
 CXXTEST_TEST_REGISTRATION(EigenFiltFiltTest, FiltFiltECG_FixedSize)
+CXXTEST_TEST_REGISTRATION(EigenFiltFiltTest, FiltFiltMultichannel)
 
 #endif // EigenFiltFiltTest_h
\ No newline at end of file
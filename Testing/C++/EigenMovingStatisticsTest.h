@@ -0,0 +1,201 @@
+#ifndef EigenMovingStatisticsTest_h
+#define EigenMovingStatisticsTest_h
+
+#include <btkEigen/SignalProcessing/MovingStatistics.h>
+#include <btkConvert.h>
+
+#include <limits>
+
+CXXTEST_SUITE(EigenMovingStatisticsTest)
+{
+  CXXTEST_TEST(MovMeanOdd)
+  {
+    Eigen::Matrix<double,Eigen::Dynamic,1> x(6), y;
+    x << 1.0, 2.0, 3.0, 4.0, 5.0, 6.0;
+    btkEigen::movmean(&y, x, 3);
+    // Matlab: movmean([1:6]', 3)
+    Eigen::Matrix<double,Eigen::Dynamic,1> ref(6);
+    ref << 1.5, 2.0, 3.0, 4.0, 5.0, 5.5;
+    TS_ASSERT_EQUALS(y.rows(), 6);
+    for (int i = 0 ; i < 6 ; ++i)
+      TSM_ASSERT_DELTA("Sample #" + btk::ToString(i), y.coeff(i), ref.coeff(i), 1e-15);
+  };
+  
+  CXXTEST_TEST(MovMeanEven)
+  {
+    Eigen::Matrix<double,Eigen::Dynamic,Eigen::Dynamic> x(6,2), y;
+    x << 1.0, 6.0,
+         2.0, 5.0,
+         3.0, 4.0,
+         4.0, 3.0,
+         5.0, 2.0,
+         6.0, 1.0;
+    btkEigen::movmean(&y, x, 4);
+    // Matlab: movmean([1:6;6:-1:1]', 4)
+    Eigen::Matrix<double,Eigen::Dynamic,Eigen::Dynamic> ref(6,2);
+    ref << 1.5, 5.5,
+           2.0, 5.0,
+           2.5, 4.5,
+           3.5, 3.5,
+           4.5, 2.5,
+           5.0, 2.0;
+    TS_ASSERT_EQUALS(y.rows(), 6);
+    TS_ASSERT_EQUALS(y.cols(), 2);
+    for (int i = 0 ; i < 6 ; ++i)
+    {
+      TSM_ASSERT_DELTA("Sample #" + btk::ToString(i), y.coeff(i,0), ref.coeff(i,0), 1e-15);
+      TSM_ASSERT_DELTA("Sample #" + btk::ToString(i), y.coeff(i,1), ref.coeff(i,1), 1e-15);
+    }
+  };
+  
+  CXXTEST_TEST(MovMeanLargeWindow)
+  {
+    Eigen::Matrix<double,Eigen::Dynamic,1> x(4), y;
+    x << 1.0, 2.0, 3.0, 6.0;
+    btkEigen::movmean(&y, x, 9);
+    for (int i = 0 ; i < 4 ; ++i)
+      TSM_ASSERT_DELTA("Sample #" + btk::ToString(i), y.coeff(i), 3.0, 1e-15);
+  };
+  
+  CXXTEST_TEST(MovRMS)
+  {
+    Eigen::Matrix<double,Eigen::Dynamic,1> x(5), y;
+    x << 3.0, -4.0, 0.0, 4.0, -3.0;
+    btkEigen::movrms(&y, x, 2);
+    Eigen::Matrix<double,Eigen::Dynamic,1> ref(5);
+    ref << 3.0, std::sqrt(12.5), std::sqrt(8.0), std::sqrt(8.0), std::sqrt(12.5);
+    for (int i = 0 ; i < 5 ; ++i)
+      TSM_ASSERT_DELTA("Sample #" + btk::ToString(i), y.coeff(i), ref.coeff(i), 1e-15);
+  };
+  
+  CXXTEST_TEST(MovVarStd)
+  {
+    Eigen::Matrix<double,Eigen::Dynamic,Eigen::Dynamic> x(50,3), y, z;
+    for (int i = 0 ; i < 50 ; ++i)
+    {
+      x(i,0) = std::sin(0.3 * i);
+      x(i,1) = 1.0e6 + std::cos(0.7 * i); // Large offset
+      x(i,2) = static_cast<double>(i % 7);
+    }
+    btkEigen::movvar(&y, x, 5);
+    btkEigen::movstd(&z, x, 5);
+    TS_ASSERT_EQUALS(y.rows(), 50);
+    TS_ASSERT_EQUALS(y.cols(), 3);
+    for (int j = 0 ; j < 3 ; ++j)
+    {
+      for (int i = 0 ; i < 50 ; ++i)
+      {
+        const int lo = std::max(0, i - 2), hi = std::min(49, i + 2), n = hi - lo + 1;
+        Eigen::Matrix<double,Eigen::Dynamic,1> w = x.block(lo,j,n,1);
+        const double ref = (w.array() - w.mean()).square().sum() / static_cast<double>(n - 1);
+        TSM_ASSERT_DELTA("Column #" + btk::ToString(j) + " - Sample #" + btk::ToString(i), y(i,j), ref, 1e-9);
+        TSM_ASSERT_DELTA("Column #" + btk::ToString(j) + " - Sample #" + btk::ToString(i), z(i,j), std::sqrt(ref), 1e-7);
+      }
+    }
+    btkEigen::movvar(&y, x.col(0), 1);
+    TS_ASSERT(y.isZero());
+  };
+  
+  CXXTEST_TEST(MovMeanVarNaN)
+  {
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    Eigen::Matrix<double,Eigen::Dynamic,1> x(8), y, z, w;
+    x << 1.0, nan, 3.0, 4.0, nan, nan, nan, 8.0;
+    btkEigen::movmean(&y, x, 3);
+    btkEigen::movvar(&z, x, 3);
+    btkEigen::movrms(&w, x, 3);
+    // Matlab: movmean([1 NaN 3 4 NaN NaN NaN 8]', 3, 'omitnan')
+    Eigen::Matrix<double,Eigen::Dynamic,1> refMean(8);
+    refMean << 1.0, 2.0, 3.5, 3.5, 4.0, nan, 8.0, 8.0;
+    // Matlab: movvar([1 NaN 3 4 NaN NaN NaN 8]', 3, 'omitnan')
+    Eigen::Matrix<double,Eigen::Dynamic,1> refVar(8);
+    refVar << 0.0, 2.0, 0.5, 0.5, 0.0, nan, 0.0, 0.0;
+    Eigen::Matrix<double,Eigen::Dynamic,1> refRMS(8);
+    refRMS << 1.0, std::sqrt(5.0), std::sqrt(12.5), std::sqrt(12.5), 4.0, nan, 8.0, 8.0;
+    for (int i = 0 ; i < 8 ; ++i)
+    {
+      if (i == 5)
+      {
+        TSM_ASSERT("Sample #5", y.coeff(i) != y.coeff(i));
+        TSM_ASSERT("Sample #5", z.coeff(i) != z.coeff(i));
+        TSM_ASSERT("Sample #5", w.coeff(i) != w.coeff(i));
+        continue;
+      }
+      TSM_ASSERT_DELTA("Sample #" + btk::ToString(i), y.coeff(i), refMean.coeff(i), 1e-12);
+      TSM_ASSERT_DELTA("Sample #" + btk::ToString(i), z.coeff(i), refVar.coeff(i), 1e-12);
+      TSM_ASSERT_DELTA("Sample #" + btk::ToString(i), w.coeff(i), refRMS.coeff(i), 1e-12);
+    }
+  };
+  
+  CXXTEST_TEST(MovMedian)
+  {
+    Eigen::Matrix<double,Eigen::Dynamic,1> x(8), y;
+    x << 4.0, 1.0, 3.0, 3.0, 9.0, 2.0, 7.0, 5.0;
+    btkEigen::movmedian(&y, x, 3);
+    // Matlab: movmedian([4 1 3 3 9 2 7 5]', 3)
+    Eigen::Matrix<double,Eigen::Dynamic,1> ref(8);
+    ref << 2.5, 3.0, 3.0, 3.0, 3.0, 7.0, 5.0, 6.0;
+    for (int i = 0 ; i < 8 ; ++i)
+      TSM_ASSERT_DELTA("Sample #" + btk::ToString(i), y.coeff(i), ref.coeff(i), 1e-15);
+  };
+  
+  CXXTEST_TEST(MovMedianNaN)
+  {
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    Eigen::Matrix<double,Eigen::Dynamic,1> x(8), y;
+    x << 4.0, 1.0, nan, 3.0, 9.0, nan, nan, 5.0;
+    btkEigen::movmedian(&y, x, 3);
+    // Matlab: movmedian([4 1 NaN 3 9 NaN NaN 5]', 3, 'omitnan')
+    Eigen::Matrix<double,Eigen::Dynamic,1> ref(8);
+    ref << 2.5, 2.5, 2.0, 6.0, 6.0, 9.0, 5.0, 5.0;
+    for (int i = 0 ; i < 8 ; ++i)
+      TSM_ASSERT_DELTA("Sample #" + btk::ToString(i), y.coeff(i), ref.coeff(i), 1e-15);
+    x << nan, nan, nan, 3.0, 9.0, 2.0, 7.0, 5.0;
+    btkEigen::movmedian(&y, x, 3);
+    TS_ASSERT(y.coeff(0) != y.coeff(0));
+    TS_ASSERT(y.coeff(1) != y.coeff(1));
+    TS_ASSERT_DELTA(y.coeff(2), 3.0, 1e-15);
+    TS_ASSERT_DELTA(y.coeff(3), 6.0, 1e-15);
+  };
+  
+  CXXTEST_TEST(MovPrctile)
+  {
+    Eigen::Matrix<double,Eigen::Dynamic,Eigen::Dynamic> x(100,2), y;
+    for (int i = 0 ; i < 100 ; ++i)
+    {
+      x(i,0) = std::sin(1.3 * i) * std::cos(0.2 * i);
+      x(i,1) = static_cast<double>((i * 37) % 11); // Many duplicates
+    }
+    const double percentiles[5] = {0.0, 10.0, 50.0, 73.0, 100.0};
+    const int windows[3] = {1, 6, 15};
+    for (int k = 0 ; k < 5 ; ++k)
+    {
+      for (int l = 0 ; l < 3 ; ++l)
+      {
+        btkEigen::movprctile(&y, x, windows[l], percentiles[k]);
+        for (int j = 0 ; j < 2 ; ++j)
+        {
+          for (int i = 0 ; i < 100 ; ++i)
+          {
+            const int lo = std::max(0, i - windows[l] / 2), hi = std::min(99, i + (windows[l] - 1) / 2);
+            Eigen::Matrix<double,Eigen::Dynamic,1> w = x.block(lo,j,hi-lo+1,1);
+            TSM_ASSERT_DELTA("Percentile: " + btk::ToString(percentiles[k]) + " - Window: " + btk::ToString(windows[l]) + " - Column #" + btk::ToString(j) + " - Sample #" + btk::ToString(i), y(i,j), w.percentile(percentiles[k]), 1e-12);
+          }
+        }
+      }
+    }
+  };
+};
+
+CXXTEST_SUITE_REGISTRATION(EigenMovingStatisticsTest)
+CXXTEST_TEST_REGISTRATION(EigenMovingStatisticsTest, MovMeanOdd)
+CXXTEST_TEST_REGISTRATION(EigenMovingStatisticsTest, MovMeanEven)
+CXXTEST_TEST_REGISTRATION(EigenMovingStatisticsTest, MovMeanLargeWindow)
+CXXTEST_TEST_REGISTRATION(EigenMovingStatisticsTest, MovRMS)
+CXXTEST_TEST_REGISTRATION(EigenMovingStatisticsTest, MovVarStd)
+CXXTEST_TEST_REGISTRATION(EigenMovingStatisticsTest, MovMeanVarNaN)
+CXXTEST_TEST_REGISTRATION(EigenMovingStatisticsTest, MovMedian)
+CXXTEST_TEST_REGISTRATION(EigenMovingStatisticsTest, MovMedianNaN)
+CXXTEST_TEST_REGISTRATION(EigenMovingStatisticsTest, MovPrctile)
+
+#endif
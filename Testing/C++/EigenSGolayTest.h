@@ -0,0 +1,74 @@
+#ifndef EigenSGolayTest_h
+#define EigenSGolayTest_h
+
+#include <btkEigen/SignalProcessing/SGolay.h>
+#include <btkConvert.h>
+
+CXXTEST_SUITE(EigenSGolayTest)
+{
+  CXXTEST_TEST(Smoothing_2_5)
+  {
+    Eigen::Matrix<double,Eigen::Dynamic,Eigen::Dynamic> B;
+    btkEigen::sgolay(&B, 2, 5);
+    TS_ASSERT_EQUALS(B.rows(), 5);
+    TS_ASSERT_EQUALS(B.cols(), 5);
+    // Matlab: sgolay(2,5)
+    Eigen::Matrix<double,5,5> ref;
+    ref << 31.0,   9.0,  -3.0,  -5.0,   3.0,
+            9.0,  13.0,  12.0,   6.0,  -5.0,
+           -3.0,  12.0,  17.0,  12.0,  -3.0,
+           -5.0,   6.0,  12.0,  13.0,   9.0,
+            3.0,  -5.0,  -3.0,   9.0,  31.0;
+    ref /= 35.0;
+    for (int i = 0 ; i < 5 ; ++i)
+      for (int j = 0 ; j < 5 ; ++j)
+        TSM_ASSERT_DELTA("Coefficient (" + btk::ToString(i) + "," + btk::ToString(j) + ")", B(i,j), ref(i,j), 1e-14);
+  };
+  
+  CXXTEST_TEST(Derivative_2_5)
+  {
+    Eigen::Matrix<double,Eigen::Dynamic,Eigen::Dynamic> B;
+    btkEigen::sgolay(&B, 2, 5, 1);
+    // Centered first derivative: [-2 -1 0 1 2] / 10
+    TS_ASSERT_DELTA(B(2,0), -0.2, 1e-15);
+    TS_ASSERT_DELTA(B(2,1), -0.1, 1e-15);
+    TS_ASSERT_DELTA(B(2,2), 0.0, 1e-15);
+    TS_ASSERT_DELTA(B(2,3), 0.1, 1e-15);
+    TS_ASSERT_DELTA(B(2,4), 0.2, 1e-15);
+    btkEigen::sgolay(&B, 2, 5, 2);
+    // Centered second derivative: [2 -1 -2 -1 2] / 7
+    TS_ASSERT_DELTA(B(2,0), 2.0 / 7.0, 1e-15);
+    TS_ASSERT_DELTA(B(2,1), -1.0 / 7.0, 1e-15);
+    TS_ASSERT_DELTA(B(2,2), -2.0 / 7.0, 1e-15);
+    TS_ASSERT_DELTA(B(2,3), -1.0 / 7.0, 1e-15);
+    TS_ASSERT_DELTA(B(2,4), 2.0 / 7.0, 1e-15);
+  };
+  
+  CXXTEST_TEST(FiltCubic)
+  {
+    Eigen::Matrix<double,Eigen::Dynamic,Eigen::Dynamic> X(20,2), Y, B;
+    for (int i = 0 ; i < 20 ; ++i)
+    {
+      const double t = static_cast<double>(i);
+      X(i,0) = 0.5 * t * t * t - 2.0 * t + 1.0;
+      X(i,1) = 3.0 * t;
+    }
+    btkEigen::sgolay(&B, 3, 7, 1);
+    btkEigen::sgolayfilt(&Y, X, B);
+    TS_ASSERT_EQUALS(Y.rows(), 20);
+    TS_ASSERT_EQUALS(Y.cols(), 2);
+    for (int i = 0 ; i < 20 ; ++i)
+    {
+      const double t = static_cast<double>(i);
+      TSM_ASSERT_DELTA("Sample #" + btk::ToString(i), Y(i,0), 1.5 * t * t - 2.0, 1e-10);
+      TSM_ASSERT_DELTA("Sample #" + btk::ToString(i), Y(i,1), 3.0, 1e-12);
+    }
+  };
+};
+
+CXXTEST_SUITE_REGISTRATION(EigenSGolayTest)
+CXXTEST_TEST_REGISTRATION(EigenSGolayTest, Smoothing_2_5)
+CXXTEST_TEST_REGISTRATION(EigenSGolayTest, Derivative_2_5)
+CXXTEST_TEST_REGISTRATION(EigenSGolayTest, FiltCubic)
+
+#endif
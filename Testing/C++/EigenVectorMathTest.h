@@ -0,0 +1,119 @@
+#ifndef EigenVectorMathTest_h
+#define EigenVectorMathTest_h
+
+#include <btkEigen/Core/VectorMath.h>
+#include <Eigen/Geometry>
+
+CXXTEST_SUITE(EigenVectorMathTest)
+{
+  CXXTEST_TEST(Atan2Fast)
+  {
+    const double pi = 3.14159265358979323846;
+    double maxErr = 0.0;
+    for (int i = 0 ; i <= 100000 ; ++i)
+    {
+      const double a = -pi + 2.0 * pi * i / 100000.0;
+      for (int j = 1 ; j <= 3 ; ++j)
+      {
+        const double r = std::pow(10.0, 2 * j - 3);
+        const double e = std::fabs(btkEigen::atan2_fast(r * std::sin(a), r * std::cos(a)) - std::atan2(r * std::sin(a), r * std::cos(a)));
+        maxErr = std::max(maxErr, e);
+      }
+    }
+    TS_ASSERT(maxErr <= btkEigen::atan2_fast_max_error);
+  };
+  
+  CXXTEST_TEST(Atan2FastSpecialValues)
+  {
+    const double values[3] = {-1.0, 0.0, 1.0};
+    for (int i = 0 ; i < 3 ; ++i)
+    {
+      for (int j = 0 ; j < 3 ; ++j)
+      {
+        // Exact values on the axes
+        const double tol = ((i == 1) || (j == 1)) ? 1e-15 : btkEigen::atan2_fast_max_error;
+        TS_ASSERT_DELTA(btkEigen::atan2_fast(values[i], values[j]), std::atan2(values[i], values[j]), tol);
+        TS_ASSERT_DELTA(btkEigen::atan2_fast(-values[i], -values[j]), std::atan2(-values[i], -values[j]), tol);
+      }
+    }
+    TS_ASSERT_DELTA(btkEigen::atan2_fast(-0.0, -1.0), std::atan2(-0.0, -1.0), 1e-15);
+    TS_ASSERT_DELTA(btkEigen::atan2_fast(0.0, -1.0), std::atan2(0.0, -1.0), 1e-15);
+    TS_ASSERT_DELTA(btkEigen::atan2_fast(-0.0, -0.0), std::atan2(-0.0, -0.0), 1e-15);
+    // Same values with the vectorized version
+    double y[12] = {-1.0, -1.0, -1.0, 0.0, 0.0, 0.0, 1.0, 1.0, 1.0, -0.0, 0.0, -0.0};
+    double x[12] = {-1.0, 0.0, 1.0, -1.0, 0.0, 1.0, -1.0, 0.0, 1.0, -1.0, -1.0, -0.0};
+    double out[12];
+    btkEigen::vatan2(out, y, x, 12);
+    for (int i = 0 ; i < 12 ; ++i)
+    {
+      TS_ASSERT_DELTA(out[i], std::atan2(y[i], x[i]), btkEigen::atan2_fast_max_error);
+      TS_ASSERT_EQUALS(out[i], btkEigen::atan2_fast(y[i], x[i]));
+    }
+  };
+  
+  CXXTEST_TEST(Atan2Vector)
+  {
+    Eigen::Matrix<double,Eigen::Dynamic,2> in = Eigen::Matrix<double,Eigen::Dynamic,2>::Random(1000,2);
+    Eigen::Matrix<double,Eigen::Dynamic,1> fast(1000), accurate(1000);
+    btkEigen::vatan2(fast.data(), in.data(), in.data() + 1000, 1000);
+    btkEigen::vatan2(accurate.data(), in.data(), in.data() + 1000, 1000, true);
+    for (int i = 0 ; i < 1000 ; ++i)
+    {
+      TS_ASSERT_EQUALS(accurate.coeff(i), std::atan2(in.coeff(i,0), in.coeff(i,1)));
+      TS_ASSERT_DELTA(fast.coeff(i), accurate.coeff(i), btkEigen::atan2_fast_max_error);
+    }
+  };
+  
+  CXXTEST_TEST(NormAndSqrt)
+  {
+    Eigen::Matrix<double,Eigen::Dynamic,3> in = Eigen::Matrix<double,Eigen::Dynamic,3>::Random(100,3);
+    in.row(10).setZero();
+    Eigen::Matrix<double,Eigen::Dynamic,1> norm(100), s(100);
+    btkEigen::vnorm(norm.data(), in.data(), in.data() + 100, in.data() + 200, 100);
+    Eigen::Matrix<double,Eigen::Dynamic,1> sq = in.rowwise().squaredNorm();
+    btkEigen::vsqrt(s.data(), sq.data(), 100);
+    for (int i = 0 ; i < 100 ; ++i)
+    {
+      TS_ASSERT_DELTA(norm.coeff(i), in.row(i).norm(), 1e-15);
+      TS_ASSERT_DELTA(s.coeff(i), in.row(i).norm(), 1e-15);
+    }
+    Eigen::Matrix<double,Eigen::Dynamic,3> out = in;
+    btkEigen::vnormalize(out.data(), out.data() + 100, out.data() + 200, 100);
+    for (int i = 0 ; i < 100 ; ++i)
+    {
+      if (i == 10)
+      {
+        TS_ASSERT_EQUALS(out.row(i).norm(), 0.0);
+      }
+      else
+      {
+        TS_ASSERT(out.row(i).isApprox(in.row(i).normalized()));
+      }
+    }
+  };
+  
+  CXXTEST_TEST(Cross)
+  {
+    Eigen::Matrix<double,Eigen::Dynamic,3> a = Eigen::Matrix<double,Eigen::Dynamic,3>::Random(100,3);
+    Eigen::Matrix<double,Eigen::Dynamic,3> b = Eigen::Matrix<double,Eigen::Dynamic,3>::Random(100,3);
+    Eigen::Matrix<double,Eigen::Dynamic,3> c(100,3);
+    btkEigen::vcross(c.data(), c.data() + 100, c.data() + 200, a.data(), a.data() + 100, a.data() + 200, b.data(), b.data() + 100, b.data() + 200, 100);
+    for (int i = 0 ; i < 100 ; ++i)
+    {
+      Eigen::Vector3d ref = Eigen::Vector3d(a.row(i).transpose()).cross(Eigen::Vector3d(b.row(i).transpose()));
+      TS_ASSERT(c.row(i).transpose().isApprox(ref));
+    }
+    // In place
+    btkEigen::vcross(a.data(), a.data() + 100, a.data() + 200, a.data(), a.data() + 100, a.data() + 200, b.data(), b.data() + 100, b.data() + 200, 100);
+    TS_ASSERT(a.isApprox(c));
+  };
+};
+
+CXXTEST_SUITE_REGISTRATION(EigenVectorMathTest)
+CXXTEST_TEST_REGISTRATION(EigenVectorMathTest, Atan2Fast)
+CXXTEST_TEST_REGISTRATION(EigenVectorMathTest, Atan2FastSpecialValues)
+CXXTEST_TEST_REGISTRATION(EigenVectorMathTest, Atan2Vector)
+CXXTEST_TEST_REGISTRATION(EigenVectorMathTest, NormAndSqrt)
+CXXTEST_TEST_REGISTRATION(EigenVectorMathTest, Cross)
+
+#endif // EigenVectorMathTest_h
@@ -4,6 +4,7 @@
 #include <btkAcquisitionFileReader.h>
 #include <btkForcePlatformWrenchFilter.h>
 #include <btkForcePlatformsExtractor.h>
+#include <btkForcePlatformTypes.h>
 
 CXXTEST_SUITE(ForcePlatformWrenchFilterTest)
 { 
@@ -47,8 +48,56 @@ CXXTEST_SUITE(ForcePlatformWrenchFilterTest)
       }
     }
   };
+  
+  CXXTEST_TEST(Type6And7LikeType3)
+  {
+    const int frameNumber = 150;
+    btk::ForcePlatform::Pointer fp3 = btk::ForcePlatformType3::New();
+    btk::ForcePlatform::Pointer fp6 = btk::ForcePlatformType6::New();
+    btk::ForcePlatform::Pointer fp7 = btk::ForcePlatformType7::New();
+    btk::ForcePlatform::Corners c;
+    c << 600.0, 0.0, 0.0, 600.0,
+         400.0, 400.0, 0.0, 0.0,
+         0.0, 0.0, 0.0, 0.0;
+    for (int i = 0 ; i < 12 ; ++i)
+    {
+      fp6->SetChannel(i, btk::Analog::New(frameNumber));
+      fp6->GetChannel(i)->GetValues().setRandom();
+    }
+    for (int i = 0 ; i < 8 ; ++i)
+      fp3->SetChannel(i, btk::Analog::New(frameNumber));
+    // FX12, FX34, FY14, FY23, FZ1, FZ2, FZ3, FZ4
+    fp3->GetChannel(0)->SetValues(fp6->GetChannel(0)->GetValues() + fp6->GetChannel(1)->GetValues());
+    fp3->GetChannel(1)->SetValues(fp6->GetChannel(2)->GetValues() + fp6->GetChannel(3)->GetValues());
+    fp3->GetChannel(2)->SetValues(fp6->GetChannel(4)->GetValues() + fp6->GetChannel(7)->GetValues());
+    fp3->GetChannel(3)->SetValues(fp6->GetChannel(5)->GetValues() + fp6->GetChannel(6)->GetValues());
+    for (int i = 0 ; i < 4 ; ++i)
+      fp3->GetChannel(4+i)->SetValues(fp6->GetChannel(8+i)->GetValues());
+    for (int i = 0 ; i < 8 ; ++i)
+      fp7->SetChannel(i, fp3->GetChannel(i));
+    fp3->SetOrigin(210.0, 260.0, -40.0); fp3->SetCorners(c);
+    fp6->SetOrigin(210.0, 260.0, -40.0); fp6->SetCorners(c);
+    fp7->SetOrigin(210.0, 260.0, -40.0); fp7->SetCorners(c);
+    btk::ForcePlatformCollection::Pointer fpc = btk::ForcePlatformCollection::New();
+    fpc->InsertItem(fp3);
+    fpc->InsertItem(fp6);
+    fpc->InsertItem(fp7);
+    
+    btk::ForcePlatformWrenchFilter::Pointer fpwf = btk::ForcePlatformWrenchFilter::New();
+    fpwf->SetInput(fpc);
+    btk::WrenchCollection::Pointer fpwc = fpwf->GetOutput();
+    fpwc->Update();
+    TS_ASSERT_EQUALS(fpwc->GetItemNumber(), 3);
+    for (int j = 1 ; j < 3 ; ++j)
+    {
+      TS_ASSERT(fpwc->GetItem(j)->GetForce()->GetValues().isApprox(fpwc->GetItem(0)->GetForce()->GetValues(), 1e-12));
+      TS_ASSERT(fpwc->GetItem(j)->GetMoment()->GetValues().isApprox(fpwc->GetItem(0)->GetMoment()->GetValues(), 1e-12));
+      TS_ASSERT(fpwc->GetItem(j)->GetPosition()->GetValues().isApprox(fpwc->GetItem(0)->GetPosition()->GetValues(), 1e-12));
+    }
+  };
 };
 
 CXXTEST_SUITE_REGISTRATION(ForcePlatformWrenchFilterTest)
 CXXTEST_TEST_REGISTRATION(ForcePlatformWrenchFilterTest, FileSample09PluginC3D)
+CXXTEST_TEST_REGISTRATION(ForcePlatformWrenchFilterTest, Type6And7LikeType3)
 #endif
@@ -3,6 +3,7 @@
 
 #include <btkAcquisitionFileReader.h>
 #include <btkForcePlatformsExtractor.h>
+#include <btkMetaDataUtils.h>
 
 CXXTEST_SUITE(ForcePlatformsExtractorTest)
 {
@@ -188,6 +189,119 @@ CXXTEST_SUITE(ForcePlatformsExtractorTest)
     TS_ASSERT_EQUALS(pfc->GetItemNumber(), 2);
     TS_ASSERT(ts == pfc->GetTimestamp());
   };
+  
+  CXXTEST_TEST(CalibrationMatrixType6)
+  {
+    const int frameNumber = 300;
+    btk::Acquisition::Pointer acq = btk::Acquisition::New();
+    acq->Init(0, frameNumber, 13);
+    for (int i = 0 ; i < 13 ; ++i)
+      acq->GetAnalog(i)->GetValues().setRandom();
+    btk::MetaData::Pointer fp = btk::MetaDataCreateChild(acq->GetMetaData(), "FORCE_PLATFORM");
+    btk::MetaDataCreateChild(fp, "USED", (int16_t)1);
+    btk::MetaDataCreateChild(fp, "TYPE", std::vector<int16_t>(1,6));
+    std::vector<int16_t> channels(12);
+    for (int i = 0 ; i < 12 ; ++i)
+      channels[i] = i + 2; // The first analog channel is not used
+    btk::MetaDataCreateChild(fp, "CHANNEL", channels, 12);
+    std::vector<float> cal(144);
+    for (int i = 0 ; i < 144 ; ++i)
+      cal[i] = static_cast<float>(((i % 13) == 0) ? 10.0 : 0.01 * (i % 7));
+    btk::MetaDataCreateChild(fp, "CAL_MATRIX", cal, 12);
+    
+    btk::ForcePlatformsExtractor::Pointer pfe = btk::ForcePlatformsExtractor::New();
+    pfe->SetInput(acq);
+    btk::ForcePlatformCollection::Pointer pfc = pfe->GetOutput();
+    pfc->Update();
+    TS_ASSERT_EQUALS(pfc->GetItemNumber(), 1);
+    btk::ForcePlatform::Pointer pf = pfc->GetItem(0);
+    TS_ASSERT_EQUALS(pf->GetType(), 6);
+    TS_ASSERT_EQUALS(pf->GetChannelNumber(), 12);
+    for (int i = 0 ; i < 12 ; ++i)
+    {
+      TS_ASSERT_EQUALS(pf->GetChannel(i)->GetFrameNumber(), frameNumber);
+      for (int j = 0 ; j < frameNumber ; ++j)
+      {
+        double v = 0.0;
+        for (int k = 0 ; k < 12 ; ++k)
+          v += static_cast<double>(cal[i + k * 12]) * acq->GetAnalog(k + 1)->GetValues()(j);
+        TS_ASSERT_DELTA(pf->GetChannel(i)->GetValues()(j), v, 1e-12);
+      }
+    }
+  };
+  
+  CXXTEST_TEST(NullCalibrationMatrixType3)
+  {
+    btk::Acquisition::Pointer acq = btk::Acquisition::New();
+    acq->Init(0, 50, 8);
+    for (int i = 0 ; i < 8 ; ++i)
+      acq->GetAnalog(i)->GetValues().setRandom();
+    btk::MetaData::Pointer fp = btk::MetaDataCreateChild(acq->GetMetaData(), "FORCE_PLATFORM");
+    btk::MetaDataCreateChild(fp, "USED", (int16_t)1);
+    btk::MetaDataCreateChild(fp, "TYPE", std::vector<int16_t>(1,3));
+    std::vector<int16_t> channels(8);
+    for (int i = 0 ; i < 8 ; ++i)
+      channels[i] = i + 1;
+    btk::MetaDataCreateChild(fp, "CHANNEL", channels, 8);
+    btk::MetaDataCreateChild(fp, "CAL_MATRIX", std::vector<float>(64, 0.0f), 8);
+    
+    btk::ForcePlatformsExtractor::Pointer pfe = btk::ForcePlatformsExtractor::New();
+    pfe->SetInput(acq);
+    btk::ForcePlatformCollection::Pointer pfc = pfe->GetOutput();
+    pfc->Update();
+    TS_ASSERT_EQUALS(pfc->GetItemNumber(), 1);
+    btk::ForcePlatform::Pointer pf = pfc->GetItem(0);
+    TS_ASSERT_EQUALS(pf->GetType(), 3);
+    TS_ASSERT_EQUALS(pf->GetCalMatrix().isIdentity(), true);
+    for (int i = 0 ; i < 8 ; ++i)
+      TS_ASSERT(pf->GetChannel(i)->GetValues().isApprox(acq->GetAnalog(i)->GetValues()));
+  };
+  
+  CXXTEST_TEST(SharedChannels)
+  {
+    btk::Acquisition::Pointer acq = btk::Acquisition::New();
+    acq->Init(0, 50, 12);
+    for (int i = 0 ; i < 12 ; ++i)
+      acq->GetAnalog(i)->GetValues().setRandom();
+    btk::MetaData::Pointer fp = btk::MetaDataCreateChild(acq->GetMetaData(), "FORCE_PLATFORM");
+    btk::MetaDataCreateChild(fp, "USED", (int16_t)2);
+    std::vector<int16_t> types(2); types[0] = 2; types[1] = 4;
+    btk::MetaDataCreateChild(fp, "TYPE", types);
+    std::vector<int16_t> channels(12);
+    for (int i = 0 ; i < 12 ; ++i)
+      channels[i] = i + 1;
+    btk::MetaDataCreateChild(fp, "CHANNEL", channels, 6);
+    std::vector<float> cal(72, 0.0f);
+    for (int i = 0 ; i < 6 ; ++i)
+    {
+      cal[i * 7] = 1.0f;
+      cal[36 + i * 7] = 2.0f;
+    }
+    std::vector<uint8_t> dims(3); dims[0] = 6; dims[1] = 6; dims[2] = 2;
+    fp->AppendChild(btk::MetaData::New("CAL_MATRIX", dims, cal));
+    
+    btk::ForcePlatformsExtractor::Pointer pfe = btk::ForcePlatformsExtractor::New();
+    pfe->SetInput(acq);
+    btk::ForcePlatformCollection::Pointer pfc = pfe->GetOutput();
+    TS_ASSERT_EQUALS(pfe->GetSharedChannels(), false);
+    pfc->Update();
+    TS_ASSERT_EQUALS(pfc->GetItemNumber(), 2);
+    for (int i = 0 ; i < 6 ; ++i)
+    {
+      TS_ASSERT(pfc->GetItem(0)->GetChannel(i) != acq->GetAnalog(i));
+      TS_ASSERT(pfc->GetItem(0)->GetChannel(i)->GetValues().isApprox(acq->GetAnalog(i)->GetValues()));
+    }
+    pfe->SetSharedChannels(true);
+    pfc->Update();
+    TS_ASSERT_EQUALS(pfc->GetItemNumber(), 2);
+    for (int i = 0 ; i < 6 ; ++i)
+    {
+      TS_ASSERT_EQUALS(pfc->GetItem(0)->GetChannel(i), acq->GetAnalog(i));
+      // Scaled channels are always copied
+      TS_ASSERT(pfc->GetItem(1)->GetChannel(i) != acq->GetAnalog(6 + i));
+      TS_ASSERT(pfc->GetItem(1)->GetChannel(i)->GetValues().isApprox(2.0 * acq->GetAnalog(6 + i)->GetValues()));
+    }
+  };
 };
 
 CXXTEST_SUITE_REGISTRATION(ForcePlatformsExtractorTest)
@@ -197,5 +311,8 @@ CXXTEST_TEST_REGISTRATION(ForcePlatformsExtractorTest, FileSample10Type4)
 CXXTEST_TEST_REGISTRATION(ForcePlatformsExtractorTest, FileSample19Sample19)
 CXXTEST_TEST_REGISTRATION(ForcePlatformsExtractorTest, FPAnalogModified)
 CXXTEST_TEST_REGISTRATION(ForcePlatformsExtractorTest, FPAnalogNotModified)
+CXXTEST_TEST_REGISTRATION(ForcePlatformsExtractorTest, CalibrationMatrixType6)
+CXXTEST_TEST_REGISTRATION(ForcePlatformsExtractorTest, NullCalibrationMatrixType3)
+CXXTEST_TEST_REGISTRATION(ForcePlatformsExtractorTest, SharedChannels)
 
 #endif
@@ -4,6 +4,32 @@
 #include <btkAcquisitionFileReader.h>
 #include <btkGroundReactionWrenchFilter.h>
 #include <btkForcePlatformsExtractor.h>
+#include <btkForcePlatformTypes.h>
+
+btk::ForcePlatform::Pointer GroundReactionWrenchFilterTest_Type2(int frameNumber)
+{
+  btk::ForcePlatform::Pointer fp = btk::ForcePlatformType2::New();
+  fp->SetOrigin(0.0, 0.0, -40.0);
+  for (int i = 0 ; i < 6 ; ++i)
+    fp->SetChannel(i, btk::Analog::New("", frameNumber));
+  for (int i = 0 ; i < frameNumber ; ++i)
+  {
+    // Force applied on the COP (Px, Py, 0) without free moment.
+    double Fx = 10.0 * sin(0.01 * i), Fy = 20.0 * cos(0.02 * i), Fz = ((i % 7) == 0) ? -2.0 : -500.0;
+    double Px = 100.0 * sin(0.03 * i), Py = -80.0 * cos(0.01 * i), Pz = 0.0;
+    // Moment at the surface
+    double Mx = Py * Fz - Pz * Fy, My = Pz * Fx - Px * Fz, Mz = Px * Fy - Py * Fx;
+    // Moment at the origin of the force platform (0, 0, 40 mm under the surface)
+    Mx -= Fy * -40.0; My -= -(-40.0 * Fx);
+    fp->GetChannel(0)->GetValues()(i) = Fx;
+    fp->GetChannel(1)->GetValues()(i) = Fy;
+    fp->GetChannel(2)->GetValues()(i) = Fz;
+    fp->GetChannel(3)->GetValues()(i) = Mx;
+    fp->GetChannel(4)->GetValues()(i) = My;
+    fp->GetChannel(5)->GetValues()(i) = Mz;
+  }
+  return fp;
+};
 
 CXXTEST_SUITE(GroundReactionWrenchFilterTest)
 { 
@@ -23,8 +49,68 @@ CXXTEST_SUITE(GroundReactionWrenchFilterTest)
     btk::Wrench::Pointer grw1 = grwc->GetItem(0);
     TS_ASSERT_EQUALS(grw1->GetPosition()->GetFrameNumber(), 5760);
   };
+  
+  CXXTEST_TEST(Type2LocalFrame)
+  {
+    const int frameNumber = 301;
+    btk::GroundReactionWrenchFilter::Pointer grwf = btk::GroundReactionWrenchFilter::New();
+    grwf->SetInput(GroundReactionWrenchFilterTest_Type2(frameNumber));
+    grwf->SetTransformToGlobalFrame(false);
+    grwf->Update();
+    btk::Wrench::Pointer grw = grwf->GetOutput()->GetItem(0);
+    TS_ASSERT_EQUALS(grw->GetPosition()->GetFrameNumber(), frameNumber);
+    for (int i = 0 ; i < frameNumber ; ++i)
+    {
+      TS_ASSERT_DELTA(grw->GetForce()->GetValues()(i,2), ((i % 7) == 0) ? -2.0 : -500.0, 1e-15);
+      TS_ASSERT_DELTA(grw->GetPosition()->GetValues()(i,0), 100.0 * sin(0.03 * i), 1e-10);
+      TS_ASSERT_DELTA(grw->GetPosition()->GetValues()(i,1), -80.0 * cos(0.01 * i), 1e-10);
+      TS_ASSERT_EQUALS(grw->GetPosition()->GetValues()(i,2), 0.0);
+      TS_ASSERT_EQUALS(grw->GetPosition()->GetResiduals()(i), 0.0);
+      // No free moment
+      TS_ASSERT_DELTA(grw->GetMoment()->GetValues()(i,0), 0.0, 1e-8);
+      TS_ASSERT_DELTA(grw->GetMoment()->GetValues()(i,1), 0.0, 1e-8);
+      TS_ASSERT_DELTA(grw->GetMoment()->GetValues()(i,2), 0.0, 1e-8);
+    }
+  };
+  
+  CXXTEST_TEST(Type2Threshold)
+  {
+    const int frameNumber = 301;
+    btk::ForcePlatform::Pointer fp = GroundReactionWrenchFilterTest_Type2(frameNumber);
+    fp->SetCorner(0, 0.0, 0.0, 0.0);
+    fp->SetCorner(1, 500.0, 0.0, 0.0);
+    fp->SetCorner(2, 500.0, 1000.0, 0.0);
+    fp->SetCorner(3, 0.0, 1000.0, 0.0);
+    btk::GroundReactionWrenchFilter::Pointer grwf = btk::GroundReactionWrenchFilter::New();
+    grwf->SetInput(fp);
+    grwf->SetThresholdValue(5.0);
+    grwf->SetThresholdState(true);
+    grwf->Update();
+    btk::Wrench::Pointer grw = grwf->GetOutput()->GetItem(0);
+    for (int i = 0 ; i < frameNumber ; ++i)
+    {
+      // The frame of the force platform is rotated by 180 degrees around the Z axis.
+      if ((i % 7) == 0)
+      {
+        TS_ASSERT_EQUALS(grw->GetPosition()->GetResiduals()(i), -1.0);
+        TS_ASSERT_DELTA(grw->GetPosition()->GetValues()(i,0), 250.0, 1e-10);
+        TS_ASSERT_DELTA(grw->GetPosition()->GetValues()(i,1), 500.0, 1e-10);
+      }
+      else
+      {
+        TS_ASSERT_EQUALS(grw->GetPosition()->GetResiduals()(i), 0.0);
+        TS_ASSERT_DELTA(grw->GetPosition()->GetValues()(i,0), 250.0 - 100.0 * sin(0.03 * i), 1e-10);
+        TS_ASSERT_DELTA(grw->GetPosition()->GetValues()(i,1), 500.0 + 80.0 * cos(0.01 * i), 1e-10);
+      }
+      TS_ASSERT_DELTA(grw->GetForce()->GetValues()(i,0), -10.0 * sin(0.01 * i), 1e-10);
+      TS_ASSERT_DELTA(grw->GetForce()->GetValues()(i,1), -20.0 * cos(0.02 * i), 1e-10);
+      TS_ASSERT_DELTA(grw->GetForce()->GetValues()(i,2), ((i % 7) == 0) ? -2.0 : -500.0, 1e-10);
+    }
+  };
 };
 
 CXXTEST_SUITE_REGISTRATION(GroundReactionWrenchFilterTest)
 CXXTEST_TEST_REGISTRATION(GroundReactionWrenchFilterTest, FileSample10Type4a)
+CXXTEST_TEST_REGISTRATION(GroundReactionWrenchFilterTest, Type2LocalFrame)
+CXXTEST_TEST_REGISTRATION(GroundReactionWrenchFilterTest, Type2Threshold)
 #endif
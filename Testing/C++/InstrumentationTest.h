@@ -0,0 +1,153 @@
+#ifndef InstrumentationTest_h
+#define InstrumentationTest_h
+
+#include <btkInstrumentation.h>
+#include <btkProcessObject.h>
+#include <btkPointCollection.h>
+
+#include <vector>
+#include <cstdio>
+
+class CopyPointsFilter : public btk::ProcessObject
+{
+public:
+  typedef btkSharedPtr<CopyPointsFilter> Pointer;
+  static Pointer New() {return Pointer(new CopyPointsFilter());};
+  btk::PointCollection::Pointer GetInput() {return static_pointer_cast<btk::PointCollection>(this->GetNthInput(0));};
+  void SetInput(btk::PointCollection::Pointer input) {this->SetNthInput(0, input);};
+  btk::PointCollection::Pointer GetOutput() {return static_pointer_cast<btk::PointCollection>(this->GetNthOutput(0));};
+
+protected:
+  virtual btk::DataObject::Pointer MakeOutput(int ) {return btk::PointCollection::New();};
+  virtual void GenerateData()
+  {
+    btk::PointCollection::Pointer output = this->GetOutput();
+    output->Clear();
+    for (btk::PointCollection::ConstIterator it = this->GetInput()->Begin() ; it != this->GetInput()->End() ; ++it)
+      output->InsertItem((*it)->Clone());
+  };
+
+private:
+  CopyPointsFilter()
+  {
+    this->SetInputNumber(1);
+    this->SetOutputNumber(1);
+  };
+};
+
+void InstrumentationTest_Collect(const btk::Instrumentation::Record& record, void* clientData)
+{
+  static_cast<std::vector<btk::Instrumentation::Record>*>(clientData)->push_back(record);
+};
+
+btk::PointCollection::Pointer InstrumentationTest_Points(int num)
+{
+  btk::PointCollection::Pointer points = btk::PointCollection::New();
+  for (int i = 0 ; i < num ; ++i)
+    points->InsertItem(btk::Point::New(10));
+  return points;
+};
+
+CXXTEST_SUITE(InstrumentationTest)
+{
+  CXXTEST_TEST(Disabled)
+  {
+    TS_ASSERT_EQUALS(btk::Instrumentation::IsEnabled(), false);
+    btk::Instrumentation::Scope scope("Test", "Disabled");
+    TS_ASSERT_EQUALS(scope.IsActive(), false);
+  };
+
+  CXXTEST_TEST(Sinks)
+  {
+    std::vector<btk::Instrumentation::Record> records;
+    btk::Instrumentation::Sink::Pointer sink = btk::Instrumentation::CallbackSink::New(&InstrumentationTest_Collect, &records);
+    btk::Instrumentation::AddSink(sink);
+    TS_ASSERT_EQUALS(btk::Instrumentation::IsEnabled(), true);
+    btk::Instrumentation::RemoveSink(sink);
+    TS_ASSERT_EQUALS(btk::Instrumentation::IsEnabled(), false);
+    btk::Instrumentation::AddSink(sink);
+    btk::Instrumentation::ClearSinks();
+    TS_ASSERT_EQUALS(btk::Instrumentation::IsEnabled(), false);
+    TS_ASSERT_EQUALS(records.size(), 0u);
+  };
+
+  CXXTEST_TEST(ScopeAndPhases)
+  {
+    std::vector<btk::Instrumentation::Record> records;
+    btk::Instrumentation::AddSink(btk::Instrumentation::CallbackSink::New(&InstrumentationTest_Collect, &records));
+    {
+      btk::Instrumentation::Scope scope("Test", "Phase:first", "detail");
+      TS_ASSERT_EQUALS(scope.IsActive(), true);
+      scope.SetBytes(10);
+      scope.SetItems(2);
+      scope.Next("Phase:second");
+      scope.SetItems(3);
+    }
+    btk::Instrumentation::ClearSinks();
+    TS_ASSERT_EQUALS(records.size(), 2u);
+    TS_ASSERT_EQUALS(records[0].Category, "Test");
+    TS_ASSERT_EQUALS(records[0].Name, "Phase:first");
+    TS_ASSERT_EQUALS(records[0].Detail, "detail");
+    TS_ASSERT_EQUALS(records[0].Bytes, 10u);
+    TS_ASSERT_EQUALS(records[0].Items, 2u);
+    TS_ASSERT(records[0].Duration >= 0.0);
+    TS_ASSERT_EQUALS(records[1].Category, "Test");
+    TS_ASSERT_EQUALS(records[1].Name, "Phase:second");
+    TS_ASSERT_EQUALS(records[1].Bytes, 0u);
+    TS_ASSERT_EQUALS(records[1].Items, 3u);
+    TS_ASSERT(records[1].Start >= records[0].Start + records[0].Duration);
+    TS_ASSERT_EQUALS(records[0].Thread, records[1].Thread);
+  };
+
+  CXXTEST_TEST(ProcessObjectUpdate)
+  {
+    std::vector<btk::Instrumentation::Record> records;
+    btk::Instrumentation::AddSink(btk::Instrumentation::CallbackSink::New(&InstrumentationTest_Collect, &records));
+    CopyPointsFilter::Pointer f1 = CopyPointsFilter::New();
+    CopyPointsFilter::Pointer f2 = CopyPointsFilter::New();
+    f1->SetInput(InstrumentationTest_Points(5));
+    f2->SetInput(f1->GetOutput());
+    f2->Update();
+    TS_ASSERT_EQUALS(records.size(), 2u);
+    f2->Update(); // Nothing to update
+    btk::Instrumentation::ClearSinks();
+    f1->GetInput()->Modified();
+    f2->Update(); // Not measured
+    TS_ASSERT_EQUALS(records.size(), 2u);
+    for (size_t i = 0 ; i < records.size() ; ++i)
+    {
+      TS_ASSERT_EQUALS(records[i].Category, "ProcessObject");
+      TS_ASSERT_EQUALS(records[i].Name, "CopyPointsFilter");
+      TS_ASSERT_EQUALS(records[i].Items, 5u);
+    }
+  };
+
+  CXXTEST_TEST(TraceFile)
+  {
+    std::string filename = "InstrumentationTest_trace.json";
+    btk::Instrumentation::TraceFileSink::Pointer sink = btk::Instrumentation::TraceFileSink::New(filename, btk::Instrumentation::TraceFileSink::JSONLines);
+    TS_ASSERT_EQUALS(sink->IsOpen(), true);
+    btk::Instrumentation::AddSink(sink);
+    {
+      btk::Instrumentation::Scope scope("Test", "Trace", "quote\"d");
+    }
+    btk::Instrumentation::ClearSinks();
+    sink.reset();
+    std::ifstream ifs(filename.c_str());
+    std::string line;
+    std::getline(ifs, line);
+    TS_ASSERT(line.find("\"name\": \"Trace\"") != std::string::npos);
+    TS_ASSERT(line.find("quote\\\"d") != std::string::npos);
+    TS_ASSERT_EQUALS(std::getline(ifs, line).good(), false);
+    ifs.close();
+    std::remove(filename.c_str());
+  };
+};
+
+CXXTEST_SUITE_REGISTRATION(InstrumentationTest)
+CXXTEST_TEST_REGISTRATION(InstrumentationTest, Disabled)
+CXXTEST_TEST_REGISTRATION(InstrumentationTest, Sinks)
+CXXTEST_TEST_REGISTRATION(InstrumentationTest, ScopeAndPhases)
+CXXTEST_TEST_REGISTRATION(InstrumentationTest, ProcessObjectUpdate)
+CXXTEST_TEST_REGISTRATION(InstrumentationTest, TraceFile)
+#endif
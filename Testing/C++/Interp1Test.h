@@ -208,6 +208,108 @@ CXXTEST_SUITE(Interp1Test)
     for (int i = 0 ; i < yi_.rows() ; ++i)
       TS_ASSERT_DELTA(yi_.coeff(i), yi_.coeff(i), 1e-6);
   };
+  
+  CXXTEST_TEST(SplineXd)
+  {
+    Eigen::Matrix<double, Eigen::Dynamic, 1> x(5), y(5), xi(4), yi;
+    x << 0.0, 1.0, 2.0, 3.0, 4.0;
+    y << 1.0, 3.0, 5.0, 7.0, 9.0;
+    xi << 0.5, 1.25, 2.0, 3.9;
+    btkEigen::interp1().spline(&yi, x, y, xi);
+    
+    TS_ASSERT_EQUALS(yi.rows(), 4);
+    TS_ASSERT_DELTA(yi.coeff(0), 2.0, 1e-12);
+    TS_ASSERT_DELTA(yi.coeff(1), 3.5, 1e-12);
+    TS_ASSERT_DELTA(yi.coeff(2), 5.0, 1e-12);
+    TS_ASSERT_DELTA(yi.coeff(3), 8.8, 1e-12);
+    
+    btkEigen::Interp1_knots< Eigen::Matrix<double, Eigen::Dynamic, 1> > knots(x, xi);
+    Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic> yb;
+    btkEigen::interp1().spline(&yb, knots, y);
+    for (int i = 0 ; i < 4 ; ++i)
+      TS_ASSERT_DELTA(yb.coeff(i,0), yi.coeff(i), 1e-12);
+  };
+  
+  CXXTEST_TEST(LinearBatchXd)
+  {
+    Eigen::Matrix<double, Eigen::Dynamic, 1> x(3), xi(7), yi_;
+    Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic> y(3,2), yi;
+    x << 3.0, 6.0, 9.0;
+    y << 6.0, -1.0,
+         12.0, 1.0,
+         18.0, 7.0;
+    xi << 3.0, 4.0, 5.0, 6.0, 7.0, 8.0, 9.0;
+    btkEigen::Interp1_knots< Eigen::Matrix<double, Eigen::Dynamic, 1> > knots(x, xi);
+    btkEigen::interp1().linear(&yi, knots, y);
+    
+    TS_ASSERT_EQUALS(yi.rows(), 7);
+    TS_ASSERT_EQUALS(yi.cols(), 2);
+    for (int c = 0 ; c < 2 ; ++c)
+    {
+      Eigen::Matrix<double, Eigen::Dynamic, 1> yc = y.col(c);
+      btkEigen::interp1().linear(&yi_, x, yc, xi);
+      for (int i = 0 ; i < 7 ; ++i)
+        TS_ASSERT_DELTA(yi.coeff(i,c), yi_.coeff(i), 1e-15);
+    }
+    TS_ASSERT_DELTA(yi.coeff(1,0), 8.0, 1e-15);
+    TS_ASSERT_DELTA(yi.coeff(4,1), 3.0, 1e-15);
+  };
+  
+  CXXTEST_TEST(PchipBatchXd)
+  {
+    Eigen::Matrix<double, Eigen::Dynamic, 1> x(10), xi(27), yi_;
+    Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic> y(10,3), yi;
+    x << 1.0, 2.0, 4.0, 5.0, 6.0, 7.0, 8.0, 10.0, 20.0, 25.0;
+    y.col(0) << -5.245373, -0.232714, -7.004030, 8.827446, 5.626890, -8.906643, -4.271316, -2.599281, 1.940986, 1.202701;
+    y.col(1) = -2.0 * y.col(0);
+    y.col(2) << 1.0, 2.0, 3.0, 4.0, 5.0, 6.0, 7.0, 8.0, 9.0, 10.0;
+    xi << 1.0, 25.0, 8.352387, 13.204208, 13.258518, 20.623065, 20.075954, 16.463635, 10.086625, 20.477931, 13.787814, 9.417450, 23.536037, 22.022627, 14.203752, 15.939402, 15.089073, 5.985815, 8.229912, 12.302160, 6.531716, 21.263411, 5.674343, 6.422123, 5.096993, 6.463943, 11.456768;
+    btkEigen::Interp1_knots< Eigen::Matrix<double, Eigen::Dynamic, 1> > knots(x, xi);
+    btkEigen::interp1().pchip(&yi, knots, y);
+    
+    TS_ASSERT_EQUALS(yi.rows(), 27);
+    TS_ASSERT_EQUALS(yi.cols(), 3);
+    for (int c = 0 ; c < 3 ; ++c)
+    {
+      Eigen::Matrix<double, Eigen::Dynamic, 1> yc = y.col(c);
+      btkEigen::interp1().pchip(&yi_, x, yc, xi);
+      for (int i = 0 ; i < 27 ; ++i)
+        TS_ASSERT_DELTA(yi.coeff(i,c), yi_.coeff(i), 1e-12);
+    }
+    TS_ASSERT_DELTA(yi.coeff(2,0), -3.799015, 1e-6);
+    TS_ASSERT_DELTA(yi.coeff(2,1), 2.0 * 3.799015, 1e-6);
+  };
+  
+  CXXTEST_TEST(BatchTemporaryKnots)
+  {
+    Eigen::Matrix<double, Eigen::Dynamic, 1> x = Eigen::Matrix<double, Eigen::Dynamic, 1>::LinSpaced(12, 0.0, 11.0), xi(5), yi_;
+    Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic> y(12,2), yi;
+    for (int i = 0 ; i < 12 ; ++i)
+    {
+      y(i,0) = std::sin(0.5 * i);
+      y(i,1) = 0.1 * i * i;
+    }
+    xi << 0.5, 2.25, 5.0, 7.75, 10.9;
+    // The abscissa given to the knots is a temporary.
+    btkEigen::Interp1_knots< Eigen::Matrix<double, Eigen::Dynamic, 1> > knots(Eigen::Matrix<double, Eigen::Dynamic, 1>::LinSpaced(12, 0.0, 11.0), xi);
+    for (int m = 0 ; m < 2 ; ++m)
+    {
+      if (m == 0)
+        btkEigen::interp1().pchip(&yi, knots, y);
+      else
+        btkEigen::interp1().spline(&yi, knots, y);
+      for (int c = 0 ; c < 2 ; ++c)
+      {
+        Eigen::Matrix<double, Eigen::Dynamic, 1> yc = y.col(c);
+        if (m == 0)
+          btkEigen::interp1().pchip(&yi_, x, yc, xi);
+        else
+          btkEigen::interp1().spline(&yi_, x, yc, xi);
+        for (int i = 0 ; i < 5 ; ++i)
+          TS_ASSERT_DELTA(yi.coeff(i,c), yi_.coeff(i), 1e-12);
+      }
+    }
+  };
 };
 
 CXXTEST_SUITE_REGISTRATION(Interp1Test)
@@ -218,5 +320,9 @@ CXXTEST_TEST_REGISTRATION(Interp1Test, PchipXd_internals_condition)
 CXXTEST_TEST_REGISTRATION(Interp1Test, PchipXd_internals)
 CXXTEST_TEST_REGISTRATION(Interp1Test, PchipXd)
 CXXTEST_TEST_REGISTRATION(Interp1Test, PchipXd_bis)
+CXXTEST_TEST_REGISTRATION(Interp1Test, SplineXd)
+CXXTEST_TEST_REGISTRATION(Interp1Test, LinearBatchXd)
+CXXTEST_TEST_REGISTRATION(Interp1Test, PchipBatchXd)
+CXXTEST_TEST_REGISTRATION(Interp1Test, BatchTemporaryKnots)
 
 #endif // CumtrapzTest_h
\ No newline at end of file
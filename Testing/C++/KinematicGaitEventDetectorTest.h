@@ -0,0 +1,139 @@
+#ifndef KinematicGaitEventDetectorTest_h
+#define KinematicGaitEventDetectorTest_h
+
+#include <btkKinematicGaitEventDetector.h>
+
+btk::PointCollection::Pointer KinematicGaitEventDetectorTest_Markers(int axis, double direction, bool psis)
+{
+  // Walking at 1 m/s with a stride of 1 s (100 frames). The right side is late of half a stride.
+  const int frameNumber = 300;
+  const double pi = 3.14159265358979323846;
+  btk::PointCollection::Pointer markers = btk::PointCollection::New();
+  const char* labels[5] = {"SACR", "LHEE", "LTOE", "RHEE", "RTOE"};
+  for (int j = 0 ; j < 5 ; ++j)
+  {
+    btk::Point::Pointer p = btk::Point::New(labels[j], frameNumber);
+    for (int i = 0 ; i < frameNumber ; ++i)
+    {
+      double s = direction * 10.0 * i;
+      double d = 0.0;
+      if (j == 1)
+        d = 300.0 * sin(2.0 * pi * i / 100.0);
+      else if (j == 2)
+        d = 300.0 * cos(2.0 * pi * i / 100.0);
+      else if (j == 3)
+        d = 300.0 * sin(2.0 * pi * (i - 50) / 100.0);
+      else if (j == 4)
+        d = 300.0 * cos(2.0 * pi * (i - 50) / 100.0);
+      p->GetValues()(i, axis) = s + direction * d;
+      p->GetValues()(i, 1 - axis) = (j == 0) ? 0.0 : ((j < 3) ? -100.0 : 100.0);
+      p->GetValues()(i, 2) = (j == 0) ? 1000.0 : 50.0;
+    }
+    if (psis && (j == 0))
+    {
+      btk::Point::Pointer q = p->Clone();
+      p->SetLabel("LPSI");
+      q->SetLabel("RPSI");
+      p->GetValues().col(1 - axis).array() -= 50.0;
+      q->GetValues().col(1 - axis).array() += 50.0;
+      markers->InsertItem(q);
+    }
+    markers->InsertItem(p);
+  }
+  return markers;
+};
+
+CXXTEST_SUITE(KinematicGaitEventDetectorTest)
+{
+  CXXTEST_TEST(NoInput)
+  {
+    btk::KinematicGaitEventDetector::Pointer kged = btk::KinematicGaitEventDetector::New();
+    btk::EventCollection::Pointer output = kged->GetOutput();
+    output->Update();
+    TS_ASSERT_EQUALS(output->GetItemNumber(), 0);
+  };
+  
+  CXXTEST_TEST(MissingMarker)
+  {
+    btk::PointCollection::Pointer markers = KinematicGaitEventDetectorTest_Markers(0, 1.0, false);
+    markers->RemoveItem(4);
+    btk::KinematicGaitEventDetector::Pointer kged = btk::KinematicGaitEventDetector::New();
+    kged->SetInput(markers);
+    btk::EventCollection::Pointer output = kged->GetOutput();
+    output->Update();
+    TS_ASSERT_EQUALS(output->GetItemNumber(), 0);
+  };
+  
+  CXXTEST_TEST(ForwardX)
+  {
+    btk::KinematicGaitEventDetector::Pointer kged = btk::KinematicGaitEventDetector::New();
+    kged->SetInput(KinematicGaitEventDetectorTest_Markers(0, 1.0, false));
+    kged->SetAcquisitionInformation(1, 100.0, "Subject");
+    btk::EventCollection::Pointer output = kged->GetOutput();
+    output->Update();
+    
+    // Left: FS 25, FO 50, FS 125, FO 150, FS 225, FO 250
+    // Right: FS 75, FO 100, FS 175, FO 200, FS 275 (FO 0 and 300 are outside)
+    TS_ASSERT_EQUALS(output->GetItemNumber(), 11);
+    const int frames[11] = {26, 51, 126, 151, 226, 251, 76, 101, 176, 201, 276};
+    for (int i = 0 ; i < output->GetItemNumber() ; ++i)
+    {
+      btk::Event::Pointer ev = output->GetItem(i);
+      TS_ASSERT_EQUALS(ev->GetContext(), (i < 6) ? "Left" : "Right");
+      TS_ASSERT_EQUALS(ev->GetLabel(), (i % 2) ? "Foot Off" : "Foot Strike");
+      TS_ASSERT_EQUALS(ev->GetId(), (i % 2) ? 2 : 1);
+      TS_ASSERT_EQUALS(ev->GetDetectionFlags(), btk::Event::Automatic);
+      TS_ASSERT_EQUALS(ev->GetSubject(), "Subject");
+      TS_ASSERT_EQUALS(ev->GetFrame(), frames[i]);
+      TS_ASSERT_DELTA(ev->GetTime(), frames[i] / 100.0, 1e-15);
+    }
+  };
+  
+  CXXTEST_TEST(BackwardY_PSIS)
+  {
+    btk::PointCollection::Pointer markers = KinematicGaitEventDetectorTest_Markers(1, -1.0, true);
+    btk::KinematicGaitEventDetector::Pointer kged = btk::KinematicGaitEventDetector::New();
+    kged->SetInput(markers);
+    btk::EventCollection::Pointer output = kged->GetOutput();
+    output->Update();
+    TS_ASSERT_EQUALS(output->GetItemNumber(), 11);
+    TS_ASSERT_EQUALS(output->GetItem(0)->GetLabel(), "Foot Strike");
+    TS_ASSERT_EQUALS(output->GetItem(0)->GetFrame(), 26);
+    TS_ASSERT_EQUALS(output->GetItem(1)->GetLabel(), "Foot Off");
+    TS_ASSERT_EQUALS(output->GetItem(1)->GetFrame(), 51);
+    // No frame rate
+    TS_ASSERT_EQUALS(output->GetItem(0)->GetTime(), 0.0);
+    
+    // Occluded left heel around the first heel strike
+    markers->GetItem(2)->GetResiduals().segment(20, 10).setConstant(-1.0);
+    markers->Modified();
+    output->Update();
+    TS_ASSERT_EQUALS(output->GetItemNumber(), 10);
+    TS_ASSERT_EQUALS(output->GetItem(0)->GetLabel(), "Foot Off");
+    TS_ASSERT_EQUALS(output->GetItem(0)->GetFrame(), 51);
+  };
+  
+  CXXTEST_TEST(Labels)
+  {
+    btk::PointCollection::Pointer markers = KinematicGaitEventDetectorTest_Markers(0, 1.0, false);
+    markers->GetItem(1)->SetLabel("LeftHeel");
+    btk::KinematicGaitEventDetector::Pointer kged = btk::KinematicGaitEventDetector::New();
+    kged->SetInput(markers);
+    kged->SetMarkerLabel(btk::KinematicGaitEventDetector::LeftHeel, "LeftHeel");
+    TS_ASSERT_EQUALS(kged->GetMarkerLabel(btk::KinematicGaitEventDetector::LeftHeel), "LeftHeel");
+    kged->SetWindowLength(30);
+    btk::EventCollection::Pointer output = kged->GetOutput();
+    output->Update();
+    // Only the events between the frames 30 and 269
+    TS_ASSERT_EQUALS(output->GetItemNumber(), 9);
+  };
+};
+
+CXXTEST_SUITE_REGISTRATION(KinematicGaitEventDetectorTest)
+CXXTEST_TEST_REGISTRATION(KinematicGaitEventDetectorTest, NoInput)
+CXXTEST_TEST_REGISTRATION(KinematicGaitEventDetectorTest, MissingMarker)
+CXXTEST_TEST_REGISTRATION(KinematicGaitEventDetectorTest, ForwardX)
+CXXTEST_TEST_REGISTRATION(KinematicGaitEventDetectorTest, BackwardY_PSIS)
+CXXTEST_TEST_REGISTRATION(KinematicGaitEventDetectorTest, Labels)
+
+#endif // KinematicGaitEventDetectorTest_h
@@ -0,0 +1,138 @@
+#ifndef LoggerTest_h
+#define LoggerTest_h
+
+#include <btkLogger.h>
+#include <btkConvert.h>
+#include <btkThread_p.h>
+
+#include <sstream>
+
+static int LoggerTest_FormatNumber = 0;
+
+std::string LoggerTest_Format(const std::string& msg)
+{
+  ++LoggerTest_FormatNumber;
+  return msg;
+};
+
+class LoggerTest_Task : public btk::parallel_task_p
+{
+public:
+  virtual void Run(int idx)
+  {
+    btk::Logger::Context context("file" + btk::ToString(idx));
+    for (int i = 0 ; i < 50 ; ++i)
+      btk::Logger::Warning("message");
+  };
+};
+
+class LoggerTest_State
+{
+public:
+  LoggerTest_State(btk::Logger::VerboseMode mode)
+  {
+    this->m_Mode = btk::Logger::GetVerboseMode();
+    this->m_Stream = btk::Logger::GetWarningStream();
+    btk::Logger::SetVerboseMode(mode);
+    btk::Logger::SetWarningStream(&(this->Output));
+  };
+  ~LoggerTest_State()
+  {
+    btk::Logger::SetAsynchronousMode(false);
+    btk::Logger::SetVerboseMode(this->m_Mode);
+    btk::Logger::SetWarningStream(this->m_Stream);
+  };
+  std::ostringstream Output;
+private:
+  btk::Logger::VerboseMode m_Mode;
+  btk::Logger::Stream::Pointer m_Stream;
+};
+
+CXXTEST_SUITE(LoggerTest)
+{
+  CXXTEST_TEST(QuietWithoutFormatting)
+  {
+    LoggerTest_State state(btk::Logger::Quiet);
+    LoggerTest_FormatNumber = 0;
+    btkWarningMacro(LoggerTest_Format("foo"));
+    btkErrorMacro("bar.c3d", LoggerTest_Format("foo"));
+    TS_ASSERT_EQUALS(LoggerTest_FormatNumber, 0);
+    btk::Logger::SetVerboseMode(btk::Logger::MessageOnly);
+    btkWarningMacro(LoggerTest_Format("foo"));
+    TS_ASSERT_EQUALS(LoggerTest_FormatNumber, 1);
+    TS_ASSERT_EQUALS(state.Output.str(), "foo\n");
+  };
+
+  CXXTEST_TEST(Context)
+  {
+    LoggerTest_State state(btk::Logger::Normal);
+    TS_ASSERT_EQUALS(btk::Logger::GetContext(), "");
+    {
+      btk::Logger::Context context("foo.c3d");
+      TS_ASSERT_EQUALS(btk::Logger::GetContext(), "foo.c3d");
+      btk::Logger::Warning("Bar");
+      btkWarningMacro("/path/to/foo.c3d", "Bar");
+      {
+        btk::Logger::Context nested("foo.trc");
+        btk::Logger::Warning("Bar");
+      }
+      TS_ASSERT_EQUALS(btk::Logger::GetContext(), "foo.c3d");
+    }
+    TS_ASSERT_EQUALS(btk::Logger::GetContext(), "");
+    btk::Logger::Warning("Bar");
+    TS_ASSERT_EQUALS(state.Output.str(), "[BTK WARNING] foo.c3d - Bar\n[BTK WARNING] foo.c3d - Bar\n[BTK WARNING] foo.trc - Bar\n[BTK WARNING] Bar\n");
+  };
+
+  CXXTEST_TEST(Asynchronous)
+  {
+    LoggerTest_State state(btk::Logger::MessageOnly);
+    TS_ASSERT_EQUALS(btk::Logger::GetAsynchronousMode(), false);
+    btk::Logger::SetAsynchronousMode(true);
+    TS_ASSERT_EQUALS(btk::Logger::GetAsynchronousMode(), true);
+    std::string expected;
+    for (int i = 0 ; i < 3000 ; ++i) // More than the size of the queue
+    {
+      btk::Logger::Warning(btk::ToString(i));
+      expected += btk::ToString(i) + "\n";
+    }
+    btk::Logger::Flush();
+    TS_ASSERT_EQUALS(state.Output.str(), expected);
+    btk::Logger::Warning("foo");
+    btk::Logger::SetAsynchronousMode(false);
+    TS_ASSERT_EQUALS(btk::Logger::GetAsynchronousMode(), false);
+    TS_ASSERT_EQUALS(state.Output.str(), expected + "foo\n");
+  };
+
+  CXXTEST_TEST(Concurrent)
+  {
+    LoggerTest_State state(btk::Logger::MessageOnly);
+    btk::Logger::SetAsynchronousMode(true);
+    LoggerTest_Task task;
+    btk::parallel_for_p(8, &task, 4);
+    btk::Logger::Flush();
+    std::istringstream iss(state.Output.str());
+    std::string line;
+    int counts[8] = {0};
+    int lineNumber = 0;
+    while (std::getline(iss, line))
+    {
+      ++lineNumber;
+      int idx = -1;
+      if ((line.length() == 15) && (line.compare(0, 4, "file") == 0) && (line.compare(5, 10, " - message") == 0))
+        idx = line[4] - '0';
+      TS_ASSERT((idx >= 0) && (idx < 8));
+      if ((idx >= 0) && (idx < 8))
+        ++counts[idx];
+    }
+    TS_ASSERT_EQUALS(lineNumber, 400);
+    for (int i = 0 ; i < 8 ; ++i)
+      TS_ASSERT_EQUALS(counts[i], 50);
+  };
+};
+
+CXXTEST_SUITE_REGISTRATION(LoggerTest)
+CXXTEST_TEST_REGISTRATION(LoggerTest, QuietWithoutFormatting)
+CXXTEST_TEST_REGISTRATION(LoggerTest, Context)
+CXXTEST_TEST_REGISTRATION(LoggerTest, Asynchronous)
+CXXTEST_TEST_REGISTRATION(LoggerTest, Concurrent)
+#endif
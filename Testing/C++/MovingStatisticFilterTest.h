@@ -0,0 +1,163 @@
+#ifndef MovingStatisticFilterTest_h
+#define MovingStatisticFilterTest_h
+
+#include <btkMovingStatisticFilter.h>
+#include <btkAnalogCollection.h>
+#include <btkPointCollection.h>
+
+CXXTEST_SUITE(MovingStatisticFilterTest)
+{
+  CXXTEST_TEST(Constructor)
+  {
+    btk::MovingStatisticFilter<btk::Analog>::Pointer filter = btk::MovingStatisticFilter<btk::Analog>::New();
+    TS_ASSERT_EQUALS(filter->GetStatistic(), btk::MovingStatisticFilter<btk::Analog>::Mean);
+    TS_ASSERT_EQUALS(filter->GetWindowLength(), 5);
+    TS_ASSERT_EQUALS(filter->GetPercentile(), 50.0);
+    TS_ASSERT_EQUALS(filter->GetBaselineRemoval(), false);
+    TS_ASSERT_EQUALS(filter->GetOutput()->GetItemNumber(), 0);
+  };
+  
+  CXXTEST_TEST(AnalogMedianSpike)
+  {
+    btk::Analog::Pointer a1 = btk::Analog::New("A1", 20);
+    btk::Analog::Pointer a2 = btk::Analog::New("A2", 20);
+    for (int i = 0 ; i < 20 ; ++i)
+    {
+      a1->GetValues().coeffRef(i) = 0.1 * i;
+      a2->GetValues().coeffRef(i) = 2.0;
+    }
+    a1->GetValues().coeffRef(10) = 50.0; // Spike
+    btk::AnalogCollection::Pointer analogs = btk::AnalogCollection::New();
+    analogs->InsertItem(a1);
+    analogs->InsertItem(a2);
+    
+    btk::MovingStatisticFilter<btk::Analog>::Pointer filter = btk::MovingStatisticFilter<btk::Analog>::New();
+    filter->SetInput(analogs);
+    filter->SetStatistic(btk::MovingStatisticFilter<btk::Analog>::Median);
+    filter->Update();
+    btk::AnalogCollection::Pointer output = filter->GetOutput();
+    TS_ASSERT_EQUALS(output->GetItemNumber(), 2);
+    TS_ASSERT_EQUALS(output->GetItem(0)->GetLabel(), "A1");
+    TS_ASSERT_DELTA(output->GetItem(0)->GetValues().coeff(10), 1.1, 1e-15);
+    TS_ASSERT_DELTA(output->GetItem(1)->GetValues().coeff(10), 2.0, 1e-15);
+    TS_ASSERT_EQUALS(a1->GetValues().coeff(10), 50.0); // Input not modified
+    
+    filter->SetBaselineRemoval(true);
+    filter->Update();
+    output = filter->GetOutput();
+    TS_ASSERT_EQUALS(output->GetItemNumber(), 2);
+    TS_ASSERT_DELTA(output->GetItem(0)->GetValues().coeff(10), 48.9, 1e-12);
+    TS_ASSERT_DELTA(output->GetItem(0)->GetValues().coeff(5), 0.0, 1e-15);
+    TS_ASSERT(output->GetItem(1)->GetValues().isZero());
+  };
+  
+  CXXTEST_TEST(PointStandardDeviation)
+  {
+    btk::Point::Pointer p = btk::Point::New("P1", 30);
+    for (int i = 0 ; i < 30 ; ++i)
+    {
+      p->GetValues().coeffRef(i,0) = 1.0 * i;
+      p->GetValues().coeffRef(i,1) = (i % 2 == 0) ? 1.0 : -1.0;
+      p->GetValues().coeffRef(i,2) = 10.0;
+    }
+    p->GetResiduals().coeffRef(3) = -1.0;
+    btk::PointCollection::Pointer points = btk::PointCollection::New();
+    points->InsertItem(p);
+    
+    btk::MovingStatisticFilter<btk::Point>::Pointer filter = btk::MovingStatisticFilter<btk::Point>::New();
+    filter->SetInput(points);
+    filter->SetStatistic(btk::MovingStatisticFilter<btk::Point>::StandardDeviation);
+    filter->SetWindowLength(4);
+    filter->Update();
+    btk::Point::Pointer out = filter->GetOutput()->GetItem(0);
+    TS_ASSERT_EQUALS(out->GetFrameNumber(), 30);
+    TS_ASSERT_EQUALS(out->GetResiduals().coeff(3), -1.0);
+    TS_ASSERT(out->GetValues().row(3).isZero());
+    // The windows from the frame #6 do not contain the invalid frame.
+    for (int i = 6 ; i < 29 ; ++i)
+    {
+      TS_ASSERT_DELTA(out->GetValues().coeff(i,0), std::sqrt(5.0 / 3.0), 1e-12);
+      TS_ASSERT_DELTA(out->GetValues().coeff(i,1), std::sqrt(4.0 / 3.0), 1e-12);
+      TS_ASSERT_DELTA(out->GetValues().coeff(i,2), 0.0, 1e-12);
+    }
+  };
+  
+  CXXTEST_TEST(PointGap)
+  {
+    btk::Point::Pointer p = btk::Point::New("P1", 20);
+    p->GetValues().col(0).setConstant(5.0);
+    p->GetValues().col(1).setConstant(-3.0);
+    p->GetValues().col(2).setConstant(100.0);
+    // Occluded frames
+    for (int i = 8 ; i < 11 ; ++i)
+    {
+      p->GetValues().row(i).setZero();
+      p->GetResiduals().coeffRef(i) = -1.0;
+    }
+    btk::PointCollection::Pointer points = btk::PointCollection::New();
+    points->InsertItem(p);
+    
+    btk::MovingStatisticFilter<btk::Point>::Pointer filter = btk::MovingStatisticFilter<btk::Point>::New();
+    filter->SetInput(points);
+    const btk::MovingStatisticFilter<btk::Point>::Statistic statistics[3] = {btk::MovingStatisticFilter<btk::Point>::Mean, btk::MovingStatisticFilter<btk::Point>::RMS, btk::MovingStatisticFilter<btk::Point>::Median};
+    for (int k = 0 ; k < 3 ; ++k)
+    {
+      filter->SetStatistic(statistics[k]);
+      filter->Update();
+      btk::Point::Pointer out = filter->GetOutput()->GetItem(0);
+      TS_ASSERT_EQUALS(out->GetFrameNumber(), 20);
+      for (int i = 0 ; i < 20 ; ++i)
+      {
+        if ((i >= 8) && (i < 11))
+        {
+          TS_ASSERT_EQUALS(out->GetResiduals().coeff(i), -1.0);
+          TS_ASSERT(out->GetValues().row(i).isZero());
+        }
+        else
+        {
+          TS_ASSERT_EQUALS(out->GetResiduals().coeff(i), 0.0);
+          TS_ASSERT_DELTA(out->GetValues().coeff(i,0), 5.0, 1e-12);
+          TS_ASSERT_DELTA(out->GetValues().coeff(i,1), (k == 1) ? 3.0 : -3.0, 1e-12);
+          TS_ASSERT_DELTA(out->GetValues().coeff(i,2), 100.0, 1e-12);
+        }
+      }
+    }
+    
+    filter->SetStatistic(btk::MovingStatisticFilter<btk::Point>::Mean);
+    filter->SetBaselineRemoval(true);
+    filter->Update();
+    btk::Point::Pointer out = filter->GetOutput()->GetItem(0);
+    TS_ASSERT(out->GetValues().isZero(1e-12));
+    TS_ASSERT_EQUALS(out->GetResiduals().coeff(9), -1.0);
+    TS_ASSERT(p->GetValues().row(9).isZero()); // Input not modified
+    TS_ASSERT_EQUALS(p->GetValues().coeff(7,0), 5.0);
+  };
+  
+  CXXTEST_TEST(Percentile)
+  {
+    btk::Analog::Pointer a1 = btk::Analog::New("A1", 10);
+    a1->GetValues() << 3.0, 1.0, 4.0, 1.0, 5.0, 9.0, 2.0, 6.0, 5.0, 3.0;
+    btk::AnalogCollection::Pointer analogs = btk::AnalogCollection::New();
+    analogs->InsertItem(a1);
+    
+    btk::MovingStatisticFilter<btk::Analog>::Pointer filter = btk::MovingStatisticFilter<btk::Analog>::New();
+    filter->SetInput(analogs);
+    filter->SetStatistic(btk::MovingStatisticFilter<btk::Analog>::Percentile);
+    filter->SetPercentile(100.0);
+    filter->SetWindowLength(3);
+    filter->Update();
+    btk::Analog::Values ref(10);
+    ref << 3.0, 4.0, 4.0, 5.0, 9.0, 9.0, 9.0, 6.0, 6.0, 5.0;
+    for (int i = 0 ; i < 10 ; ++i)
+      TS_ASSERT_EQUALS(filter->GetOutput()->GetItem(0)->GetValues().coeff(i), ref.coeff(i));
+  };
+};
+
+CXXTEST_SUITE_REGISTRATION(MovingStatisticFilterTest)
+CXXTEST_TEST_REGISTRATION(MovingStatisticFilterTest, Constructor)
+CXXTEST_TEST_REGISTRATION(MovingStatisticFilterTest, AnalogMedianSpike)
+CXXTEST_TEST_REGISTRATION(MovingStatisticFilterTest, PointStandardDeviation)
+CXXTEST_TEST_REGISTRATION(MovingStatisticFilterTest, PointGap)
+CXXTEST_TEST_REGISTRATION(MovingStatisticFilterTest, Percentile)
+
+#endif
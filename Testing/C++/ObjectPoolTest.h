@@ -0,0 +1,150 @@
+#ifndef ObjectPoolTest_h
+#define ObjectPoolTest_h
+
+#include <btkObjectPool.h>
+#include <btkAcquisition.h>
+#include <btkThread_p.h>
+
+class ObjectPoolTest_Task : public btk::parallel_task_p
+{
+public:
+  virtual void Run(int idx)
+  {
+    for (int i = 0 ; i < 200 ; ++i)
+    {
+      btk::Point::Pointer pt = btk::Point::New(10 + (i + idx) % 5);
+      btk::Analog::Pointer analog = btk::Analog::New(100);
+      pt->GetValues().setConstant(static_cast<double>(idx));
+      analog->GetValues().setConstant(static_cast<double>(i));
+    }
+  };
+};
+
+CXXTEST_SUITE(ObjectPoolTest)
+{
+  CXXTEST_TEST(Disabled)
+  {
+    TS_ASSERT_EQUALS(btk::ObjectPool::IsEnabled(), false);
+    TS_ASSERT_EQUALS(btk::ObjectPool::GetMemoryBudget(), 0u);
+    btk::Point::Pointer pt = btk::Point::New(10);
+    pt.reset();
+    TS_ASSERT_EQUALS(btk::ObjectPool::GetEntryNumber(), 0);
+    TS_ASSERT_EQUALS(btk::ObjectPool::GetMemoryUsage(), 0u);
+    TS_ASSERT_EQUALS(btk::ObjectPool::GetHitNumber(), 0ul);
+    TS_ASSERT_EQUALS(btk::ObjectPool::GetMissNumber(), 0ul);
+  };
+
+  CXXTEST_TEST(PointData)
+  {
+    btk::ObjectPool::SetMemoryBudget(1048576);
+    btk::Point::Pointer pt = btk::Point::New("foo", 10);
+    btk::Point::Data* data = pt->GetData().get();
+    const double* values = pt->GetValues().data();
+    pt->GetValues().setConstant(5.0);
+    pt->GetResiduals().setConstant(-1.0);
+    pt.reset();
+    TS_ASSERT(btk::ObjectPool::GetEntryNumber() >= 1);
+    TS_ASSERT(btk::ObjectPool::GetMemoryUsage() >= 40u * sizeof(double));
+
+    btk::ObjectPool::ResetStatistics();
+    btk::Point::Pointer pt2 = btk::Point::New("bar", 10);
+    TS_ASSERT(btk::ObjectPool::GetHitNumber() >= 1ul);
+    TS_ASSERT_EQUALS(pt2->GetData().get(), data);
+    TS_ASSERT_EQUALS(pt2->GetValues().data(), values);
+    TS_ASSERT_EQUALS(pt2->GetData()->GetParent(), pt2.get());
+    TS_ASSERT_EQUALS(pt2->GetLabel(), "bar");
+    TS_ASSERT_EQUALS(pt2->GetFrameNumber(), 10);
+    TS_ASSERT(pt2->GetValues().isZero());
+    TS_ASSERT(pt2->GetResiduals().isZero());
+
+    // Different number of frames
+    btk::Point::Pointer pt3 = btk::Point::New(20);
+    TS_ASSERT(pt3->GetData().get() != data);
+    TS_ASSERT_EQUALS(pt3->GetFrameNumber(), 20);
+
+    // The data shared with another point is not recycled while used.
+    btk::Point::Pointer pt4 = btk::Point::New(10);
+    btk::Point::Data::Pointer shared = pt2->GetData();
+    pt4->SetData(shared, false);
+    pt2.reset();
+    btk::Point::Pointer pt5 = btk::Point::New(10);
+    TS_ASSERT(pt5->GetData() != shared);
+
+    btk::ObjectPool::SetMemoryBudget(0);
+    TS_ASSERT_EQUALS(btk::ObjectPool::GetEntryNumber(), 0);
+    TS_ASSERT_EQUALS(btk::ObjectPool::GetMemoryUsage(), 0u);
+  };
+
+  CXXTEST_TEST(Acquisition)
+  {
+    btk::ObjectPool::SetMemoryBudget(16777216);
+    btk::Acquisition::Pointer acq = btk::Acquisition::New();
+    acq->Init(20, 100, 8, 10);
+    acq->AppendEvent(btk::Event::New("FS", 10));
+    acq->Reset();
+    acq->Init(20, 100, 8, 10);
+    acq->AppendEvent(btk::Event::New("FS", 10));
+    btk::ObjectPool::ResetStatistics();
+    acq = btk::Acquisition::New();
+    acq->Init(20, 100, 8, 10);
+    acq->AppendEvent(btk::Event::New("FO", 20));
+    TS_ASSERT_EQUALS(btk::ObjectPool::GetMissNumber(), 0ul);
+    TS_ASSERT(btk::ObjectPool::GetHitNumber() >= 2ul * (20ul + 8ul));
+    TS_ASSERT_EQUALS(acq->GetPointNumber(), 20);
+    TS_ASSERT_EQUALS(acq->GetAnalogNumber(), 8);
+    TS_ASSERT_EQUALS(acq->GetAnalog(7)->GetFrameNumber(), 1000);
+    TS_ASSERT_EQUALS(acq->GetPoint(0)->GetLabel(), "uname*1");
+    TS_ASSERT(acq->GetAnalog(0)->GetValues().isZero());
+    TS_ASSERT_EQUALS(acq->GetEvent(0)->GetLabel(), "FO");
+    TS_ASSERT_EQUALS(acq->GetEvent(0)->GetFrame(), 20);
+    btk::ObjectPool::Clear();
+    TS_ASSERT_EQUALS(btk::ObjectPool::GetEntryNumber(), 0);
+    TS_ASSERT_EQUALS(btk::ObjectPool::GetMemoryBudget(), 16777216u);
+    btk::ObjectPool::SetMemoryBudget(0);
+  };
+
+  CXXTEST_TEST(Budget)
+  {
+    btk::ObjectPool::SetMemoryBudget(100 * sizeof(double) + 2 * sizeof(btk::Point::Data));
+    btk::Point::Pointer pt = btk::Point::New(20); // 80 doubles
+    pt.reset();
+    int num = btk::ObjectPool::GetEntryNumber();
+    TS_ASSERT(num >= 1);
+    // Too large
+    pt = btk::Point::New(1000);
+    pt.reset();
+    TS_ASSERT(btk::ObjectPool::GetMemoryUsage() <= btk::ObjectPool::GetMemoryBudget());
+    // The new data replaces the previous one
+    btk::Analog::Pointer analog = btk::Analog::New(50);
+    analog.reset();
+    TS_ASSERT(btk::ObjectPool::GetMemoryUsage() <= btk::ObjectPool::GetMemoryBudget());
+    btk::ObjectPool::ResetStatistics();
+    analog = btk::Analog::New(50);
+    TS_ASSERT(btk::ObjectPool::GetHitNumber() >= 1ul);
+    analog.reset();
+    btk::ObjectPool::SetMemoryBudget(0);
+  };
+  
+  CXXTEST_TEST(Concurrent)
+  {
+    btk::ObjectPool::SetMemoryBudget(65536);
+    btk::ObjectPool::ResetStatistics();
+    ObjectPoolTest_Task task;
+    TS_ASSERT_EQUALS(btk::parallel_for_p(8, &task, 4), true);
+    TS_ASSERT(btk::ObjectPool::GetHitNumber() > 0ul);
+    TS_ASSERT(btk::ObjectPool::GetMemoryUsage() <= btk::ObjectPool::GetMemoryBudget());
+    TS_ASSERT(btk::ObjectPool::GetEntryNumber() > 0);
+    btk::ObjectPool::Clear();
+    TS_ASSERT_EQUALS(btk::ObjectPool::GetEntryNumber(), 0);
+    TS_ASSERT_EQUALS(btk::ObjectPool::GetMemoryUsage(), 0u);
+    btk::ObjectPool::SetMemoryBudget(0);
+  };
+};
+
+CXXTEST_SUITE_REGISTRATION(ObjectPoolTest)
+CXXTEST_TEST_REGISTRATION(ObjectPoolTest, Disabled)
+CXXTEST_TEST_REGISTRATION(ObjectPoolTest, PointData)
+CXXTEST_TEST_REGISTRATION(ObjectPoolTest, Acquisition)
+CXXTEST_TEST_REGISTRATION(ObjectPoolTest, Budget)
+CXXTEST_TEST_REGISTRATION(ObjectPoolTest, Concurrent)
+#endif
@@ -3,6 +3,8 @@
 
 #include <btkDataObject.h>
 #include <btkProcessObject.h>
+#include <btkPipelineExecutor.h>
+#include <btkException.h>
 
 class Source : public btk::DataObject
 {
@@ -59,6 +61,97 @@ private:
   int m_Inc;
 };
 
+class SumFilter : public btk::ProcessObject
+{
+public:
+  typedef btkSharedPtr<SumFilter> Pointer;
+  static Pointer New(int inputNumber) {return Pointer(new SumFilter(inputNumber));}; 
+  void SetInc(int inc)
+  {
+    this->m_Inc = inc; 
+    this->Modified();
+  };
+  void SetThrow(bool enabled)
+  {
+    this->m_Throw = enabled; 
+    this->Modified();
+  };
+  int GetGenerationNumber() const {return this->m_GenerationNumber;};
+  void SetInput(int idx, Source::Pointer input) {this->SetNthInput(idx, input);};
+  Source::Pointer GetOutput() {return static_pointer_cast<Source>(this->GetNthOutput(0));};
+  
+protected:
+  virtual btk::DataObject::Pointer MakeOutput(int /* idx */)
+  {
+    return Source::New();
+  };
+  virtual void GenerateData()
+  {
+    ++this->m_GenerationNumber;
+    if (this->m_Throw)
+      throw(btk::RuntimeError("Generation failed."));
+    int sum = this->m_Inc;
+    for (int i = 0 ; i < this->GetInputNumber() ; ++i)
+    {
+      Source::Pointer input = static_pointer_cast<Source>(this->GetNthInput(i));
+      if (input)
+        sum += input->GetValue();
+    }
+    this->GetOutput()->SetValue(sum);
+  };
+  
+private:
+  SumFilter(int inputNumber)
+  : btk::ProcessObject()
+  {
+    this->SetInputNumber(inputNumber);
+    this->SetOutputNumber(1);
+    this->m_Inc = 1;
+    this->m_Throw = false;
+    this->m_GenerationNumber = 0;
+  };
+  
+  int m_Inc;
+  bool m_Throw;
+  int m_GenerationNumber;
+};
+
+class RelinkFilter : public btk::ProcessObject
+{
+public:
+  typedef btkSharedPtr<RelinkFilter> Pointer;
+  static Pointer New() {return Pointer(new RelinkFilter());}; 
+  void SetInput(Source::Pointer input) {this->SetNthInput(0, input);};
+  Source::Pointer GetOutput() {return static_pointer_cast<Source>(this->GetNthOutput(0));};
+  void SetShared(Source::Pointer shared) {this->m_Shared = shared; this->Modified();};
+  
+protected:
+  virtual btk::DataObject::Pointer MakeOutput(int /* idx */)
+  {
+    return Source::New();
+  };
+  virtual void GenerateData()
+  {
+    Source::Pointer output = this->GetOutput();
+    Source::Pointer input = static_pointer_cast<Source>(this->GetNthInput(0));
+    for (int i = 0 ; i < 2000 ; ++i)
+    {
+      this->m_Shared->SetParent(output.get());
+      output->SetValue(input->GetValue() + i);
+    }
+  };
+  
+private:
+  RelinkFilter()
+  : btk::ProcessObject(), m_Shared()
+  {
+    this->SetInputNumber(1);
+    this->SetOutputNumber(1);
+  };
+  
+  Source::Pointer m_Shared;
+};
+
 CXXTEST_SUITE(PipelineTest)
 {
   CXXTEST_TEST(PipelineOne)
@@ -164,6 +257,197 @@ CXXTEST_SUITE(PipelineTest)
     TS_ASSERT_EQUALS(res1->GetValue(), 11);
     TS_ASSERT_EQUALS(res2->GetValue(), 13);
   };
+  
+  CXXTEST_TEST(ExecutorFanOut)
+  {
+    Source::Pointer src = Source::New();
+    src->SetValue(5);
+    SumFilter::Pointer reader = SumFilter::New(1);
+    reader->SetInput(0, src);
+    std::vector<SumFilter::Pointer> branches;
+    for (int i = 0 ; i < 6 ; ++i)
+    {
+      branches.push_back(SumFilter::New(1));
+      branches.back()->SetInc(i);
+      branches.back()->SetInput(0, reader->GetOutput());
+    }
+    SumFilter::Pointer merge = SumFilter::New(2);
+    merge->SetInput(0, branches[0]->GetOutput());
+    merge->SetInput(1, branches[1]->GetOutput());
+    
+    btk::PipelineExecutor::Pointer executor = btk::PipelineExecutor::New();
+    executor->SetThreadNumber(4);
+    executor->AddProcess(merge);
+    for (int i = 1 ; i < 6 ; ++i)
+      executor->AddProcess(branches[i]);
+    executor->AddProcess(merge);
+    TS_ASSERT_EQUALS(executor->GetProcessNumber(), 6);
+    TS_ASSERT_EQUALS(executor->Update(), true);
+    TS_ASSERT_EQUALS(executor->GetLevelNumber(), 3);
+    TS_ASSERT_EQUALS(reader->GetOutput()->GetValue(), 6);
+    for (int i = 0 ; i < 6 ; ++i)
+    {
+      TS_ASSERT_EQUALS(branches[i]->GetOutput()->GetValue(), 6 + i);
+      TS_ASSERT_EQUALS(branches[i]->GetGenerationNumber(), 1);
+    }
+    TS_ASSERT_EQUALS(merge->GetOutput()->GetValue(), 6 + 7 + 1);
+    TS_ASSERT_EQUALS(reader->GetGenerationNumber(), 1);
+    
+    // Nothing modified
+    TS_ASSERT_EQUALS(executor->Update(), true);
+    TS_ASSERT_EQUALS(reader->GetGenerationNumber(), 1);
+    TS_ASSERT_EQUALS(merge->GetGenerationNumber(), 1);
+    
+    // Only one branch modified
+    branches[1]->SetInc(10);
+    TS_ASSERT_EQUALS(executor->Update(), true);
+    TS_ASSERT_EQUALS(reader->GetGenerationNumber(), 1);
+    TS_ASSERT_EQUALS(branches[0]->GetGenerationNumber(), 1);
+    TS_ASSERT_EQUALS(branches[1]->GetGenerationNumber(), 2);
+    TS_ASSERT_EQUALS(branches[2]->GetGenerationNumber(), 1);
+    TS_ASSERT_EQUALS(merge->GetGenerationNumber(), 2);
+    TS_ASSERT_EQUALS(merge->GetOutput()->GetValue(), 6 + 16 + 1);
+    
+    // Source modified
+    src->SetValue(0);
+    TS_ASSERT_EQUALS(executor->Update(), true);
+    TS_ASSERT_EQUALS(reader->GetGenerationNumber(), 2);
+    for (int i = 2 ; i < 6 ; ++i)
+      TS_ASSERT_EQUALS(branches[i]->GetOutput()->GetValue(), 1 + i);
+    TS_ASSERT_EQUALS(merge->GetOutput()->GetValue(), 1 + 11 + 1);
+    
+    // Same results with the serial update
+    src->SetValue(3);
+    merge->Update();
+    TS_ASSERT_EQUALS(merge->GetOutput()->GetValue(), 4 + 14 + 1);
+    TS_ASSERT_EQUALS(branches[2]->GetGenerationNumber(), 2);
+    TS_ASSERT_EQUALS(executor->Update(), true);
+    TS_ASSERT_EQUALS(branches[2]->GetGenerationNumber(), 3);
+    TS_ASSERT_EQUALS(merge->GetGenerationNumber(), 4);
+  };
+  
+  CXXTEST_TEST(ExecutorCycle)
+  {
+    Source::Pointer src = Source::New();
+    src->SetValue(5);
+    Filter::Pointer incFilt = Filter::New();
+    incFilt->SetInput(src);
+    btk::PipelineExecutor::Pointer executor = btk::PipelineExecutor::New();
+    executor->AddProcess(incFilt);
+    executor->Update();
+    TS_ASSERT_EQUALS(incFilt->GetOutput()->GetValue(), 6);
+    incFilt->SetInput(incFilt->GetOutput());
+    executor->Update();
+    TS_ASSERT_EQUALS(incFilt->GetOutput()->GetValue(), 7);
+    TS_ASSERT_EQUALS(executor->GetLevelNumber(), 1);
+    executor->Update();
+    TS_ASSERT_EQUALS(incFilt->GetOutput()->GetValue(), 8);
+  };
+  
+  CXXTEST_TEST(ExecutorFailure)
+  {
+    Source::Pointer src = Source::New();
+    src->SetValue(5);
+    SumFilter::Pointer first = SumFilter::New(1);
+    first->SetInput(0, src);
+    SumFilter::Pointer second = SumFilter::New(1);
+    second->SetInput(0, first->GetOutput());
+    SumFilter::Pointer other = SumFilter::New(1);
+    other->SetInput(0, src);
+    first->SetThrow(true);
+    
+    btk::PipelineExecutor::Pointer executor = btk::PipelineExecutor::New();
+    executor->AddProcess(second);
+    executor->AddProcess(other);
+    TS_ASSERT_EQUALS(executor->Update(), false);
+    TS_ASSERT_EQUALS(first->GetGenerationNumber(), 1);
+    TS_ASSERT_EQUALS(second->GetGenerationNumber(), 0);
+    TS_ASSERT_EQUALS(other->GetOutput()->GetValue(), 6);
+    
+    first->SetThrow(false);
+    TS_ASSERT_EQUALS(executor->Update(), true);
+    TS_ASSERT_EQUALS(second->GetOutput()->GetValue(), 7);
+    TS_ASSERT_EQUALS(other->GetGenerationNumber(), 1);
+  };
+  
+  CXXTEST_TEST(ModificationDeferral)
+  {
+    Source::Pointer parent = Source::New();
+    Source::Pointer child1 = Source::New();
+    Source::Pointer child2 = Source::New();
+    child1->SetParent(parent.get());
+    child2->SetParent(parent.get());
+    child1->SetValue(1);
+    TS_ASSERT_EQUALS(parent->GetTimestamp(), child1->GetTimestamp() + 1);
+    
+    unsigned long int ts = parent->GetTimestamp();
+    parent->BeginModification();
+    parent->BeginModification();
+    TS_ASSERT_EQUALS(parent->IsModificationDeferred(), true);
+    child1->SetValue(2);
+    child2->SetValue(3);
+    parent->SetValue(4);
+    TS_ASSERT(child1->GetTimestamp() > ts);
+    TS_ASSERT(child2->GetTimestamp() > child1->GetTimestamp());
+    TS_ASSERT_EQUALS(parent->GetTimestamp(), ts);
+    parent->EndModification();
+    TS_ASSERT_EQUALS(parent->GetTimestamp(), ts);
+    parent->EndModification();
+    TS_ASSERT_EQUALS(parent->IsModificationDeferred(), false);
+    TS_ASSERT(parent->GetTimestamp() > child2->GetTimestamp());
+    TS_ASSERT_EQUALS(parent->GetValue(), 4);
+    
+    // Nothing modified
+    ts = parent->GetTimestamp();
+    parent->BeginModification();
+    parent->EndModification();
+    TS_ASSERT_EQUALS(parent->GetTimestamp(), ts);
+    
+    // Pipeline updated only once after the bulk edit
+    SumFilter::Pointer filter = SumFilter::New(1);
+    filter->SetInput(0, parent);
+    filter->Update();
+    TS_ASSERT_EQUALS(filter->GetOutput()->GetValue(), 5);
+    parent->BeginModification();
+    child1->SetValue(5);
+    filter->Update();
+    TS_ASSERT_EQUALS(filter->GetGenerationNumber(), 1);
+    parent->EndModification();
+    filter->Update();
+    TS_ASSERT_EQUALS(filter->GetGenerationNumber(), 2);
+  };
+  
+  CXXTEST_TEST(ConcurrentModified)
+  {
+    Source::Pointer src = Source::New();
+    Source::Pointer root = Source::New();
+    Source::Pointer shared = Source::New();
+    unsigned long int ts = root->GetTimestamp();
+    btk::PipelineExecutor::Pointer executor = btk::PipelineExecutor::New();
+    executor->SetThreadNumber(8);
+    std::vector<RelinkFilter::Pointer> filters;
+    for (int i = 0 ; i < 8 ; ++i)
+    {
+      filters.push_back(RelinkFilter::New());
+      filters.back()->SetInput(src);
+      filters.back()->SetShared(shared);
+      filters.back()->GetOutput()->SetParent(root.get());
+      executor->AddProcess(filters.back());
+    }
+    TS_ASSERT_EQUALS(executor->Update(), true);
+    bool linked = false;
+    for (int i = 0 ; i < 8 ; ++i)
+    {
+      TS_ASSERT_EQUALS(filters[i]->GetOutput()->GetValue(), 1999);
+      TS_ASSERT_EQUALS(filters[i]->GetOutput()->GetParent(), root.get());
+      linked |= (shared->GetParent() == filters[i]->GetOutput().get());
+    }
+    TS_ASSERT_EQUALS(linked, true);
+    TS_ASSERT(root->GetTimestamp() > ts);
+    shared.reset();
+    filters.clear();
+    TS_ASSERT_EQUALS(root->HasParent(), false);
+  };
 };
 
 CXXTEST_SUITE_REGISTRATION(PipelineTest)
@@ -172,4 +456,9 @@ CXXTEST_TEST_REGISTRATION(PipelineTest, PipelineTwo)
 CXXTEST_TEST_REGISTRATION(PipelineTest, PipelineThree)
 CXXTEST_TEST_REGISTRATION(PipelineTest, DeleteParent)
 CXXTEST_TEST_REGISTRATION(PipelineTest, NewInput)
+CXXTEST_TEST_REGISTRATION(PipelineTest, ExecutorFanOut)
+CXXTEST_TEST_REGISTRATION(PipelineTest, ExecutorCycle)
+CXXTEST_TEST_REGISTRATION(PipelineTest, ExecutorFailure)
+CXXTEST_TEST_REGISTRATION(PipelineTest, ModificationDeferral)
+CXXTEST_TEST_REGISTRATION(PipelineTest, ConcurrentModified)
 #endif
@@ -0,0 +1,129 @@
+#ifndef PointDifferentiationFilterTest_h
+#define PointDifferentiationFilterTest_h
+
+#include <btkPointDifferentiationFilter.h>
+#include <btkConvert.h>
+
+CXXTEST_SUITE(PointDifferentiationFilterTest)
+{
+  CXXTEST_TEST(Constructor)
+  {
+    btk::PointDifferentiationFilter::Pointer filter = btk::PointDifferentiationFilter::New();
+    TS_ASSERT_EQUALS(filter->GetFrequency(), 0.0);
+    TS_ASSERT_EQUALS(filter->GetWindowLength(), 9);
+    TS_ASSERT_EQUALS(filter->GetPolynomialOrder(), 3);
+    TS_ASSERT_EQUALS(filter->GetVelocityOutput()->GetItemNumber(), 0);
+    TS_ASSERT_EQUALS(filter->GetAccelerationOutput()->GetItemNumber(), 0);
+    filter->SetWindowLength(4);
+    TS_ASSERT_EQUALS(filter->GetWindowLength(), 9);
+    filter->SetPolynomialOrder(1);
+    TS_ASSERT_EQUALS(filter->GetPolynomialOrder(), 3);
+  };
+  
+  CXXTEST_TEST(Polynomial)
+  {
+    btk::PointCollection::Pointer points = btk::PointCollection::New();
+    for (int j = 0 ; j < 3 ; ++j)
+    {
+      btk::Point::Pointer p = btk::Point::New("P" + btk::ToString(j), 50);
+      for (int i = 0 ; i < 50 ; ++i)
+      {
+        const double t = static_cast<double>(i) / 100.0;
+        p->GetValues().coeffRef(i,0) = 10.0 * j * t * t * t;
+        p->GetValues().coeffRef(i,1) = 2.0 * t * t + t;
+        p->GetValues().coeffRef(i,2) = 5.0 + j;
+      }
+      points->InsertItem(p);
+    }
+    
+    btk::PointDifferentiationFilter::Pointer filter = btk::PointDifferentiationFilter::New();
+    filter->SetInput(points);
+    filter->SetFrequency(100.0);
+    filter->Update();
+    TS_ASSERT_EQUALS(filter->GetVelocityOutput()->GetItemNumber(), 3);
+    TS_ASSERT_EQUALS(filter->GetAccelerationOutput()->GetItemNumber(), 3);
+    for (int j = 0 ; j < 3 ; ++j)
+    {
+      btk::Point::Pointer vel = filter->GetVelocityOutput()->GetItem(j);
+      btk::Point::Pointer acc = filter->GetAccelerationOutput()->GetItem(j);
+      TS_ASSERT_EQUALS(vel->GetLabel(), "P" + btk::ToString(j));
+      TS_ASSERT_EQUALS(acc->GetFrameNumber(), 50);
+      for (int i = 0 ; i < 50 ; ++i)
+      {
+        const double t = static_cast<double>(i) / 100.0;
+        TSM_ASSERT_DELTA("Point #" + btk::ToString(j) + " - Frame #" + btk::ToString(i), vel->GetValues().coeff(i,0), 30.0 * j * t * t, 1e-9);
+        TSM_ASSERT_DELTA("Point #" + btk::ToString(j) + " - Frame #" + btk::ToString(i), vel->GetValues().coeff(i,1), 4.0 * t + 1.0, 1e-9);
+        TSM_ASSERT_DELTA("Point #" + btk::ToString(j) + " - Frame #" + btk::ToString(i), vel->GetValues().coeff(i,2), 0.0, 1e-9);
+        TSM_ASSERT_DELTA("Point #" + btk::ToString(j) + " - Frame #" + btk::ToString(i), acc->GetValues().coeff(i,0), 60.0 * j * t, 1e-6);
+        TSM_ASSERT_DELTA("Point #" + btk::ToString(j) + " - Frame #" + btk::ToString(i), acc->GetValues().coeff(i,1), 4.0, 1e-6);
+        TSM_ASSERT_DELTA("Point #" + btk::ToString(j) + " - Frame #" + btk::ToString(i), acc->GetValues().coeff(i,2), 0.0, 1e-6);
+        TS_ASSERT_EQUALS(vel->GetResiduals().coeff(i), 0.0);
+      }
+    }
+  };
+  
+  CXXTEST_TEST(Gaps)
+  {
+    btk::Point::Pointer p = btk::Point::New("P", 40);
+    for (int i = 0 ; i < 40 ; ++i)
+    {
+      const double t = static_cast<double>(i) / 50.0;
+      p->GetValues().coeffRef(i,0) = 3.0 * t * t;
+      p->GetValues().coeffRef(i,1) = -t;
+      p->GetValues().coeffRef(i,2) = 1.0;
+      p->GetResiduals().coeffRef(i) = 0.5;
+    }
+    // Gap of 3 frames: frames 0-11 are valid, 15-19 are valid but too short for the window, 20 to 39 are valid.
+    for (int i = 12 ; i < 15 ; ++i)
+    {
+      p->GetValues().row(i).setZero();
+      p->GetResiduals().coeffRef(i) = -1.0;
+    }
+    p->GetValues().row(20).setZero();
+    p->GetResiduals().coeffRef(20) = -1.0;
+    
+    btk::PointDifferentiationFilter::Pointer filter = btk::PointDifferentiationFilter::New();
+    filter->SetInput(p);
+    filter->SetFrequency(50.0);
+    filter->SetWindowLength(7);
+    filter->SetPolynomialOrder(2);
+    filter->Update();
+    btk::Point::Pointer vel = filter->GetVelocityOutput()->GetItem(0);
+    btk::Point::Pointer acc = filter->GetAccelerationOutput()->GetItem(0);
+    for (int i = 0 ; i < 40 ; ++i)
+    {
+      const double t = static_cast<double>(i) / 50.0;
+      if ((i < 12) || (i > 20))
+      {
+        TSM_ASSERT_EQUALS("Frame #" + btk::ToString(i), vel->GetResiduals().coeff(i), 0.5);
+        TSM_ASSERT_DELTA("Frame #" + btk::ToString(i), vel->GetValues().coeff(i,0), 6.0 * t, 1e-10);
+        TSM_ASSERT_DELTA("Frame #" + btk::ToString(i), vel->GetValues().coeff(i,1), -1.0, 1e-10);
+        TSM_ASSERT_DELTA("Frame #" + btk::ToString(i), acc->GetValues().coeff(i,0), 6.0, 1e-8);
+      }
+      else
+      {
+        TSM_ASSERT_EQUALS("Frame #" + btk::ToString(i), vel->GetResiduals().coeff(i), -1.0);
+        TSM_ASSERT_EQUALS("Frame #" + btk::ToString(i), acc->GetResiduals().coeff(i), -1.0);
+        TSM_ASSERT_EQUALS("Frame #" + btk::ToString(i), vel->GetValues().coeff(i,0), 0.0);
+      }
+    }
+  };
+  
+  CXXTEST_TEST(NoFrequency)
+  {
+    btk::Point::Pointer p = btk::Point::New("P", 40);
+    btk::PointDifferentiationFilter::Pointer filter = btk::PointDifferentiationFilter::New();
+    filter->SetInput(p);
+    filter->Update();
+    TS_ASSERT_EQUALS(filter->GetVelocityOutput()->GetItemNumber(), 0);
+    TS_ASSERT_EQUALS(filter->GetAccelerationOutput()->GetItemNumber(), 0);
+  };
+};
+
+CXXTEST_SUITE_REGISTRATION(PointDifferentiationFilterTest)
+CXXTEST_TEST_REGISTRATION(PointDifferentiationFilterTest, Constructor)
+CXXTEST_TEST_REGISTRATION(PointDifferentiationFilterTest, Polynomial)
+CXXTEST_TEST_REGISTRATION(PointDifferentiationFilterTest, Gaps)
+CXXTEST_TEST_REGISTRATION(PointDifferentiationFilterTest, NoFrequency)
+
+#endif
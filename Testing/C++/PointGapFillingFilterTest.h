@@ -0,0 +1,145 @@
+#ifndef PointGapFillingFilterTest_h
+#define PointGapFillingFilterTest_h
+
+#include <btkPointGapFillingFilter.h>
+#include <btkPointCollection.h>
+#include <btkConvert.h>
+
+CXXTEST_SUITE(PointGapFillingFilterTest)
+{
+  CXXTEST_TEST(Constructor)
+  {
+    btk::PointGapFillingFilter::Pointer gff = btk::PointGapFillingFilter::New();
+    TS_ASSERT_EQUALS(gff->GetMethod(), btk::PointGapFillingFilter::PCHIP);
+    TS_ASSERT_EQUALS(gff->GetMaxInterpolationGap(), 10);
+    TS_ASSERT_EQUALS(gff->GetThreadNumber(), 0);
+    TS_ASSERT_EQUALS(gff->GetRigidBodies().size(), 0u);
+  };
+  
+  CXXTEST_TEST(Linear)
+  {
+    btk::Point::Pointer p = btk::Point::New("P1", 20);
+    for (int i = 0 ; i < 20 ; ++i)
+      p->SetDataSlice(i, 2.0 * i, -1.0 * i, 5.0);
+    for (int i = 5 ; i < 9 ; ++i)
+      p->SetDataSlice(i, 0.0, 0.0, 0.0, -1.0);
+    p->GetResiduals().coeffRef(0) = -1.0; // Leading gap: cannot be interpolated
+    btk::PointGapFillingFilter::Pointer gff = btk::PointGapFillingFilter::New();
+    gff->SetInput(p);
+    gff->SetMethod(btk::PointGapFillingFilter::Linear);
+    gff->Update();
+    btk::Point::Pointer output = gff->GetOutput()->GetItem(0);
+    TS_ASSERT(output != p);
+    TS_ASSERT_EQUALS(output->GetResiduals().coeff(0), -1.0);
+    for (int i = 5 ; i < 9 ; ++i)
+    {
+      TS_ASSERT_DELTA(output->GetValues().coeff(i,0), 2.0 * i, 1e-12);
+      TS_ASSERT_DELTA(output->GetValues().coeff(i,1), -1.0 * i, 1e-12);
+      TS_ASSERT_DELTA(output->GetValues().coeff(i,2), 5.0, 1e-12);
+      TS_ASSERT_EQUALS(output->GetResiduals().coeff(i), 0.0);
+      TS_ASSERT_EQUALS(p->GetResiduals().coeff(i), -1.0);
+    }
+  };
+  
+  CXXTEST_TEST(MaxInterpolationGap)
+  {
+    btk::Point::Pointer p = btk::Point::New("P1", 30);
+    for (int i = 0 ; i < 30 ; ++i)
+      p->SetDataSlice(i, sin(0.1 * i), cos(0.1 * i), 0.1 * i);
+    for (int i = 2 ; i < 5 ; ++i)
+      p->GetResiduals().coeffRef(i) = -1.0;
+    for (int i = 10 ; i < 20 ; ++i)
+      p->GetResiduals().coeffRef(i) = -1.0;
+    btk::PointGapFillingFilter::Pointer gff = btk::PointGapFillingFilter::New();
+    gff->SetInput(p);
+    gff->SetMaxInterpolationGap(5);
+    gff->Update();
+    btk::Point::Pointer output = gff->GetOutput()->GetItem(0);
+    for (int i = 2 ; i < 5 ; ++i)
+    {
+      TS_ASSERT_EQUALS(output->GetResiduals().coeff(i), 0.0);
+      TS_ASSERT_DELTA(output->GetValues().coeff(i,2), 0.1 * i, 1e-3);
+    }
+    for (int i = 10 ; i < 20 ; ++i)
+      TS_ASSERT_EQUALS(output->GetResiduals().coeff(i), -1.0);
+  };
+  
+  CXXTEST_TEST(SplineMultiplePoints)
+  {
+    btk::PointCollection::Pointer points = btk::PointCollection::New();
+    for (int j = 0 ; j < 16 ; ++j)
+    {
+      btk::Point::Pointer p = btk::Point::New("P" + btk::ToString(j), 100);
+      for (int i = 0 ; i < 100 ; ++i)
+        p->SetDataSlice(i, 100.0 * sin(0.05 * i + j), 50.0 * cos(0.05 * i), j);
+      for (int i = 40 + j ; i < 45 + j ; ++i)
+        p->GetResiduals().coeffRef(i) = -1.0;
+      points->InsertItem(p);
+    }
+    btk::PointGapFillingFilter::Pointer gff = btk::PointGapFillingFilter::New();
+    gff->SetInput(points);
+    gff->SetMethod(btk::PointGapFillingFilter::Spline);
+    gff->SetThreadNumber(4);
+    gff->Update();
+    TS_ASSERT_EQUALS(gff->GetOutput()->GetItemNumber(), 16);
+    for (int j = 0 ; j < 16 ; ++j)
+    {
+      btk::Point::Pointer output = gff->GetOutput()->GetItem(j);
+      TS_ASSERT_EQUALS(output->GetLabel(), "P" + btk::ToString(j));
+      TS_ASSERT((output->GetResiduals().array() >= 0.0).all());
+      for (int i = 40 + j ; i < 45 + j ; ++i)
+      {
+        TS_ASSERT_DELTA(output->GetValues().coeff(i,0), 100.0 * sin(0.05 * i + j), 1e-2);
+        TS_ASSERT_DELTA(output->GetValues().coeff(i,1), 50.0 * cos(0.05 * i), 1e-2);
+      }
+    }
+  };
+  
+  CXXTEST_TEST(RigidBody)
+  {
+    // Four markers of a rigid body translating and rotating around the Z axis
+    const double local[4][3] = {{0.0, 0.0, 0.0}, {100.0, 0.0, 0.0}, {0.0, 80.0, 0.0}, {50.0, 40.0, 30.0}};
+    const char* labels[4] = {"M1", "M2", "M3", "M4"};
+    btk::PointCollection::Pointer points = btk::PointCollection::New();
+    std::list<std::string> body;
+    for (int j = 0 ; j < 4 ; ++j)
+    {
+      btk::Point::Pointer p = btk::Point::New(labels[j], 50);
+      for (int i = 0 ; i < 50 ; ++i)
+      {
+        double a = 0.02 * i;
+        p->SetDataSlice(i, cos(a) * local[j][0] - sin(a) * local[j][1] + 3.0 * i, sin(a) * local[j][0] + cos(a) * local[j][1], local[j][2] + 1.0);
+      }
+      points->InsertItem(p);
+      body.push_back(labels[j]);
+    }
+    btk::Point::Pointer m4 = points->GetItem(3);
+    for (int i = 0 ; i < 5 ; ++i) // Leading gap
+      m4->GetResiduals().coeffRef(i) = -1.0;
+    for (int i = 20 ; i < 28 ; ++i)
+      m4->GetResiduals().coeffRef(i) = -1.0;
+    btk::PointGapFillingFilter::Pointer gff = btk::PointGapFillingFilter::New();
+    gff->SetInput(points);
+    gff->SetMethod(btk::PointGapFillingFilter::RigidBody);
+    gff->AppendRigidBody(body);
+    gff->Update();
+    btk::Point::Pointer output = gff->GetOutput()->GetItem(3);
+    TS_ASSERT((output->GetResiduals().array() >= 0.0).all());
+    for (int i = 0 ; i < 50 ; ++i)
+    {
+      double a = 0.02 * i;
+      TS_ASSERT_DELTA(output->GetValues().coeff(i,0), cos(a) * local[3][0] - sin(a) * local[3][1] + 3.0 * i, 1e-9);
+      TS_ASSERT_DELTA(output->GetValues().coeff(i,1), sin(a) * local[3][0] + cos(a) * local[3][1], 1e-9);
+      TS_ASSERT_DELTA(output->GetValues().coeff(i,2), local[3][2] + 1.0, 1e-9);
+    }
+  };
+};
+
+CXXTEST_SUITE_REGISTRATION(PointGapFillingFilterTest)
+CXXTEST_TEST_REGISTRATION(PointGapFillingFilterTest, Constructor)
+CXXTEST_TEST_REGISTRATION(PointGapFillingFilterTest, Linear)
+CXXTEST_TEST_REGISTRATION(PointGapFillingFilterTest, MaxInterpolationGap)
+CXXTEST_TEST_REGISTRATION(PointGapFillingFilterTest, SplineMultiplePoints)
+CXXTEST_TEST_REGISTRATION(PointGapFillingFilterTest, RigidBody)
+
+#endif
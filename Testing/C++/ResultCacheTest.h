@@ -0,0 +1,268 @@
+#ifndef ResultCacheTest_h
+#define ResultCacheTest_h
+
+#include <btkResultCache.h>
+#include <btkProcessObject.h>
+#include <btkPointCollection.h>
+#include <btkWrenchCollection.h>
+#include <btkConvert.h>
+
+class ScalePointsFilter : public btk::ProcessObject
+{
+public:
+  typedef btkSharedPtr<ScalePointsFilter> Pointer;
+  static Pointer New() {return Pointer(new ScalePointsFilter());};
+  btk::PointCollection::Pointer GetInput() {return static_pointer_cast<btk::PointCollection>(this->GetNthInput(0));};
+  void SetInput(btk::PointCollection::Pointer input) {this->SetNthInput(0, input);};
+  btk::PointCollection::Pointer GetOutput() {return static_pointer_cast<btk::PointCollection>(this->GetNthOutput(0));};
+  double GetScale() const {return this->m_Scale;};
+  void SetScale(double scale)
+  {
+    this->m_Scale = scale;
+    this->Modified();
+  };
+  int GetGenerationNumber() const {return this->m_GenerationNumber;};
+  
+protected:
+  virtual btk::DataObject::Pointer MakeOutput(int ) {return btk::PointCollection::New();};
+  virtual void GenerateData()
+  {
+    ++this->m_GenerationNumber;
+    btk::PointCollection::Pointer output = this->GetOutput();
+    output->Clear();
+    for (btk::PointCollection::ConstIterator it = this->GetInput()->Begin() ; it != this->GetInput()->End() ; ++it)
+    {
+      btk::Point::Pointer pt = (*it)->Clone();
+      pt->SetValues(pt->GetValues() * this->m_Scale);
+      output->InsertItem(pt);
+    }
+  };
+  virtual bool GetCacheParameters(std::string& parameters) const
+  {
+    parameters = btk::ToString(this->m_Scale);
+    return true;
+  };
+  
+private:
+  ScalePointsFilter()
+  {
+    this->SetInputNumber(1);
+    this->SetOutputNumber(1);
+    this->m_Scale = 1.0;
+    this->m_GenerationNumber = 0;
+  };
+  double m_Scale;
+  int m_GenerationNumber;
+};
+
+btk::PointCollection::Pointer ResultCacheTest_Points(double offset)
+{
+  btk::PointCollection::Pointer points = btk::PointCollection::New();
+  btk::Point::Pointer pt = btk::Point::New("uname*1", 10);
+  for (int i = 0 ; i < 10 ; ++i)
+  {
+    pt->GetValues().coeffRef(i,0) = offset + i;
+    pt->GetValues().coeffRef(i,1) = offset - i;
+    pt->GetValues().coeffRef(i,2) = offset * i;
+  }
+  points->InsertItem(pt);
+  return points;
+};
+
+CXXTEST_SUITE(ResultCacheTest)
+{
+  CXXTEST_TEST(Default)
+  {
+    btk::ResultCache::Pointer cache = btk::ResultCache::New();
+    TS_ASSERT_EQUALS(cache->GetMemoryBudget(), 268435456u);
+    TS_ASSERT_EQUALS(cache->GetMemoryUsage(), 0u);
+    TS_ASSERT_EQUALS(cache->GetEntryNumber(), 0);
+    TS_ASSERT_EQUALS(cache->GetHitNumber(), 0ul);
+    TS_ASSERT_EQUALS(cache->GetMissNumber(), 0ul);
+    TS_ASSERT_EQUALS(cache->GetEvictionNumber(), 0ul);
+    TS_ASSERT_EQUALS(btk::ResultCache::ComputeDigest("").length(), 16u);
+    TS_ASSERT(btk::ResultCache::ComputeDigest("a") != btk::ResultCache::ComputeDigest("b"));
+  };
+  
+  CXXTEST_TEST(ContentDigest)
+  {
+    std::string d1, d2, d3;
+    TS_ASSERT_EQUALS(btk::ResultCache::ComputeContentDigest(ResultCacheTest_Points(1.0), d1), true);
+    TS_ASSERT_EQUALS(btk::ResultCache::ComputeContentDigest(ResultCacheTest_Points(1.0), d2), true);
+    TS_ASSERT_EQUALS(d1, d2);
+    btk::PointCollection::Pointer points = ResultCacheTest_Points(1.0);
+    points->GetItem(0)->GetValues().coeffRef(5,1) += 1e-9;
+    TS_ASSERT_EQUALS(btk::ResultCache::ComputeContentDigest(points, d3), true);
+    TS_ASSERT(d1 != d3);
+    points = ResultCacheTest_Points(1.0);
+    points->GetItem(0)->SetLabel("uname*2");
+    TS_ASSERT_EQUALS(btk::ResultCache::ComputeContentDigest(points, d3), true);
+    TS_ASSERT(d1 != d3);
+    TS_ASSERT_EQUALS(btk::ResultCache::ComputeContentDigest(btk::DataObject::ConstPointer(), d3), false);
+  };
+  
+  CXXTEST_TEST(HitAndMiss)
+  {
+    btk::ResultCache::Pointer cache = btk::ResultCache::New();
+    ScalePointsFilter::Pointer f1 = ScalePointsFilter::New();
+    f1->SetInput(ResultCacheTest_Points(1.0));
+    f1->SetScale(2.0);
+    f1->SetResultCache(cache);
+    f1->Update();
+    TS_ASSERT_EQUALS(f1->GetGenerationNumber(), 1);
+    TS_ASSERT_EQUALS(cache->GetMissNumber(), 1ul);
+    TS_ASSERT_EQUALS(cache->GetHitNumber(), 0ul);
+    TS_ASSERT_EQUALS(cache->GetEntryNumber(), 1);
+    TS_ASSERT(cache->GetMemoryUsage() > 10u * 4u * sizeof(double));
+    
+    // Another filter with the same parameters and an identical input
+    ScalePointsFilter::Pointer f2 = ScalePointsFilter::New();
+    btk::PointCollection::Pointer output = f2->GetOutput();
+    f2->SetInput(ResultCacheTest_Points(1.0));
+    f2->SetScale(2.0);
+    f2->SetResultCache(cache);
+    f2->Update();
+    TS_ASSERT_EQUALS(f2->GetGenerationNumber(), 0);
+    TS_ASSERT_EQUALS(cache->GetHitNumber(), 1ul);
+    TS_ASSERT_EQUALS(f2->GetOutput(), output);
+    TS_ASSERT_EQUALS(output->GetItemNumber(), 1);
+    TS_ASSERT(output->GetItem(0) != f1->GetOutput()->GetItem(0));
+    TS_ASSERT(output->GetItem(0)->GetValues().isApprox(f1->GetOutput()->GetItem(0)->GetValues()));
+    TS_ASSERT_EQUALS(output->GetItem(0)->GetLabel(), "uname*1");
+    
+    // Modifying the restored output doesn't modify the cached one.
+    output->GetItem(0)->GetValues().setZero();
+    f2->SetScale(3.0);
+    f2->Update();
+    TS_ASSERT_EQUALS(f2->GetGenerationNumber(), 1);
+    TS_ASSERT_EQUALS(cache->GetMissNumber(), 2ul);
+    f2->SetScale(2.0);
+    f2->Update();
+    TS_ASSERT_EQUALS(f2->GetGenerationNumber(), 1);
+    TS_ASSERT_EQUALS(cache->GetHitNumber(), 2ul);
+    TS_ASSERT(f2->GetOutput()->GetItem(0)->GetValues().isApprox(f1->GetOutput()->GetItem(0)->GetValues()));
+    
+    // Different input's content
+    f2->SetInput(ResultCacheTest_Points(2.0));
+    f2->Update();
+    TS_ASSERT_EQUALS(f2->GetGenerationNumber(), 2);
+    TS_ASSERT_EQUALS(cache->GetMissNumber(), 3ul);
+    TS_ASSERT_EQUALS(cache->GetEntryNumber(), 3);
+    
+    cache->ResetStatistics();
+    TS_ASSERT_EQUALS(cache->GetHitNumber(), 0ul);
+    TS_ASSERT_EQUALS(cache->GetMissNumber(), 0ul);
+    cache->Clear();
+    TS_ASSERT_EQUALS(cache->GetEntryNumber(), 0);
+    TS_ASSERT_EQUALS(cache->GetMemoryUsage(), 0u);
+  };
+  
+  CXXTEST_TEST(Chain)
+  {
+    btk::ResultCache::Pointer cache = btk::ResultCache::New();
+    btk::PointCollection::Pointer input = ResultCacheTest_Points(1.0);
+    ScalePointsFilter::Pointer f1 = ScalePointsFilter::New();
+    ScalePointsFilter::Pointer f2 = ScalePointsFilter::New();
+    f1->SetInput(input); f1->SetScale(2.0); f1->SetResultCache(cache);
+    f2->SetInput(f1->GetOutput()); f2->SetScale(3.0); f2->SetResultCache(cache);
+    f2->Update();
+    TS_ASSERT_EQUALS(cache->GetMissNumber(), 2ul);
+    TS_ASSERT_DELTA(f2->GetOutput()->GetItem(0)->GetValues().coeff(4,0), 30.0, 1e-15);
+    
+    ScalePointsFilter::Pointer f3 = ScalePointsFilter::New();
+    ScalePointsFilter::Pointer f4 = ScalePointsFilter::New();
+    f3->SetInput(ResultCacheTest_Points(1.0)); f3->SetScale(2.0); f3->SetResultCache(cache);
+    f4->SetInput(f3->GetOutput()); f4->SetScale(3.0); f4->SetResultCache(cache);
+    f4->Update();
+    TS_ASSERT_EQUALS(f3->GetGenerationNumber(), 0);
+    TS_ASSERT_EQUALS(f4->GetGenerationNumber(), 0);
+    TS_ASSERT_EQUALS(cache->GetHitNumber(), 2ul);
+    TS_ASSERT_DELTA(f4->GetOutput()->GetItem(0)->GetValues().coeff(4,0), 30.0, 1e-15);
+    
+    // The intermediate output is modified: its content is used as key.
+    btk::Point::Values values = f3->GetOutput()->GetItem(0)->GetValues();
+    values.coeffRef(4,0) = 0.0;
+    f3->GetOutput()->GetItem(0)->SetValues(values);
+    f3->GetOutput()->Modified();
+    f4->Update();
+    TS_ASSERT_EQUALS(f4->GetGenerationNumber(), 1);
+    TS_ASSERT_DELTA(f4->GetOutput()->GetItem(0)->GetValues().coeff(4,0), 0.0, 1e-15);
+  };
+  
+  CXXTEST_TEST(Eviction)
+  {
+    btk::ResultCache::Pointer cache = btk::ResultCache::New();
+    ScalePointsFilter::Pointer f = ScalePointsFilter::New();
+    f->SetInput(ResultCacheTest_Points(1.0));
+    f->SetResultCache(cache);
+    f->Update();
+    size_t size = cache->GetMemoryUsage();
+    cache->SetMemoryBudget(size + size / 2);
+    TS_ASSERT_EQUALS(cache->GetEntryNumber(), 1);
+    f->SetScale(2.0);
+    f->Update();
+    TS_ASSERT_EQUALS(cache->GetEntryNumber(), 1);
+    TS_ASSERT_EQUALS(cache->GetEvictionNumber(), 1ul);
+    TS_ASSERT_EQUALS(cache->GetMemoryUsage(), size);
+    // The first result was evicted
+    f->SetScale(1.0);
+    f->Update();
+    TS_ASSERT_EQUALS(f->GetGenerationNumber(), 3);
+    TS_ASSERT_EQUALS(cache->GetHitNumber(), 0ul);
+    TS_ASSERT_EQUALS(cache->GetEvictionNumber(), 2ul);
+    // Too large to be stored
+    cache->SetMemoryBudget(size / 2);
+    TS_ASSERT_EQUALS(cache->GetEntryNumber(), 0);
+    TS_ASSERT_EQUALS(cache->GetEvictionNumber(), 3ul);
+    f->SetScale(4.0);
+    f->Update();
+    TS_ASSERT_EQUALS(cache->GetEntryNumber(), 0);
+    TS_ASSERT_EQUALS(cache->GetMemoryUsage(), 0u);
+  };
+  
+  CXXTEST_TEST(NotCacheable)
+  {
+    btk::ResultCache::Pointer cache = btk::ResultCache::New();
+    ScalePointsFilter::Pointer f = ScalePointsFilter::New();
+    f->SetInput(ResultCacheTest_Points(1.0));
+    f->Update();
+    f->SetScale(2.0);
+    f->Update();
+    TS_ASSERT_EQUALS(f->GetGenerationNumber(), 2);
+    f->SetResultCache(cache);
+    TS_ASSERT_EQUALS(f->GetResultCache(), cache);
+    f->Update();
+    f->SetResultCache(btk::ResultCache::Pointer());
+    f->Update();
+    TS_ASSERT_EQUALS(f->GetGenerationNumber(), 4);
+    TS_ASSERT_EQUALS(cache->GetMissNumber(), 1ul);
+  };
+  
+  CXXTEST_TEST(FailedRestore)
+  {
+    btk::ResultCache::Pointer cache = btk::ResultCache::New();
+    std::vector<btk::DataObject::Pointer> outputs(1, ResultCacheTest_Points(1.0));
+    TS_ASSERT_EQUALS(cache->Store("foo", outputs), true);
+    // The cached result cannot be copied into another type of output.
+    std::vector<btk::DataObject::Pointer> wrenches(1, btk::WrenchCollection::New());
+    TS_ASSERT_EQUALS(cache->Restore("foo", wrenches), false);
+    TS_ASSERT_EQUALS(cache->GetHitNumber(), 0ul);
+    TS_ASSERT_EQUALS(cache->GetMissNumber(), 1ul);
+    std::vector<btk::DataObject::Pointer> points(1, btk::PointCollection::New());
+    TS_ASSERT_EQUALS(cache->Restore("foo", points), true);
+    TS_ASSERT_EQUALS(cache->GetHitNumber(), 1ul);
+    TS_ASSERT_EQUALS(static_pointer_cast<btk::PointCollection>(points[0])->GetItemNumber(), 1);
+    TS_ASSERT_EQUALS(cache->Restore("bar", points), false);
+    TS_ASSERT_EQUALS(cache->GetMissNumber(), 2ul);
+  };
+};
+
+CXXTEST_SUITE_REGISTRATION(ResultCacheTest)
+CXXTEST_TEST_REGISTRATION(ResultCacheTest, Default)
+CXXTEST_TEST_REGISTRATION(ResultCacheTest, ContentDigest)
+CXXTEST_TEST_REGISTRATION(ResultCacheTest, HitAndMiss)
+CXXTEST_TEST_REGISTRATION(ResultCacheTest, Chain)
+CXXTEST_TEST_REGISTRATION(ResultCacheTest, Eviction)
+CXXTEST_TEST_REGISTRATION(ResultCacheTest, NotCacheable)
+CXXTEST_TEST_REGISTRATION(ResultCacheTest, FailedRestore)
+#endif
@@ -4,6 +4,9 @@
 #include <btkAcquisitionFileReader.h>
 #include <btkTRCFileIO.h>
 #include <btkConvert.h>
+#include <btkResultCache.h>
+
+#include <fstream>
 
 CXXTEST_SUITE(TRCFileReaderTest)
 {
@@ -291,6 +294,94 @@ CXXTEST_SUITE(TRCFileReaderTest)
     TS_ASSERT_DELTA(acq->GetPoint(32)->GetValues()(1312,2), 951.17596, 1e-5);
     TS_ASSERT_DELTA(acq->GetPoint(32)->GetResiduals()(1312), 0.0, 1e-15);
   };
+  
+  CXXTEST_TEST(WindowsEndOfLineWithOcclusion)
+  {
+    std::string filename = TRCFilePathOUT + "WindowsEndOfLine.trc";
+    std::ofstream ofs(filename.c_str(), std::ios_base::out | std::ios_base::binary);
+    ofs << "PathFileType\t4\t(X/Y/Z)\tWindowsEndOfLine.trc\r\n"
+        << "DataRate\tCameraRate\tNumFrames\tNumMarkers\tUnits\tOrigDataRate\tOrigDataStartFrame\tOrigNumFrames\r\n"
+        << "100.00\t100.00\t3\t2\tm\t100.00\t5\t3\r\n"
+        << "Frame#\tTime\tRASI\t\t\tLASI\r\n"
+        << "\t\tX1\tY1\tZ1\tX2\tY2\tZ2\r\n"
+        << "\r\n"
+        << "5\t0.000\t1.5\t-2.25\t3e2\t4\t5\t6\r\n"
+        << "6\t0.010\t\t\t\t7.125\t8\t9\r\n"
+        << "7\t0.020\t10\t11\t12\t13\t14\t15.5";
+    ofs.close();
+    
+    btk::AcquisitionFileReader::Pointer reader = btk::AcquisitionFileReader::New();
+    reader->SetFilename(filename);
+    reader->Update();
+    btk::Acquisition::Pointer acq = reader->GetOutput();
+    
+    TS_ASSERT_EQUALS(acq->GetFirstFrame(), 5);
+    TS_ASSERT_EQUALS(acq->GetPointFrequency(), 100.0);
+    TS_ASSERT_EQUALS(acq->GetPointUnit(), "m");
+    TS_ASSERT_EQUALS(acq->GetPointNumber(), 2);
+    TS_ASSERT_EQUALS(acq->GetPointFrameNumber(), 3);
+    TS_ASSERT_EQUALS(acq->GetPoint(0)->GetLabel(), "RASI");
+    TS_ASSERT_EQUALS(acq->GetPoint(1)->GetLabel(), "LASI");
+    TS_ASSERT_EQUALS(acq->GetPoint(0)->GetValues()(0,0), 1.5);
+    TS_ASSERT_EQUALS(acq->GetPoint(0)->GetValues()(0,1), -2.25);
+    TS_ASSERT_EQUALS(acq->GetPoint(0)->GetValues()(0,2), 300.0);
+    TS_ASSERT_EQUALS(acq->GetPoint(0)->GetResiduals()(0), 0.0);
+    TS_ASSERT_EQUALS(acq->GetPoint(0)->GetValues()(1,0), 0.0);
+    TS_ASSERT_EQUALS(acq->GetPoint(0)->GetResiduals()(1), -1.0);
+    TS_ASSERT_EQUALS(acq->GetPoint(1)->GetValues()(1,0), 7.125);
+    TS_ASSERT_EQUALS(acq->GetPoint(1)->GetResiduals()(1), 0.0);
+    TS_ASSERT_EQUALS(acq->GetPoint(1)->GetValues()(2,2), 15.5);
+    
+    // Missing frame
+    ofs.open(filename.c_str(), std::ios_base::out | std::ios_base::binary);
+    ofs << "PathFileType\t4\t(X/Y/Z)\tWindowsEndOfLine.trc\r\n"
+        << "DataRate\tCameraRate\tNumFrames\tNumMarkers\tUnits\tOrigDataRate\tOrigDataStartFrame\tOrigNumFrames\r\n"
+        << "100.00\t100.00\t2\t1\tmm\t100.00\t1\t2\r\n"
+        << "Frame#\tTime\tRASI\r\n"
+        << "\t\tX1\tY1\tZ1\r\n"
+        << "\r\n"
+        << "1\t0.000\t1.5\t-2.25\t3e2\r\n";
+    ofs.close();
+    reader = btk::AcquisitionFileReader::New();
+    reader->SetFilename(filename);
+    TS_ASSERT_THROWS_EQUALS(reader->Update(), const btk::TRCFileIOException &e, e.what(), std::string("Unexpected end of file."));
+  };
+  
+  CXXTEST_TEST(ResultCache)
+  {
+    std::string filename = TRCFilePathOUT + "ResultCache.trc";
+    std::ofstream ofs(filename.c_str());
+    ofs << "PathFileType\t4\t(X/Y/Z)\tResultCache.trc\n"
+        << "DataRate\tCameraRate\tNumFrames\tNumMarkers\tUnits\tOrigDataRate\tOrigDataStartFrame\tOrigNumFrames\n"
+        << "100.00\t100.00\t1\t1\tmm\t100.00\t1\t1\n"
+        << "Frame#\tTime\tRASI\n"
+        << "\t\tX1\tY1\tZ1\n"
+        << "\n"
+        << "1\t0.000\t1.5\t-2.25\t3e2\n";
+    ofs.close();
+    
+    btk::ResultCache::Pointer cache = btk::ResultCache::New();
+    btk::AcquisitionFileReader::Pointer reader = btk::AcquisitionFileReader::New();
+    reader->SetFilename(filename);
+    reader->SetResultCache(cache);
+    reader->Update();
+    TS_ASSERT_EQUALS(cache->GetMissNumber(), 1ul);
+    reader = btk::AcquisitionFileReader::New();
+    reader->SetFilename(filename);
+    reader->SetResultCache(cache);
+    reader->Update();
+    TS_ASSERT_EQUALS(cache->GetHitNumber(), 1ul);
+    TS_ASSERT_EQUALS(reader->GetOutput()->GetPoint(0)->GetValues()(0,0), 1.5);
+    // The IO is a part of the key
+    reader = btk::AcquisitionFileReader::New();
+    reader->SetFilename(filename);
+    reader->SetAcquisitionIO(btk::TRCFileIO::New());
+    reader->SetResultCache(cache);
+    reader->Update();
+    TS_ASSERT_EQUALS(cache->GetHitNumber(), 1ul);
+    TS_ASSERT_EQUALS(cache->GetMissNumber(), 2ul);
+    TS_ASSERT_EQUALS(reader->GetOutput()->GetPoint(0)->GetValues()(0,0), 1.5);
+  };
 };
 
 CXXTEST_SUITE_REGISTRATION(TRCFileReaderTest)
@@ -302,4 +393,6 @@ CXXTEST_TEST_REGISTRATION(TRCFileReaderTest, MOTEK_ballet)
 CXXTEST_TEST_REGISTRATION(TRCFileReaderTest, KneeWithOcclusion)
 CXXTEST_TEST_REGISTRATION(TRCFileReaderTest, Unamed1)
 CXXTEST_TEST_REGISTRATION(TRCFileReaderTest, Unamed2)
+CXXTEST_TEST_REGISTRATION(TRCFileReaderTest, WindowsEndOfLineWithOcclusion)
+CXXTEST_TEST_REGISTRATION(TRCFileReaderTest, ResultCache)
 #endif
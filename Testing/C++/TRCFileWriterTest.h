@@ -5,6 +5,8 @@
 #include <btkAcquisitionFileWriter.h>
 #include <btkTRCFileIO.h>
 
+#include <fstream>
+
 CXXTEST_SUITE(TRCFileWriterTest)
 {
   CXXTEST_TEST(NoFileNoInput)
@@ -183,6 +185,41 @@ CXXTEST_SUITE(TRCFileWriterTest)
       }
     }
   };
+  
+  CXXTEST_TEST(ThreadNumber)
+  {
+    btk::Acquisition::Pointer acq = btk::Acquisition::New();
+    acq->Init(3, 2000);
+    acq->SetPointFrequency(100.0);
+    for (int i = 0 ; i < acq->GetPointNumber() ; ++i)
+      acq->GetPoint(i)->GetValues().setRandom();
+    acq->GetPoint(1)->GetValues().row(10).setZero();
+    acq->GetPoint(1)->GetResiduals()(10) = -1.0;
+    std::string content[2];
+    for (int i = 0 ; i < 2 ; ++i)
+    {
+      btk::TRCFileIO::Pointer io = btk::TRCFileIO::New();
+      TS_ASSERT_EQUALS(io->GetThreadNumber(), 0);
+      io->SetThreadNumber((i == 0) ? 1 : 4);
+      btk::AcquisitionFileWriter::Pointer writer = btk::AcquisitionFileWriter::New();
+      writer->SetAcquisitionIO(io);
+      writer->SetInput(acq);
+      writer->SetFilename(TRCFilePathOUT + "ThreadNumber.trc");
+      writer->Update();
+      std::ifstream ifs((TRCFilePathOUT + "ThreadNumber.trc").c_str());
+      content[i] = std::string((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+    }
+    TS_ASSERT(!content[0].empty());
+    TS_ASSERT(content[0] == content[1]);
+    
+    btk::AcquisitionFileReader::Pointer reader = btk::AcquisitionFileReader::New();
+    reader->SetFilename(TRCFilePathOUT + "ThreadNumber.trc");
+    reader->Update();
+    btk::Acquisition::Pointer acq2 = reader->GetOutput();
+    TS_ASSERT_EQUALS(acq2->GetPointFrameNumber(), 2000);
+    TS_ASSERT_DELTA(acq2->GetPoint(2)->GetValues()(1999, 2), acq->GetPoint(2)->GetValues()(1999, 2), 0.00001);
+    TS_ASSERT_EQUALS(acq2->GetPoint(1)->GetResiduals()(10), -1.0);
+  };
 };
 
 CXXTEST_SUITE_REGISTRATION(TRCFileWriterTest)
@@ -193,5 +230,6 @@ CXXTEST_TEST_REGISTRATION(TRCFileWriterTest, MOTEK_T_rewrited)
 CXXTEST_TEST_REGISTRATION(TRCFileWriterTest, Knee_rewrited)
 CXXTEST_TEST_REGISTRATION(TRCFileWriterTest, Gait_from_c3d)
 CXXTEST_TEST_REGISTRATION(TRCFileWriterTest, PlugInC3D)
+CXXTEST_TEST_REGISTRATION(TRCFileWriterTest, ThreadNumber)
   
 #endif
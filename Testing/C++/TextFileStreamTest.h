@@ -0,0 +1,229 @@
+#ifndef TextFileStreamTest_h
+#define TextFileStreamTest_h
+
+#include <btkTextFileStream_p.h>
+
+#include <fstream>
+#include <sstream>
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+
+static void TextFileStreamTest_Write(const std::string& filename, const std::string& content)
+{
+  std::ofstream ofs(filename.c_str(), std::ios_base::out | std::ios_base::binary);
+  ofs.write(content.data(), content.length());
+};
+
+static double TextFileStreamTest_Convert(const std::string& str)
+{
+  double value = -1.0;
+  const char* end = btk::text_to_double_p(str.data(), str.data() + str.length(), &value);
+  TS_ASSERT(end != 0);
+  return value;
+};
+
+static std::string TextFileStreamTest_Stream(double value, int precision, bool fixed)
+{
+  std::ostringstream oss;
+  if (fixed)
+    oss.setf(std::ios::fixed, std::ios::floatfield);
+  oss.precision(precision);
+  oss << value;
+  return oss.str();
+};
+
+static std::string TextFileStreamTest_Format(double value, int precision, bool fixed)
+{
+  std::string str;
+  if (fixed)
+    btk::text_append_fixed_p(&str, value, precision);
+  else
+    btk::text_append_general_p(&str, value, precision);
+  return str;
+};
+
+class TextFileStreamTest_Rows : public btk::text_row_formatter_p
+{
+public:
+  virtual void format(std::string* out, int row) const
+  {
+    btk::text_append_int_p(out, row);
+    out->push_back('\t');
+    btk::text_append_general_p(out, static_cast<double>(row) / 7.0);
+    out->push_back('\n');
+  };
+};
+
+CXXTEST_SUITE(TextFileStreamTest)
+{
+  CXXTEST_TEST(NoFile)
+  {
+    btk::text_file_p file;
+    TS_ASSERT_EQUALS(file.open("test.txt"), false);
+    TS_ASSERT_EQUALS(file.is_open(), false);
+  };
+  
+  CXXTEST_TEST(EmptyFile)
+  {
+    std::string filename = TDD_FilePathOUT + std::string("TextFileStreamEmpty.txt");
+    TextFileStreamTest_Write(filename, "");
+    btk::text_file_p file;
+    TS_ASSERT_EQUALS(file.open(filename), true);
+    TS_ASSERT_EQUALS(file.size(), 0u);
+    TS_ASSERT_EQUALS(file.eof(), true);
+    std::string line;
+    TS_ASSERT_EQUALS(file.getline(line), false);
+    file.close();
+    std::remove(filename.c_str());
+  };
+  
+  CXXTEST_TEST(LinesAndFields)
+  {
+    std::string filename = TDD_FilePathOUT + std::string("TextFileStreamLines.txt");
+    TextFileStreamTest_Write(filename, "Name\tFoo\tBar\r\n\r\n1\t\t3.5 \n  4 5\t6");
+    btk::text_file_p file;
+    TS_ASSERT_EQUALS(file.open(filename), true);
+    std::string str;
+    TS_ASSERT_EQUALS(file.getline(str), true);
+    TS_ASSERT_EQUALS(str, "Name\tFoo\tBar");
+    TS_ASSERT_EQUALS(file.getline(str), true);
+    TS_ASSERT_EQUALS(str, "");
+    btk::text_range_p line, field;
+    TS_ASSERT_EQUALS(file.getline(&line), true);
+    TS_ASSERT_EQUALS(btk::text_next_field_p(&line, '\t', &field), true);
+    TS_ASSERT_EQUALS(field.str(), "1");
+    TS_ASSERT_EQUALS(btk::text_next_field_p(&line, '\t', &field), true);
+    TS_ASSERT_EQUALS(field.empty(), true);
+    TS_ASSERT_EQUALS(btk::text_next_field_p(&line, '\t', &field), true);
+    TS_ASSERT_EQUALS(field.str(), "3.5 ");
+    TS_ASSERT_EQUALS(btk::text_next_field_p(&line, '\t', &field), false);
+    btk::text_range_p token;
+    TS_ASSERT_EQUALS(file.gettoken(&token), true);
+    TS_ASSERT_EQUALS(token.str(), "4");
+    TS_ASSERT_EQUALS(file.gettoken(&token), true);
+    TS_ASSERT_EQUALS(token.str(), "5");
+    TS_ASSERT_EQUALS(file.gettoken(&token), true);
+    TS_ASSERT_EQUALS(token.str(), "6");
+    TS_ASSERT_EQUALS(file.eof(), true);
+    TS_ASSERT_EQUALS(file.gettoken(&token), false);
+    TS_ASSERT_EQUALS(file.getline(&line), false);
+    file.close();
+    std::remove(filename.c_str());
+  };
+  
+  CXXTEST_TEST(Numbers)
+  {
+    TS_ASSERT_EQUALS(TextFileStreamTest_Convert("0"), 0.0);
+    TS_ASSERT_EQUALS(TextFileStreamTest_Convert(" -12"), -12.0);
+    TS_ASSERT_EQUALS(TextFileStreamTest_Convert("+3.25\t"), 3.25);
+    TS_ASSERT_EQUALS(TextFileStreamTest_Convert(".5"), 0.5);
+    TS_ASSERT_EQUALS(TextFileStreamTest_Convert("5."), 5.0);
+    TS_ASSERT_EQUALS(TextFileStreamTest_Convert("1e3"), 1000.0);
+    TS_ASSERT_EQUALS(TextFileStreamTest_Convert("-2.5E-2"), -0.025);
+    TS_ASSERT_EQUALS(TextFileStreamTest_Convert("7e"), 7.0);
+    TS_ASSERT_EQUALS(TextFileStreamTest_Convert("301.65476"), 301.65476);
+    TS_ASSERT_EQUALS(TextFileStreamTest_Convert("0.1"), 0.1);
+    TS_ASSERT_EQUALS(TextFileStreamTest_Convert("1.7976931348623157e308"), 1.7976931348623157e308);
+    TS_ASSERT_EQUALS(TextFileStreamTest_Convert("4.9406564584124654e-324"), 4.9406564584124654e-324);
+    TS_ASSERT_EQUALS(TextFileStreamTest_Convert("123456789012345678901234567890"), 123456789012345678901234567890.0);
+    TS_ASSERT_EQUALS(TextFileStreamTest_Convert("0.000000000000000000000000000001"), 1e-30);
+    double value = 0.0;
+    std::string str = "abc";
+    TS_ASSERT(btk::text_to_double_p(str.data(), str.data() + str.length(), &value) == 0);
+    str = "-.e5";
+    TS_ASSERT(btk::text_to_double_p(str.data(), str.data() + str.length(), &value) == 0);
+    str = "12.5abc";
+    TS_ASSERT(btk::text_to_double_p(str.data(), str.data() + str.length(), &value) == str.data() + 4);
+    TS_ASSERT_EQUALS(value, 12.5);
+  };
+  
+  CXXTEST_TEST(RoundTrip)
+  {
+    char buffer[64];
+    srand(0);
+    for (int i = 0 ; i < 10000 ; ++i)
+    {
+      double v = (static_cast<double>(rand()) / RAND_MAX - 0.5) * pow(10.0, (i % 20) - 10);
+      sprintf(buffer, (i % 2) ? "%.17g" : "%.5f", v);
+      double expected = strtod(buffer, 0);
+      TS_ASSERT_EQUALS(TextFileStreamTest_Convert(buffer), expected);
+    }
+  };
+  
+  CXXTEST_TEST(Integers)
+  {
+    std::string str;
+    btk::text_append_int_p(&str, 0);
+    TS_ASSERT_EQUALS(str, "0");
+    str.clear();
+    btk::text_append_int_p(&str, -1234567);
+    TS_ASSERT_EQUALS(str, "-1234567");
+    str.clear();
+    btk::text_append_int_p(&str, 2147483647);
+    TS_ASSERT_EQUALS(str, "2147483647");
+  };
+  
+  CXXTEST_TEST(FormatNumbers)
+  {
+    const double values[] = {0.0, -0.0, 1.0, -1.5, 0.5, 0.0005, 0.00005, 2.5, 0.125, 1.0005, 100000.0, 999999.5, 1234567.0, 1e15, 1e-5, 
+                             301.65476, -0.000001, 123456789.123456789, 1e300, -4.9406564584124654e-324};
+    for (size_t i = 0 ; i < sizeof(values) / sizeof(double) ; ++i)
+    {
+      TS_ASSERT_EQUALS(TextFileStreamTest_Format(values[i], 6, false), TextFileStreamTest_Stream(values[i], 6, false));
+      TS_ASSERT_EQUALS(TextFileStreamTest_Format(values[i], 3, true), TextFileStreamTest_Stream(values[i], 3, true));
+      TS_ASSERT_EQUALS(TextFileStreamTest_Format(values[i], 5, true), TextFileStreamTest_Stream(values[i], 5, true));
+    }
+    TS_ASSERT_EQUALS(TextFileStreamTest_Format(0.1, 17, false), TextFileStreamTest_Stream(0.1, 17, false));
+    TS_ASSERT_EQUALS(TextFileStreamTest_Format(-0.000001, 5, true), "-0.00000");
+    TS_ASSERT_EQUALS(TextFileStreamTest_Format(1234567.0, 6, false), "1.23457e+06");
+  };
+  
+  CXXTEST_TEST(FormatRandomNumbers)
+  {
+    srand(0);
+    for (int i = 0 ; i < 20000 ; ++i)
+    {
+      double v = (static_cast<double>(rand()) / RAND_MAX - 0.5) * pow(10.0, (i % 30) - 15);
+      if (i % 3 == 0)
+        v = floor(v * 1000.0) / 1000.0 + 0.0005; // Values close to a tie
+      TS_ASSERT_EQUALS(TextFileStreamTest_Format(v, 6, false), TextFileStreamTest_Stream(v, 6, false));
+      TS_ASSERT_EQUALS(TextFileStreamTest_Format(v, 3, true), TextFileStreamTest_Stream(v, 3, true));
+      TS_ASSERT_EQUALS(TextFileStreamTest_Format(v, 5, true), TextFileStreamTest_Stream(v, 5, true));
+    }
+  };
+  
+  CXXTEST_TEST(WriteRows)
+  {
+    std::string expected = "Header\n";
+    TextFileStreamTest_Rows rows;
+    for (int i = 0 ; i < 10000 ; ++i)
+      rows.format(&expected, i);
+    std::string filename = TDD_FilePathOUT + std::string("TextFileStreamRows.txt");
+    for (int threads = 1 ; threads <= 4 ; threads += 3)
+    {
+      btk::text_output_p output;
+      TS_ASSERT_EQUALS(output.open(filename), true);
+      output.write("Header\n");
+      TS_ASSERT_EQUALS(btk::text_write_rows_p(&output, 10000, &rows, threads), true);
+      TS_ASSERT_EQUALS(output.close(), true);
+      std::ifstream ifs(filename.c_str(), std::ios_base::in | std::ios_base::binary);
+      std::string content((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+      ifs.close();
+      TS_ASSERT(content == expected);
+    }
+    std::remove(filename.c_str());
+  };
+};
+
+CXXTEST_SUITE_REGISTRATION(TextFileStreamTest)
+CXXTEST_TEST_REGISTRATION(TextFileStreamTest, NoFile)
+CXXTEST_TEST_REGISTRATION(TextFileStreamTest, EmptyFile)
+CXXTEST_TEST_REGISTRATION(TextFileStreamTest, LinesAndFields)
+CXXTEST_TEST_REGISTRATION(TextFileStreamTest, Numbers)
+CXXTEST_TEST_REGISTRATION(TextFileStreamTest, RoundTrip)
+CXXTEST_TEST_REGISTRATION(TextFileStreamTest, Integers)
+CXXTEST_TEST_REGISTRATION(TextFileStreamTest, FormatNumbers)
+CXXTEST_TEST_REGISTRATION(TextFileStreamTest, FormatRandomNumbers)
+CXXTEST_TEST_REGISTRATION(TextFileStreamTest, WriteRows)
+#endif
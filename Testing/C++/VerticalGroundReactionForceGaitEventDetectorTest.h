@@ -6,6 +6,61 @@
 #include <btkForcePlatformsExtractor.h>
 #include <btkGroundReactionWrenchFilter.h>
 #include <btkDownsampleFilter.h>
+#include <btkMetaDataUtils.h>
+
+void VerticalGroundReactionForceGaitEventDetectorTest_Fill(btk::Acquisition::Pointer acq, int first, int last)
+{
+  for (int i = first ; i < last ; ++i)
+  {
+    // One step every 150 frames on each force platform. The second one is scaled by 2.
+    for (int j = 0 ; j < 2 ; ++j)
+    {
+      double fz = (((i + 75 * j) % 150 >= 30) && ((i + 75 * j) % 150 < 100)) ? 500.0 + 100.0 * sin(0.1 * i) : 0.0;
+      double s = (j == 0) ? 1.0 : 0.5;
+      acq->GetAnalog(6*j)->GetValues()(i) = s * 0.05 * fz;
+      acq->GetAnalog(6*j+1)->GetValues()(i) = s * -0.02 * fz;
+      acq->GetAnalog(6*j+2)->GetValues()(i) = s * fz;
+      acq->GetAnalog(6*j+3)->GetValues()(i) = s * 0.1 * fz;
+      acq->GetAnalog(6*j+4)->GetValues()(i) = s * -0.05 * fz;
+      acq->GetAnalog(6*j+5)->GetValues()(i) = s * 0.01 * fz;
+    }
+  }
+};
+
+btk::Acquisition::Pointer VerticalGroundReactionForceGaitEventDetectorTest_Acquisition(int frameNumber)
+{
+  btk::Acquisition::Pointer acq = btk::Acquisition::New();
+  acq->Init(0, frameNumber, 12);
+  acq->SetPointFrequency(100.0);
+  VerticalGroundReactionForceGaitEventDetectorTest_Fill(acq, 0, frameNumber);
+  btk::MetaData::Pointer fp = btk::MetaDataCreateChild(acq->GetMetaData(), "FORCE_PLATFORM");
+  btk::MetaDataCreateChild(fp, "USED", (int16_t)2);
+  std::vector<int16_t> types(2); types[0] = 2; types[1] = 4;
+  btk::MetaDataCreateChild(fp, "TYPE", types);
+  std::vector<int16_t> channels(12);
+  for (int i = 0 ; i < 12 ; ++i)
+    channels[i] = i + 1;
+  btk::MetaDataCreateChild(fp, "CHANNEL", channels, 6);
+  std::vector<float> origin(6, 0.0f); origin[2] = -40.0f; origin[5] = -40.0f;
+  btk::MetaDataCreateChild(fp, "ORIGIN", origin, 3);
+  std::vector<float> cal(72, 0.0f);
+  for (int i = 0 ; i < 6 ; ++i)
+  {
+    cal[i * 7] = 1.0f;
+    cal[36 + i * 7] = 2.0f;
+  }
+  std::vector<float> corners(24, 0.0f);
+  for (int i = 0 ; i < 2 ; ++i)
+  {
+    corners[12*i] = 500.0f * i; corners[12*i+3] = 500.0f * (i+1); corners[12*i+6] = 500.0f * (i+1); corners[12*i+9] = 500.0f * i;
+    corners[12*i+7] = 1000.0f; corners[12*i+10] = 1000.0f;
+  }
+  std::vector<uint8_t> cdims(3); cdims[0] = 3; cdims[1] = 4; cdims[2] = 2;
+  fp->AppendChild(btk::MetaData::New("CORNERS", cdims, corners));
+  std::vector<uint8_t> dims(3); dims[0] = 6; dims[1] = 6; dims[2] = 2;
+  fp->AppendChild(btk::MetaData::New("CAL_MATRIX", dims, cal));
+  return acq;
+};
 
 CXXTEST_SUITE(VerticalGroundReactionForceGaitEventDetectorTest)
 {
@@ -274,6 +329,225 @@ CXXTEST_SUITE(VerticalGroundReactionForceGaitEventDetectorTest)
     TS_ASSERT_EQUALS(ev->GetFrame(), 108);
     TS_ASSERT_EQUALS(ev->GetTime(), 108.0/60.0);
   };
+  
+  CXXTEST_TEST(IncrementalChain)
+  {
+    btk::Acquisition::Pointer acq = VerticalGroundReactionForceGaitEventDetectorTest_Acquisition(100);
+    
+    btk::ForcePlatformsExtractor::Pointer pfe = btk::ForcePlatformsExtractor::New();
+    pfe->SetSharedChannels(true);
+    pfe->SetIncrementalMode(true);
+    pfe->SetInput(acq);
+    btk::GroundReactionWrenchFilter::Pointer grwf = btk::GroundReactionWrenchFilter::New();
+    grwf->SetTransformToGlobalFrame(false);
+    grwf->SetIncrementalMode(true);
+    grwf->SetInput(pfe->GetOutput());
+    btk::VerticalGroundReactionForceGaitEventDetector::Pointer vgrfged = btk::VerticalGroundReactionForceGaitEventDetector::New();
+    vgrfged->SetIncrementalMode(true);
+    vgrfged->SetInput(grwf->GetOutput());
+    std::vector<std::string> mapping(2); mapping[0] = "Left"; mapping[1] = "Right";
+    vgrfged->SetForceplateContextMapping(mapping);
+    vgrfged->SetAcquisitionInformation(1, 100.0, "");
+    btk::EventCollection::Pointer output = vgrfged->GetOutput();
+    output->Update();
+    
+    btk::ForcePlatform::Pointer fp1 = pfe->GetOutput()->GetItem(0);
+    btk::ForcePlatform::Pointer fp2 = pfe->GetOutput()->GetItem(1);
+    TS_ASSERT_EQUALS(fp1->GetChannel(2), acq->GetAnalog(2));
+    std::vector<btk::Event::Pointer> events(output->Begin(), output->End());
+    for (int n = 200 ; n <= 600 ; n += 100)
+    {
+      acq->ResizeFrameNumber(n);
+      VerticalGroundReactionForceGaitEventDetectorTest_Fill(acq, n - 100, n);
+      output->Update();
+      // The force platforms are not extracted again.
+      TS_ASSERT_EQUALS(pfe->GetOutput()->GetItem(0), fp1);
+      TS_ASSERT_EQUALS(pfe->GetOutput()->GetItem(1), fp2);
+      TS_ASSERT_EQUALS(grwf->GetOutput()->GetItem(1)->GetForce()->GetFrameNumber(), n);
+      events.insert(events.end(), output->Begin(), output->End());
+    }
+    
+    // Same wrenches than the ones computed on all the frames
+    btk::ForcePlatformsExtractor::Pointer pfe_ = btk::ForcePlatformsExtractor::New();
+    pfe_->SetInput(acq);
+    btk::GroundReactionWrenchFilter::Pointer grwf_ = btk::GroundReactionWrenchFilter::New();
+    grwf_->SetTransformToGlobalFrame(false);
+    grwf_->SetInput(pfe_->GetOutput());
+    grwf_->Update();
+    for (int i = 0 ; i < 2 ; ++i)
+    {
+      TS_ASSERT(grwf->GetOutput()->GetItem(i)->GetForce()->GetValues().isApprox(grwf_->GetOutput()->GetItem(i)->GetForce()->GetValues()));
+      TS_ASSERT(grwf->GetOutput()->GetItem(i)->GetMoment()->GetValues().isApprox(grwf_->GetOutput()->GetItem(i)->GetMoment()->GetValues()));
+      TS_ASSERT(grwf->GetOutput()->GetItem(i)->GetPosition()->GetValues().isApprox(grwf_->GetOutput()->GetItem(i)->GetPosition()->GetValues()));
+      TS_ASSERT(grwf->GetOutput()->GetItem(i)->GetPosition()->GetResiduals().isApprox(grwf_->GetOutput()->GetItem(i)->GetPosition()->GetResiduals()));
+    }
+    
+    // 4 steps on each force platform. The second one is already loaded at the first frame.
+    TS_ASSERT_EQUALS(events.size(), 16u);
+    int strikes[2] = {0, 0}, offs[2] = {0, 0};
+    for (size_t i = 0 ; i < events.size() ; ++i)
+    {
+      int j = (events[i]->GetContext() == "Left") ? 0 : 1;
+      int frame = events[i]->GetFrame() - 1 + 75 * j;
+      if (events[i]->GetLabel() == "Foot Strike")
+      {
+        TS_ASSERT_EQUALS(frame % 150, 29);
+        ++strikes[j];
+      }
+      else
+      {
+        TS_ASSERT_EQUALS(frame % 150, 100);
+        ++offs[j];
+      }
+      TS_ASSERT_DELTA(events[i]->GetTime(), events[i]->GetFrame() / 100.0, 1e-10);
+    }
+    TS_ASSERT_EQUALS(strikes[0], 4);
+    TS_ASSERT_EQUALS(offs[0], 4);
+    TS_ASSERT_EQUALS(strikes[1], 4);
+    TS_ASSERT_EQUALS(offs[1], 4);
+  };
+  
+  CXXTEST_TEST(Hysteresis)
+  {
+    // The vertical force oscillates around the threshold before and after the step
+    btk::Wrench::Pointer w = btk::Wrench::New(100);
+    for (int i = 0 ; i < 100 ; ++i)
+      w->GetForce()->GetValues()(i,2) = ((i >= 40) && (i < 60)) ? 500.0 : ((i % 2) ? 12.0 : 8.0);
+    btk::VerticalGroundReactionForceGaitEventDetector::Pointer vgrfged = btk::VerticalGroundReactionForceGaitEventDetector::New();
+    vgrfged->SetInput(w);
+    vgrfged->SetAcquisitionInformation(1, 100.0, "");
+    vgrfged->SetIncrementalMode(true);
+    btk::EventCollection::Pointer output = vgrfged->GetOutput();
+    output->Update();
+    TS_ASSERT(output->GetItemNumber() > 2);
+    vgrfged->SetHysteresisValue(10);
+    w->Modified();
+    output->Update();
+    TS_ASSERT_EQUALS(output->GetItemNumber(), 2);
+    TS_ASSERT_EQUALS(output->GetItem(0)->GetLabel(), "Foot Strike");
+    TS_ASSERT_EQUALS(output->GetItem(0)->GetFrame(), 39);
+    TS_ASSERT_EQUALS(output->GetItem(1)->GetLabel(), "Foot Off");
+    TS_ASSERT_EQUALS(output->GetItem(1)->GetFrame(), 61);
+    // Same events without the incremental mode
+    vgrfged->SetIncrementalMode(false);
+    output->Update();
+    TS_ASSERT_EQUALS(output->GetItemNumber(), 2);
+    TS_ASSERT_EQUALS(output->GetItem(0)->GetFrame(), 39);
+    TS_ASSERT_EQUALS(output->GetItem(1)->GetFrame(), 61);
+    // The maximum must exceed the threshold and the hysteresis
+    vgrfged->SetHysteresisValue(500);
+    output->Update();
+    TS_ASSERT_EQUALS(output->GetItemNumber(), 0);
+  };
+  
+  CXXTEST_TEST(BatchWrenches)
+  {
+    std::vector<btk::WrenchCollection::Pointer> inputs(20);
+    for (size_t k = 0 ; k < inputs.size() ; ++k)
+    {
+      if (k == 5)
+        continue; // Null input
+      inputs[k] = btk::WrenchCollection::New();
+      for (int j = 0 ; j < 2 ; ++j)
+      {
+        btk::Wrench::Pointer w = btk::Wrench::New(100 + 37 * static_cast<int>(k));
+        for (int i = 0 ; i < w->GetForce()->GetFrameNumber() ; ++i)
+          w->GetForce()->GetValues()(i,2) = ((i > 20 + 3 * static_cast<int>(k) + 10 * j) && (i < 90 - j)) ? 300.0 + 10.0 * i : 0.0;
+        inputs[k]->InsertItem(w);
+      }
+    }
+    btk::VerticalGroundReactionForceGaitEventDetector::Pointer vgrfged = btk::VerticalGroundReactionForceGaitEventDetector::New();
+    std::vector<std::string> mapping(1, "Right");
+    vgrfged->SetForceplateContextMapping(mapping);
+    vgrfged->SetAcquisitionInformation(10, 200.0, "Subject");
+    vgrfged->SetRegionOfInterest(5, -1);
+    std::vector<btk::EventCollection::Pointer> outputs = vgrfged->DetectEvents(inputs, 4);
+    TS_ASSERT_EQUALS(outputs.size(), inputs.size());
+    TS_ASSERT_EQUALS(outputs[5]->GetItemNumber(), 0);
+    for (size_t k = 0 ; k < inputs.size() ; ++k)
+    {
+      if (!inputs[k])
+        continue;
+      vgrfged->SetInput(inputs[k]);
+      btk::EventCollection::Pointer output = vgrfged->GetOutput();
+      output->Update();
+      TS_ASSERT_EQUALS(outputs[k]->GetItemNumber(), 4);
+      TS_ASSERT_EQUALS(outputs[k]->GetItemNumber(), output->GetItemNumber());
+      for (int i = 0 ; i < output->GetItemNumber() ; ++i)
+      {
+        TS_ASSERT_EQUALS(outputs[k]->GetItem(i)->GetLabel(), output->GetItem(i)->GetLabel());
+        TS_ASSERT_EQUALS(outputs[k]->GetItem(i)->GetContext(), output->GetItem(i)->GetContext());
+        TS_ASSERT_EQUALS(outputs[k]->GetItem(i)->GetSubject(), "Subject");
+        TS_ASSERT_EQUALS(outputs[k]->GetItem(i)->GetFrame(), output->GetItem(i)->GetFrame());
+        TS_ASSERT_EQUALS(outputs[k]->GetItem(i)->GetTime(), output->GetItem(i)->GetTime());
+      }
+      TS_ASSERT_EQUALS(output->GetItem(0)->GetFrame(), 30 + 3 * static_cast<int>(k));
+      TS_ASSERT_EQUALS(output->GetItem(2)->GetContext(), "General");
+    }
+  };
+  
+  CXXTEST_TEST(BatchWrenchesNoFrameRate)
+  {
+    std::vector<btk::WrenchCollection::Pointer> inputs(3);
+    for (size_t k = 0 ; k < inputs.size() ; ++k)
+    {
+      inputs[k] = btk::WrenchCollection::New();
+      btk::Wrench::Pointer w = btk::Wrench::New(100);
+      for (int i = 0 ; i < w->GetForce()->GetFrameNumber() ; ++i)
+        w->GetForce()->GetValues()(i,2) = ((i > 20 + 5 * static_cast<int>(k)) && (i < 90)) ? 300.0 : 0.0;
+      inputs[k]->InsertItem(w);
+    }
+    btk::VerticalGroundReactionForceGaitEventDetector::Pointer vgrfged = btk::VerticalGroundReactionForceGaitEventDetector::New();
+    std::vector<std::string> mapping(1, "Right");
+    vgrfged->SetForceplateContextMapping(mapping);
+    // No frame rate set: the times are set to 0.
+    std::vector<btk::EventCollection::Pointer> outputs = vgrfged->DetectEvents(inputs, 2);
+    TS_ASSERT_EQUALS(outputs.size(), inputs.size());
+    for (size_t k = 0 ; k < outputs.size() ; ++k)
+    {
+      TS_ASSERT_EQUALS(outputs[k]->GetItemNumber(), 2);
+      for (int i = 0 ; i < outputs[k]->GetItemNumber() ; ++i)
+      {
+        const double time = outputs[k]->GetItem(i)->GetTime();
+        TS_ASSERT((time - time) == 0.0); // Finite
+        TS_ASSERT_EQUALS(time, 0.0);
+      }
+    }
+  };
+  
+  CXXTEST_TEST(BatchAcquisitions)
+  {
+    std::vector<btk::Acquisition::Pointer> inputs(8);
+    for (size_t k = 0 ; k < inputs.size() ; ++k)
+      inputs[k] = VerticalGroundReactionForceGaitEventDetectorTest_Acquisition(100 + 50 * static_cast<int>(k));
+    btk::VerticalGroundReactionForceGaitEventDetector::Pointer vgrfged = btk::VerticalGroundReactionForceGaitEventDetector::New();
+    std::vector<std::string> mapping(2); mapping[0] = "Left"; mapping[1] = "Right";
+    vgrfged->SetForceplateContextMapping(mapping);
+    std::vector<btk::EventCollection::Pointer> outputs = vgrfged->DetectEvents(inputs);
+    TS_ASSERT_EQUALS(outputs.size(), inputs.size());
+    for (size_t k = 0 ; k < inputs.size() ; ++k)
+    {
+      btk::ForcePlatformsExtractor::Pointer pfe = btk::ForcePlatformsExtractor::New();
+      btk::GroundReactionWrenchFilter::Pointer grwf = btk::GroundReactionWrenchFilter::New();
+      btk::DownsampleFilter<btk::WrenchCollection>::Pointer dswc = btk::DownsampleFilter<btk::WrenchCollection>::New();
+      dswc->SetUpDownRatio(inputs[k]->GetNumberAnalogSamplePerFrame());
+      pfe->SetInput(inputs[k]);
+      grwf->SetInput(pfe->GetOutput());
+      dswc->SetInput(grwf->GetOutput());
+      vgrfged->SetInput(dswc->GetOutput());
+      vgrfged->SetAcquisitionInformation(inputs[k]->GetFirstFrame(), inputs[k]->GetPointFrequency(), "");
+      btk::EventCollection::Pointer output = vgrfged->GetOutput();
+      output->Update();
+      TS_ASSERT(output->GetItemNumber() != 0);
+      TS_ASSERT_EQUALS(outputs[k]->GetItemNumber(), output->GetItemNumber());
+      for (int i = 0 ; i < std::min(output->GetItemNumber(), outputs[k]->GetItemNumber()) ; ++i)
+      {
+        TS_ASSERT_EQUALS(outputs[k]->GetItem(i)->GetLabel(), output->GetItem(i)->GetLabel());
+        TS_ASSERT_EQUALS(outputs[k]->GetItem(i)->GetContext(), output->GetItem(i)->GetContext());
+        TS_ASSERT_EQUALS(outputs[k]->GetItem(i)->GetFrame(), output->GetItem(i)->GetFrame());
+      }
+    }
+  };
 };
 
 CXXTEST_SUITE_REGISTRATION(VerticalGroundReactionForceGaitEventDetectorTest)
@@ -283,5 +557,10 @@ CXXTEST_TEST_REGISTRATION(VerticalGroundReactionForceGaitEventDetectorTest, Gait
 CXXTEST_TEST_REGISTRATION(VerticalGroundReactionForceGaitEventDetectorTest, PluginC3D)
 CXXTEST_TEST_REGISTRATION(VerticalGroundReactionForceGaitEventDetectorTest, PluginC3D_Threshold50)
 CXXTEST_TEST_REGISTRATION(VerticalGroundReactionForceGaitEventDetectorTest, PluginC3D_ROI)
+CXXTEST_TEST_REGISTRATION(VerticalGroundReactionForceGaitEventDetectorTest, IncrementalChain)
+CXXTEST_TEST_REGISTRATION(VerticalGroundReactionForceGaitEventDetectorTest, Hysteresis)
+CXXTEST_TEST_REGISTRATION(VerticalGroundReactionForceGaitEventDetectorTest, BatchWrenches)
+CXXTEST_TEST_REGISTRATION(VerticalGroundReactionForceGaitEventDetectorTest, BatchWrenchesNoFrameRate)
+CXXTEST_TEST_REGISTRATION(VerticalGroundReactionForceGaitEventDetectorTest, BatchAcquisitions)
 
 #endif // VerticalGroundReactionForceGaitEventDetectorTest_h
\ No newline at end of file
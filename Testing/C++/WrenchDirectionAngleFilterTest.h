@@ -66,9 +66,47 @@ CXXTEST_SUITE(WrenchDirectionAngleFilterTest)
     TS_ASSERT_DELTA(output->GetItem(0)->GetValues()(5,1), 0.0, 1e-15);
     TS_ASSERT_DELTA(output->GetItem(0)->GetValues()(5,2), 0.0, 1e-15);
   };
+  
+  CXXTEST_TEST(FastMode)
+  {
+    btk::Wrench::Pointer w = btk::Wrench::New(1000);
+    w->GetForce()->GetValues().setRandom();
+    w->GetForce()->GetValues().row(10).setZero();
+    w->GetForce()->GetValues()(11,2) = 0.0;
+    w->GetPosition()->GetResiduals()(20) = -1.0;
+    btk::WrenchDirectionAngleFilter::Pointer wdaf = btk::WrenchDirectionAngleFilter::New();
+    wdaf->SetInput(w);
+    btk::PointCollection::Pointer output = wdaf->GetOutput();
+    output->Update();
+    btk::Point::Values accurate = output->GetItem(0)->GetValues();
+    TS_ASSERT_EQUALS(wdaf->GetMode(), btk::WrenchDirectionAngleFilter::Accurate);
+    wdaf->SetMode(btk::WrenchDirectionAngleFilter::Fast);
+    output->Update();
+    btk::Point::Values fast = output->GetItem(0)->GetValues();
+    TS_ASSERT_EQUALS(output->GetItem(0)->GetFrameNumber(), 1000);
+    const btk::Point::Values& F = w->GetForce()->GetValues();
+    for (int i = 0 ; i < 1000 ; ++i)
+    {
+      if (i == 20)
+        continue;
+      TS_ASSERT_DELTA(accurate(i,0), atan2(-F(i,2), -F(i,1)) * 180.0 / M_PI + 180.0, 1e-12);
+      TS_ASSERT_DELTA(accurate(i,1), atan2(-F(i,2), -F(i,0)) * 180.0 / M_PI + 180.0, 1e-12);
+      TS_ASSERT_DELTA(accurate(i,2), atan2(-F(i,1), -F(i,0)) * 180.0 / M_PI + 180.0, 1e-12);
+      for (int j = 0 ; j < 3 ; ++j)
+        TS_ASSERT_DELTA(fast(i,j), accurate(i,j), 3e-6);
+    }
+    TS_ASSERT(fast.row(20).isZero(0.0));
+    TS_ASSERT_EQUALS(output->GetItem(0)->GetResiduals()(20), -1.0);
+    TS_ASSERT_EQUALS(output->GetItem(0)->GetResiduals()(21), 0.0);
+    // Same angles for the null components
+    TS_ASSERT(fast.row(10) == accurate.row(10));
+    TS_ASSERT_EQUALS(fast(11,0), accurate(11,0));
+    TS_ASSERT_EQUALS(fast(11,1), accurate(11,1));
+  };
 };
 
 CXXTEST_SUITE_REGISTRATION(WrenchDirectionAngleFilterTest)
 CXXTEST_TEST_REGISTRATION(WrenchDirectionAngleFilterTest, OneFrame)
+CXXTEST_TEST_REGISTRATION(WrenchDirectionAngleFilterTest, FastMode)
 
 #endif // WrenchDirectionAngleFilterTest_h
\ No newline at end of file
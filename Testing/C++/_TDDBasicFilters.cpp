@@ -2,13 +2,19 @@
 
 #include "AcquisitionUnitConverterTest.h"
 #include "AnalogOffsetRemoverTest.h"
+#include "CombinedGroundReactionWrenchFilterTest.h"
+#include "EMGEnvelopeFilterTest.h"
 #include "DownSampleFilterTest.h"
 #include "ForcePlatformsExtractorTest.h"
 #include "ForcePlatformWrenchFilterTest.h"
 #include "GroundReactionWrenchFilterTest.h"
 #include "IMUsExtractorTest.h"
+#include "KinematicGaitEventDetectorTest.h"
 #include "MeasureFrameExtractorTest.h"
 #include "MergeAcquisitionFilterTest.h"
+#include "MovingStatisticFilterTest.h"
+#include "PointDifferentiationFilterTest.h"
+#include "PointGapFillingFilterTest.h"
 #include "SeparateKnownVirtualMarkersFilterTest.h"
 #include "SpecializedPointsExtractorTest.h"
 #include "SubAcquisitionFilterTest.h"
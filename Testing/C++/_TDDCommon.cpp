@@ -10,4 +10,8 @@
 #include "MetaDataInfoTest.h"
 #include "MetaDataTest.h"
 #include "PipelineTest.h"
+#include "ResultCacheTest.h"
+#include "InstrumentationTest.h"
+#include "LoggerTest.h"
+#include "ObjectPoolTest.h"
 #include "TriangleMeshTest.h"
\ No newline at end of file
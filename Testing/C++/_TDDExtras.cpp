@@ -3,6 +3,9 @@
 #include "EigenFilterTest.h"
 #include "EigenFiltFiltTest.h"
 #include "EigenIIRFilterDesignTest.h"
+#include "EigenMovingStatisticsTest.h"
+#include "EigenSGolayTest.h"
+#include "EigenVectorMathTest.h"
 #include "GammalnTest.h"
 #include "CombTest.h"
 #include "CumtrapzTest.h"
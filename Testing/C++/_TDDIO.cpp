@@ -2,6 +2,9 @@
 #include "_TDDIO_Open3DMotion_Ressources.cpp"
 
 #include "BinaryFileStreamTest.h" // Be the first to test the stream
+#include "TextFileStreamTest.h"
+
+#include "AcquisitionFileIOFactoryTest.h"
 
 #include "ANBFileIOTest.h"
 #include "ANBFileReaderTest.h"
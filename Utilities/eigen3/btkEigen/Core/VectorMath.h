@@ -0,0 +1,204 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __btkEigenVectorMath_h
+#define __btkEigenVectorMath_h
+
+#include <Eigen/Core>
+
+#include <cmath>
+#include <limits>
+
+// The following kernels work on the raw arrays of the columns of a matrix stored 
+// in column-major order (e.g. the values of a btk::Point: x = data, y = data + n, z = data + 2 * n).
+// The output can be one of the inputs. When Eigen uses SSE2, two elements are computed 
+// at the same time with SSE2 instructions. Otherwise (or for the last element), scalar loops are used.
+
+namespace btkEigen
+{
+  using namespace Eigen;
+  
+  /**
+   * Maximum absolute error (in radians) of the function atan2_fast().
+   */
+  static const double atan2_fast_max_error = 4.0e-8;
+  
+  // Coefficients of the odd polynomial (degree 15) approximating atan on [0,1] (minimax fit, error lower than 3.8e-8)
+  static const double _atan_fast_coefficients[8] = {0.99999933560826038, -0.3332986084609994, 0.19946566051618225, -0.13908630674314695, 0.096421987614269761, -0.055912332857199584, 0.02186295541675266, -0.0040545651722610331};
+  
+  /**
+   * Approximation of the function atan2 with a maximum absolute error of 4e-8 radians (about 2.2e-6 degrees).
+   * The range [-pi, pi] and the sign of the zeros are the same than for the function std::atan2.
+   *
+   * The arctangent of the ratio between the smallest and the largest absolute coordinate (in [0,1]) is 
+   * approximated by an odd polynomial of degree 15 (minimax fit) and the result is then moved to the right octant.
+   */
+  EIGEN_STRONG_INLINE double atan2_fast(double y, double x)
+  {
+    const double pi = 3.14159265358979323846;
+    const double* c = _atan_fast_coefficients;
+    const double ax = std::fabs(x), ay = std::fabs(y);
+    const double mx = (ay > ax) ? ay : ax;
+    const double mn = (ay > ax) ? ax : ay;
+    // mx is null only if mn is null too.
+    const double t = mn / ((mx > std::numeric_limits<double>::denorm_min()) ? mx : std::numeric_limits<double>::denorm_min());
+    const double s = t * t;
+    double a = ((((((c[7] * s + c[6]) * s + c[5]) * s + c[4]) * s + c[3]) * s + c[2]) * s + c[1]) * s + c[0];
+    a *= t;
+    a = (ay > ax) ? 0.5 * pi - a : a;
+    // The sign of the inverse gives also the sign of the zeros
+    a = (1.0 / x < 0.0) ? pi - a : a;
+    return (1.0 / y < 0.0) ? -a : a;
+  };
+  
+#ifdef EIGEN_VECTORIZE_SSE2
+  // SSE2 version of the function atan2_fast() computing two values at a time.
+  EIGEN_STRONG_INLINE __m128d _atan2_fast_sse2(__m128d y, __m128d x)
+  {
+    const double* c = _atan_fast_coefficients;
+    const __m128d signMask = _mm_set1_pd(-0.0);
+    const __m128d ax = _mm_andnot_pd(signMask, x);
+    const __m128d ay = _mm_andnot_pd(signMask, y);
+    const __m128d swap = _mm_cmpgt_pd(ay, ax);
+    const __m128d mx = _mm_max_pd(_mm_max_pd(ax, ay), _mm_set1_pd(std::numeric_limits<double>::denorm_min()));
+    const __m128d mn = _mm_min_pd(ax, ay);
+    const __m128d t = _mm_div_pd(mn, mx);
+    const __m128d s = _mm_mul_pd(t, t);
+    __m128d a = _mm_set1_pd(c[7]);
+    for (int k = 6 ; k >= 0 ; --k)
+      a = _mm_add_pd(_mm_mul_pd(a, s), _mm_set1_pd(c[k]));
+    a = _mm_mul_pd(a, t);
+    // Octant
+    const __m128d b = _mm_sub_pd(_mm_set1_pd(0.5 * 3.14159265358979323846), a);
+    a = _mm_or_pd(_mm_and_pd(swap, b), _mm_andnot_pd(swap, a));
+    // Left half-plane (sign bit of x set, zeros included)
+    const __m128d left = _mm_castsi128_pd(_mm_srai_epi32(_mm_castpd_si128(_mm_and_pd(x, signMask)), 31));
+    const __m128d leftMask = _mm_castsi128_pd(_mm_shuffle_epi32(_mm_castpd_si128(left), _MM_SHUFFLE(3,3,1,1)));
+    const __m128d d = _mm_sub_pd(_mm_set1_pd(3.14159265358979323846), a);
+    a = _mm_or_pd(_mm_and_pd(leftMask, d), _mm_andnot_pd(leftMask, a));
+    // Sign of y
+    return _mm_xor_pd(a, _mm_and_pd(y, signMask));
+  };
+#endif
+  
+  /**
+   * Computes the four-quadrant arctangent of the @a n elements of @a y and @a x and stores the result in @a out.
+   * If @a accurate is false, the function atan2_fast() is used. Otherwise, the function std::atan2 is used.
+   */
+  EIGEN_STRONG_INLINE void vatan2(double* out, const double* y, const double* x, int n, bool accurate = false)
+  {
+    int i = 0;
+    if (accurate)
+    {
+      for ( ; i < n ; ++i)
+        out[i] = std::atan2(y[i], x[i]);
+      return;
+    }
+#ifdef EIGEN_VECTORIZE_SSE2
+    for ( ; i + 1 < n ; i += 2)
+      _mm_storeu_pd(out + i, _atan2_fast_sse2(_mm_loadu_pd(y + i), _mm_loadu_pd(x + i)));
+#endif
+    for ( ; i < n ; ++i)
+      out[i] = atan2_fast(y[i], x[i]);
+  };
+  
+  /**
+   * Computes the square root of the @a n elements of @a in and stores the result in @a out.
+   */
+  EIGEN_STRONG_INLINE void vsqrt(double* out, const double* in, int n)
+  {
+    int i = 0;
+#ifdef EIGEN_VECTORIZE_SSE2
+    for ( ; i + 1 < n ; i += 2)
+      _mm_storeu_pd(out + i, _mm_sqrt_pd(_mm_loadu_pd(in + i)));
+#endif
+    for ( ; i < n ; ++i)
+      out[i] = std::sqrt(in[i]);
+  };
+  
+  /**
+   * Computes the norm of the @a n vectors (@a x, @a y, @a z) and stores the result in @a out.
+   */
+  EIGEN_STRONG_INLINE void vnorm(double* out, const double* x, const double* y, const double* z, int n)
+  {
+    for (int i = 0 ; i < n ; ++i)
+      out[i] = x[i] * x[i] + y[i] * y[i] + z[i] * z[i];
+    vsqrt(out, out, n);
+  };
+  
+  /**
+   * Normalizes in place the @a n vectors (@a x, @a y, @a z). The null vectors are not modified.
+   */
+  EIGEN_STRONG_INLINE void vnormalize(double* x, double* y, double* z, int n)
+  {
+    int i = 0;
+#ifdef EIGEN_VECTORIZE_SSE2
+    const __m128d zero = _mm_setzero_pd(), one = _mm_set1_pd(1.0);
+    for ( ; i + 1 < n ; i += 2)
+    {
+      __m128d vx = _mm_loadu_pd(x + i), vy = _mm_loadu_pd(y + i), vz = _mm_loadu_pd(z + i);
+      __m128d norm = _mm_sqrt_pd(_mm_add_pd(_mm_add_pd(_mm_mul_pd(vx, vx), _mm_mul_pd(vy, vy)), _mm_mul_pd(vz, vz)));
+      __m128d null = _mm_cmpeq_pd(norm, zero);
+      __m128d scale = _mm_div_pd(one, _mm_or_pd(_mm_and_pd(null, one), _mm_andnot_pd(null, norm)));
+      _mm_storeu_pd(x + i, _mm_mul_pd(vx, scale));
+      _mm_storeu_pd(y + i, _mm_mul_pd(vy, scale));
+      _mm_storeu_pd(z + i, _mm_mul_pd(vz, scale));
+    }
+#endif
+    for ( ; i < n ; ++i)
+    {
+      const double norm = std::sqrt(x[i] * x[i] + y[i] * y[i] + z[i] * z[i]);
+      const double scale = 1.0 / ((norm != 0.0) ? norm : 1.0);
+      x[i] *= scale; y[i] *= scale; z[i] *= scale;
+    }
+  };
+  
+  /**
+   * Computes the cross products of the @a n vectors (@a ax, @a ay, @a az) and (@a bx, @a by, @a bz). 
+   * The result is stored in (@a ox, @a oy, @a oz).
+   */
+  EIGEN_STRONG_INLINE void vcross(double* ox, double* oy, double* oz, const double* ax, const double* ay, const double* az, const double* bx, const double* by, const double* bz, int n)
+  {
+    for (int i = 0 ; i < n ; ++i)
+    {
+      const double x = ay[i] * bz[i] - az[i] * by[i];
+      const double y = az[i] * bx[i] - ax[i] * bz[i];
+      const double z = ax[i] * by[i] - ay[i] * bx[i];
+      ox[i] = x; oy[i] = y; oz[i] = z;
+    }
+  };
+};
+
+#endif // __btkEigenVectorMath_h
@@ -38,6 +38,8 @@
 
 #include "interp1_linear.h"
 #include "interp1_pchip.h"
+#include "interp1_spline.h"
+#include "interp1_knots.h"
 
 namespace btkEigen
 {
@@ -53,6 +55,18 @@ namespace btkEigen
     
     template <typename VectorType, typename OtherVectorType>
     void pchip(OtherVectorType* yi, const VectorType& x, const VectorType& y, const OtherVectorType& xi);
+    
+    template <typename VectorType, typename OtherVectorType>
+    void spline(OtherVectorType* yi, const VectorType& x, const VectorType& y, const OtherVectorType& xi);
+    
+    template <typename VectorType, typename MatrixType, typename OtherMatrixType>
+    void linear(OtherMatrixType* yi, const Interp1_knots<VectorType>& knots, const MatrixType& y);
+    
+    template <typename VectorType, typename MatrixType, typename OtherMatrixType>
+    void pchip(OtherMatrixType* yi, const Interp1_knots<VectorType>& knots, const MatrixType& y);
+    
+    template <typename VectorType, typename MatrixType, typename OtherMatrixType>
+    void spline(OtherMatrixType* yi, const Interp1_knots<VectorType>& knots, const MatrixType& y);
   };
   
   template <typename VectorType, typename OtherVectorType>
@@ -74,6 +88,50 @@ namespace btkEigen
     for (Index i = 0 ; i < (xi.rows() * xi.cols()) ; ++i)
       yi->coeffRef(i) = pi.interp(xi.coeff(i));
   };
+  
+  template <typename VectorType, typename OtherVectorType>
+  inline void interp1::spline(OtherVectorType* yi, const VectorType& x, const VectorType& y, const OtherVectorType& xi)
+  {
+    typedef typename VectorType::Index Index;
+    Spline_interp<VectorType> si(&x, &y);
+    yi->resize(xi.rows(), xi.cols());
+    for (Index i = 0 ; i < (xi.rows() * xi.cols()) ; ++i)
+      yi->coeffRef(i) = si.interp(xi.coeff(i));
+  };
+  
+  /**
+   * Batched version of the linear interpolation. Each column of @a y is interpolated
+   * using the knots and weights precomputed in @a knots.
+   * @code
+   * btkEigen::Interp1_knots<Eigen::VectorXd> knots(x, xi); // Bracketing search done only once
+   * btkEigen::interp1().linear(&yi, knots, y); // y: one curve per column
+   * @endcode
+   */
+  template <typename VectorType, typename MatrixType, typename OtherMatrixType>
+  inline void interp1::linear(OtherMatrixType* yi, const Interp1_knots<VectorType>& knots, const MatrixType& y)
+  {
+    knots.linear(yi, y);
+  };
+  
+  /**
+   * Batched version of the PCHIP interpolation. Each column of @a y is interpolated
+   * using the knots and Hermite basis precomputed in @a knots.
+   */
+  template <typename VectorType, typename MatrixType, typename OtherMatrixType>
+  inline void interp1::pchip(OtherMatrixType* yi, const Interp1_knots<VectorType>& knots, const MatrixType& y)
+  {
+    knots.pchip(yi, y);
+  };
+  
+  /**
+   * Batched version of the cubic spline interpolation. Each column of @a y is interpolated
+   * using the knots precomputed in @a knots.
+   */
+  template <typename VectorType, typename MatrixType, typename OtherMatrixType>
+  inline void interp1::spline(OtherMatrixType* yi, const Interp1_knots<VectorType>& knots, const MatrixType& y)
+  {
+    knots.spline(yi, y);
+  };
 };
 
 #endif // __btkEigenInterp1_h
\ No newline at end of file
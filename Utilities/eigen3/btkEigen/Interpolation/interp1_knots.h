@@ -0,0 +1,213 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __btkEigenInterp1Knots_h
+#define __btkEigenInterp1Knots_h
+
+#include "interp1_pchip.h"
+#include "interp1_spline.h"
+
+namespace btkEigen
+{
+  using namespace Eigen;
+  
+  /**
+   * Knot locator reusing the bracketing search (locate/hunt) of Base_interp.
+   * No interpolation is done by this structure.
+   */
+  template <typename VectorType>
+  struct Knots_locator : Base_interp<VectorType>
+  {
+    typedef typename VectorType::Scalar Scalar;
+    typedef typename VectorType::Index Index;
+    
+    Knots_locator(const VectorType* x)
+    : Base_interp<VectorType>(x,x,2)
+    {};
+    
+    Index search(Scalar x)
+    {
+      return this->cor ? this->hunt(x) : this->locate(x);
+    };
+    
+    Scalar rawinterp(Index j, Scalar x)
+    {
+      (void)x;
+      return this->yy->coeff(j);
+    };
+  };
+  
+  /**
+   * Knot indices and weights shared by several columns interpolated on the same abscissa.
+   *
+   * The bracketing search is done only once for all the query points. The weights of the 
+   * linear interpolation (@a t) and of the cubic Hermite basis (@a h00, @a h10, @a h01, @a h11)
+   * are also computed once. They depend only of @a x and @a xi and can then be applied to any
+   * number of columns sharing the same abscissa.
+   *
+   * The abscissa @a x is copied (member @a xx), so a temporary can be given to the constructor or to the method setknots().
+   *
+   * WARNING: The value for the horizontal axis (variable x) MUST be monotone increasing for the PCHIP weights.
+   */
+  template <typename VectorType>
+  struct Interp1_knots
+  {
+    typedef typename VectorType::Scalar Scalar;
+    typedef typename VectorType::Index Index;
+    typedef Matrix<Index, Dynamic, 1> IndexVector;
+    typedef Array<Scalar, Dynamic, 1> WeightVector;
+    
+    VectorType xx;
+    IndexVector j;
+    WeightVector h, t, h00, h10, h01, h11;
+    
+    template <typename OtherVectorType>
+    Interp1_knots(const VectorType& x, const OtherVectorType& xi)
+    : xx(), j(), h(), t(), h00(), h10(), h01(), h11()
+    {
+      this->setknots(x, xi);
+    };
+    
+    Index size() const {return this->j.rows();};
+    
+    template <typename OtherVectorType>
+    void setknots(const VectorType& x, const OtherVectorType& xi)
+    {
+      this->xx = x;
+      Index num = xi.rows() * xi.cols();
+      Knots_locator<VectorType> kl(&(this->xx));
+      this->j.resize(num);
+      this->h.resize(num);
+      this->t.resize(num);
+      for (Index i = 0 ; i < num ; ++i)
+      {
+        Index k = kl.search(xi.coeff(i));
+        Scalar h_ = x.coeff(k+1) - x.coeff(k);
+        this->j.coeffRef(i) = k;
+        this->h.coeffRef(i) = h_;
+        // Same behaviour than Linear_interp::rawinterp when two knots are identical.
+        this->t.coeffRef(i) = (h_ == Scalar(0)) ? Scalar(0) : (xi.coeff(i) - x.coeff(k)) / h_;
+      }
+      const Scalar c1 = Scalar(1);
+      const Scalar c2 = Scalar(2);
+      const Scalar c3 = Scalar(3);
+      WeightVector t2 = this->t.square();
+      WeightVector t3 = t2 * this->t;
+      this->h00 = c2*t3 - c3*t2 + c1;
+      this->h10 = (t3 - c2*t2 + this->t) * this->h;
+      this->h01 = -c2*t3 + c3*t2;
+      this->h11 = (t3 - t2) * this->h;
+    };
+    
+    /**
+     * Interpolate linearly each column of @a y. The result is stored in @a yi (one column for each column of @a y).
+     */
+    template <typename MatrixType, typename OtherMatrixType>
+    void linear(OtherMatrixType* yi, const MatrixType& y) const
+    {
+      Index num = this->size();
+      WeightVector y0(num), y1(num);
+      yi->resize(num, y.cols());
+      for (Index c = 0 ; c < y.cols() ; ++c)
+      {
+        for (Index i = 0 ; i < num ; ++i)
+        {
+          y0.coeffRef(i) = y.coeff(this->j.coeff(i), c);
+          y1.coeffRef(i) = y.coeff(this->j.coeff(i)+1, c);
+        }
+        yi->col(c) = (y0 + this->t * (y1 - y0)).matrix();
+      }
+    };
+    
+    /**
+     * Interpolate each column of @a y using the PCHIP method. The slopes are computed for each column
+     * (see PCHIP_interp) but the Hermite basis is shared between all of them.
+     */
+    template <typename MatrixType, typename OtherMatrixType>
+    void pchip(OtherMatrixType* yi, const MatrixType& y) const
+    {
+      Index num = this->size();
+      VectorType yc;
+      WeightVector y0(num), y1(num), d0(num), d1(num);
+      yi->resize(num, y.cols());
+      for (Index c = 0 ; c < y.cols() ; ++c)
+      {
+        yc = y.col(c);
+        PCHIP_interp<VectorType> pi(&(this->xx), &yc);
+        for (Index i = 0 ; i < num ; ++i)
+        {
+          Index k = this->j.coeff(i);
+          eigen_assert(this->h.coeff(i) > 0.0);
+          y0.coeffRef(i) = yc.coeff(k);
+          y1.coeffRef(i) = yc.coeff(k+1);
+          d0.coeffRef(i) = pi.dk.coeff(k);
+          d1.coeffRef(i) = pi.dk.coeff(k+1);
+        }
+        yi->col(c) = (y0 * this->h00 + d0 * this->h10 + y1 * this->h01 + d1 * this->h11).matrix();
+      }
+    };
+    
+    /**
+     * Interpolate each column of @a y using a natural cubic spline (see Spline_interp).
+     */
+    template <typename MatrixType, typename OtherMatrixType>
+    void spline(OtherMatrixType* yi, const MatrixType& y) const
+    {
+      Index num = this->size();
+      VectorType yc;
+      WeightVector y0(num), y1(num), d0(num), d1(num);
+      WeightVector a = Scalar(1) - this->t;
+      WeightVector c0 = (a.cube() - a) * this->h.square() / Scalar(6);
+      WeightVector c1 = (this->t.cube() - this->t) * this->h.square() / Scalar(6);
+      yi->resize(num, y.cols());
+      for (Index c = 0 ; c < y.cols() ; ++c)
+      {
+        yc = y.col(c);
+        Spline_interp<VectorType> si(&(this->xx), &yc);
+        for (Index i = 0 ; i < num ; ++i)
+        {
+          Index k = this->j.coeff(i);
+          y0.coeffRef(i) = yc.coeff(k);
+          y1.coeffRef(i) = yc.coeff(k+1);
+          d0.coeffRef(i) = si.y2.coeff(k);
+          d1.coeffRef(i) = si.y2.coeff(k+1);
+        }
+        yi->col(c) = (y0 * a + y1 * this->t + d0 * c0 + d1 * c1).matrix();
+      }
+    };
+  };
+};
+
+#endif // __btkEigenInterp1Knots_h
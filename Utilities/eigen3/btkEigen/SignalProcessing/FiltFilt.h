@@ -55,6 +55,37 @@ namespace btkEigen
 {
   using namespace Eigen;
   
+  /**
+   * Compute the steady-state of the filter (step response) used to initialize the forward and backward passes of filtfilt().
+   * The coefficients @a bb and @a aa must have the same length.
+   * The method proposed by Gustafsson (1996) is used.
+   */
+  template<typename VectorType, typename CoeffType>
+  void filtfilt_initial_state(VectorType* zi, const CoeffType& bb, const CoeffType& aa)
+  {
+    typedef typename CoeffType::Scalar Scalar;
+    typedef typename CoeffType::Index Index;
+    typedef Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic> FFMatrix;
+    
+    const Index order = bb.rows();
+    if (order == 2)
+    {
+      zi->resize(1,1);
+      zi->coeffRef(0) = (1.0 + aa.coeff(1)) / (bb.coeff(1) - bb.coeff(0)*aa.coeff(1));
+    }
+    else
+    {
+      FFMatrix temp(order-1,order-2);
+      temp.block(0,0,order-2,order-2) = -FFMatrix::Identity(order-2,order-2);
+      temp.block(order-2,0,1,order-2) = FFMatrix::Zero(1,order-2);
+      FFMatrix temp1(order-1,order-1);
+      temp1 << aa.block(1,0,order-1,1), temp;
+      temp1 += FFMatrix::Identity(order-1,order-1);
+      FFMatrix temp2 =  bb.block(1,0,order-1,1) - (bb.coeff(0) * aa.block(1,0,order-1,1));
+      *zi = temp1.lu().solve(temp2);
+    }
+  };
+  
   /**
    * A forward-backward digital filter without phase delay (zero phase distorsion). 
    * Compared to a simple forward filter, the order of this filter is twice of the original order and the cutoff frequency is reduced. 
@@ -72,7 +103,6 @@ namespace btkEigen
   {
     typedef typename MatrixType::Scalar Scalar;
     typedef typename MatrixType::Index Index;
-    typedef Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic> FFMatrix;
     typedef Eigen::Matrix<Scalar, Eigen::Dynamic, 1> FFVector;
   
     const Index slen = X.rows();
@@ -88,22 +118,7 @@ namespace btkEigen
     
     // Compute the initial state of the filter
     FFVector zi;
-    if (order == 2)
-    {
-      zi.resize(1,1);
-      zi.coeffRef(0) = (1.0 + aa.coeff(1)) / (bb.coeff(1) - bb.coeff(0)*aa.coeff(1));
-    }
-    else
-    {
-      FFMatrix temp(order-1,order-2);
-      temp.block(0,0,order-2,order-2) = -FFMatrix::Identity(order-2,order-2);
-      temp.block(order-2,0,1,order-2) = FFMatrix::Zero(1,order-2);
-      FFMatrix temp1(order-1,order-1);
-      temp1 << aa.block(1,0,order-1,1), temp;
-      temp1 += FFMatrix::Identity(order-1,order-1);
-      FFMatrix temp2 =  bb.block(1,0,order-1,1) - (bb.coeff(0) * aa.block(1,0,order-1,1));
-      zi = temp1.lu().solve(temp2);
-    }
+    filtfilt_initial_state(&zi, bb, aa);
     
     MatrixType Y = X;
     for (int i = 0 ; i < Y.cols() ; ++i)
@@ -133,5 +148,54 @@ namespace btkEigen
     
     return Y;
   };
+  
+  /**
+   * Forward-backward digital filter applied in place on several signals at once.
+   *
+   * This function gives the same result than filtfilt() but each row of @a X is a signal (a channel) and each column is a sample.
+   * The reflections, the initial states and both passes are computed for all the channels together (see filter_multichannel()),
+   * which is faster than filtering each signal separately when several channels are sampled at the same frequency (e.g. EMG).
+   */
+  template<typename NumeratorFilterCoeff, typename DenominatorFilterCoeff, typename MatrixType>
+  void filtfilt_multichannel(const NumeratorFilterCoeff& b, const DenominatorFilterCoeff& a, MatrixType* X)
+  {
+    typedef typename MatrixType::Scalar Scalar;
+    typedef typename MatrixType::Index Index;
+    typedef Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic> FFMatrix;
+    typedef Eigen::Matrix<Scalar, Eigen::Dynamic, 1> FFVector;
+    
+    const Index cnum = X->rows();
+    const Index slen = X->cols();
+    const Index order = std::max(b.rows(), a.rows());
+    const Index elen = 3 * (order - 1); // Number of element used in the reflections
+    
+    eigen_assert((order > 1) && "The order of the filter must be greater than 1.");
+    eigen_assert((slen > elen) && "The signal to filter must have a length 3 times greater than the order of the filter.");
+    
+    // Copy the coefficients and pad them with zeros 
+    BTKEIGEN_FILTER_PAD_COEFFICIENTS(MatrixType,bb,b,order)
+    BTKEIGEN_FILTER_PAD_COEFFICIENTS(MatrixType,aa,a,order)
+    
+    // Compute the initial state of the filter
+    FFVector zi;
+    filtfilt_initial_state(&zi, bb, aa);
+    
+    // Signals to filter with their reflections
+    FFMatrix Y(cnum, slen + 2*elen);
+    Y.block(0,elen,cnum,slen) = *X;
+    for (Index k = 0 ; k < elen ; ++k)
+    {
+      Y.col(elen-k-1) = 2.0 * X->col(0) - X->col(k+1);
+      Y.col(elen+slen+k) = 2.0 * X->col(slen-1) - X->col(slen-k-2);
+    }
+    // Forward filter
+    FFMatrix Z = Y.col(0) * zi.transpose();
+    filter_multichannel(bb,aa,&Y,&Z);
+    // Backward filter
+    Z = Y.col(Y.cols()-1) * zi.transpose();
+    filter_multichannel(bb,aa,&Y,&Z,true);
+    // Final filtered signals
+    *X = Y.block(0,elen,cnum,slen);
+  };
 };
 #endif // __btkEigenFiltFilt_h
\ No newline at end of file
@@ -147,5 +147,60 @@ namespace btkEigen
     Eigen::Matrix<Scalar, Eigen::Dynamic, 1> si = Eigen::Matrix<Scalar, Eigen::Dynamic, 1>::Zero(std::max(b.rows(), a.rows())-1);
     return filter(b,a,X,si);
   };
+  
+  /**
+   * Digital filter applied in place on several signals at once.
+   *
+   * Contrary to the function filter(), each row of @a X is a signal (a channel) and each column is a sample.
+   * With this layout, the samples of all the channels at a given instant are contiguous in memory and
+   * the Direct Form II Transposed recurrence is evaluated with vector operations over the channels.
+   *
+   * The matrix @a Z contains the state of the filter with one row per channel and one column per delay.
+   * It is used as the initial state and contains the final state when the function returns.
+   * If @a reverse is set to true, the samples are processed from the last one to the first one.
+   */
+  template<typename NumeratorFilterCoeff, typename DenominatorFilterCoeff, typename MatrixType, typename StateType>
+  void filter_multichannel(const NumeratorFilterCoeff& b, const DenominatorFilterCoeff& a, MatrixType* X, StateType* Z, bool reverse = false)
+  {
+    typedef typename MatrixType::Scalar Scalar;
+    typedef typename MatrixType::Index Index;
+    
+    const Index len = std::max(b.rows(), a.rows());
+    
+    eigen_assert(b.cols() == 1);
+    eigen_assert(a.cols() == 1);
+    eigen_assert(len > 1);
+    eigen_assert(Z->rows() == X->rows());
+    eigen_assert(Z->cols() == len-1);
+    
+    // Copy the coefficients and pad them with zeros
+    BTKEIGEN_FILTER_PAD_COEFFICIENTS(MatrixType,bb,b,len)
+    BTKEIGEN_FILTER_PAD_COEFFICIENTS(MatrixType,aa,a,len)
+    
+    Scalar norm = aa.coeff(0);
+    if (norm == 0.0)
+    {
+      btkErrorMacro("Impossible to filter the signal, the first element of the denominator is equal to 0.");
+      return;
+    }
+    else if (std::abs(norm - 1.0) > NumTraits<Scalar>::epsilon())
+    {
+      bb /= norm;
+      aa /= norm;
+    }
+    
+    const Index lsi = len-2; // last index for the state matrix
+    const Index slen = X->cols();
+    Eigen::Matrix<Scalar, Eigen::Dynamic, 1> x(X->rows());
+    for (Index k = 0 ; k < slen ; ++k)
+    {
+      const Index i = reverse ? slen-k-1 : k;
+      x = X->col(i);
+      X->col(i) = Z->col(0) + bb.coeff(0) * x;
+      for (Index j = 0 ; j < lsi ; ++j)
+        Z->col(j) = Z->col(j+1) + bb.coeff(j+1) * x - aa.coeff(j+1) * X->col(i);
+      Z->col(lsi) = bb.coeff(lsi+1) * x - aa.coeff(lsi+1) * X->col(i);
+    }
+  };
 };
 #endif // __btkEigenFilter_h
\ No newline at end of file
@@ -0,0 +1,391 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __btkEigenMovingStatistics_h
+#define __btkEigenMovingStatistics_h
+
+#include <Eigen/Core>
+
+#include <set>
+#include <cmath>
+#include <limits>
+
+namespace btkEigen
+{
+  using namespace Eigen;
+  
+  /**
+   * Number of samples used by the sliding window for each of the @a slen samples of a signal.
+   * The window is defined as in the function movsum().
+   */
+  template<typename VectorType>
+  void movcount(VectorType* out, typename VectorType::Index slen, int window)
+  {
+    typedef typename VectorType::Scalar Scalar;
+    typedef typename VectorType::Index Index;
+    
+    const Index kb = window / 2;
+    const Index kf = (window - 1) / 2;
+    out->resize(slen);
+    for (Index i = 0 ; i < slen ; ++i)
+      out->coeffRef(i) = static_cast<Scalar>(std::min(slen - 1, i + kf) - std::max(static_cast<Index>(0), i - kb) + 1);
+  };
+  
+  /**
+   * Moving sum computed on each column of @a X over a sliding window of @a window samples.
+   *
+   * The window is centered on the current sample. For an even length, the window contains one more sample 
+   * before the current one than after it. Near the endpoints, the window is truncated and the sum is computed
+   * only with the available samples (shrink mode of the Matlab function movsum).
+   *
+   * The non-finite samples (NaN, infinity) are omitted (as with the option 'omitnan' of the Matlab function movsum): 
+   * once in a cumulative sum, they could not be removed from it. A window without finite sample gives 0.
+   *
+   * The sums are computed only once (cumulative sum), so the cost of each output sample does not depend on the length of the window.
+   * The rows of the matrices are processed as a whole, so all the columns are computed together.
+   */
+  template<typename MatrixType, typename OtherMatrixType>
+  void movsum(OtherMatrixType* out, const MatrixType& X, int window)
+  {
+    typedef typename MatrixType::Scalar Scalar;
+    typedef typename MatrixType::Index Index;
+    typedef Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic> MSMatrix;
+    
+    eigen_assert((window > 0) && "The length of the window must be greater than 0.");
+    
+    const Index slen = X.rows();
+    const Index cnum = X.cols();
+    const Index kb = window / 2; // Number of samples before the current one
+    const Index kf = (window - 1) / 2; // Number of samples after the current one
+    
+    // Cumulative sums of the finite samples with a leading row of zeros: S(i) = X(0) + ... + X(i-1)
+    MSMatrix S(slen+1, cnum);
+    S.row(0).setZero();
+    for (Index i = 0 ; i < slen ; ++i)
+      S.row(i+1) = S.row(i) + ((X.row(i).array() - X.row(i).array()) == static_cast<Scalar>(0)).select(X.row(i), static_cast<Scalar>(0));
+    
+    out->resize(slen, cnum);
+    // Samples where the window is complete
+    const Index inner = slen - kb - kf;
+    if (inner > 0)
+      out->middleRows(kb, inner) = S.middleRows(kb+kf+1, inner) - S.topRows(inner);
+    // Samples where the window is truncated
+    const Index first = (inner > 0) ? kb : slen;
+    const Index last = (inner > 0) ? slen - kf : slen;
+    for (Index i = 0 ; i < slen ; ++i)
+    {
+      if (i == first)
+        i = last;
+      if (i >= slen)
+        break;
+      const Index lo = std::max(static_cast<Index>(0), i - kb);
+      const Index hi = std::min(slen - 1, i + kf);
+      out->row(i) = S.row(hi+1) - S.row(lo);
+    }
+  };
+  
+  /**
+   * Number of finite samples of each column of @a X used by the sliding window. 
+   * The window is defined as in the function movsum().
+   */
+  template<typename MatrixType, typename OtherMatrixType>
+  void movcountfinite(OtherMatrixType* out, const MatrixType& X, int window)
+  {
+    typedef typename MatrixType::Scalar Scalar;
+    typedef Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic> MSMatrix;
+    
+    MSMatrix N = ((X.array() - X.array()) == static_cast<Scalar>(0)).template cast<Scalar>().matrix();
+    movsum(out, N, window);
+  };
+  
+  /**
+   * Mean of the finite samples of each column of @a X (0 for a column without finite sample).
+   */
+  template<typename MatrixType>
+  Eigen::Matrix<typename MatrixType::Scalar, 1, Eigen::Dynamic> colwisemeanfinite(const MatrixType& X)
+  {
+    typedef typename MatrixType::Scalar Scalar;
+    typedef typename MatrixType::Index Index;
+    
+    Eigen::Matrix<Scalar, 1, Eigen::Dynamic> mu(X.cols());
+    for (Index j = 0 ; j < X.cols() ; ++j)
+    {
+      Scalar sum = static_cast<Scalar>(0);
+      Index num = 0;
+      for (Index i = 0 ; i < X.rows() ; ++i)
+      {
+        const Scalar v = X.coeff(i, j);
+        if ((v - v) == static_cast<Scalar>(0))
+        {
+          sum += v;
+          ++num;
+        }
+      }
+      mu.coeffRef(j) = (num != 0) ? sum / static_cast<Scalar>(num) : static_cast<Scalar>(0);
+    }
+    return mu;
+  };
+  
+  /**
+   * Moving average computed on each column of @a X over a sliding window of @a window samples.
+   * The window is defined as in the function movsum().
+   *
+   * Only the finite samples are averaged. A window without finite sample gives NaN.
+   * To limit the rounding errors of the cumulative sums, the mean of each column is removed before the computation and added after.
+   */
+  template<typename MatrixType, typename OtherMatrixType>
+  void movmean(OtherMatrixType* out, const MatrixType& X, int window)
+  {
+    typedef typename MatrixType::Scalar Scalar;
+    typedef Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic> MSMatrix;
+    typedef Eigen::Matrix<Scalar, 1, Eigen::Dynamic> MSRowVector;
+    
+    if (X.rows() == 0)
+    {
+      out->resize(0, X.cols());
+      return;
+    }
+    MSRowVector mu = colwisemeanfinite(X);
+    MSMatrix Y = X.rowwise() - mu;
+    movsum(out, Y, window);
+    MSMatrix n;
+    movcountfinite(&n, X, window);
+    // 0/0 gives NaN for the windows without finite sample.
+    *out = ((out->array() / n.array()).rowwise() + mu.array()).matrix();
+  };
+  
+  /**
+   * Moving root mean square computed on each column of @a X over a sliding window of @a window samples.
+   * The window is defined as in the function movsum().
+   *
+   * Only the finite samples are used. A window without finite sample gives NaN.
+   */
+  template<typename MatrixType, typename OtherMatrixType>
+  void movrms(OtherMatrixType* out, const MatrixType& X, int window)
+  {
+    typedef typename MatrixType::Scalar Scalar;
+    typedef Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic> MSMatrix;
+    
+    MSMatrix X2 = X.array().square().matrix();
+    movsum(out, X2, window);
+    MSMatrix n;
+    movcountfinite(&n, X, window);
+    // Rounding errors in the cumulative sums could give very small negative values.
+    // The selection keeps the NaN of the windows without finite sample (0/0).
+    MSMatrix ms = (out->array() / n.array()).matrix();
+    *out = (ms.array() < static_cast<Scalar>(0)).select(MSMatrix::Zero(ms.rows(), ms.cols()), ms).array().sqrt().matrix();
+  };
+  
+  /**
+   * Moving variance computed on each column of @a X over a sliding window of @a window samples.
+   * The window is defined as in the function movsum().
+   *
+   * The variance is normalized by the number of samples in the window minus one (unbiased estimator). 
+   * When the window contains only one sample, the variance is set to 0.
+   * Only the finite samples are used and counted. A window without finite sample gives NaN.
+   * The sums of the samples and of their squares are computed once (see movsum()) on the signals centered 
+   * on their mean, so the cost of each output sample does not depend on the length of the window.
+   */
+  template<typename MatrixType, typename OtherMatrixType>
+  void movvar(OtherMatrixType* out, const MatrixType& X, int window)
+  {
+    typedef typename MatrixType::Scalar Scalar;
+    typedef Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic> MSMatrix;
+    
+    if (X.rows() == 0)
+    {
+      out->resize(0, X.cols());
+      return;
+    }
+    MSMatrix Y = X.rowwise() - colwisemeanfinite(X);
+    MSMatrix S1, S2, n;
+    movsum(&S1, Y, window);
+    movsum(&S2, MSMatrix(Y.array().square().matrix()), window);
+    movcountfinite(&n, X, window);
+    MSMatrix d = (n.array() - static_cast<Scalar>(1)).max(static_cast<Scalar>(1)).matrix();
+    // The selection keeps the NaN of the windows without finite sample (0/0).
+    MSMatrix v = ((S2.array() - S1.array().square() / n.array()) / d.array()).matrix();
+    *out = (v.array() < static_cast<Scalar>(0)).select(MSMatrix::Zero(v.rows(), v.cols()), v);
+  };
+  
+  /**
+   * Moving standard deviation computed on each column of @a X over a sliding window of @a window samples.
+   * See the function movvar() for the details.
+   */
+  template<typename MatrixType, typename OtherMatrixType>
+  void movstd(OtherMatrixType* out, const MatrixType& X, int window)
+  {
+    movvar(out, X, window);
+    *out = out->array().sqrt().matrix();
+  };
+  
+  /**
+   * Order statistics of the samples inside a sliding window.
+   *
+   * The samples are split in two sorted sets: the lowest one contains the @a rank smallest samples and the highest one the others. 
+   * Adding or removing a sample and moving the split to another rank cost O(log(w)) where w is the number of samples in the window.
+   *
+   * NaN samples cannot be ordered and are ignored by insert() and erase(): the method size() gives only the number of valid samples.
+   */
+  template<typename Scalar>
+  class movorder_window
+  {
+  public:
+    movorder_window() : m_Low(), m_High() {};
+    
+    int size() const {return static_cast<int>(this->m_Low.size() + this->m_High.size());};
+    
+    void insert(Scalar v)
+    {
+      if (v != v) // NaN
+        return;
+      if (!this->m_Low.empty() && (v <= *(this->m_Low.rbegin())))
+        this->m_Low.insert(v);
+      else
+        this->m_High.insert(v);
+    };
+    
+    void erase(Scalar v)
+    {
+      if (v != v) // NaN
+        return;
+      if (!this->m_Low.empty() && (v <= *(this->m_Low.rbegin())))
+        this->m_Low.erase(this->m_Low.find(v));
+      else
+        this->m_High.erase(this->m_High.find(v));
+    };
+    
+    /**
+     * Returns the (@a rank)-th smallest sample (0-based index) and the next one (or the same if there is no next sample).
+     */
+    void get(int rank, Scalar* value, Scalar* next)
+    {
+      const size_t num = static_cast<size_t>(rank) + 1;
+      while (this->m_Low.size() > num)
+      {
+        typename std::multiset<Scalar>::iterator it = --(this->m_Low.end());
+        this->m_High.insert(*it);
+        this->m_Low.erase(it);
+      }
+      while ((this->m_Low.size() < num) && !this->m_High.empty())
+      {
+        this->m_Low.insert(*(this->m_High.begin()));
+        this->m_High.erase(this->m_High.begin());
+      }
+      *value = *(this->m_Low.rbegin());
+      *next = this->m_High.empty() ? *value : *(this->m_High.begin());
+    };
+    
+  private:
+    std::multiset<Scalar> m_Low;
+    std::multiset<Scalar> m_High;
+  };
+  
+  /**
+   * Moving percentile computed on each column of @a X over a sliding window of @a window samples.
+   * The window is defined as in the function movsum() and the percentile @a p (between 0 and 100) is computed as in the method DenseBase::percentile()
+   * (linear interpolation between the closest ranks).
+   *
+   * Contrary to the method DenseBase::percentile() which sorts the data for each call, the samples of the window are kept sorted 
+   * (see movorder_window) and only the sample entering and the one leaving the window are updated. The cost of each output sample is in O(log(w)).
+   *
+   * The NaN samples are omitted (as with the option 'omitnan' of the Matlab function movmedian). When the window contains only NaN samples, the output is NaN.
+   * Contrary to the functions based on cumulative sums (see movsum()), the infinite samples are kept as they can be ordered.
+   */
+  template<typename MatrixType, typename OtherMatrixType>
+  void movprctile(OtherMatrixType* out, const MatrixType& X, int window, double p)
+  {
+    typedef typename MatrixType::Scalar Scalar;
+    typedef typename MatrixType::Index Index;
+    
+    eigen_assert((window > 0) && "The length of the window must be greater than 0.");
+    eigen_assert((p >= 0.0) && (p <= 100.0) && "The percentile must be between 0 and 100.");
+    
+    const Index slen = X.rows();
+    const Index cnum = X.cols();
+    const Index kb = window / 2;
+    const Index kf = (window - 1) / 2;
+    
+    out->resize(slen, cnum);
+    for (Index j = 0 ; j < cnum ; ++j)
+    {
+      movorder_window<Scalar> w;
+      Index lo = 0, hi = -1; // Current samples in the window
+      for (Index i = 0 ; i < slen ; ++i)
+      {
+        const Index lo_ = std::max(static_cast<Index>(0), i - kb);
+        const Index hi_ = std::min(slen - 1, i + kf);
+        while (hi < hi_)
+          w.insert(X.coeff(++hi, j));
+        while (lo < lo_)
+          w.erase(X.coeff(lo++, j));
+        const int num = w.size();
+        if (num == 0)
+        {
+          out->coeffRef(i, j) = std::numeric_limits<Scalar>::quiet_NaN();
+          continue;
+        }
+        const double idx = p / 100.0 * static_cast<double>(num) - 0.5;
+        Scalar v, n;
+        if (idx <= 0.0)
+          w.get(0, &v, &n);
+        else if (idx >= static_cast<double>(num - 1))
+        {
+          w.get(num - 1, &v, &n);
+          n = v;
+        }
+        else
+        {
+          const double idx_ = std::floor(idx);
+          w.get(static_cast<int>(idx_), &v, &n);
+          v += static_cast<Scalar>(idx - idx_) * (n - v);
+        }
+        out->coeffRef(i, j) = v;
+      }
+    }
+  };
+  
+  /**
+   * Moving median computed on each column of @a X over a sliding window of @a window samples.
+   * See the function movprctile() for the details.
+   */
+  template<typename MatrixType, typename OtherMatrixType>
+  void movmedian(OtherMatrixType* out, const MatrixType& X, int window)
+  {
+    movprctile(out, X, window, 50.0);
+  };
+};
+
+#endif // __btkEigenMovingStatistics_h
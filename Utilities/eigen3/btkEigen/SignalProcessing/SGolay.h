@@ -0,0 +1,131 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __btkEigenSGolay_h
+#define __btkEigenSGolay_h
+
+#include <Eigen/Core>
+#include <Eigen/QR>
+
+namespace btkEigen
+{
+  using namespace Eigen;
+  
+  /**
+   * Savitzky-Golay FIR filters.
+   *
+   * A polynomial of order @a order is fitted (least squares) on a window of @a window samples (odd number). 
+   * The row @a p of the matrix @a B contains the coefficients to apply on the samples of the window to 
+   * obtain the @a deriv-th derivative of this polynomial (with a unit sampling period) at the @a p-th sample of the window.
+   * The middle row corresponds to the classical centered filter, while the other rows are used to process the 
+   * first and last samples of a signal (see sgolayfilt()).
+   *
+   * For @a deriv set to 0, the matrix @a B corresponds to the first output of the Matlab function sgolay.
+   */
+  template<typename MatrixType>
+  void sgolay(MatrixType* B, int order, int window, int deriv = 0)
+  {
+    typedef typename MatrixType::Scalar Scalar;
+    typedef typename MatrixType::Index Index;
+    typedef Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic> SGMatrix;
+    
+    eigen_assert((window % 2 == 1) && "The length of the window must be odd.");
+    eigen_assert((order < window) && "The order of the polynomial must be lower than the length of the window.");
+    eigen_assert((deriv >= 0) && "The order of the derivative must be positive.");
+    
+    const Index m = window / 2;
+    // Vandermonde matrix with the time centered on the middle of the window.
+    SGMatrix A(window, order+1);
+    for (Index i = 0 ; i < window ; ++i)
+    {
+      const Scalar t = static_cast<Scalar>(i - m);
+      Scalar v = static_cast<Scalar>(1);
+      for (Index k = 0 ; k <= order ; ++k)
+      {
+        A.coeffRef(i,k) = v;
+        v *= t;
+      }
+    }
+    // Coefficients of the polynomial: C * x 
+    SGMatrix C = A.householderQr().solve(SGMatrix::Identity(window, window));
+    // Derivative of the monomials evaluated at each sample of the window
+    SGMatrix D = SGMatrix::Zero(window, order+1);
+    for (Index i = 0 ; i < window ; ++i)
+    {
+      const Scalar t = static_cast<Scalar>(i - m);
+      for (Index k = deriv ; k <= order ; ++k)
+      {
+        Scalar v = static_cast<Scalar>(1);
+        for (Index l = 0 ; l < deriv ; ++l)
+          v *= static_cast<Scalar>(k - l);
+        for (Index l = 0 ; l < k - deriv ; ++l)
+          v *= t;
+        D.coeffRef(i,k) = v;
+      }
+    }
+    *B = D * C;
+  };
+  
+  /**
+   * Apply a Savitzky-Golay filter on each column of @a X.
+   *
+   * The matrix @a B must be computed with the function sgolay(). The centered filter (middle row of @a B) is used for 
+   * the samples where the window is complete, while the first (last) samples use the polynomial fitted on the first (last) window.
+   * Each coefficient of the centered filter is applied on all the rows at once, so all the columns are processed together.
+   * The number of rows of @a X must be greater or equal to the length of the window.
+   */
+  template<typename MatrixType, typename OtherMatrixType, typename KernelType>
+  void sgolayfilt(OtherMatrixType* out, const MatrixType& X, const KernelType& B)
+  {
+    typedef typename MatrixType::Index Index;
+    
+    const Index window = B.rows();
+    const Index m = window / 2;
+    const Index slen = X.rows();
+    
+    eigen_assert((B.cols() == window) && "The kernel must be a square matrix.");
+    eigen_assert((slen >= window) && "The signal must have at least as many samples as the length of the window.");
+    
+    out->resize(slen, X.cols());
+    const Index inner = slen - window + 1;
+    out->middleRows(m, inner) = B.coeff(m,0) * X.topRows(inner);
+    for (Index j = 1 ; j < window ; ++j)
+      out->middleRows(m, inner) += B.coeff(m,j) * X.middleRows(j, inner);
+    out->topRows(m) = B.topRows(m) * X.topRows(window);
+    out->bottomRows(m) = B.bottomRows(m) * X.bottomRows(window);
+  };
+};
+
+#endif // __btkEigenSGolay_h
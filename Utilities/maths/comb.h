@@ -52,9 +52,9 @@ T comb(T n, T k)
 }
 
 #if defined(_MSC_VER)
-  template <> int comb<int>(int n, int k) {return static_cast<int>(floor(comb(static_cast<float>(n), static_cast<float>(k))+0.5f));};
+  template <> inline int comb<int>(int n, int k) {return static_cast<int>(floor(comb(static_cast<float>(n), static_cast<float>(k))+0.5f));};
 #else
-  template <> int comb<int>(int n, int k) {return static_cast<int>(round(comb(static_cast<float>(n), static_cast<float>(k))));};
+  template <> inline int comb<int>(int n, int k) {return static_cast<int>(round(comb(static_cast<float>(n), static_cast<float>(k))));};
 #endif
 
 #endif // __comb_h
\ No newline at end of file
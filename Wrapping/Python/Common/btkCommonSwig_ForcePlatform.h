@@ -48,3 +48,7 @@ btkForcePlatform btkForcePlatformType3();
 btkForcePlatform btkForcePlatformType4();
 btkForcePlatform btkForcePlatformType5();
 btkForcePlatform btkForcePlatformType6();
+btkForcePlatform btkForcePlatformType7();
+btkForcePlatform btkForcePlatformType11();
+btkForcePlatform btkForcePlatformType12();
+btkForcePlatform btkForcePlatformType21();
@@ -141,6 +141,26 @@ btkForcePlatform btkForcePlatformType6()
   return btkForcePlatform_shared(btk::ForcePlatformType6::New());
 };
 
+btkForcePlatform btkForcePlatformType7()
+{
+  return btkForcePlatform_shared(btk::ForcePlatformType7::New());
+};
+
+btkForcePlatform btkForcePlatformType11()
+{
+  return btkForcePlatform_shared(btk::ForcePlatformType11::New());
+};
+
+btkForcePlatform btkForcePlatformType12()
+{
+  return btkForcePlatform_shared(btk::ForcePlatformType12::New());
+};
+
+btkForcePlatform btkForcePlatformType21()
+{
+  return btkForcePlatform_shared(btk::ForcePlatformType21::New());
+};
+
 // ------------------------------------------------------------------------- //
 //                                    Wrench                                 //
 // ------------------------------------------------------------------------- //
@@ -368,6 +368,18 @@ Force platform composed of 12 channels and a 12 columns by 12 rows calibration m
  - FZ2: Vertical forces measured by the sensor on the corner 2;
  - FZ3: Vertical forces measured by the sensor on the corner 3;
  - FZ4: Vertical forces measured by the sensor on the corner 4."
+
+%feature("docstring") btkForcePlatformType7 "
+Force platform composed of 8 channels (FX12, FX34, FY14, FY23, FZ1, FZ2, FZ3, FZ4) and a 8 columns by 8 rows calibration matrix."
+
+%feature("docstring") btkForcePlatformType11 "
+Kistler split belt treadmill composed of 8 channels and a 8 columns by 8 rows calibration matrix."
+
+%feature("docstring") btkForcePlatformType12 "
+Gaitway treadmill composed of 8 channels (FZ11, FZ12, FZ13, FZ14, FZ21, FZ22, FZ23, FZ24) and a 8 columns by 8 rows calibration matrix."
+
+%feature("docstring") btkForcePlatformType21 "
+AMTI stairs composed of 6 channels (FX, FY, FZ, MX, MY, MZ) and a 6 columns by 6 rows calibration matrix."
  
 // ------------------------------------------------------------------------- //
 //                                    Wrench                                 //